@@ -1,23 +1,35 @@
 #include <assert.h>
+#include <dirent.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
 #include <stdarg.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
 #include <unistd.h>
 
+#include "utils/base64.h"
 #include "utils/bits.h"
+#include "utils/checksum.h"
 #include "utils/collections/single_link_list.h"
 #include "utils/collections/vector.h"
+#include "utils/csv.h"
 #include "utils/data_types.h"
+#include "utils/external_sort.h"
 #include "utils/file.h"
 #include "utils/hex_buffer.h"
 #include "utils/log.h"
 #include "utils/memory.h"
 #include "utils/random.h"
+#include "utils/record_log.h"
 #include "utils/smart_ptr.h"
 #include "utils/heap_string.h"
 #include "utils/timer.h"
+#include "utils/utf8.h"
 
 //
 //
@@ -896,6 +908,1416 @@ void test_random_numbers(void) {
     }
 }
 
+//
+//
+//
+void test_utf8_performance(void) {
+    //
+    // Create a 64MB mixed ASCII and multi-byte UTF-8 file
+    //
+    const char *filename   = "/tmp/c_utils_utf8_benchmark.txt";
+    const char line[]      = "Column alignment: \xE4\xBD\xA0\xE5\xA5\xBD, "
+                             "\xE2\x82\xAC 100, \xF0\x9F\x98\x80 ok\n";
+    const usize line_len   = sizeof(line) - 1;
+    const usize file_lines = 64 * 1024 * 1024 / line_len;
+
+    FILE *bench_file = fopen(filename, "w");
+    if (bench_file == NULL) return;
+    for (usize index = 0; index < file_lines; index++) {
+        fwrite(line, line_len, 1, bench_file);
+    }
+    fclose(bench_file);
+
+    defer_file(my_file) = File_open(filename, FM_READ_ONLY);
+    File_load_into_buffer(my_file);
+    String data     = my_file->data;
+    usize data_size = HS_length(data);
+
+    long double start_time = Timer_get_current_time(TU_MILLISECONDS);
+    bool is_valid          = HS_is_valid_utf8(data);
+    long double valid_time =
+        Timer_get_current_time(TU_MILLISECONDS) - start_time;
+
+    start_time       = Timer_get_current_time(TU_MILLISECONDS);
+    usize char_count = HS_utf8_char_count(data);
+    long double count_time =
+        Timer_get_current_time(TU_MILLISECONDS) - start_time;
+
+    //
+    // Byte by byte count for comparison
+    //
+    start_time           = Timer_get_current_time(TU_MILLISECONDS);
+    const char *data_str = HS_as_str(data);
+    usize byte_by_byte   = 0;
+    for (usize index = 0; index < data_size; index++) {
+        if ((data_str[index] & 0xC0) != 0x80) byte_by_byte++;
+    }
+    long double byte_time =
+        Timer_get_current_time(TU_MILLISECONDS) - start_time;
+
+    long double gb = (long double)data_size / (1024 * 1024 * 1024);
+    printf("\n>>> UTF-8 benchmark, file size: %lu bytes", data_size);
+    printf("\n>>> HS_is_valid_utf8: %s, %.2Lf ms, %.2Lf GB/s",
+           is_valid ? "true" : "false",
+           valid_time,
+           gb / (valid_time / 1000));
+    printf("\n>>> HS_utf8_char_count: %lu, %.2Lf ms, %.2Lf GB/s",
+           char_count,
+           count_time,
+           gb / (count_time / 1000));
+    printf("\n>>> byte by byte count: %lu, %.2Lf ms, %.2Lf GB/s\n",
+           byte_by_byte,
+           byte_time,
+           gb / (byte_time / 1000));
+
+    unlink(filename);
+}
+
+//
+//
+//
+void test_hex_performance(void) {
+    const usize data_size = 1024 * 1024;
+    const usize rounds    = 256;
+
+    u8 *data = malloc(data_size);
+    for (usize index = 0; index < data_size; index++) {
+        data[index] = (u8)(index * 131 + 7);
+    }
+    char *hex_str = malloc(data_size * 2 + 1);
+
+    //
+    // Per byte `snprintf` (the old `Hex_to_string` implementation) for
+    // comparison, 1 round is slow enough
+    //
+    long double start_time = Timer_get_current_time(TU_MILLISECONDS);
+    for (usize index = 0; index < data_size; index++) {
+        char hex_value[3] = {0};
+        snprintf(hex_value, 3, "%02X", data[index]);
+        memcpy(hex_str + index * 2, hex_value, 2);
+    }
+    long double snprintf_time =
+        Timer_get_current_time(TU_MILLISECONDS) - start_time;
+
+    start_time = Timer_get_current_time(TU_MILLISECONDS);
+    for (usize round = 0; round < rounds; round++) {
+        Hex_encode(data, data_size, hex_str, (HexEncodeOptions){0});
+    }
+    long double encode_time =
+        Timer_get_current_time(TU_MILLISECONDS) - start_time;
+
+    start_time = Timer_get_current_time(TU_MILLISECONDS);
+    for (usize round = 0; round < rounds; round++) {
+        HexBuffer buffer = Hex_from_bytes_strict(hex_str, data_size * 2);
+        Hex_free(buffer);
+    }
+    long double decode_time =
+        Timer_get_current_time(TU_MILLISECONDS) - start_time;
+
+    long double gb = (long double)data_size / (1024 * 1024 * 1024);
+    printf("\n>>> Hex benchmark, buffer size: %lu bytes, rounds: %lu",
+           data_size,
+           rounds);
+    printf("\n>>> snprintf encode: %.2Lf ms, %.3Lf GB/s",
+           snprintf_time,
+           gb / (snprintf_time / 1000));
+    printf("\n>>> Hex_encode: %.2Lf ms, %.2Lf GB/s",
+           encode_time,
+           gb * rounds / (encode_time / 1000));
+    printf("\n>>> Hex_from_bytes_strict: %.2Lf ms, %.2Lf GB/s\n",
+           decode_time,
+           gb * rounds / (decode_time / 1000));
+
+    free(hex_str);
+    free(data);
+}
+
+//
+// Checksum throughput over a 1MB buffer, compare with the classic
+// byte-at-a-time table `CRC32`
+//
+void test_checksum_performance(void) {
+    const usize data_size = 1024 * 1024;
+    const usize rounds    = 1024;
+
+    u8 *data = malloc(data_size);
+    for (usize index = 0; index < data_size; index++) {
+        data[index] = (u8)(index * 131 + 7);
+    }
+
+    u32 table[256];
+    for (u32 n = 0; n < 256; n++) {
+        u32 crc = n;
+        for (usize bit = 0; bit < 8; bit++) {
+            crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : crc >> 1;
+        }
+        table[n] = crc;
+    }
+
+    long double start_time = Timer_get_current_time(TU_MILLISECONDS);
+    u32 table_crc          = 0;
+    for (usize round = 0; round < rounds / 16; round++) {
+        u32 crc = ~0u;
+        for (usize index = 0; index < data_size; index++) {
+            crc = table[(crc ^ data[index]) & 0xFF] ^ (crc >> 8);
+        }
+        table_crc = ~crc;
+    }
+    long double table_time =
+        Timer_get_current_time(TU_MILLISECONDS) - start_time;
+
+    u32 results[3]                = {0};
+    long double checksum_times[3] = {0};
+    for (usize kind = 0; kind < 3; kind++) {
+        start_time = Timer_get_current_time(TU_MILLISECONDS);
+        for (usize round = 0; round < rounds; round++) {
+            results[kind] = kind == 0   ? Checksum_crc32c(data, data_size)
+                            : kind == 1 ? Checksum_crc32(data, data_size)
+                                        : Checksum_adler32(data, data_size);
+        }
+        checksum_times[kind] =
+            Timer_get_current_time(TU_MILLISECONDS) - start_time;
+    }
+
+    long double gb = (long double)data_size / (1024 * 1024 * 1024);
+    printf("\n>>> Checksum benchmark, buffer size: %lu bytes, rounds: %lu",
+           data_size,
+           rounds);
+    printf("\n>>> Byte table CRC32 (0x%08X): %.3Lf GB/s",
+           table_crc,
+           gb * (rounds / 16) / (table_time / 1000));
+    printf("\n>>> Checksum_crc32c (0x%08X): %.2Lf GB/s",
+           results[0],
+           gb * rounds / (checksum_times[0] / 1000));
+    printf("\n>>> Checksum_crc32 (0x%08X): %.2Lf GB/s",
+           results[1],
+           gb * rounds / (checksum_times[1] / 1000));
+    printf("\n>>> Checksum_adler32 (0x%08X): %.2Lf GB/s\n",
+           results[2],
+           gb * rounds / (checksum_times[2] / 1000));
+
+    free(data);
+}
+
+//
+// Decode a hex capture file chunk by chunk in constant memory
+//
+void test_hex_streaming(void) {
+    const char *hex_filename = "/tmp/c_utils_hex_capture.txt";
+    const char *bin_filename = "/tmp/c_utils_hex_capture.bin";
+
+    //
+    // Create a 64MB hex capture with `HexEncoder`, 32 bytes per line
+    //
+    FILE *hex_file = fopen(hex_filename, "w");
+    if (hex_file == NULL) return;
+
+    HexEncoder encoder;
+    HexEncoder_init(&encoder, (HexEncodeOptions){.separator = ' '});
+    u8 line_bytes[32];
+    char line[HEX_ENCODER_MAX_OUTPUT(sizeof(line_bytes)) + 1];
+    for (usize index = 0; index < 64 * 1024 * 1024 / sizeof(line); index++) {
+        for (usize byte = 0; byte < sizeof(line_bytes); byte++) {
+            line_bytes[byte] = (u8)(index + byte);
+        }
+        usize line_len = HexEncoder_feed(&encoder,
+                                         line_bytes,
+                                         sizeof(line_bytes),
+                                         line);
+        line[line_len++] = '\n';
+        fwrite(line, line_len, 1, hex_file);
+    }
+    fclose(hex_file);
+
+    //
+    // Decode it back with a fixed chunk size. It's odd on purpose, so hex
+    // pairs get split between chunks and the decoder keeps the odd nibble.
+    //
+    long double start_time = Timer_get_current_time(TU_MILLISECONDS);
+
+    defer_file(capture) = File_open(hex_filename, FM_READ_ONLY);
+    FILE *bin_file      = fopen(bin_filename, "w");
+    if (!File_is_open_successfully(capture) || bin_file == NULL) return;
+
+    HexDecoder decoder;
+    HexDecoder_init(&decoder, false);
+
+    char chunk[65536 + 1];
+    u8 out[HEX_DECODER_MAX_OUTPUT(sizeof(chunk))];
+    usize read_size = 0;
+    usize total_out = 0;
+    while ((read_size = fread(chunk, 1, sizeof(chunk), capture->inner)) > 0) {
+        long out_len = HexDecoder_feed(&decoder, chunk, read_size, out);
+        if (out_len < 0) break;
+
+        fwrite(out, out_len, 1, bin_file);
+        total_out += out_len;
+    }
+    fclose(bin_file);
+
+    bool is_valid = HexDecoder_finish(&decoder);
+    long double decode_time =
+        Timer_get_current_time(TU_MILLISECONDS) - start_time;
+
+    printf("\n>>> Hex streaming decode, input: %lu bytes, output: %lu bytes, "
+           "valid: %s, %.2Lf ms\n",
+           File_get_size(capture),
+           total_out,
+           is_valid ? "true" : "false",
+           decode_time);
+
+    unlink(hex_filename);
+    unlink(bin_filename);
+}
+
+/*
+ * Sort `input` into `output` and return the time in milliseconds
+ */
+static long double external_sort_timed(const char *input,
+                                       const char *output,
+                                       ExternalSortOptions options,
+                                       usize *run_count) {
+    long double start_time = Timer_get_current_time(TU_MILLISECONDS);
+    {
+        defer_file(in)              = File_open(input, FM_READ_ONLY);
+        defer_file(out)             = File_open(output, FM_WRITE_ONLY);
+        defer_external_sort(sorter) = ExternalSort_new(options);
+        if (!ExternalSort_sort(sorter, in, out)) {
+            printf("\n>>> ExternalSort_sort failed: %s",
+                   ExternalSort_get_error(sorter));
+        }
+        *run_count = ExternalSort_get_run_count(sorter);
+    }
+
+    return Timer_get_current_time(TU_MILLISECONDS) - start_time;
+}
+
+void test_external_sort_performance(void) {
+    const char *filename        = "/tmp/c_utils_external_sort.log";
+    const char *output_filename = "/tmp/c_utils_external_sort.out";
+    const usize file_size       = 2UL * 1024 * 1024 * 1024;
+    const usize memory_budget   = 256 * 1024 * 1024;
+
+    //
+    // Synthetic log lines (~100 bytes) in random order, the 3rd field is a
+    // random latency
+    //
+    usize written   = 0;
+    usize lines     = 0;
+    u64 seed        = 0x9E3779B97F4A7C15;
+    long double gen = Timer_get_current_time(TU_MILLISECONDS);
+    {
+        defer_file(log) = File_open(filename, FM_WRITE_ONLY);
+        char line[160];
+        while (written < file_size) {
+            seed ^= seed << 13;
+            seed ^= seed >> 7;
+            seed ^= seed << 17;
+            int len = snprintf(line,
+                               sizeof(line),
+                               "user_%016" PRIx64 "\tlogin\t%" PRIu64
+                               "\tregion=eu-west client=web version=1.2.3 "
+                               "status=ok trace=%" PRIu64 "\n",
+                               seed,
+                               seed % 1000003,
+                               seed >> 20);
+            File_append_bytes(log, line, len);
+            written += len;
+            lines++;
+        }
+    }
+    gen = Timer_get_current_time(TU_MILLISECONDS) - gen;
+
+    usize line_runs;
+    long double line_time = external_sort_timed(
+        filename,
+        output_filename,
+        (ExternalSortOptions){.memory_budget = memory_budget},
+        &line_runs);
+
+    usize field_runs;
+    long double field_time =
+        external_sort_timed(filename,
+                            output_filename,
+                            (ExternalSortOptions){
+                                .memory_budget = memory_budget,
+                                .key           = ESK_FIELD,
+                                .field         = 3,
+                                .numeric       = true,
+                            },
+                            &field_runs);
+
+    long double start_time = Timer_get_current_time(TU_MILLISECONDS);
+    char command[256];
+    snprintf(command,
+             sizeof(command),
+             "LC_ALL=C sort -S 256M --parallel=1 -T /tmp -o %s %s",
+             output_filename,
+             filename);
+    int sort_result = system(command);
+    long double sort_time =
+        Timer_get_current_time(TU_MILLISECONDS) - start_time;
+
+    printf("\n>>> External sort benchmark, file size: %lu bytes, lines: %lu, "
+           "memory budget: %lu bytes (generated in %.2Lf ms)",
+           written,
+           lines,
+           memory_budget,
+           gen);
+    printf("\n>>> ExternalSort_sort (whole line, runs: %lu): %.2Lf ms",
+           line_runs,
+           line_time);
+    printf("\n>>> ExternalSort_sort (3rd field numeric, runs: %lu): %.2Lf ms",
+           field_runs,
+           field_time);
+    printf("\n>>> LC_ALL=C sort -S 256M (exit code: %d): %.2Lf ms\n",
+           sort_result,
+           sort_time);
+
+    unlink(filename);
+    unlink(output_filename);
+}
+
+/*
+ * The old way: `fgets` + `snprintf` + `fprintf` per line
+ */
+static void file_print_like_bat_per_line(const char *filename, FILE *out) {
+    FILE *input = fopen(filename, "r");
+    char line[255];
+    char line_no[16];
+    u32 current_line_no = 1;
+    while (fgets(line, sizeof(line) - 9, input) != NULL) {
+        snprintf(line_no, sizeof(line_no), " %5u | ", current_line_no++);
+        fprintf(out, "%s%s", line_no, line);
+    }
+    fclose(input);
+}
+
+void test_file_print_like_bat_performance(void) {
+    const char *filename        = "/tmp/c_utils_file_bat.log";
+    const char *output_filename = "/tmp/c_utils_file_bat.out";
+    const usize line_count      = 4 * 1024 * 1024;
+    {
+        defer_file(log) = File_open(filename, FM_WRITE_ONLY);
+        char line[128];
+        for (usize index = 0; index < line_count; index++) {
+            int len = sprintf(line,
+                              "2024-01-01T00:00:00 INFO request %lu done in "
+                              "%lu us\n",
+                              index,
+                              index % 977);
+            File_append_bytes(log, line, len);
+        }
+    }
+
+    long double start_time = Timer_get_current_time(TU_MILLISECONDS);
+    FILE *out              = fopen(output_filename, "w");
+    file_print_like_bat_per_line(filename, out);
+    fclose(out);
+    long double per_line_time =
+        Timer_get_current_time(TU_MILLISECONDS) - start_time;
+
+    start_time = Timer_get_current_time(TU_MILLISECONDS);
+    int out_fd = open(output_filename, O_WRONLY | O_TRUNC);
+    {
+        defer_file(log) = File_open(filename, FM_READ_ONLY);
+        File_print_like_bat(log, (FilePrintOptions){.out_fd = out_fd});
+    }
+    close(out_fd);
+    long double streaming_time =
+        Timer_get_current_time(TU_MILLISECONDS) - start_time;
+
+    start_time = Timer_get_current_time(TU_MILLISECONDS);
+    out_fd     = open(output_filename, O_WRONLY | O_TRUNC);
+    {
+        defer_file(log) = File_open(filename, FM_READ_ONLY);
+        File_print_like_bat(log,
+                            (FilePrintOptions){
+                                .first_line = line_count - 100,
+                                .last_line  = line_count - 50,
+                                .out_fd     = out_fd,
+                            });
+    }
+    close(out_fd);
+    long double range_time =
+        Timer_get_current_time(TU_MILLISECONDS) - start_time;
+
+    printf("\n>>> Print like bat benchmark, lines: %lu", line_count);
+    printf("\n>>> fgets + snprintf + fprintf per line: %.2Lf ms",
+           per_line_time);
+    printf("\n>>> File_print_like_bat: %.2Lf ms", streaming_time);
+    printf("\n>>> File_print_like_bat (last 100 to 50 lines): %.2Lf ms\n",
+           range_time);
+
+    unlink(filename);
+    unlink(output_filename);
+}
+
+void test_record_log_performance(void) {
+    const char *text_filename = "/tmp/c_utils_record_log.txt";
+    const char *log_folder    = "/tmp/c_utils_record_log";
+    const usize count         = 4 * 1024 * 1024;
+
+    //
+    // Formatting isn't counted, both sides write the same 256 records
+    //
+    char records[256][128];
+    int record_lens[256];
+    for (usize index = 0; index < 256; index++) {
+        record_lens[index] = snprintf(records[index],
+                                      sizeof(records[index]),
+                                      "event=%lu user=user_%lu action=login "
+                                      "latency_us=%lu status=ok region=eu",
+                                      index * 7919,
+                                      index * 13,
+                                      index % 977);
+    }
+
+    //
+    // The usual way: `fprintf` text lines
+    //
+    long double start_time = Timer_get_current_time(TU_MILLISECONDS);
+    FILE *text             = fopen(text_filename, "w");
+    for (usize index = 0; index < count; index++) {
+        fprintf(text, "%s\n", records[index % 256]);
+    }
+    fclose(text);
+    long double fprintf_time =
+        Timer_get_current_time(TU_MILLISECONDS) - start_time;
+
+    start_time = Timer_get_current_time(TU_MILLISECONDS);
+    {
+        defer_record_log(log) =
+            RecordLog_open(log_folder, (RecordLogOptions){0});
+        for (usize index = 0; index < count; index++) {
+            RecordLog_append(log,
+                             records[index % 256],
+                             record_lens[index % 256]);
+        }
+    }
+    long double append_time =
+        Timer_get_current_time(TU_MILLISECONDS) - start_time;
+
+    //
+    // Scan
+    //
+    start_time = Timer_get_current_time(TU_MILLISECONDS);
+    usize line_count = 0;
+    {
+        defer_file(lines) = File_open(text_filename, FM_READ_ONLY);
+        StrView line;
+        while (File_read_line(lines, &line)) line_count++;
+    }
+    long double read_line_time =
+        Timer_get_current_time(TU_MILLISECONDS) - start_time;
+
+    start_time = Timer_get_current_time(TU_MILLISECONDS);
+    usize record_count = 0, record_bytes = 0;
+    {
+        defer_record_log_reader(reader) = RecordLogReader_open(log_folder);
+        StrView record;
+        while (RecordLogReader_next(reader, &record)) {
+            record_count++;
+            record_bytes += record.len;
+        }
+    }
+    long double reader_time =
+        Timer_get_current_time(TU_MILLISECONDS) - start_time;
+
+    printf("\n>>> Record log benchmark, count: %lu", count);
+    printf("\n>>> fprintf lines: %.2Lf ms", fprintf_time);
+    printf("\n>>> RecordLog_append (CRC32C + buffered): %.2Lf ms", append_time);
+    printf("\n>>> File_read_line scan: %.2Lf ms, lines: %lu",
+           read_line_time,
+           line_count);
+    printf("\n>>> RecordLogReader_next scan (CRC32C checked): %.2Lf ms, "
+           "records: %lu, bytes: %lu\n",
+           reader_time,
+           record_count,
+           record_bytes);
+
+    unlink(text_filename);
+    defer_string_table(segments) =
+        Dir_walk(log_folder, (DirWalkOptions){0});
+    for (usize index = 0; index < ST_len(segments); index++) {
+        unlink(ST_get(segments, index).ptr);
+    }
+    rmdir(log_folder);
+}
+
+void test_file_reload_performance(void) {
+    const char *filename = "/tmp/c_utils_file_reload.conf";
+    const usize checks   = 100000;
+    {
+        defer_file(config) = File_open(filename, FM_WRITE_ONLY);
+        char line[64];
+        for (usize index = 0; index < 1024; index++) {
+            usize len = sprintf(line, "key_%lu = value_%lu\n", index, index);
+            File_append_bytes(config, line, len);
+        }
+    }
+
+    //
+    // Polling the usual way: reopen and reload every time
+    //
+    long double start_time = Timer_get_current_time(TU_MILLISECONDS);
+    usize loaded           = 0;
+    for (usize index = 0; index < checks; index++) {
+        defer_file(config) = File_open(filename, FM_READ_ONLY);
+        loaded += File_load_into_buffer(config);
+    }
+    long double reopen_time =
+        Timer_get_current_time(TU_MILLISECONDS) - start_time;
+
+    start_time = Timer_get_current_time(TU_MILLISECONDS);
+    usize reloaded_count = 0;
+    {
+        defer_file(config) = File_open(filename, FM_READ_ONLY);
+        File_load_into_buffer(config);
+        for (usize index = 0; index < checks; index++) {
+            if (File_reload_if_changed(config) == FRR_RELOADED) {
+                reloaded_count++;
+            }
+        }
+    }
+    long double reload_time =
+        Timer_get_current_time(TU_MILLISECONDS) - start_time;
+
+    //
+    // Nothing to do at all until `inotify` reports a change
+    //
+    start_time = Timer_get_current_time(TU_MILLISECONDS);
+    usize event_count = 0;
+    {
+        defer_file_watch(watch) = FileWatch_new();
+        FileWatch_add(watch, filename);
+        FileWatchEvent events[1];
+        for (usize index = 0; index < checks; index++) {
+            event_count += FileWatch_read(watch, 0, events, 1);
+        }
+    }
+    long double watch_time =
+        Timer_get_current_time(TU_MILLISECONDS) - start_time;
+
+    printf("\n>>> Config reload benchmark, checks: %lu", checks);
+    printf("\n>>> File_open + File_load_into_buffer: %.2Lf ms, loaded: %lu",
+           reopen_time,
+           loaded);
+    printf("\n>>> File_reload_if_changed: %.2Lf ms, reloaded: %lu",
+           reload_time,
+           reloaded_count);
+    printf("\n>>> FileWatch_read (no wait): %.2Lf ms, events: %lu\n",
+           watch_time,
+           event_count);
+
+    unlink(filename);
+}
+
+/*
+ * The usual byte by byte state machine, count the fields
+ */
+static usize csv_bytewise_field_count(const char *ptr, usize len) {
+    usize fields = 0;
+    bool quoted  = false;
+    for (usize index = 0; index < len; index++) {
+        char c = ptr[index];
+        if (c == '"') {
+            quoted = !quoted;
+        } else if (!quoted && (c == ',' || c == '\n')) {
+            fields++;
+        }
+    }
+
+    return fields;
+}
+
+static usize csv_reader_field_count(CsvReader csv) {
+    usize fields = 0;
+    CsvChunk chunk;
+    while (Csv_read_chunk(csv, &chunk)) {
+        for (usize row = 0; row < chunk.row_count; row++) {
+            fields += chunk.rows[row].field_count;
+        }
+    }
+
+    return fields;
+}
+
+void test_csv_performance(void) {
+    const usize row_count = 4 * 1024 * 1024;
+    char *csv_data        = malloc(row_count * 80);
+    char *tsv_data        = malloc(row_count * 80);
+    usize csv_len = 0, tsv_len = 0;
+    for (usize row = 0; row < row_count; row++) {
+        csv_len += sprintf(csv_data + csv_len,
+                           "%lu,user_%lu,\"%lu, Main St\",%lu.%02lu,%s\n",
+                           row,
+                           row * 7,
+                           row % 1000,
+                           row % 10000,
+                           row % 100,
+                           row % 3 == 0 ? "\"said \"\"hi\"\"\"" : "ok");
+        tsv_len += sprintf(tsv_data + tsv_len,
+                           "%lu\tuser_%lu\t%lu Main St\t%lu.%02lu\tok\n",
+                           row,
+                           row * 7,
+                           row % 1000,
+                           row % 10000,
+                           row % 100);
+    }
+
+    long double start_time = Timer_get_current_time(TU_MILLISECONDS);
+    usize bytewise_fields  = csv_bytewise_field_count(csv_data, csv_len);
+    long double bytewise_time =
+        Timer_get_current_time(TU_MILLISECONDS) - start_time;
+
+    start_time = Timer_get_current_time(TU_MILLISECONDS);
+    usize csv_fields;
+    {
+        defer_csv_reader(csv) =
+            Csv_from_memory(csv_data, csv_len, (CsvOptions){0});
+        csv_fields = csv_reader_field_count(csv);
+    }
+    long double csv_time = Timer_get_current_time(TU_MILLISECONDS) - start_time;
+
+    start_time = Timer_get_current_time(TU_MILLISECONDS);
+    usize tsv_fields;
+    {
+        defer_csv_reader(tsv) = Csv_from_memory(
+            tsv_data,
+            tsv_len,
+            (CsvOptions){.delimiter = '\t', .no_quotes = true});
+        tsv_fields = csv_reader_field_count(tsv);
+    }
+    long double tsv_time = Timer_get_current_time(TU_MILLISECONDS) - start_time;
+
+    start_time = Timer_get_current_time(TU_MILLISECONDS);
+    usize parallel_fields;
+    {
+        defer_csv_reader(tsv) = Csv_from_memory(tsv_data,
+                                                tsv_len,
+                                                (CsvOptions){
+                                                    .delimiter = '\t',
+                                                    .no_quotes = true,
+                                                    .parallel  = true,
+                                                });
+        parallel_fields = csv_reader_field_count(tsv);
+    }
+    long double parallel_time =
+        Timer_get_current_time(TU_MILLISECONDS) - start_time;
+
+    printf("\n>>> CSV benchmark, rows: %lu, CSV size: %lu, TSV size: %lu",
+           row_count,
+           csv_len,
+           tsv_len);
+    printf("\n>>> Bytewise field count (no views): %.2Lf ms, fields: %lu",
+           bytewise_time,
+           bytewise_fields);
+    printf("\n>>> Csv_read_chunk (CSV): %.2Lf ms, fields: %lu",
+           csv_time,
+           csv_fields);
+    printf("\n>>> Csv_read_chunk (TSV, no quotes): %.2Lf ms, fields: %lu",
+           tsv_time,
+           tsv_fields);
+    printf("\n>>> Csv_read_chunk (TSV, parallel): %.2Lf ms, fields: %lu\n",
+           parallel_time,
+           parallel_fields);
+
+    free(csv_data);
+    free(tsv_data);
+}
+
+/*
+ * Fork a child that writes `size` bytes into a pipe, return the read end
+ */
+static int file_load_pipe_writer(usize size) {
+    int pipe_fds[2];
+    if (pipe(pipe_fds) != 0) return -1;
+
+    if (fork() == 0) {
+        close(pipe_fds[0]);
+        char chunk[64 * 1024];
+        memset(chunk, 'x', sizeof(chunk));
+        for (usize written = 0; written < size; written += sizeof(chunk)) {
+            if (write(pipe_fds[1], chunk, sizeof(chunk)) < 0) _exit(1);
+        }
+        _exit(0);
+    }
+    close(pipe_fds[1]);
+
+    return pipe_fds[0];
+}
+
+void test_file_load_pipe_performance(void) {
+    const usize size = 1024 * 1024 * 1024;
+
+    //
+    // `fread` into a growing buffer, how it's usually done for stdin
+    //
+    int fd                 = file_load_pipe_writer(size);
+    long double start_time = Timer_get_current_time(TU_MILLISECONDS);
+    FILE *input            = fdopen(fd, "r");
+    usize capacity = 4096, len = 0;
+    char *buffer = malloc(capacity);
+    for (;;) {
+        if (len == capacity) {
+            capacity *= 2;
+            buffer = realloc(buffer, capacity);
+        }
+        usize read_size = fread(buffer + len, 1, capacity - len, input);
+        if (read_size == 0) break;
+        len += read_size;
+    }
+    fclose(input);
+    free(buffer);
+    long double fread_time =
+        Timer_get_current_time(TU_MILLISECONDS) - start_time;
+    wait(NULL);
+
+    fd         = file_load_pipe_writer(size);
+    start_time = Timer_get_current_time(TU_MILLISECONDS);
+    usize loaded;
+    {
+        defer_file(pipe_file) = File_from_fd(fd, "pipe", FM_READ_ONLY);
+        loaded                = File_load_into_buffer(pipe_file);
+    }
+    long double load_time =
+        Timer_get_current_time(TU_MILLISECONDS) - start_time;
+    wait(NULL);
+
+    printf("\n>>> Pipe loading benchmark, size: %lu", size);
+    printf("\n>>> fread + realloc: %.2Lf ms, len: %lu", fread_time, len);
+    printf("\n>>> File_from_fd + File_load_into_buffer: %.2Lf ms, len: %lu\n",
+           load_time,
+           loaded);
+}
+
+void test_file_copy_performance(void) {
+    const char *src_filename = "/tmp/c_utils_file_copy.bin";
+    const char *dst_filename = "/tmp/c_utils_file_copy.bin.dst";
+    const usize file_size    = 2UL * 1024 * 1024 * 1024;
+
+    {
+        defer_file(src) = File_open(src_filename, FM_WRITE_ONLY);
+        char chunk[64 * 1024];
+        for (usize index = 0; index < sizeof(chunk); index++) {
+            chunk[index] = (char)(index * 7);
+        }
+        for (usize written = 0; written < file_size;
+             written += sizeof(chunk)) {
+            File_append_bytes(src, chunk, sizeof(chunk));
+        }
+    }
+
+    const char *names[] = {
+        "File_load_into_buffer + write",
+        "File_copy (read/write)",
+        "File_copy (no clone)",
+        "File_copy",
+        "File_send_to_fd",
+    };
+    long double times[5]      = {0};
+    FileCopyMethod methods[5] = {0};
+
+    defer_file(src) = File_open(src_filename, FM_READ_ONLY);
+    for (usize kind = 0; kind < 5; kind++) {
+        unlink(dst_filename);
+        long double start_time = Timer_get_current_time(TU_MILLISECONDS);
+
+        if (kind == 0) {
+            //
+            // The old way: load the whole file, then write it out
+            //
+            File_load_into_buffer(src);
+            int out_fd =
+                open(dst_filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            const char *data = File_get_data(src);
+            for (usize offset = 0; offset < File_get_size(src);) {
+                ssize_t written =
+                    write(out_fd, data + offset, File_get_size(src) - offset);
+                if (written <= 0) break;
+                offset += written;
+            }
+            close(out_fd);
+            HS_free(src->data);
+            src->data  = NULL;
+            methods[0] = FCM_READ_WRITE;
+        } else if (kind == 4) {
+            int out_fd =
+                open(dst_filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            methods[4] = File_send_to_fd(src, out_fd);
+            close(out_fd);
+        } else {
+            methods[kind] = File_copy(
+                src,
+                dst_filename,
+                (FileCopyOptions){.no_clone       = kind == 2,
+                                  .no_kernel_copy = kind == 1});
+        }
+
+        times[kind] = Timer_get_current_time(TU_MILLISECONDS) - start_time;
+    }
+
+    printf("\n>>> Copy benchmark, file size: %lu", file_size);
+    for (usize kind = 0; kind < 5; kind++) {
+        printf("\n>>> %s: %.2Lf ms, %.2Lf GB/s, method: %d",
+               names[kind],
+               times[kind],
+               file_size / (times[kind] / 1000.0L) / 1024 / 1024 / 1024,
+               methods[kind]);
+    }
+    printf("\n");
+
+    unlink(dst_filename);
+    unlink(src_filename);
+}
+
+//
+// `opendir` + `readdir` + `stat` per entry, the classic way
+//
+static usize dir_walk_readdir_stat(const char *folder) {
+    DIR *dir = opendir(folder);
+    if (dir == NULL) return 0;
+
+    usize count = 0;
+    char path[512];
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (strcmp(entry->d_name, ".") == 0 ||
+            strcmp(entry->d_name, "..") == 0) {
+            continue;
+        }
+
+        struct stat entry_stat;
+        snprintf(path, sizeof(path), "%s/%s", folder, entry->d_name);
+        if (lstat(path, &entry_stat) != 0) continue;
+
+        if (S_ISDIR(entry_stat.st_mode)) {
+            count += dir_walk_readdir_stat(path);
+        } else {
+            count++;
+        }
+    }
+    closedir(dir);
+
+    return count;
+}
+
+void test_dir_walk_performance(void) {
+    char root[] = "/tmp/c_utils_dir_walk_XXXXXX";
+    if (mkdtemp(root) == NULL) return;
+
+    //
+    // 200 folders * 250 files, 2 levels
+    //
+    char path[256];
+    for (usize folder = 0; folder < 200; folder++) {
+        snprintf(path, sizeof(path), "%s/%lu", root, folder / 20);
+        mkdir(path, 0755);
+        snprintf(path, sizeof(path), "%s/%lu/%lu", root, folder / 20, folder);
+        mkdir(path, 0755);
+        for (usize file = 0; file < 250; file++) {
+            snprintf(path,
+                     sizeof(path),
+                     "%s/%lu/%lu/file_%lu.conf",
+                     root,
+                     folder / 20,
+                     folder,
+                     file);
+            close(open(path, O_WRONLY | O_CREAT, 0644));
+        }
+    }
+
+    long double start_time = Timer_get_current_time(TU_MILLISECONDS);
+    usize readdir_count    = dir_walk_readdir_stat(root);
+    long double readdir_time =
+        Timer_get_current_time(TU_MILLISECONDS) - start_time;
+
+    start_time = Timer_get_current_time(TU_MILLISECONDS);
+    char command[256];
+    snprintf(command, sizeof(command), "find %s -type f | wc -l", root);
+    FILE *find = popen(command, "r");
+    usize find_count = 0;
+    if (find != NULL) {
+        if (fscanf(find, "%lu", &find_count) != 1) find_count = 0;
+        pclose(find);
+    }
+    long double find_time =
+        Timer_get_current_time(TU_MILLISECONDS) - start_time;
+
+    start_time = Timer_get_current_time(TU_MILLISECONDS);
+    StringTable paths = Dir_walk(root, (DirWalkOptions){0});
+    long double walk_time =
+        Timer_get_current_time(TU_MILLISECONDS) - start_time;
+    usize walk_count = ST_len(paths);
+    ST_free(paths);
+
+    start_time = Timer_get_current_time(TU_MILLISECONDS);
+    paths      = Dir_walk(root, (DirWalkOptions){.pattern = "*.conf"});
+    long double pattern_time =
+        Timer_get_current_time(TU_MILLISECONDS) - start_time;
+    ST_free(paths);
+
+    start_time = Timer_get_current_time(TU_MILLISECONDS);
+    paths = Dir_walk(root, (DirWalkOptions){.parallel = true, .threads = 4});
+    long double parallel_time =
+        Timer_get_current_time(TU_MILLISECONDS) - start_time;
+    ST_free(paths);
+
+    printf("\n>>> Dir walk benchmark, files: %lu", walk_count);
+    printf("\n>>> readdir + stat: %.2Lf ms, files: %lu",
+           readdir_time,
+           readdir_count);
+    printf("\n>>> find | wc -l: %.2Lf ms, files: %lu", find_time, find_count);
+    printf("\n>>> Dir_walk: %.2Lf ms", walk_time);
+    printf("\n>>> Dir_walk (*.conf): %.2Lf ms", pattern_time);
+    printf("\n>>> Dir_walk (4 threads): %.2Lf ms\n", parallel_time);
+
+    snprintf(command, sizeof(command), "rm -rf %s", root);
+    if (system(command) != 0) printf("\n>>> Failed to remove: %s", root);
+}
+
+void test_file_load_many_performance(void) {
+    const usize count = 20000;
+    char folder[]     = "/tmp/c_utils_load_many_XXXXXX";
+    if (mkdtemp(folder) == NULL) return;
+
+    //
+    // Small config-like files, 100 ~ 4000 bytes
+    //
+    char **paths  = malloc(count * sizeof(char *));
+    char line[64] = "key = value, some more text to make the line longer\n";
+    for (usize index = 0; index < count; index++) {
+        paths[index] = malloc(sizeof(folder) + 32);
+        sprintf(paths[index], "%s/file_%lu.conf", folder, index);
+
+        FILE *file = fopen(paths[index], "w");
+        for (usize lines = 0; lines < 2 + index % 76; lines++) {
+            fputs(line, file);
+        }
+        fclose(file);
+    }
+
+    //
+    // `File_open` + `File_load_into_buffer` one by one
+    //
+    long double start_time = Timer_get_current_time(TU_MILLISECONDS);
+    usize total_bytes      = 0;
+    for (usize index = 0; index < count; index++) {
+        defer_file(file) = File_open(paths[index], FM_READ_ONLY);
+        File_load_into_buffer(file);
+        total_bytes += File_get_size(file);
+    }
+    long double one_by_one_time =
+        Timer_get_current_time(TU_MILLISECONDS) - start_time;
+
+    FileLoadManyStats io_uring_stats;
+    Vector files = File_load_many((const char **)paths,
+                                  count,
+                                  (FileLoadManyOptions){0},
+                                  &io_uring_stats);
+    Vec_free(files);
+
+    FileLoadManyStats thread_pool_stats;
+    files = File_load_many((const char **)paths,
+                           count,
+                           (FileLoadManyOptions){.no_io_uring = true},
+                           &thread_pool_stats);
+    Vec_free(files);
+
+    FileLoadManyStats single_thread_stats;
+    files = File_load_many(
+        (const char **)paths,
+        count,
+        (FileLoadManyOptions){.no_io_uring = true, .threads = 1},
+        &single_thread_stats);
+    Vec_free(files);
+
+    printf("\n>>> Load many benchmark, files: %lu, total bytes: %lu",
+           count,
+           total_bytes);
+    printf("\n>>> File_open + File_load_into_buffer: %.2Lf ms",
+           one_by_one_time);
+    printf("\n>>> File_load_many (io_uring used: %d): %.2Lf ms, loaded: %lu",
+           io_uring_stats.io_uring_used,
+           io_uring_stats.elapsed_ms,
+           io_uring_stats.loaded);
+    printf("\n>>> File_load_many (thread pool): %.2Lf ms, loaded: %lu",
+           thread_pool_stats.elapsed_ms,
+           thread_pool_stats.loaded);
+    printf("\n>>> File_load_many (1 thread): %.2Lf ms, loaded: %lu\n",
+           single_thread_stats.elapsed_ms,
+           single_thread_stats.loaded);
+
+    for (usize index = 0; index < count; index++) {
+        unlink(paths[index]);
+        free(paths[index]);
+    }
+    free(paths);
+    rmdir(folder);
+}
+
+//
+// Write 4M log lines with `fputs`, `fputs` + `fflush` (every line hits the
+// file) and `File_append`
+//
+void test_file_append_performance(void) {
+    const char *filename = "/tmp/c_utils_file_append.log";
+    const usize lines    = 4 * 1024 * 1024;
+    const char *line =
+        "2024-01-01 00:00:00 [INFO] request id: 1234567, status: 200\n";
+
+    long double times[4] = {0};
+    for (usize kind = 0; kind < 4; kind++) {
+        long double start_time = Timer_get_current_time(TU_MILLISECONDS);
+
+        if (kind < 2) {
+            FILE *file = fopen(filename, "w");
+            if (file == NULL) return;
+            for (usize index = 0; index < lines; index++) {
+                fputs(line, file);
+                if (kind == 1) fflush(file);
+            }
+            fclose(file);
+        } else {
+            //
+            // `kind == 3`: `fdatasync` every 64MB
+            //
+            defer_file(log) = File_open(filename, FM_WRITE_ONLY);
+            File_set_write_options(
+                log,
+                (FileWriteOptions){
+                    .sync = kind == 3 ? FS_EVERY_N_BYTES : FS_NONE,
+                    .sync_every_bytes = 64 * 1024 * 1024});
+            for (usize index = 0; index < lines; index++) {
+                File_append(log, line);
+            }
+        }
+
+        times[kind] = Timer_get_current_time(TU_MILLISECONDS) - start_time;
+    }
+
+    printf("\n>>> Append benchmark, lines: %lu, file size: %lu bytes",
+           lines,
+           lines * strlen(line));
+    printf("\n>>> fputs: %.2Lf ms", times[0]);
+    printf("\n>>> fputs + fflush: %.2Lf ms", times[1]);
+    printf("\n>>> File_append: %.2Lf ms", times[2]);
+    printf("\n>>> File_append (fdatasync every 64MB): %.2Lf ms\n", times[3]);
+
+    unlink(filename);
+}
+
+//
+// Count lines of a 512MB log with `File_read_line`, `fgets` and `wc -l`
+//
+void test_file_read_line_performance(void) {
+    const char *filename  = "/tmp/c_utils_file_lines.log";
+    const usize file_size = 512 * 1024 * 1024;
+
+    FILE *file = fopen(filename, "w");
+    if (file == NULL) return;
+
+    char line[128];
+    usize written = 0;
+    for (usize index = 0; written < file_size; index++) {
+        int line_len = snprintf(line,
+                                sizeof(line),
+                                "2024-01-01 00:00:%02lu [INFO] request id: "
+                                "%lu, status: 200, elapsed: %lu ms\n",
+                                index % 60,
+                                index,
+                                index % 1000);
+        fwrite(line, line_len, 1, file);
+        written += line_len;
+    }
+    fclose(file);
+
+    long double start_time = Timer_get_current_time(TU_MILLISECONDS);
+    usize line_count       = 0;
+    usize total_len        = 0;
+    {
+        defer_file(log) = File_open(filename, FM_READ_ONLY);
+        File_lines(log, 1024 * 1024);
+
+        StrView view;
+        while (File_read_line(log, &view)) {
+            line_count++;
+            total_len += view.len;
+        }
+    }
+    long double read_line_time =
+        Timer_get_current_time(TU_MILLISECONDS) - start_time;
+
+    start_time             = Timer_get_current_time(TU_MILLISECONDS);
+    usize fgets_line_count = 0;
+    FILE *fgets_file       = fopen(filename, "r");
+    while (fgets(line, sizeof(line), fgets_file) != NULL) {
+        fgets_line_count++;
+    }
+    fclose(fgets_file);
+    long double fgets_time =
+        Timer_get_current_time(TU_MILLISECONDS) - start_time;
+
+    start_time = Timer_get_current_time(TU_MILLISECONDS);
+    char command[128];
+    snprintf(command, sizeof(command), "wc -l < %s > /dev/null", filename);
+    int wc_result       = system(command);
+    long double wc_time = Timer_get_current_time(TU_MILLISECONDS) - start_time;
+
+    long double gb = (long double)written / (1024 * 1024 * 1024);
+    printf("\n>>> Line reader benchmark, file size: %lu bytes, lines: %lu, "
+           "line bytes: %lu (page cache hot)",
+           written,
+           line_count,
+           total_len);
+    printf("\n>>> File_read_line: %.2Lf GB/s", gb / (read_line_time / 1000));
+    printf("\n>>> fgets (lines: %lu): %.2Lf GB/s",
+           fgets_line_count,
+           gb / (fgets_time / 1000));
+    printf("\n>>> wc -l (exit code: %d): %.2Lf GB/s\n",
+           wc_result,
+           gb / (wc_time / 1000));
+
+    unlink(filename);
+}
+
+//
+// `File_load_into_buffer` vs `File_map` on a 256MB file
+//
+void test_file_map_performance(void) {
+    const char *filename  = "/tmp/c_utils_file_map.bin";
+    const usize file_size = 256 * 1024 * 1024;
+
+    FILE *file = fopen(filename, "w");
+    if (file == NULL) return;
+
+    char block[65536];
+    for (usize index = 0; index < sizeof(block); index++) {
+        block[index] = (char)('a' + index % 26);
+    }
+    for (usize written = 0; written < file_size; written += sizeof(block)) {
+        fwrite(block, sizeof(block), 1, file);
+    }
+    fclose(file);
+
+    //
+    // Both versions sum up 1 byte per page, so every page gets touched
+    //
+    long double start_time = Timer_get_current_time(TU_MILLISECONDS);
+    usize load_sum         = 0;
+    {
+        defer_file(loaded) = File_open(filename, FM_READ_ONLY);
+        File_load_into_buffer(loaded);
+        const char *data = File_get_data(loaded);
+        for (usize index = 0; index < File_get_size(loaded); index += 4096) {
+            load_sum += (u8)data[index];
+        }
+    }
+    long double load_time =
+        Timer_get_current_time(TU_MILLISECONDS) - start_time;
+
+    start_time                = Timer_get_current_time(TU_MILLISECONDS);
+    usize map_sum             = 0;
+    long double map_only_time = 0;
+    {
+        defer_file(mapped) = File_open(filename, FM_READ_ONLY);
+        File_map(mapped, (FileMapOptions){.sequential = true});
+        map_only_time = Timer_get_current_time(TU_MILLISECONDS) - start_time;
+
+        StrView view = File_as_view(mapped);
+        for (usize index = 0; index < view.len; index += 4096) {
+            map_sum += (u8)view.ptr[index];
+        }
+    }
+    long double map_time = Timer_get_current_time(TU_MILLISECONDS) - start_time;
+
+    printf("\n>>> File load vs map, file size: %lu bytes (page cache hot)",
+           file_size);
+    printf("\n>>> File_load_into_buffer + touch all pages: %.2Lf ms",
+           load_time);
+    printf("\n>>> File_map: %.3Lf ms, + touch all pages: %.2Lf ms (same "
+           "result: %s)\n",
+           map_only_time,
+           map_time,
+           load_sum == map_sum ? "true" : "false");
+
+    unlink(filename);
+}
+
+//
+// `HexBuffer` bytewise operations vs walking `Hex_iter` byte by byte
+//
+void test_hex_bytewise_performance(void) {
+    const usize data_size = 64 * 1024 * 1024;
+    const usize rounds    = 8;
+
+    HexBuffer a   = Hex_with_length(data_size);
+    HexBuffer b   = Hex_with_length(data_size);
+    HexBuffer key = Hex_with_length(data_size);
+    if (a == NULL || b == NULL || key == NULL) return;
+
+    HexBufferIteractor a_iter   = Hex_iter(a);
+    HexBufferIteractor b_iter   = Hex_iter(b);
+    HexBufferIteractor key_iter = Hex_iter(key);
+    for (usize index = 0; index < data_size; index++) {
+        a_iter.arr[index]   = (u8)(index * 131 + 7) % 0xF0;
+        b_iter.arr[index]   = a_iter.arr[index];
+        key_iter.arr[index] = (u8)(index * 61 + 1);
+    }
+    const u8 magic[] = {0xFA, 0xCE, 0xB0, 0x0C};
+    memcpy(a_iter.arr + data_size - sizeof(magic), magic, sizeof(magic));
+
+    const char *names[] = {"Hex_equals",
+                           "Hex_xor_into",
+                           "Hex_find",
+                           "Hex_count_byte",
+                           "Hex_popcount"};
+    long double loop_times[5] = {0};
+    long double simd_times[5] = {0};
+    usize loop_results[5]     = {0};
+    usize simd_results[5]     = {0};
+
+    for (usize kind = 0; kind < 5; kind++) {
+        long double start_time = Timer_get_current_time(TU_MILLISECONDS);
+        for (usize round = 0; round < rounds; round++) {
+            usize result = 0;
+            if (kind == 0) {
+                result = 1;
+                for (usize index = 0; index < a_iter.length; index++) {
+                    if (a_iter.arr[index] != b_iter.arr[index]) {
+                        result = 0;
+                        break;
+                    }
+                }
+            } else if (kind == 1) {
+                for (usize index = 0; index < a_iter.length; index++) {
+                    b_iter.arr[index] ^= key_iter.arr[index];
+                }
+                result = b_iter.arr[data_size - 1];
+            } else if (kind == 2) {
+                result = -1;
+                for (usize index = 0; index + sizeof(magic) <= a_iter.length;
+                     index++) {
+                    if (memcmp(a_iter.arr + index, magic, sizeof(magic)) ==
+                        0) {
+                        result = index;
+                        break;
+                    }
+                }
+            } else if (kind == 3) {
+                for (usize index = 0; index < a_iter.length; index++) {
+                    result += a_iter.arr[index] == 0x2A;
+                }
+            } else {
+                for (usize index = 0; index < a_iter.length; index++) {
+                    result += __builtin_popcount(a_iter.arr[index]);
+                }
+            }
+            loop_results[kind] = result;
+        }
+        loop_times[kind] = Timer_get_current_time(TU_MILLISECONDS) - start_time;
+
+        start_time = Timer_get_current_time(TU_MILLISECONDS);
+        for (usize round = 0; round < rounds; round++) {
+            simd_results[kind] =
+                kind == 0   ? (usize)Hex_equals(a, b)
+                : kind == 1 ? (Hex_xor_into(b, key), b_iter.arr[data_size - 1])
+                : kind == 2 ? (usize)Hex_find(a, magic, sizeof(magic))
+                : kind == 3 ? Hex_count_byte(a, 0x2A)
+                            : Hex_popcount(a);
+        }
+        simd_times[kind] = Timer_get_current_time(TU_MILLISECONDS) - start_time;
+    }
+
+    long double gb = (long double)data_size / (1024 * 1024 * 1024);
+    printf("\n>>> HexBuffer bytewise benchmark, buffer size: %lu bytes, "
+           "rounds: %lu",
+           data_size,
+           rounds);
+    for (usize kind = 0; kind < 5; kind++) {
+        printf("\n>>> %-16s (same result: %s): Hex_iter loop: %6.2Lf GB/s, "
+               "SIMD: %6.2Lf GB/s",
+               names[kind],
+               loop_results[kind] == simd_results[kind] ? "true" : "false",
+               gb * rounds / (loop_times[kind] / 1000),
+               gb * rounds / (simd_times[kind] / 1000));
+    }
+    printf("\n");
+
+    Hex_free(key);
+    Hex_free(b);
+    Hex_free(a);
+}
+
+//
+// Base64 encode/decode throughput vs the plain lookup table version
+//
+void test_base64_performance(void) {
+    const usize data_size = 1024 * 1024;
+    const usize rounds    = 256;
+
+    u8 *data = malloc(data_size);
+    for (usize index = 0; index < data_size; index++) {
+        data[index] = (u8)(index * 131 + 7);
+    }
+    Base64Options options = {0};
+    usize encoded_len     = Base64_encoded_length(data_size, options);
+    char *encoded         = malloc(encoded_len);
+    u8 *decoded           = malloc(BASE64_DECODED_MAX_LENGTH(encoded_len));
+
+    const char *alphabet =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    long double start_time = Timer_get_current_time(TU_MILLISECONDS);
+    for (usize round = 0; round < rounds; round++) {
+        char *out = encoded;
+        for (usize index = 0; index + 3 <= data_size; index += 3) {
+            u32 block = (u32)data[index] << 16 | (u32)data[index + 1] << 8 |
+                        data[index + 2];
+            *out++ = alphabet[block >> 18];
+            *out++ = alphabet[(block >> 12) & 0x3F];
+            *out++ = alphabet[(block >> 6) & 0x3F];
+            *out++ = alphabet[block & 0x3F];
+        }
+    }
+    long double table_time =
+        Timer_get_current_time(TU_MILLISECONDS) - start_time;
+
+    start_time = Timer_get_current_time(TU_MILLISECONDS);
+    for (usize round = 0; round < rounds; round++) {
+        Base64_encode(data, data_size, encoded, options);
+    }
+    long double encode_time =
+        Timer_get_current_time(TU_MILLISECONDS) - start_time;
+
+    long decoded_len = 0;
+    start_time       = Timer_get_current_time(TU_MILLISECONDS);
+    for (usize round = 0; round < rounds; round++) {
+        decoded_len = Base64_decode(encoded, encoded_len, decoded, options);
+    }
+    long double decode_time =
+        Timer_get_current_time(TU_MILLISECONDS) - start_time;
+
+    long double gb = (long double)data_size / (1024 * 1024 * 1024);
+    printf("\n>>> Base64 benchmark, buffer size: %lu bytes, rounds: %lu",
+           data_size,
+           rounds);
+    printf("\n>>> Lookup table encode: %.2Lf GB/s",
+           gb * rounds / (table_time / 1000));
+    printf("\n>>> Base64_encode: %.2Lf GB/s",
+           gb * rounds / (encode_time / 1000));
+    printf("\n>>> Base64_decode (valid: %s): %.2Lf GB/s\n",
+           decoded_len == (long)data_size &&
+                   memcmp(decoded, data, data_size) == 0
+               ? "true"
+               : "false",
+           gb * rounds / (decode_time / 1000));
+
+    free(decoded);
+    free(encoded);
+    free(data);
+}
+
 //
 //
 //
@@ -943,6 +2365,24 @@ int main(void) {
     /* test_bits(); */
 
     /* test_random_numbers(); */
+    /* test_utf8_performance(); */
+    /* test_hex_performance(); */
+    /* test_hex_streaming(); */
+    /* test_checksum_performance(); */
+    /* test_base64_performance(); */
+    /* test_hex_bytewise_performance(); */
+    /* test_file_map_performance(); */
+    /* test_file_read_line_performance(); */
+    /* test_file_append_performance(); */
+    /* test_file_load_many_performance(); */
+    /* test_dir_walk_performance(); */
+    /* test_file_copy_performance(); */
+    /* test_file_load_pipe_performance(); */
+    /* test_csv_performance(); */
+    /* test_file_reload_performance(); */
+    /* test_record_log_performance(); */
+    /* test_file_print_like_bat_performance(); */
+    /* test_external_sort_performance(); */
 
     return 0;
 }
@@ -0,0 +1,72 @@
+#include "./arena_test.h"
+
+#include <string.h>
+#include <unity.h>
+
+#include "../../utils/arena.h"
+
+void test_arena_alloc(void) {
+    defer_arena(arena) = Arena_new(64);
+    TEST_ASSERT_EQUAL_UINT(Arena_used(arena), 0);
+    TEST_ASSERT_EQUAL_UINT(Arena_capacity(arena), 0);
+
+    u8 *a = Arena_alloc(arena, 10);
+    u8 *b = Arena_alloc(arena, 20);
+    TEST_ASSERT_NOT_NULL(a);
+    TEST_ASSERT_NOT_NULL(b);
+    TEST_ASSERT_EQUAL_UINT((usize)a % ARENA_ALIGNMENT, 0);
+    TEST_ASSERT_EQUAL_UINT((usize)b % ARENA_ALIGNMENT, 0);
+    TEST_ASSERT_EQUAL_UINT(Arena_used(arena), 16 + 32);
+    TEST_ASSERT_EQUAL_UINT(Arena_capacity(arena), 64);
+
+    // Bigger than the chunk size gets its own chunk
+    u8 *c = Arena_alloc(arena, 100);
+    memset(c, 0xAB, 100);
+    TEST_ASSERT_EQUAL_UINT(Arena_used(arena), 16 + 32 + 112);
+    TEST_ASSERT_EQUAL_UINT(Arena_capacity(arena), 64 + 112);
+
+    TEST_ASSERT_NULL(Arena_alloc(NULL, 10));
+}
+
+void test_arena_realloc(void) {
+    defer_arena(arena) = Arena_new(256);
+
+    // The latest allocation grows in-place
+    char *a = Arena_alloc(arena, 4);
+    memcpy(a, "abcd", 4);
+    char *a_grow = Arena_realloc(arena, a, 4, 100);
+    TEST_ASSERT_EQUAL_PTR(a, a_grow);
+    TEST_ASSERT_EQUAL_UINT(Arena_used(arena), 112);
+
+    // Not the latest one, copy to the new block
+    char *b       = Arena_alloc(arena, 16);
+    char *a_moved = Arena_realloc(arena, a, 100, 120);
+    TEST_ASSERT_NOT_NULL(b);
+    TEST_ASSERT_TRUE(a_moved != a);
+    TEST_ASSERT_EQUAL_MEMORY(a_moved, "abcd", 4);
+
+    // `NULL` works like `Arena_alloc`
+    TEST_ASSERT_NOT_NULL(Arena_realloc(arena, NULL, 0, 8));
+}
+
+void test_arena_reset(void) {
+    defer_arena(arena) = Arena_new(64);
+    for (usize index = 0; index < 10; index++) {
+        TEST_ASSERT_NOT_NULL(Arena_alloc(arena, 48));
+    }
+    TEST_ASSERT_EQUAL_UINT(Arena_used(arena), 480);
+    TEST_ASSERT_EQUAL_UINT(Arena_capacity(arena), 640);
+
+    // All chunks are merged into one
+    Arena_reset(arena);
+    TEST_ASSERT_EQUAL_UINT(Arena_used(arena), 0);
+    TEST_ASSERT_EQUAL_UINT(Arena_capacity(arena), 640);
+
+    for (usize index = 0; index < 10; index++) {
+        TEST_ASSERT_NOT_NULL(Arena_alloc(arena, 48));
+    }
+    TEST_ASSERT_EQUAL_UINT(Arena_capacity(arena), 640);
+
+    Arena_reset(arena);
+    TEST_ASSERT_EQUAL_UINT(Arena_used(arena), 0);
+}
@@ -0,0 +1,8 @@
+#ifndef __ARENA_TEST_H__
+#define __ARENA_TEST_H__
+
+void test_arena_alloc(void);
+void test_arena_realloc(void);
+void test_arena_reset(void);
+
+#endif
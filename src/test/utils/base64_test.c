@@ -0,0 +1,247 @@
+#include "./base64_test.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <unity.h>
+
+#include "../../utils/base64.h"
+
+static const char *RFC4648_INPUTS[] = {"f", "fo", "foo", "foob", "fooba",
+                                       "foobar"};
+static const char *RFC4648_OUTPUTS[] = {"Zg==", "Zm8=", "Zm9v", "Zm9vYg==",
+                                        "Zm9vYmE=", "Zm9vYmFy"};
+
+void test_base64_rfc4648_vectors(void) {
+    Base64Options options = {0};
+
+    for (usize index = 0; index < 6; index++) {
+        const u8 *input = (const u8 *)RFC4648_INPUTS[index];
+        usize len       = strlen(RFC4648_INPUTS[index]);
+
+        char encoded[16] = {0};
+        usize encoded_len = Base64_encode(input, len, encoded, options);
+        TEST_ASSERT_EQUAL_UINT(encoded_len,
+                               Base64_encoded_length(len, options));
+        TEST_ASSERT_EQUAL_STRING(encoded, RFC4648_OUTPUTS[index]);
+
+        u8 decoded[16];
+        long decoded_len =
+            Base64_decode(encoded, encoded_len, decoded, options);
+        TEST_ASSERT_EQUAL_INT(decoded_len, len);
+        TEST_ASSERT_EQUAL_MEMORY(decoded, input, len);
+    }
+
+    // Empty input
+    TEST_ASSERT_EQUAL_UINT(Base64_encoded_length(0, options), 0);
+    TEST_ASSERT_EQUAL_INT(Base64_decode("", 0, NULL, options), 0);
+    TEST_ASSERT_NULL(Base64_to_hex_buffer("", 0, options));
+
+    // `HexBuffer` <-> base64 `String`
+    HexBuffer hex_buffer = Hex_from_string("666F6F626172");
+    defer_string(encoded) = Base64_from_hex_buffer(hex_buffer, options);
+    TEST_ASSERT_EQUAL_STRING(HS_as_str(encoded), "Zm9vYmFy");
+    Hex_free(hex_buffer);
+
+    hex_buffer = Base64_to_hex_buffer("Zm9vYmE=", 8, options);
+    TEST_ASSERT_NOT_NULL(hex_buffer);
+    char hex_str[16];
+    Hex_to_string(hex_buffer, hex_str, sizeof(hex_str));
+    TEST_ASSERT_EQUAL_STRING(hex_str, "666F6F6261");
+    Hex_free(hex_buffer);
+}
+
+void test_base64_url_and_no_padding(void) {
+    const u8 input[] = {0xFB, 0xFF, 0xBF, 0xFE};
+
+    char encoded[16] = {0};
+    Base64_encode(input, sizeof(input), encoded, (Base64Options){0});
+    TEST_ASSERT_EQUAL_STRING(encoded, "+/+//g==");
+
+    Base64Options url = {.alphabet = B64_URL, .no_padding = true};
+    memset(encoded, 0, sizeof(encoded));
+    usize encoded_len = Base64_encode(input, sizeof(input), encoded, url);
+    TEST_ASSERT_EQUAL_UINT(encoded_len, 6);
+    TEST_ASSERT_EQUAL_UINT(Base64_encoded_length(sizeof(input), url), 6);
+    TEST_ASSERT_EQUAL_STRING(encoded, "-_-__g");
+
+    u8 decoded[8];
+    TEST_ASSERT_EQUAL_INT(Base64_decode("-_-__g", 6, decoded, url), 4);
+    TEST_ASSERT_EQUAL_MEMORY(decoded, input, sizeof(input));
+
+    // The alphabets don't mix
+    TEST_ASSERT_EQUAL_INT(Base64_decode("+/+__g", 6, decoded, url), -1);
+    TEST_ASSERT_EQUAL_INT(
+        Base64_decode("-_-__g==", 8, decoded, (Base64Options){0}),
+        -1);
+
+    // `no_padding` rejects `=`
+    TEST_ASSERT_EQUAL_INT(Base64_decode("-_-__g==", 8, decoded, url), -1);
+
+    HexBuffer hex_buffer = Base64_to_hex_buffer("-_-__g", 6, url);
+    TEST_ASSERT_NOT_NULL(hex_buffer);
+    TEST_ASSERT_EQUAL_UINT(Hex_length(hex_buffer), 4);
+    Hex_free(hex_buffer);
+}
+
+void test_base64_strict_validation(void) {
+    Base64Options options = {0};
+    u8 out[16];
+
+    const char *invalid_inputs[] = {
+        "Zm9v\n",    // line break
+        "Zm 9v",     // whitespace
+        "Zm9",       // missing padding
+        "Zg=",       // not a full block
+        "Z===",      // too much padding
+        "Zm=v",      // padding in the middle
+        "Zg==Zm9v",  // data after padding
+        "Zh==",      // non-zero unused bits
+        "Zm9=",      // non-zero unused bits
+        "Zm9v*A==",  // out of the alphabet
+    };
+    usize count = sizeof(invalid_inputs) / sizeof(invalid_inputs[0]);
+    for (usize index = 0; index < count; index++) {
+        const char *input = invalid_inputs[index];
+        TEST_ASSERT_EQUAL_INT(Base64_decode(input, strlen(input), out, options),
+                              -1);
+        TEST_ASSERT_NULL(Base64_to_hex_buffer(input, strlen(input), options));
+    }
+
+    // `no_padding`: the last block can't be a single character
+    Base64Options no_padding = {.no_padding = true};
+    TEST_ASSERT_EQUAL_INT(Base64_decode("Zm9vY", 5, out, no_padding), -1);
+    TEST_ASSERT_EQUAL_INT(Base64_decode("Zm9vYg", 6, out, no_padding), 4);
+}
+
+void test_base64_big_buffer(void) {
+    //
+    // Big enough for the SIMD paths, plus the odd tails
+    //
+    usize max_len = 4096 + 7;
+    u8 *data      = malloc(max_len);
+    for (usize index = 0; index < max_len; index++) {
+        data[index] = (u8)(index * 131 + (index >> 8));
+    }
+    char *encoded = malloc(Base64_encoded_length(max_len, (Base64Options){0}));
+    u8 *decoded   = malloc(BASE64_DECODED_MAX_LENGTH(max_len * 2));
+
+    const usize lens[] = {31, 32, 33, 64, 95, 96, 97, 1000, max_len};
+    for (usize index = 0; index < sizeof(lens) / sizeof(usize); index++) {
+        for (usize mode = 0; mode < 4; mode++) {
+            Base64Options options = {
+                .alphabet   = (mode & 1) ? B64_URL : B64_STANDARD,
+                .no_padding = (mode & 2) != 0,
+            };
+            usize len         = lens[index];
+            usize encoded_len = Base64_encode(data, len, encoded, options);
+            TEST_ASSERT_EQUAL_UINT(encoded_len,
+                                   Base64_encoded_length(len, options));
+
+            long decoded_len =
+                Base64_decode(encoded, encoded_len, decoded, options);
+            TEST_ASSERT_EQUAL_INT(decoded_len, len);
+            TEST_ASSERT_EQUAL_MEMORY(decoded, data, len);
+
+            // An invalid character deep inside the SIMD blocks
+            char saved             = encoded[encoded_len / 2];
+            encoded[encoded_len / 2] = '.';
+            TEST_ASSERT_EQUAL_INT(
+                Base64_decode(encoded, encoded_len, decoded, options),
+                -1);
+            encoded[encoded_len / 2] = saved;
+        }
+    }
+
+    // Append to `String`
+    defer_string(str) = HS_from_str(">");
+    Base64_encode_into(data, max_len, str, (Base64Options){0});
+    TEST_ASSERT_EQUAL_UINT(
+        HS_length(str),
+        1 + Base64_encoded_length(max_len, (Base64Options){0}));
+    TEST_ASSERT_EQUAL_INT(Base64_decode(HS_as_str(str) + 1,
+                                        HS_length(str) - 1,
+                                        decoded,
+                                        (Base64Options){0}),
+                          max_len);
+    TEST_ASSERT_EQUAL_MEMORY(decoded, data, max_len);
+
+    free(decoded);
+    free(encoded);
+    free(data);
+}
+
+void test_base64_streaming(void) {
+    usize len = 10000;
+    u8 *data  = malloc(len);
+    for (usize index = 0; index < len; index++) {
+        data[index] = (u8)(index * 7 + 3);
+    }
+
+    Base64Options options = {0};
+    usize encoded_len     = Base64_encoded_length(len, options);
+    char *expected        = malloc(encoded_len);
+    Base64_encode(data, len, expected, options);
+
+    char *encoded = malloc(BASE64_ENCODER_MAX_OUTPUT(len));
+    u8 *decoded   = malloc(BASE64_DECODER_MAX_OUTPUT(encoded_len));
+
+    const usize chunk_sizes[] = {1, 2, 5, 64, 1000};
+    for (usize index = 0; index < sizeof(chunk_sizes) / sizeof(usize);
+         index++) {
+        usize chunk_size = chunk_sizes[index];
+
+        Base64Encoder encoder;
+        Base64Encoder_init(&encoder, options);
+        usize out_len = 0;
+        for (usize offset = 0; offset < len; offset += chunk_size) {
+            usize chunk_len =
+                len - offset < chunk_size ? len - offset : chunk_size;
+            out_len += Base64Encoder_feed(&encoder,
+                                          data + offset,
+                                          chunk_len,
+                                          encoded + out_len);
+        }
+        out_len += Base64Encoder_finish(&encoder, encoded + out_len);
+        TEST_ASSERT_EQUAL_UINT(out_len, encoded_len);
+        TEST_ASSERT_EQUAL_MEMORY(encoded, expected, encoded_len);
+
+        Base64Decoder decoder;
+        Base64Decoder_init(&decoder, options);
+        long decoded_len = 0;
+        for (usize offset = 0; offset < encoded_len; offset += chunk_size) {
+            usize chunk_len = encoded_len - offset < chunk_size
+                                  ? encoded_len - offset
+                                  : chunk_size;
+            long chunk_out_len = Base64Decoder_feed(&decoder,
+                                                    expected + offset,
+                                                    chunk_len,
+                                                    decoded + decoded_len);
+            TEST_ASSERT_TRUE(chunk_out_len >= 0);
+            decoded_len += chunk_out_len;
+        }
+        TEST_ASSERT_EQUAL_INT(Base64Decoder_finish(&decoder, NULL), 0);
+        TEST_ASSERT_EQUAL_INT(decoded_len, len);
+        TEST_ASSERT_EQUAL_MEMORY(decoded, data, len);
+    }
+
+    //
+    // Unpadded last block is decoded by `finish`, data after padding fails
+    //
+    Base64Decoder decoder;
+    Base64Decoder_init(&decoder, (Base64Options){.no_padding = true});
+    u8 out[BASE64_DECODER_MAX_OUTPUT(8)];
+    TEST_ASSERT_EQUAL_INT(Base64Decoder_feed(&decoder, "Zm9vYg", 6, out), 3);
+    TEST_ASSERT_EQUAL_INT(Base64Decoder_finish(&decoder, out), 1);
+    TEST_ASSERT_EQUAL_HEX8(out[0], 'b');
+
+    Base64Decoder_init(&decoder, options);
+    TEST_ASSERT_EQUAL_INT(Base64Decoder_feed(&decoder, "Zg=", 3, out), 0);
+    TEST_ASSERT_EQUAL_INT(Base64Decoder_feed(&decoder, "=", 1, out), 1);
+    TEST_ASSERT_EQUAL_INT(Base64Decoder_feed(&decoder, "Zm9v", 4, out), -1);
+    TEST_ASSERT_EQUAL_INT(Base64Decoder_finish(&decoder, out), -1);
+
+    free(decoded);
+    free(encoded);
+    free(expected);
+    free(data);
+}
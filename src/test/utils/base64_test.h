@@ -0,0 +1,10 @@
+#ifndef __BASE64_TEST_H__
+#define __BASE64_TEST_H__
+
+void test_base64_rfc4648_vectors(void);
+void test_base64_url_and_no_padding(void);
+void test_base64_strict_validation(void);
+void test_base64_big_buffer(void);
+void test_base64_streaming(void);
+
+#endif
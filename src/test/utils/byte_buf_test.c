@@ -0,0 +1,196 @@
+#include "./byte_buf_test.h"
+
+#include <string.h>
+#include <unity.h>
+
+#include "../../utils/byte_buf.h"
+
+void test_byte_buf_put_get(void) {
+    defer_byte_buf(buf) = BB_new();
+    TEST_ASSERT_EQUAL_UINT(BB_capacity(buf), 0);
+
+    TEST_ASSERT_TRUE(BB_put_u8(buf, 0xAB));
+    TEST_ASSERT_TRUE(BB_put_u16_le(buf, 0x1234));
+    TEST_ASSERT_TRUE(BB_put_u16_be(buf, 0x1234));
+    TEST_ASSERT_TRUE(BB_put_u32_le(buf, 0xDEADBEEF));
+    TEST_ASSERT_TRUE(BB_put_u32_be(buf, 0xDEADBEEF));
+    TEST_ASSERT_TRUE(BB_put_u64_le(buf, 0x0102030405060708));
+    TEST_ASSERT_TRUE(BB_put_u64_be(buf, 0x0102030405060708));
+    TEST_ASSERT_EQUAL_UINT(BB_length(buf), 1 + 2 * 2 + 4 * 2 + 8 * 2);
+
+    // Byte order in memory
+    const u8 expected[] = {
+        0xAB, 0x34, 0x12, 0x12, 0x34, 0xEF, 0xBE, 0xAD, 0xDE, 0xDE, 0xAD,
+        0xBE, 0xEF, 0x08, 0x07, 0x06, 0x05, 0x04, 0x03, 0x02, 0x01, 0x01,
+        0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,
+    };
+    ByteView view = BB_as_view(buf);
+    TEST_ASSERT_EQUAL_UINT(view.len, sizeof(expected));
+    TEST_ASSERT_EQUAL_MEMORY(view.ptr, expected, sizeof(expected));
+
+    // Read back (unaligned positions)
+    u8 v8;
+    u16 v16;
+    u32 v32;
+    u64 v64;
+    TEST_ASSERT_TRUE(BB_get_u8(buf, &v8));
+    TEST_ASSERT_EQUAL_HEX8(v8, 0xAB);
+    TEST_ASSERT_TRUE(BB_get_u16_le(buf, &v16));
+    TEST_ASSERT_EQUAL_HEX16(v16, 0x1234);
+    TEST_ASSERT_TRUE(BB_get_u16_be(buf, &v16));
+    TEST_ASSERT_EQUAL_HEX16(v16, 0x1234);
+    TEST_ASSERT_TRUE(BB_get_u32_le(buf, &v32));
+    TEST_ASSERT_EQUAL_HEX32(v32, 0xDEADBEEF);
+    TEST_ASSERT_TRUE(BB_get_u32_be(buf, &v32));
+    TEST_ASSERT_EQUAL_HEX32(v32, 0xDEADBEEF);
+    TEST_ASSERT_TRUE(BB_get_u64_le(buf, &v64));
+    TEST_ASSERT_TRUE(v64 == 0x0102030405060708);
+    TEST_ASSERT_EQUAL_UINT(BB_remaining(buf), 8);
+
+    // Not enough bytes, the read cursor doesn't move
+    u8 bytes[16];
+    TEST_ASSERT_FALSE(BB_get_bytes(buf, bytes, sizeof(bytes)));
+    TEST_ASSERT_EQUAL_UINT(BB_remaining(buf), 8);
+    TEST_ASSERT_TRUE(BB_get_u64_be(buf, &v64));
+    TEST_ASSERT_TRUE(v64 == 0x0102030405060708);
+    TEST_ASSERT_FALSE(BB_get_u8(buf, &v8));
+
+    // Compact reuses the already read space
+    TEST_ASSERT_TRUE(BB_put_u16_be(buf, 0xCAFE));
+    BB_set_read_index(buf, BB_length(buf) - 1);
+    BB_compact(buf);
+    TEST_ASSERT_EQUAL_UINT(BB_read_index(buf), 0);
+    TEST_ASSERT_EQUAL_UINT(BB_length(buf), 1);
+    TEST_ASSERT_TRUE(BB_get_u8(buf, &v8));
+    TEST_ASSERT_EQUAL_HEX8(v8, 0xFE);
+
+    // Grows as needed
+    BB_clear(buf);
+    for (u32 index = 0; index < 1000; index++) BB_put_u32_le(buf, index);
+    TEST_ASSERT_EQUAL_UINT(BB_length(buf), 4000);
+    BB_set_read_index(buf, 999 * 4);
+    TEST_ASSERT_TRUE(BB_get_u32_le(buf, &v32));
+    TEST_ASSERT_EQUAL_UINT(v32, 999);
+}
+
+void test_byte_buf_varint(void) {
+    defer_byte_buf(buf) = BB_new();
+
+    const u64 values[] = {
+        0, 1, 127, 128, 300, 16383, 16384, 0xFFFFFFFF, 0xFFFFFFFFFFFFFFFF,
+    };
+    const usize lengths[] = {1, 1, 1, 2, 2, 2, 3, 5, 10};
+    usize count           = sizeof(values) / sizeof(values[0]);
+
+    for (usize index = 0; index < count; index++) {
+        usize before = BB_length(buf);
+        TEST_ASSERT_TRUE(BB_put_varint(buf, values[index]));
+        TEST_ASSERT_EQUAL_UINT(BB_length(buf) - before, lengths[index]);
+        TEST_ASSERT_EQUAL_UINT(BB_varint_length(values[index]),
+                               lengths[index]);
+    }
+
+    // `300` is `AC 02`
+    ByteView view = BB_slice(buf, 5, 2);
+    TEST_ASSERT_EQUAL_HEX8(view.ptr[0], 0xAC);
+    TEST_ASSERT_EQUAL_HEX8(view.ptr[1], 0x02);
+
+    for (usize index = 0; index < count; index++) {
+        u64 value;
+        TEST_ASSERT_TRUE(BB_get_varint(buf, &value));
+        TEST_ASSERT_TRUE(value == values[index]);
+    }
+
+    // Zigzag
+    const i64 signed_values[] = {0, -1, 1, -2, 63, -64, 64, INT64_MIN};
+    const u8 first_bytes[]    = {0, 1, 2, 3, 126, 127, 0x80, 0xFF};
+    count = sizeof(signed_values) / sizeof(signed_values[0]);
+    for (usize index = 0; index < count; index++) {
+        BB_clear(buf);
+        TEST_ASSERT_TRUE(BB_put_varint_signed(buf, signed_values[index]));
+        TEST_ASSERT_EQUAL_HEX8(BB_as_view(buf).ptr[0], first_bytes[index]);
+
+        i64 value;
+        TEST_ASSERT_TRUE(BB_get_varint_signed(buf, &value));
+        TEST_ASSERT_TRUE(value == signed_values[index]);
+    }
+
+    // Truncated: the read cursor doesn't move
+    BB_clear(buf);
+    BB_put_u8(buf, 0x80);
+    u64 value;
+    TEST_ASSERT_FALSE(BB_get_varint(buf, &value));
+    TEST_ASSERT_EQUAL_UINT(BB_read_index(buf), 0);
+
+    // Overflow `u64` or longer than 10 bytes
+    BB_clear(buf);
+    for (usize index = 0; index < 9; index++) BB_put_u8(buf, 0xFF);
+    BB_put_u8(buf, 0x02);
+    TEST_ASSERT_FALSE(BB_get_varint(buf, &value));
+
+    BB_clear(buf);
+    for (usize index = 0; index < 11; index++) BB_put_u8(buf, 0x80);
+    TEST_ASSERT_FALSE(BB_get_varint(buf, &value));
+}
+
+void test_byte_buf_slice_and_wrap(void) {
+    // frame: magic (u16 BE) + varint payload length + payload
+    const char payload[] = "Hello ByteBuf";
+    usize payload_len    = sizeof(payload) - 1;
+
+    defer_byte_buf(frame) = BB_with_capacity(4);
+    TEST_ASSERT_EQUAL_UINT(BB_capacity(frame), 4);
+    BB_put_u16_be(frame, 0xCAFE);
+    BB_put_varint(frame, payload_len);
+    BB_put_bytes(frame, (const u8 *)payload, payload_len);
+
+    // Out of range slice
+    ByteView empty = BB_slice(frame, 3, BB_remaining(frame));
+    TEST_ASSERT_NULL(empty.ptr);
+    TEST_ASSERT_EQUAL_UINT(empty.len, 0);
+
+    // Parse it through a read-only wrapper without copying
+    defer_byte_buf(reader) = BB_wrap(BB_as_view(frame));
+    u16 magic;
+    u64 len;
+    ByteView body;
+    TEST_ASSERT_TRUE(BB_get_u16_be(reader, &magic));
+    TEST_ASSERT_EQUAL_HEX16(magic, 0xCAFE);
+    TEST_ASSERT_TRUE(BB_get_varint(reader, &len));
+    TEST_ASSERT_EQUAL_UINT(len, payload_len);
+    TEST_ASSERT_TRUE(BB_get_view(reader, len, &body));
+    TEST_ASSERT_EQUAL_UINT(body.len, payload_len);
+    TEST_ASSERT_EQUAL_MEMORY(body.ptr, payload, payload_len);
+    TEST_ASSERT_TRUE(body.ptr == BB_as_view(frame).ptr + 3);
+    TEST_ASSERT_EQUAL_UINT(BB_remaining(reader), 0);
+
+    // Read-only
+    TEST_ASSERT_FALSE(BB_put_u8(reader, 0x01));
+    BB_clear(reader);
+    TEST_ASSERT_EQUAL_UINT(BB_remaining(reader), BB_length(frame));
+}
+
+void test_byte_buf_hex_buffer(void) {
+    HexBuffer hex_buffer = Hex_from_string("DEADBEEF0102");
+    TEST_ASSERT_NOT_NULL(hex_buffer);
+
+    defer_byte_buf(buf) = BB_from_hex_buffer(hex_buffer);
+    Hex_free(hex_buffer);
+
+    u32 value;
+    TEST_ASSERT_TRUE(BB_get_u32_be(buf, &value));
+    TEST_ASSERT_EQUAL_HEX32(value, 0xDEADBEEF);
+
+    // Only the readable bytes
+    BB_put_u16_le(buf, 0x0403);
+    HexBuffer rest = BB_to_hex_buffer(buf);
+    TEST_ASSERT_NOT_NULL(rest);
+    char rest_str[Hex_length(rest) * 2 + 1];
+    Hex_to_string(rest, rest_str, sizeof(rest_str));
+    TEST_ASSERT_EQUAL_STRING(rest_str, "01020304");
+    Hex_free(rest);
+
+    // Nothing readable
+    BB_set_read_index(buf, BB_length(buf));
+    TEST_ASSERT_NULL(BB_to_hex_buffer(buf));
+}
@@ -0,0 +1,9 @@
+#ifndef __BYTE_BUF_TEST_H__
+#define __BYTE_BUF_TEST_H__
+
+void test_byte_buf_put_get(void);
+void test_byte_buf_varint(void);
+void test_byte_buf_slice_and_wrap(void);
+void test_byte_buf_hex_buffer(void);
+
+#endif
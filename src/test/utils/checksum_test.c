@@ -0,0 +1,142 @@
+#include "./checksum_test.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <unity.h>
+
+#include "../../utils/checksum.h"
+
+//
+// Bit-at-a-time reference implementations
+//
+static u32 reference_crc(u32 poly, const u8 *ptr, usize len) {
+    u32 crc = ~0u;
+    for (usize index = 0; index < len; index++) {
+        crc ^= ptr[index];
+        for (usize bit = 0; bit < 8; bit++) {
+            crc = (crc & 1) ? (crc >> 1) ^ poly : crc >> 1;
+        }
+    }
+
+    return ~crc;
+}
+
+static u32 reference_adler32(const u8 *ptr, usize len) {
+    u32 s1 = 1;
+    u32 s2 = 0;
+    for (usize index = 0; index < len; index++) {
+        s1 = (s1 + ptr[index]) % 65521;
+        s2 = (s2 + s1) % 65521;
+    }
+
+    return (s2 << 16) | s1;
+}
+
+void test_checksum_known_values(void) {
+    TEST_ASSERT_EQUAL_HEX32(Checksum_crc32c("123456789", 9), 0xE3069283);
+    TEST_ASSERT_EQUAL_HEX32(Checksum_crc32("123456789", 9), 0xCBF43926);
+    TEST_ASSERT_EQUAL_HEX32(Checksum_adler32("Wikipedia", 9), 0x11E60398);
+
+    // Empty input
+    TEST_ASSERT_EQUAL_HEX32(Checksum_crc32c(NULL, 0), 0);
+    TEST_ASSERT_EQUAL_HEX32(Checksum_crc32("", 0), 0);
+    TEST_ASSERT_EQUAL_HEX32(Checksum_adler32(NULL, 0), 1);
+
+    //
+    // Every length from 0 to 1KB (at an odd address), so all the SIMD
+    // block sizes and tails are covered, plus some big ones.
+    //
+    usize max_len = 300 * 1024;
+    u8 *buffer    = malloc(max_len + 1);
+    u8 *data      = buffer + 1;
+    for (usize index = 0; index < max_len; index++) {
+        data[index] = (u8)(index * 131 + (index >> 9));
+    }
+
+    for (usize len = 0; len <= 1024; len++) {
+        TEST_ASSERT_EQUAL_HEX32(Checksum_crc32c(data, len),
+                                reference_crc(0x82F63B78, data, len));
+        TEST_ASSERT_EQUAL_HEX32(Checksum_crc32(data, len),
+                                reference_crc(0xEDB88320, data, len));
+        TEST_ASSERT_EQUAL_HEX32(Checksum_adler32(data, len),
+                                reference_adler32(data, len));
+    }
+
+    const usize big_lens[] = {5552, 5553, 24 * 1024 + 7, max_len};
+    for (usize index = 0; index < sizeof(big_lens) / sizeof(usize); index++) {
+        usize len = big_lens[index];
+        TEST_ASSERT_EQUAL_HEX32(Checksum_crc32c(data, len),
+                                reference_crc(0x82F63B78, data, len));
+        TEST_ASSERT_EQUAL_HEX32(Checksum_crc32(data, len),
+                                reference_crc(0xEDB88320, data, len));
+        TEST_ASSERT_EQUAL_HEX32(Checksum_adler32(data, len),
+                                reference_adler32(data, len));
+    }
+
+    // All `0xFF` is the worst case of the `Adler-32` overflow
+    memset(data, 0xFF, max_len);
+    TEST_ASSERT_EQUAL_HEX32(Checksum_adler32(data, max_len),
+                            reference_adler32(data, max_len));
+
+    free(buffer);
+}
+
+void test_checksum_streaming(void) {
+    usize len = 100 * 1024;
+    u8 *data  = malloc(len);
+    for (usize index = 0; index < len; index++) {
+        data[index] = (u8)(index * 7 + 3);
+    }
+
+    u32 crc32c = Checksum_crc32c(data, len);
+    u32 crc32  = Checksum_crc32(data, len);
+    u32 adler  = Checksum_adler32(data, len);
+
+    // Chunk by chunk with different chunk sizes
+    const usize chunk_sizes[] = {1, 7, 64, 1000, 65537};
+    for (usize index = 0; index < sizeof(chunk_sizes) / sizeof(usize);
+         index++) {
+        u32 crc32c_chunked = CHECKSUM_CRC32_INIT;
+        u32 crc32_chunked  = CHECKSUM_CRC32_INIT;
+        u32 adler_chunked  = CHECKSUM_ADLER32_INIT;
+
+        for (usize offset = 0; offset < len; offset += chunk_sizes[index]) {
+            usize chunk_len = len - offset < chunk_sizes[index]
+                                  ? len - offset
+                                  : chunk_sizes[index];
+            crc32c_chunked = Checksum_crc32c_update(crc32c_chunked,
+                                                    data + offset,
+                                                    chunk_len);
+            crc32_chunked  = Checksum_crc32_update(crc32_chunked,
+                                                  data + offset,
+                                                  chunk_len);
+            adler_chunked  = Checksum_adler32_update(adler_chunked,
+                                                    data + offset,
+                                                    chunk_len);
+        }
+
+        TEST_ASSERT_EQUAL_HEX32(crc32c_chunked, crc32c);
+        TEST_ASSERT_EQUAL_HEX32(crc32_chunked, crc32);
+        TEST_ASSERT_EQUAL_HEX32(adler_chunked, adler);
+    }
+
+    free(data);
+}
+
+void test_checksum_hex_buffer(void) {
+    // "123456789"
+    HexBuffer hex_buffer = Hex_from_string("313233343536373839");
+    TEST_ASSERT_NOT_NULL(hex_buffer);
+
+    TEST_ASSERT_EQUAL_HEX32(Checksum_crc32c_hex_buffer(hex_buffer),
+                            0xE3069283);
+    TEST_ASSERT_EQUAL_HEX32(Checksum_crc32_hex_buffer(hex_buffer), 0xCBF43926);
+    TEST_ASSERT_EQUAL_HEX32(Checksum_adler32_hex_buffer(hex_buffer),
+                            Checksum_adler32("123456789", 9));
+
+    TEST_ASSERT_EQUAL_HEX32(Checksum_crc32c_hex_buffer(NULL), 0);
+    TEST_ASSERT_EQUAL_HEX32(Checksum_crc32_hex_buffer(NULL), 0);
+    TEST_ASSERT_EQUAL_HEX32(Checksum_adler32_hex_buffer(NULL), 1);
+
+    Hex_free(hex_buffer);
+}
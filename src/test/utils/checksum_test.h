@@ -0,0 +1,8 @@
+#ifndef __CHECKSUM_TEST_H__
+#define __CHECKSUM_TEST_H__
+
+void test_checksum_known_values(void);
+void test_checksum_streaming(void);
+void test_checksum_hex_buffer(void);
+
+#endif
@@ -0,0 +1,102 @@
+#include "./string_table_test.h"
+
+#include <string.h>
+
+#include "../../../utils/collections/string_table.h"
+#include "unity.h"
+
+void test_string_table_empty(void) {
+    defer_string(empty_str)         = HS_from_empty();
+    defer_string_table(empty_table) = HS_split_to_table(empty_str, ",");
+    TEST_ASSERT_EQUAL_UINT(ST_len(empty_table), 0);
+    TEST_ASSERT_NULL(ST_get(empty_table, 0).ptr);
+
+    StringTableIteractor iter = ST_iter(empty_table);
+    TEST_ASSERT_EQUAL_UINT(iter.length, 0);
+
+    defer_string(str)                    = HS_from_str("no delimiter here");
+    defer_string_table(no_delimiter_tbl) = HS_split_to_table(str, NULL);
+    TEST_ASSERT_EQUAL_UINT(ST_len(no_delimiter_tbl), 1);
+    TEST_ASSERT_EQUAL_STRING(ST_get(no_delimiter_tbl, 0).ptr,
+                             "no delimiter here");
+}
+
+void test_string_table_split(void) {
+    defer_string(str)         = HS_from_str("name,,age,city,");
+    defer_string_table(table) = HS_split_to_table(str, ",");
+    TEST_ASSERT_EQUAL_UINT(ST_len(table), 5);
+
+    const char *expected[]    = {"name", "", "age", "city", ""};
+    StringTableIteractor iter = ST_iter(table);
+    TEST_ASSERT_EQUAL_UINT(iter.length, 5);
+    for (usize index = 0; index < iter.length; index++) {
+        TEST_ASSERT_EQUAL_UINT(iter.items[index].len, strlen(expected[index]));
+
+        // Every item is null-terminated as well
+        TEST_ASSERT_EQUAL_STRING(iter.items[index].ptr, expected[index]);
+    }
+
+    // Out of range
+    TEST_ASSERT_NULL(ST_get(table, 5).ptr);
+    TEST_ASSERT_EQUAL_UINT(ST_get(table, 5).len, 0);
+
+    // The original string doesn't change
+    TEST_ASSERT_EQUAL_STRING(HS_as_str(str), "name,,age,city,");
+}
+
+void test_string_table_multi_char_delimiter(void) {
+    defer_string(str)         = HS_from_str("a::b:c::::d");
+    defer_string_table(table) = HS_split_to_table(str, "::");
+    TEST_ASSERT_EQUAL_UINT(ST_len(table), 4);
+    TEST_ASSERT_EQUAL_STRING(ST_get(table, 0).ptr, "a");
+    TEST_ASSERT_EQUAL_STRING(ST_get(table, 1).ptr, "b:c");
+    TEST_ASSERT_EQUAL_STRING(ST_get(table, 2).ptr, "");
+    TEST_ASSERT_EQUAL_STRING(ST_get(table, 3).ptr, "d");
+}
+
+void test_string_table_sort(void) {
+    defer_string(str)         = HS_from_str("pear apple banana app apple");
+    defer_string_table(table) = HS_split_to_table(str, " ");
+    ST_sort(table);
+
+    const char *expected[] = {"app", "apple", "apple", "banana", "pear"};
+    for (usize index = 0; index < ST_len(table); index++) {
+        TEST_ASSERT_EQUAL_STRING(ST_get(table, index).ptr, expected[index]);
+    }
+}
+
+void test_string_table_to_vector(void) {
+    defer_string(str)         = HS_from_str("1|22||333");
+    defer_string_table(table) = HS_split_to_table(str, "|");
+
+    Vector vec = ST_to_vector(table);
+    TEST_ASSERT_EQUAL_UINT(Vec_len(vec), 4);
+    TEST_ASSERT_EQUAL_STRING(HS_as_str((String)Vec_get(vec, 0)), "1");
+    TEST_ASSERT_EQUAL_STRING(HS_as_str((String)Vec_get(vec, 1)), "22");
+    TEST_ASSERT_NULL(HS_as_str((String)Vec_get(vec, 2)));
+    TEST_ASSERT_EQUAL_STRING(HS_as_str((String)Vec_get(vec, 3)), "333");
+
+    defer_string(joined) = Vec_join(vec, "|", NULL);
+    TEST_ASSERT_EQUAL_STRING(HS_as_str(joined), "1|22||333");
+    Vec_free(vec);
+}
+
+void test_string_table_from_packed(void) {
+    defer_string_table(empty) = ST_from_packed(NULL, 10);
+    TEST_ASSERT_EQUAL_UINT(ST_len(empty), 0);
+
+    const char packed[] = "a\0bc\0\0d";
+    defer_string_table(table) = ST_from_packed(packed, sizeof(packed) - 1);
+    TEST_ASSERT_EQUAL_UINT(ST_len(table), 4);
+    TEST_ASSERT_EQUAL_STRING(ST_get(table, 0).ptr, "a");
+    TEST_ASSERT_EQUAL_STRING(ST_get(table, 1).ptr, "bc");
+    TEST_ASSERT_EQUAL_UINT(ST_get(table, 1).len, 2);
+    TEST_ASSERT_EQUAL_STRING(ST_get(table, 2).ptr, "");
+    TEST_ASSERT_EQUAL_UINT(ST_get(table, 2).len, 0);
+    TEST_ASSERT_EQUAL_STRING(ST_get(table, 3).ptr, "d");
+
+    // The ending `\0` doesn't add an empty item
+    defer_string_table(table2) = ST_from_packed(packed, sizeof(packed));
+    TEST_ASSERT_EQUAL_UINT(ST_len(table2), 4);
+    TEST_ASSERT_EQUAL_STRING(ST_get(table2, 3).ptr, "d");
+}
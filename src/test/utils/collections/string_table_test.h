@@ -0,0 +1,11 @@
+#ifndef __STRING_TABLE_TEST_H__
+#define __STRING_TABLE_TEST_H__
+
+void test_string_table_empty(void);
+void test_string_table_split(void);
+void test_string_table_multi_char_delimiter(void);
+void test_string_table_sort(void);
+void test_string_table_to_vector(void);
+void test_string_table_from_packed(void);
+
+#endif
@@ -0,0 +1,309 @@
+#include "./csv_test.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <unity.h>
+
+#include "../../utils/csv.h"
+
+static void assert_field(StrView field, const char *expected) {
+    TEST_ASSERT_EQUAL_UINT(field.len, strlen(expected));
+    TEST_ASSERT_EQUAL_MEMORY(field.ptr, expected, field.len);
+}
+
+//
+// Quoting, escapes, CRLF, empty lines and the last row without newline
+//
+static const char RFC4180_INPUT[] =
+    "name,comment,count\r\n"
+    "\r\n"
+    "\"Wison, Ye\",\"He said \"\"hi\"\"\",1\n"
+    "\n"
+    "multi,\"line 1\nline 2\r\nline 3\",\"\"\n"
+    ",,\n"
+    "last,\"\"\"\",3";
+
+static const char *RFC4180_FIELDS[][3] = {
+    {"name", "comment", "count"},
+    {"Wison, Ye", "He said \"hi\"", "1"},
+    {"multi", "line 1\nline 2\r\nline 3", ""},
+    {"", "", ""},
+    {"last", "\"", "3"},
+};
+
+void test_csv_rfc4180(void) {
+    usize input_len = sizeof(RFC4180_INPUT) - 1;
+
+    //
+    // Every chunk size, so rows straddle the chunks in every possible way
+    //
+    for (usize chunk_size = 1; chunk_size <= input_len + 1; chunk_size++) {
+        defer_csv_reader(csv) = Csv_from_memory(
+            RFC4180_INPUT, input_len, (CsvOptions){.chunk_size = chunk_size});
+
+        CsvRow row;
+        usize row_count = 0;
+        while (Csv_read_row(csv, &row)) {
+            TEST_ASSERT_TRUE(row_count < 5);
+            TEST_ASSERT_EQUAL_UINT(row.field_count, 3);
+            for (usize index = 0; index < 3; index++) {
+                assert_field(row.fields[index],
+                             RFC4180_FIELDS[row_count][index]);
+            }
+            row_count++;
+        }
+        TEST_ASSERT_EQUAL_UINT(row_count, 5);
+        TEST_ASSERT_NULL(Csv_get_error(csv));
+
+        // Stay at the end
+        TEST_ASSERT_FALSE(Csv_read_row(csv, &row));
+    }
+
+    //
+    // Empty input
+    //
+    defer_csv_reader(empty) = Csv_from_memory("", 0, (CsvOptions){0});
+    CsvRow row;
+    TEST_ASSERT_FALSE(Csv_read_row(empty, &row));
+    TEST_ASSERT_NULL(Csv_get_error(empty));
+}
+
+//
+// Field `column` of `row`: random length and characters that need quoting,
+// so the quoted fields cross the 64 bytes blocks
+//
+static usize generated_field(usize row, usize column, char *out) {
+    static const char CHARS[] = "ab,\"\n\r xyz0123";
+    usize len                 = (row * 7 + column * 13) % 90;
+    for (usize index = 0; index < len; index++) {
+        out[index] = CHARS[(row * 31 + column * 17 + index * 5) %
+                           (sizeof(CHARS) - 1)];
+    }
+
+    return len;
+}
+
+static usize generated_csv(usize row_count, char *out) {
+    char field[128];
+    usize len = 0;
+    for (usize row = 0; row < row_count; row++) {
+        for (usize column = 0; column < 4; column++) {
+            usize field_len = generated_field(row, column, field);
+            bool quoted     = false;
+            for (usize index = 0; index < field_len; index++) {
+                quoted |= field[index] == ',' || field[index] == '"' ||
+                          field[index] == '\n' || field[index] == '\r';
+            }
+
+            if (column > 0) out[len++] = ',';
+            if (quoted) out[len++] = '"';
+            for (usize index = 0; index < field_len; index++) {
+                if (field[index] == '"') out[len++] = '"';
+                out[len++] = field[index];
+            }
+            if (quoted) out[len++] = '"';
+        }
+        if (row % 3 == 0) out[len++] = '\r';
+        out[len++] = '\n';
+    }
+
+    return len;
+}
+
+static void assert_generated_rows(CsvReader csv, usize row_count) {
+    char field[128];
+    CsvRow row;
+    usize row_index = 0;
+    while (Csv_read_row(csv, &row)) {
+        TEST_ASSERT_TRUE(row_index < row_count);
+        TEST_ASSERT_EQUAL_UINT(row.field_count, 4);
+        for (usize column = 0; column < 4; column++) {
+            usize field_len = generated_field(row_index, column, field);
+            TEST_ASSERT_EQUAL_UINT(row.fields[column].len, field_len);
+            TEST_ASSERT_EQUAL_MEMORY(row.fields[column].ptr, field, field_len);
+        }
+        row_index++;
+    }
+    TEST_ASSERT_EQUAL_UINT(row_index, row_count);
+    TEST_ASSERT_NULL(Csv_get_error(csv));
+}
+
+void test_csv_generated_rows(void) {
+    const usize row_count = 2000;
+    char *input           = malloc(row_count * 4 * 200);
+    usize input_len       = generated_csv(row_count, input);
+
+    const usize chunk_sizes[] = {0, 64, 100, 4096, 65536};
+    for (usize index = 0; index < 5; index++) {
+        defer_csv_reader(csv) = Csv_from_memory(
+            input,
+            input_len,
+            (CsvOptions){.chunk_size = chunk_sizes[index]});
+        assert_generated_rows(csv, row_count);
+    }
+
+    free(input);
+}
+
+void test_csv_tsv_parallel(void) {
+    const usize row_count = 10000;
+    char *input           = malloc(row_count * 32);
+    usize input_len       = 0;
+    for (usize row = 0; row < row_count; row++) {
+        input_len += sprintf(input + input_len,
+                             "%lu\t\"%lu\t%s\n",
+                             row,
+                             row * 3,
+                             row % 2 == 0 ? "even" : "");
+    }
+
+    //
+    // `"` is a normal character, the serial and parallel readers return the
+    // same rows in the same order
+    //
+    const usize thread_counts[] = {1, 3, 0};
+    for (usize index = 0; index < 3; index++) {
+        defer_csv_reader(csv) =
+            Csv_from_memory(input,
+                            input_len,
+                            (CsvOptions){
+                                .delimiter  = '\t',
+                                .no_quotes  = true,
+                                .chunk_size = 1000,
+                                .parallel   = true,
+                                .threads    = thread_counts[index],
+                            });
+
+        char expected[32];
+        usize row_index = 0;
+        CsvChunk chunk;
+        while (Csv_read_chunk(csv, &chunk)) {
+            TEST_ASSERT_TRUE(chunk.row_count > 0);
+            for (usize row = 0; row < chunk.row_count; row++) {
+                const CsvRow *current = &chunk.rows[row];
+                TEST_ASSERT_EQUAL_UINT(current->field_count, 3);
+
+                sprintf(expected, "%lu", row_index);
+                assert_field(current->fields[0], expected);
+                sprintf(expected, "\"%lu", row_index * 3);
+                assert_field(current->fields[1], expected);
+                assert_field(current->fields[2],
+                             row_index % 2 == 0 ? "even" : "");
+                row_index++;
+            }
+        }
+        TEST_ASSERT_EQUAL_UINT(row_index, row_count);
+        TEST_ASSERT_NULL(Csv_get_error(csv));
+    }
+
+    free(input);
+}
+
+void test_csv_streaming_file(void) {
+    const usize row_count = 500;
+    char *input           = malloc(row_count * 4 * 200);
+    usize input_len       = generated_csv(row_count, input);
+
+    char test_filename[] = "/tmp/c_utils_csv_XXXXXX";
+    int fd               = mkstemp(test_filename);
+    TEST_ASSERT_TRUE(fd >= 0);
+    TEST_ASSERT_EQUAL_INT(write(fd, input, input_len), input_len);
+    close(fd);
+
+    //
+    // Streaming: a small buffer grows for the rows bigger than it
+    //
+    const usize chunk_sizes[] = {1, 17, 256, 0};
+    for (usize index = 0; index < 4; index++) {
+        defer_file(file)      = File_open(test_filename, FM_READ_ONLY);
+        defer_csv_reader(csv) = Csv_open(
+            file, (CsvOptions){.chunk_size = chunk_sizes[index]});
+        TEST_ASSERT_NOT_NULL(csv);
+        assert_generated_rows(csv, row_count);
+    }
+
+    //
+    // Loaded and mapped
+    //
+    defer_file(loaded) = File_open(test_filename, FM_READ_ONLY);
+    File_load_into_buffer(loaded);
+    defer_csv_reader(loaded_csv) = Csv_open(loaded, (CsvOptions){0});
+    assert_generated_rows(loaded_csv, row_count);
+
+    defer_file(mapped) = File_open(test_filename, FM_READ_ONLY);
+    TEST_ASSERT_TRUE(File_map(mapped, (FileMapOptions){0}));
+    defer_csv_reader(mapped_csv) = Csv_open(mapped, (CsvOptions){0});
+    assert_generated_rows(mapped_csv, row_count);
+
+    //
+    // The buffered appends are written before reading
+    //
+    TEST_ASSERT_EQUAL_INT(truncate(test_filename, 0), 0);
+    {
+        defer_file(appended) = File_open(test_filename, FM_READ_WRITE);
+        TEST_ASSERT_TRUE(File_append_bytes(appended, input, input_len));
+        defer_csv_reader(appended_csv) =
+            Csv_open(appended, (CsvOptions){.chunk_size = 256});
+        assert_generated_rows(appended_csv, row_count);
+    }
+
+    //
+    // Mapped then appended: only the mapped content is parsed
+    //
+    {
+        defer_file(appended) = File_open(test_filename, FM_READ_WRITE);
+        TEST_ASSERT_TRUE(File_map(appended, (FileMapOptions){0}));
+        TEST_ASSERT_TRUE(File_append_bytes(appended, input, input_len));
+        defer_csv_reader(appended_csv) = Csv_open(appended, (CsvOptions){0});
+        assert_generated_rows(appended_csv, row_count);
+    }
+
+    unlink(test_filename);
+    free(input);
+
+    defer_file(not_exists) =
+        File_open("/file-that-not-exists.csv", FM_READ_ONLY);
+    TEST_ASSERT_NULL(Csv_open(not_exists, (CsvOptions){0}));
+}
+
+void test_csv_unterminated_quote(void) {
+    const char input[] = "a,b\nc,\"d\ne,f\n";
+    usize input_len    = sizeof(input) - 1;
+
+    //
+    // The rows before the unterminated quoted field are returned first
+    //
+    for (usize chunk_size = 1; chunk_size <= input_len; chunk_size++) {
+        defer_csv_reader(csv) = Csv_from_memory(
+            input, input_len, (CsvOptions){.chunk_size = chunk_size});
+
+        CsvRow row;
+        TEST_ASSERT_TRUE(Csv_read_row(csv, &row));
+        TEST_ASSERT_EQUAL_UINT(row.field_count, 2);
+        assert_field(row.fields[0], "a");
+        assert_field(row.fields[1], "b");
+
+        TEST_ASSERT_FALSE(Csv_read_row(csv, &row));
+        TEST_ASSERT_EQUAL_STRING(Csv_get_error(csv),
+                                 "Unterminated quoted field");
+    }
+
+    //
+    // The same input from a file
+    //
+    char test_filename[] = "/tmp/c_utils_csv_XXXXXX";
+    int fd               = mkstemp(test_filename);
+    TEST_ASSERT_TRUE(fd >= 0);
+    TEST_ASSERT_EQUAL_INT(write(fd, input, input_len), input_len);
+    close(fd);
+
+    defer_file(file)      = File_open(test_filename, FM_READ_ONLY);
+    defer_csv_reader(csv) = Csv_open(file, (CsvOptions){.chunk_size = 4});
+    CsvRow row;
+    TEST_ASSERT_TRUE(Csv_read_row(csv, &row));
+    TEST_ASSERT_FALSE(Csv_read_row(csv, &row));
+    TEST_ASSERT_EQUAL_STRING(Csv_get_error(csv), "Unterminated quoted field");
+
+    unlink(test_filename);
+}
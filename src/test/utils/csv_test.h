@@ -0,0 +1,10 @@
+#ifndef __CSV_TEST_H__
+#define __CSV_TEST_H__
+
+void test_csv_rfc4180(void);
+void test_csv_generated_rows(void);
+void test_csv_tsv_parallel(void);
+void test_csv_streaming_file(void);
+void test_csv_unterminated_quote(void);
+
+#endif
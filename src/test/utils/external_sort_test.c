@@ -0,0 +1,234 @@
+#include "./external_sort_test.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <unity.h>
+
+#include "../../utils/external_sort.h"
+
+//
+// Write `content` to a new temp file, the path goes to `path`
+//
+static void write_temp_file(char *path, const char *content, usize len) {
+    strcpy(path, "/tmp/c_utils_external_sort_test_XXXXXX");
+    int fd = mkstemp(path);
+    TEST_ASSERT_TRUE(fd >= 0);
+    TEST_ASSERT_EQUAL_INT(write(fd, content, len), len);
+    close(fd);
+}
+
+/*
+ * Sort `input[0..input_len]`, check the output is `expected` and return the
+ * run count
+ */
+static usize sort_and_check(const char *input,
+                            usize input_len,
+                            ExternalSortOptions options,
+                            const char *expected,
+                            usize expected_len) {
+    char input_path[64];
+    char output_path[64];
+    write_temp_file(input_path, input, input_len);
+    write_temp_file(output_path, "", 0);
+
+    usize run_count = 0;
+    {
+        defer_file(in)              = File_open(input_path, FM_READ_ONLY);
+        defer_file(out)             = File_open(output_path, FM_WRITE_ONLY);
+        defer_external_sort(sorter) = ExternalSort_new(options);
+        TEST_ASSERT_TRUE(ExternalSort_sort(sorter, in, out));
+        TEST_ASSERT_NULL(ExternalSort_get_error(sorter));
+        run_count = ExternalSort_get_run_count(sorter);
+    }
+
+    defer_file(result) = File_open(output_path, FM_READ_ONLY);
+    TEST_ASSERT_EQUAL_UINT(File_load_into_buffer(result), expected_len);
+    TEST_ASSERT_EQUAL_MEMORY(File_get_data(result), expected, expected_len);
+
+    unlink(input_path);
+    unlink(output_path);
+
+    return run_count;
+}
+
+static int compare_lines(const void *a, const void *b) {
+    return strcmp(*(const char **)a, *(const char **)b);
+}
+
+void test_external_sort_lines(void) {
+    //
+    // Empty input
+    //
+    usize run_count = sort_and_check("", 0, (ExternalSortOptions){0}, "", 0);
+    TEST_ASSERT_EQUAL_UINT(run_count, 0);
+
+    //
+    // CRLF, empty lines, duplicates, and no line break at the end
+    //
+    const char input[]    = "pear\r\nbanana\n\napple pie\napple\nbanana\nzoo";
+    const char expected[] = "\napple\napple pie\nbanana\nbanana\npear\nzoo\n";
+    TEST_ASSERT_EQUAL_UINT(sort_and_check(input,
+                                          strlen(input),
+                                          (ExternalSortOptions){0},
+                                          expected,
+                                          strlen(expected)),
+                           0);
+
+    //
+    // Bytes order, the compare prefix is 8 bytes
+    //
+    const char long_input[] = "abcdefghz\nabcdefgh\nabcdefghij\n\xff\nABC\n";
+    const char long_expected[] =
+        "ABC\nabcdefgh\nabcdefghij\nabcdefghz\n\xff\n";
+    sort_and_check(long_input,
+                   strlen(long_input),
+                   (ExternalSortOptions){0},
+                   long_expected,
+                   strlen(long_expected));
+}
+
+void test_external_sort_runs(void) {
+    //
+    // Random lines of 0 ~ 40 bytes
+    //
+    const usize line_count = 20000;
+    char *input            = malloc(line_count * 42);
+    char **lines           = malloc(line_count * sizeof(char *));
+    char *storage          = malloc(line_count * 42);
+    usize input_len        = 0;
+    u32 seed               = 12345;
+    for (usize index = 0; index < line_count; index++) {
+        seed       = seed * 1103515245 + 12345;
+        usize len  = (seed >> 16) % 41;
+        char *line = storage + index * 42;
+        for (usize offset = 0; offset < len; offset++) {
+            seed         = seed * 1103515245 + 12345;
+            line[offset] = 'a' + (seed >> 16) % 4;
+        }
+        line[len]    = '\0';
+        lines[index] = line;
+
+        memcpy(input + input_len, line, len);
+        input_len += len;
+        input[input_len++] = '\n';
+    }
+
+    qsort(lines, line_count, sizeof(char *), compare_lines);
+    char *expected     = malloc(line_count * 42);
+    usize expected_len = 0;
+    for (usize index = 0; index < line_count; index++) {
+        usize len = strlen(lines[index]);
+        memcpy(expected + expected_len, lines[index], len);
+        expected_len += len;
+        expected[expected_len++] = '\n';
+    }
+
+    //
+    // In memory
+    //
+    TEST_ASSERT_EQUAL_UINT(sort_and_check(input,
+                                          input_len,
+                                          (ExternalSortOptions){0},
+                                          expected,
+                                          expected_len),
+                           0);
+
+    //
+    // 64KB runs, merged in one pass
+    //
+    usize run_count = sort_and_check(
+        input,
+        input_len,
+        (ExternalSortOptions){.memory_budget = 64 * 1024},
+        expected,
+        expected_len);
+    TEST_ASSERT_TRUE(run_count > 10);
+
+    //
+    // 16KB runs, merged 3 at a time (many passes)
+    //
+    usize pass_run_count =
+        sort_and_check(input,
+                       input_len,
+                       (ExternalSortOptions){.memory_budget = 16 * 1024,
+                                             .max_runs      = 3},
+                       expected,
+                       expected_len);
+    TEST_ASSERT_TRUE(pass_run_count > run_count * 4);
+
+    //
+    // The temp folder doesn't exist
+    //
+    char input_path[64];
+    write_temp_file(input_path, input, input_len);
+    defer_file(in)              = File_open(input_path, FM_READ_ONLY);
+    defer_file(out)             = File_open("/dev/null", FM_WRITE_ONLY);
+    defer_external_sort(sorter) = ExternalSort_new((ExternalSortOptions){
+        .memory_budget = 16 * 1024,
+        .temp_folder   = "/folder-that-not-exists",
+    });
+    TEST_ASSERT_FALSE(ExternalSort_sort(sorter, in, out));
+    TEST_ASSERT_NOT_NULL(ExternalSort_get_error(sorter));
+    unlink(input_path);
+
+    free(input);
+    free(lines);
+    free(storage);
+    free(expected);
+}
+
+void test_external_sort_field_key(void) {
+    //
+    // Sort by the 2nd field as numbers: negative, saturated, not a number
+    // (`0`) and missing field (empty key, `0`). The same keys keep the input
+    // order, in memory and across the runs.
+    //
+    const char input[] = "a\t10\n"
+                         "b\t-5\n"
+                         "c\t 10\tx\n"
+                         "d\t99999999999999999999999\n"
+                         "e\tabc\n"
+                         "f\n"
+                         "g\t-99999999999999999999999\n"
+                         "h\t+3\n"
+                         "i\t10\n";
+    const char expected[] = "g\t-99999999999999999999999\n"
+                            "b\t-5\n"
+                            "e\tabc\n"
+                            "f\n"
+                            "h\t+3\n"
+                            "a\t10\n"
+                            "c\t 10\tx\n"
+                            "i\t10\n"
+                            "d\t99999999999999999999999\n";
+    ExternalSortOptions options = {
+        .key     = ESK_FIELD,
+        .field   = 2,
+        .numeric = true,
+    };
+    sort_and_check(input, strlen(input), options, expected, strlen(expected));
+
+    options.memory_budget = 70;
+    options.max_runs      = 2;
+    TEST_ASSERT_TRUE(sort_and_check(input,
+                                    strlen(input),
+                                    options,
+                                    expected,
+                                    strlen(expected)) > 3);
+
+    //
+    // Bytes order of the 3rd field with `,`
+    //
+    const char csv[]          = "1,x,pear\n2,y,apple\n3,z\n4,w,apple,9\n";
+    const char csv_expected[] = "3,z\n2,y,apple\n4,w,apple,9\n1,x,pear\n";
+    sort_and_check(csv,
+                   strlen(csv),
+                   (ExternalSortOptions){
+                       .key       = ESK_FIELD,
+                       .field     = 3,
+                       .delimiter = ',',
+                   },
+                   csv_expected,
+                   strlen(csv_expected));
+}
@@ -0,0 +1,8 @@
+#ifndef __EXTERNAL_SORT_TEST_H__
+#define __EXTERNAL_SORT_TEST_H__
+
+void test_external_sort_lines(void);
+void test_external_sort_runs(void);
+void test_external_sort_field_key(void);
+
+#endif
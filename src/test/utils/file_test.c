@@ -1,9 +1,13 @@
 #include "./file_test.h"
 
 #include <errno.h>
+#include <fcntl.h>
 #include <pwd.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
 #include <unistd.h>
 #include <unity.h>
 
@@ -62,3 +66,978 @@ void test_file_read_should_success(void) {
         // printf("\n>>> test_file content: %s", File_get_data(test_file));
     }
 }
+
+void test_file_map_should_success(void) {
+    char test_filename[] = "/tmp/c_utils_file_map_XXXXXX";
+    int fd               = mkstemp(test_filename);
+    TEST_ASSERT_TRUE(fd >= 0);
+
+    const char content[] = "line 1\nline 2\nline 3";
+    TEST_ASSERT_EQUAL_INT(write(fd, content, sizeof(content) - 1),
+                          sizeof(content) - 1);
+    close(fd);
+
+    {
+        defer_file(test_file) = File_open(test_filename, FM_READ_ONLY);
+        TEST_ASSERT_TRUE(
+            File_map(test_file,
+                     (FileMapOptions){.populate = true, .sequential = true}));
+        TEST_ASSERT_TRUE(File_is_mapped(test_file));
+        TEST_ASSERT_NULL(File_get_error(test_file));
+        TEST_ASSERT_EQUAL_UINT(File_get_size(test_file), sizeof(content) - 1);
+        TEST_ASSERT_EQUAL_MEMORY(File_get_data(test_file),
+                                 content,
+                                 sizeof(content) - 1);
+
+        StrView view = File_as_view(test_file);
+        TEST_ASSERT_EQUAL_PTR(view.ptr, File_get_data(test_file));
+        TEST_ASSERT_EQUAL_UINT(view.len, sizeof(content) - 1);
+
+        // Loading into the buffer replaces the mapping
+        File_load_into_buffer(test_file);
+        TEST_ASSERT_FALSE(File_is_mapped(test_file));
+        TEST_ASSERT_EQUAL_STRING(File_get_data(test_file), content);
+        view = File_as_view(test_file);
+        TEST_ASSERT_EQUAL_UINT(view.len, sizeof(content) - 1);
+
+        // And mapping again frees the buffer
+        TEST_ASSERT_TRUE(
+            File_map(test_file, (FileMapOptions){.will_need = true}));
+        TEST_ASSERT_TRUE(File_is_mapped(test_file));
+        TEST_ASSERT_NULL(test_file->data);
+    }
+
+    //
+    // Empty file is an empty view
+    //
+    fd = open(test_filename, O_WRONLY | O_TRUNC);
+    close(fd);
+    {
+        defer_file(test_file) = File_open(test_filename, FM_READ_ONLY);
+        TEST_ASSERT_TRUE(File_map(test_file, (FileMapOptions){0}));
+        TEST_ASSERT_FALSE(File_is_mapped(test_file));
+        TEST_ASSERT_EQUAL_UINT(File_get_size(test_file), 0);
+        TEST_ASSERT_EQUAL_UINT(File_as_view(test_file).len, 0);
+    }
+
+    unlink(test_filename);
+}
+
+void test_file_map_should_fail(void) {
+    defer_file(not_exists) =
+        File_open("/file-that-not-exists.txt", FM_READ_ONLY);
+    TEST_ASSERT_FALSE(File_map(not_exists, (FileMapOptions){0}));
+    TEST_ASSERT_FALSE(File_is_mapped(not_exists));
+
+    // Not a regular file
+    defer_file(folder) = File_open("/tmp", FM_READ_ONLY);
+    TEST_ASSERT_FALSE(File_map(folder, (FileMapOptions){0}));
+    TEST_ASSERT_EQUAL_STRING(File_get_error(folder), "Not a regular file");
+    TEST_ASSERT_NULL(File_get_data(folder));
+}
+
+void test_file_read_line(void) {
+    char test_filename[] = "/tmp/c_utils_file_lines_XXXXXX";
+    int fd               = mkstemp(test_filename);
+    TEST_ASSERT_TRUE(fd >= 0);
+
+    //
+    // CRLF, empty lines, a line longer than the buffer and the last line
+    // without line break
+    //
+    char long_line[100];
+    memset(long_line, 'x', sizeof(long_line));
+    const char head[] = "first\r\n\nthird\n";
+    write(fd, head, sizeof(head) - 1);
+    write(fd, long_line, sizeof(long_line));
+    const char tail[] = "\r\n\r\nlast";
+    write(fd, tail, sizeof(tail) - 1);
+    close(fd);
+
+    const char *expected_lines[] = {"first", "", "third", NULL, "", "last"};
+
+    //
+    // Every buffer size, so lines straddle the `read` calls in every
+    // possible way
+    //
+    defer_file(test_file) = File_open(test_filename, FM_READ_ONLY);
+    for (usize buffer_size = 1; buffer_size <= 130; buffer_size++) {
+        TEST_ASSERT_TRUE(File_lines(test_file, buffer_size));
+
+        StrView line;
+        usize line_count = 0;
+        while (File_read_line(test_file, &line)) {
+            TEST_ASSERT_TRUE(line_count < 6);
+            if (expected_lines[line_count] == NULL) {
+                TEST_ASSERT_EQUAL_UINT(line.len, sizeof(long_line));
+                TEST_ASSERT_EQUAL_MEMORY(line.ptr, long_line, line.len);
+            } else {
+                TEST_ASSERT_EQUAL_UINT(line.len,
+                                       strlen(expected_lines[line_count]));
+                TEST_ASSERT_EQUAL_MEMORY(line.ptr,
+                                         expected_lines[line_count],
+                                         line.len);
+            }
+            line_count++;
+        }
+        TEST_ASSERT_EQUAL_UINT(line_count, 6);
+
+        // Stay at the end
+        TEST_ASSERT_FALSE(File_read_line(test_file, &line));
+    }
+
+    unlink(test_filename);
+
+    //
+    // `File_read_line` starts with the default buffer, an empty file has no
+    // line
+    //
+    defer_file(empty_file) = File_open("/dev/null", FM_READ_ONLY);
+    StrView line;
+    TEST_ASSERT_FALSE(File_read_line(empty_file, &line));
+
+    defer_file(not_exists) =
+        File_open("/file-that-not-exists.txt", FM_READ_ONLY);
+    TEST_ASSERT_FALSE(File_lines(not_exists, 0));
+    TEST_ASSERT_FALSE(File_read_line(not_exists, &line));
+}
+
+void test_file_append_and_save(void) {
+    char test_filename[] = "/tmp/c_utils_file_write_XXXXXX";
+    int fd               = mkstemp(test_filename);
+    TEST_ASSERT_TRUE(fd >= 0);
+    close(fd);
+
+    //
+    // Small appends stay in the buffer until it's full, a big one is
+    // written straight away
+    //
+    {
+        defer_file(test_file) = File_open(test_filename, FM_APPEND);
+        File_set_write_options(
+            test_file,
+            (FileWriteOptions){.buffer_size      = 16,
+                               .sync             = FS_EVERY_N_BYTES,
+                               .sync_every_bytes = 32});
+        TEST_ASSERT_TRUE(File_append(test_file, "0123456789"));
+
+        struct stat file_stat;
+        stat(test_filename, &file_stat);
+        TEST_ASSERT_EQUAL_INT(file_stat.st_size, 0);
+
+        TEST_ASSERT_TRUE(File_append(test_file, "abcdefghij"));
+        TEST_ASSERT_TRUE(File_append(test_file, "ABCDEFGHIJKLMNOPQRSTUVWXYZ"));
+        stat(test_filename, &file_stat);
+        TEST_ASSERT_EQUAL_INT(file_stat.st_size, 46);
+
+        TEST_ASSERT_TRUE(File_append_bytes(test_file, "\n!", 2));
+        TEST_ASSERT_TRUE(File_flush(test_file));
+        stat(test_filename, &file_stat);
+        TEST_ASSERT_EQUAL_INT(file_stat.st_size, 48);
+        TEST_ASSERT_EQUAL_UINT(File_get_size(test_file), 48);
+
+        // The rest is flushed by `File_free`
+        TEST_ASSERT_TRUE(File_append(test_file, "?"));
+    }
+
+    const char expected[] =
+        "0123456789abcdefghijABCDEFGHIJKLMNOPQRSTUVWXYZ\n!?";
+    {
+        defer_file(test_file) = File_open(test_filename, FM_READ_ONLY);
+        File_load_into_buffer(test_file);
+        TEST_ASSERT_EQUAL_STRING(File_get_data(test_file), expected);
+
+        // Read-only
+        TEST_ASSERT_FALSE(File_append(test_file, "x"));
+        TEST_ASSERT_EQUAL_STRING(File_get_error(test_file),
+                                 "File isn't opened for writing");
+    }
+
+    //
+    // Append updates the loaded `data`, then save it back in place and
+    // atomically
+    //
+    for (usize atomic = 0; atomic < 2; atomic++) {
+        {
+            defer_file(test_file) = File_open(test_filename, FM_READ_WRITE);
+            File_set_write_options(
+                test_file,
+                (FileWriteOptions){.sync        = FS_ON_CLOSE,
+                                   .atomic_save = atomic == 1});
+            usize loaded_size = File_load_into_buffer(test_file);
+            TEST_ASSERT_TRUE(File_append(test_file, "+"));
+            TEST_ASSERT_EQUAL_UINT(File_get_size(test_file), loaded_size + 1);
+            TEST_ASSERT_EQUAL_UINT(HS_length(test_file->data),
+                                   loaded_size + 1);
+
+            // Append the loaded `data` to itself (it grows while copying)
+            TEST_ASSERT_TRUE(
+                File_append(test_file, File_get_data(test_file)));
+            TEST_ASSERT_EQUAL_UINT(HS_length(test_file->data),
+                                   (loaded_size + 1) * 2);
+            TEST_ASSERT_EQUAL_MEMORY(HS_as_str(test_file->data),
+                                     HS_as_str(test_file->data) +
+                                         loaded_size + 1,
+                                     loaded_size + 1);
+
+            HS_reset_to_empty(test_file->data);
+            HS_push_str(test_file->data, atomic ? "atomic" : "in place");
+            TEST_ASSERT_TRUE(File_save(test_file));
+            TEST_ASSERT_EQUAL_UINT(File_get_size(test_file),
+                                   atomic ? 6 : 8);
+
+            // Still usable after the save
+            TEST_ASSERT_TRUE(File_append(test_file, "!"));
+        }
+
+        defer_file(test_file) = File_open(test_filename, FM_READ_ONLY);
+        File_load_into_buffer(test_file);
+        TEST_ASSERT_EQUAL_STRING(File_get_data(test_file),
+                                 atomic ? "atomic!" : "in place!");
+    }
+
+    struct stat file_stat;
+    stat(test_filename, &file_stat);
+    TEST_ASSERT_EQUAL_UINT(file_stat.st_mode & 0777, 0600);
+
+    unlink(test_filename);
+}
+
+void test_file_append_with_reads(void) {
+    char test_filename[] = "/tmp/c_utils_file_append_read_XXXXXX";
+    int fd               = mkstemp(test_filename);
+    TEST_ASSERT_TRUE(fd >= 0);
+    close(fd);
+
+    const usize line_count = 1000;
+    char line[32];
+    {
+        defer_file(test_file) = File_open(test_filename, FM_WRITE_ONLY);
+        for (usize index = 0; index < line_count; index++) {
+            snprintf(line, sizeof(line), "line %04lu\n", index);
+            File_append(test_file, line);
+        }
+    }
+
+    //
+    // The reads move the file offset, the appends still go to the end
+    //
+    {
+        defer_file(test_file) = File_open(test_filename, FM_READ_WRITE);
+        TEST_ASSERT_TRUE(File_append(test_file, "first append\n"));
+        TEST_ASSERT_TRUE(File_flush(test_file));
+
+        TEST_ASSERT_TRUE(File_lines(test_file, 4096));
+        StrView view;
+        TEST_ASSERT_TRUE(File_read_line(test_file, &view));
+        TEST_ASSERT_EQUAL_UINT(view.len, 9);
+        TEST_ASSERT_EQUAL_MEMORY(view.ptr, "line 0000", 9);
+
+        TEST_ASSERT_TRUE(File_append(test_file, "second append\n"));
+        TEST_ASSERT_TRUE(File_flush(test_file));
+
+        usize read_count = 1;
+        while (File_read_line(test_file, &view)) read_count++;
+        TEST_ASSERT_EQUAL_UINT(read_count, line_count + 2);
+        TEST_ASSERT_EQUAL_MEMORY(view.ptr, "second append", 13);
+
+        // The rest is flushed by `File_free`
+        TEST_ASSERT_TRUE(File_lines(test_file, 4096));
+        TEST_ASSERT_TRUE(File_read_line(test_file, &view));
+        TEST_ASSERT_TRUE(File_append(test_file, "third append\n"));
+    }
+
+    defer_file(test_file) = File_open(test_filename, FM_READ_ONLY);
+    TEST_ASSERT_EQUAL_UINT(File_load_into_buffer(test_file),
+                           line_count * 10 + 13 + 14 + 13);
+
+    const char *data = File_get_data(test_file);
+    for (usize index = 0; index < line_count; index++) {
+        snprintf(line, sizeof(line), "line %04lu\n", index);
+        TEST_ASSERT_EQUAL_MEMORY(data + index * 10, line, 10);
+    }
+    TEST_ASSERT_EQUAL_STRING(data + line_count * 10,
+                             "first append\nsecond append\nthird append\n");
+
+    //
+    // The mapped content and size stay the same after appends, until it's
+    // mapped again
+    //
+    {
+        defer_file(mapped) = File_open(test_filename, FM_READ_WRITE);
+        TEST_ASSERT_TRUE(File_map(mapped, (FileMapOptions){0}));
+        usize mapped_size = File_get_size(mapped);
+
+        char big[64 * 1024];
+        memset(big, 'x', sizeof(big));
+        for (usize index = 0; index < 32; index++) {
+            TEST_ASSERT_TRUE(File_append_bytes(mapped, big, sizeof(big)));
+        }
+        TEST_ASSERT_TRUE(File_append(mapped, "\nlast line\n"));
+        TEST_ASSERT_EQUAL_UINT(File_get_size(mapped), mapped_size);
+        TEST_ASSERT_EQUAL_UINT(File_as_view(mapped).len, mapped_size);
+
+        TEST_ASSERT_TRUE(File_map(mapped, (FileMapOptions){0}));
+        usize new_size = mapped_size + 32 * sizeof(big) + 11;
+        TEST_ASSERT_EQUAL_UINT(File_get_size(mapped), new_size);
+        TEST_ASSERT_EQUAL_MEMORY(File_get_data(mapped) + new_size - 10,
+                                 "last line\n",
+                                 10);
+    }
+
+    unlink(test_filename);
+}
+
+void test_file_load_many(void) {
+    char folder[] = "/tmp/c_utils_file_load_many_XXXXXX";
+    TEST_ASSERT_NOT_NULL(mkdtemp(folder));
+
+    //
+    // More files than one `io_uring` batch, plus an empty file, a missing
+    // file, a folder and a non-regular file (size unknown)
+    //
+    const usize file_count = 300;
+    const usize count      = file_count + 4;
+    char **paths           = malloc(count * sizeof(char *));
+    for (usize index = 0; index < file_count; index++) {
+        paths[index] = malloc(sizeof(folder) + 32);
+        sprintf(paths[index], "%s/file_%lu.txt", folder, index);
+
+        FILE *file = fopen(paths[index], "w");
+        for (usize line = 0; line < index; line++) {
+            fprintf(file, "%lu: line %lu\n", index, line);
+        }
+        fclose(file);
+    }
+    paths[file_count]     = malloc(sizeof(folder) + 32);
+    paths[file_count + 1] = malloc(sizeof(folder) + 32);
+    paths[file_count + 2] = malloc(sizeof(folder) + 32);
+    paths[file_count + 3] = malloc(sizeof(folder) + 32);
+    sprintf(paths[file_count], "%s/not_exists.txt", folder);
+    sprintf(paths[file_count + 1], "%s", folder);
+    sprintf(paths[file_count + 2], "%s", "/proc/self/stat");
+    sprintf(paths[file_count + 3], "%s/file_0.txt", folder);
+
+    for (usize no_io_uring = 0; no_io_uring < 2; no_io_uring++) {
+        FileLoadManyStats stats;
+        Vector files =
+            File_load_many((const char **)paths,
+                           count,
+                           (FileLoadManyOptions){.no_io_uring = no_io_uring,
+                                                 .threads     = 3},
+                           &stats);
+        TEST_ASSERT_EQUAL_UINT(Vec_len(files), count);
+        TEST_ASSERT_EQUAL_UINT(stats.loaded, count - 2);
+        TEST_ASSERT_EQUAL_UINT(stats.failed, 2);
+        if (no_io_uring) TEST_ASSERT_FALSE(stats.io_uring_used);
+
+        usize total_bytes = 0;
+        for (usize index = 0; index < file_count; index++) {
+            File file = *(const File *)Vec_get(files, index);
+            TEST_ASSERT_EQUAL_STRING(File_get_filename(file), paths[index]);
+            TEST_ASSERT_TRUE(File_is_open_successfully(file));
+
+            // Same with the normal loading
+            defer_file(expected) = File_open(paths[index], FM_READ_ONLY);
+            File_load_into_buffer(expected);
+            TEST_ASSERT_EQUAL_UINT(File_get_size(file),
+                                   File_get_size(expected));
+            if (index > 0) {
+                TEST_ASSERT_EQUAL_STRING(File_get_data(file),
+                                         File_get_data(expected));
+            }
+            total_bytes += File_get_size(file);
+        }
+
+        File missing = *(const File *)Vec_get(files, file_count);
+        TEST_ASSERT_FALSE(File_is_open_successfully(missing));
+        TEST_ASSERT_EQUAL_STRING(File_get_error(missing), strerror(ENOENT));
+
+        File folder_file = *(const File *)Vec_get(files, file_count + 1);
+        TEST_ASSERT_FALSE(File_is_open_successfully(folder_file));
+        TEST_ASSERT_EQUAL_STRING(File_get_error(folder_file),
+                                 strerror(EISDIR));
+
+        File proc_file = *(const File *)Vec_get(files, file_count + 2);
+        TEST_ASSERT_TRUE(File_is_open_successfully(proc_file));
+        TEST_ASSERT_TRUE(File_get_size(proc_file) > 0);
+        TEST_ASSERT_EQUAL_UINT(strlen(File_get_data(proc_file)),
+                               File_get_size(proc_file));
+
+        File empty_file = *(const File *)Vec_get(files, file_count + 3);
+        TEST_ASSERT_TRUE(File_is_open_successfully(empty_file));
+        TEST_ASSERT_EQUAL_UINT(File_get_size(empty_file), 0);
+        TEST_ASSERT_EQUAL_STRING(File_get_data(empty_file), "");
+
+        TEST_ASSERT_EQUAL_UINT(
+            stats.total_bytes,
+            total_bytes + File_get_size(proc_file));
+
+        Vec_free(files);
+    }
+
+    // Nothing to load
+    Vector files =
+        File_load_many(NULL, 0, (FileLoadManyOptions){0}, NULL);
+    TEST_ASSERT_EQUAL_UINT(Vec_len(files), 0);
+    Vec_free(files);
+
+    for (usize index = 0; index < count; index++) {
+        if (index < file_count) unlink(paths[index]);
+        free(paths[index]);
+    }
+    free(paths);
+    rmdir(folder);
+}
+
+static void file_test_touch(const char *folder, const char *name) {
+    char path[256];
+    snprintf(path, sizeof(path), "%s/%s", folder, name);
+    FILE *file = fopen(path, "w");
+    fputs(name, file);
+    fclose(file);
+}
+
+static void file_test_assert_walk(const char *root,
+                                  DirWalkOptions options,
+                                  const char **expected,
+                                  usize expected_count) {
+    options.sort              = true;
+    defer_string_table(paths) = Dir_walk(root, options);
+    TEST_ASSERT_NOT_NULL(paths);
+    TEST_ASSERT_EQUAL_UINT(ST_len(paths), expected_count);
+
+    char expected_path[256];
+    for (usize index = 0; index < expected_count; index++) {
+        snprintf(expected_path,
+                 sizeof(expected_path),
+                 "%s/%s",
+                 root,
+                 expected[index]);
+        TEST_ASSERT_EQUAL_STRING(ST_get(paths, index).ptr, expected_path);
+    }
+}
+
+void test_dir_walk(void) {
+    char root[] = "/tmp/c_utils_dir_walk_XXXXXX";
+    TEST_ASSERT_NOT_NULL(mkdtemp(root));
+
+    //
+    // root/
+    //   a.conf, b.txt, .hidden.conf
+    //   sub/c.conf, sub/deep/d.conf
+    //   .git/e.conf
+    //   link.conf -> a.conf, sub_link -> sub, loop -> . (inside sub)
+    //
+    char path[256];
+    file_test_touch(root, "a.conf");
+    file_test_touch(root, "b.txt");
+    file_test_touch(root, ".hidden.conf");
+    snprintf(path, sizeof(path), "%s/sub", root);
+    mkdir(path, 0755);
+    snprintf(path, sizeof(path), "%s/sub/deep", root);
+    mkdir(path, 0755);
+    snprintf(path, sizeof(path), "%s/.git", root);
+    mkdir(path, 0755);
+    file_test_touch(root, "sub/c.conf");
+    file_test_touch(root, "sub/deep/d.conf");
+    file_test_touch(root, ".git/e.conf");
+    snprintf(path, sizeof(path), "%s/link.conf", root);
+    TEST_ASSERT_EQUAL_INT(symlink("a.conf", path), 0);
+    snprintf(path, sizeof(path), "%s/sub_link", root);
+    TEST_ASSERT_EQUAL_INT(symlink("sub", path), 0);
+    snprintf(path, sizeof(path), "%s/sub/loop", root);
+    TEST_ASSERT_EQUAL_INT(symlink(".", path), 0);
+
+    for (usize parallel = 0; parallel < 2; parallel++) {
+        // All files, links are listed but not followed
+        const char *all[] = {".git/e.conf",
+                             ".hidden.conf",
+                             "a.conf",
+                             "b.txt",
+                             "link.conf",
+                             "sub/c.conf",
+                             "sub/deep/d.conf",
+                             "sub/loop",
+                             "sub_link"};
+        file_test_assert_walk(
+            root,
+            (DirWalkOptions){.parallel = parallel, .threads = 4},
+            all,
+            9);
+
+        // Pattern, no hidden, no links
+        const char *conf[] = {"a.conf", "sub/c.conf", "sub/deep/d.conf"};
+        file_test_assert_walk(root,
+                              (DirWalkOptions){.pattern     = "*.conf",
+                                               .symlinks    = DWS_SKIP,
+                                               .skip_hidden = true,
+                                               .parallel    = parallel},
+                              conf,
+                              3);
+
+        // Depth and folders
+        const char *top[] = {"a.conf", "b.txt", "sub"};
+        file_test_assert_walk(root,
+                              (DirWalkOptions){.symlinks     = DWS_SKIP,
+                                               .include_dirs = true,
+                                               .skip_hidden  = true,
+                                               .max_depth    = 1,
+                                               .parallel     = parallel},
+                              top,
+                              3);
+
+        //
+        // Follow links: `sub` and `sub_link` are the same folder, and
+        // `sub/loop` points back to `sub`, every folder is walked once
+        //
+        defer_string_table(followed) =
+            Dir_walk(root,
+                     (DirWalkOptions){.pattern     = "*.conf",
+                                      .symlinks    = DWS_FOLLOW,
+                                      .skip_hidden = true,
+                                      .parallel    = parallel});
+        TEST_ASSERT_EQUAL_UINT(ST_len(followed), 4);
+    }
+
+    // Ending `/` is removed
+    char root_with_slash[sizeof(root) + 1];
+    snprintf(root_with_slash, sizeof(root_with_slash), "%s/", root);
+    defer_string_table(top) = Dir_walk(
+        root_with_slash,
+        (DirWalkOptions){.pattern = "b.txt", .max_depth = 1});
+    TEST_ASSERT_EQUAL_UINT(ST_len(top), 1);
+    snprintf(path, sizeof(path), "%s/b.txt", root);
+    TEST_ASSERT_EQUAL_STRING(ST_get(top, 0).ptr, path);
+
+    // Not a folder
+    TEST_ASSERT_NULL(Dir_walk(path, (DirWalkOptions){0}));
+    TEST_ASSERT_NULL(Dir_walk("/not_exists_folder", (DirWalkOptions){0}));
+
+    char command[256];
+    snprintf(command, sizeof(command), "rm -rf %s", root);
+    TEST_ASSERT_EQUAL_INT(system(command), 0);
+}
+
+static void file_test_assert_same_content(const char *filename,
+                                          const char *expected,
+                                          usize expected_len) {
+    defer_file(file) = File_open(filename, FM_READ_ONLY);
+    TEST_ASSERT_TRUE(File_is_open_successfully(file));
+    TEST_ASSERT_EQUAL_UINT(File_get_size(file), expected_len);
+    if (expected_len > 0) {
+        File_load_into_buffer(file);
+        TEST_ASSERT_EQUAL_MEMORY(File_get_data(file), expected, expected_len);
+    }
+}
+
+void test_file_copy_and_send(void) {
+    char src_filename[] = "/tmp/c_utils_file_copy_XXXXXX";
+    int fd              = mkstemp(src_filename);
+    TEST_ASSERT_TRUE(fd >= 0);
+    fchmod(fd, 0640);
+    close(fd);
+
+    char dst_filename[sizeof(src_filename) + 4];
+    snprintf(dst_filename, sizeof(dst_filename), "%s.dst", src_filename);
+
+    //
+    // Bigger than the `FCM_READ_WRITE` chunk, and with bytes still in the
+    // `File_append` buffer
+    //
+    const usize content_len = 3 * 1024 * 1024 + 123;
+    char *content           = malloc(content_len);
+    for (usize index = 0; index < content_len; index++) {
+        content[index] = (char)(index * 31 + index / 7);
+    }
+
+    defer_file(src) = File_open(src_filename, FM_READ_WRITE);
+    TEST_ASSERT_TRUE(File_append_bytes(src, content, content_len - 10));
+    TEST_ASSERT_TRUE(File_append_bytes(src, content + content_len - 10, 10));
+
+    FileCopyOptions all_options[] = {
+        {0},
+        {.no_clone = true, .sync = true},
+        {.no_kernel_copy = true},
+    };
+    for (usize index = 0; index < 3; index++) {
+        unlink(dst_filename);
+        FileCopyMethod method =
+            File_copy(src, dst_filename, all_options[index]);
+        TEST_ASSERT_TRUE(method != FCM_FAILED);
+        if (all_options[index].no_clone) {
+            TEST_ASSERT_TRUE(method != FCM_CLONE);
+        }
+        if (all_options[index].no_kernel_copy) {
+            TEST_ASSERT_EQUAL(method, FCM_READ_WRITE);
+        }
+        file_test_assert_same_content(dst_filename, content, content_len);
+
+        struct stat dst_stat;
+        stat(dst_filename, &dst_stat);
+        TEST_ASSERT_EQUAL_UINT(dst_stat.st_mode & 0777, 0640);
+    }
+
+    //
+    // Copy to itself, and a small source overwrites a bigger destination
+    //
+    {
+        defer_file(small) = File_open(dst_filename, FM_WRITE_ONLY);
+        TEST_ASSERT_TRUE(File_append(small, "abc"));
+        TEST_ASSERT_EQUAL(
+            File_copy(small, dst_filename, (FileCopyOptions){0}),
+            FCM_FAILED);
+        TEST_ASSERT_EQUAL_STRING(File_get_error(small),
+                                 "Source and destination are the same file");
+
+        char small_filename[sizeof(src_filename) + 6];
+        snprintf(small_filename,
+                 sizeof(small_filename),
+                 "%s.small",
+                 src_filename);
+        TEST_ASSERT_TRUE(
+            File_copy(src, small_filename, (FileCopyOptions){0}) !=
+            FCM_FAILED);
+        TEST_ASSERT_TRUE(
+            File_copy(small, small_filename, (FileCopyOptions){0}) !=
+            FCM_FAILED);
+        file_test_assert_same_content(small_filename, "abc", 3);
+        unlink(small_filename);
+    }
+
+    // Send to a regular file fd, after the existing content
+    int out_fd = open(dst_filename, O_WRONLY | O_TRUNC);
+    TEST_ASSERT_EQUAL_INT(write(out_fd, "head", 4), 4);
+    TEST_ASSERT_EQUAL(File_send_to_fd(src, out_fd), FCM_SENDFILE);
+    close(out_fd);
+    {
+        defer_file(dst) = File_open(dst_filename, FM_READ_ONLY);
+        TEST_ASSERT_EQUAL_UINT(File_get_size(dst), content_len + 4);
+        File_load_into_buffer(dst);
+        TEST_ASSERT_EQUAL_MEMORY(File_get_data(dst), "head", 4);
+        TEST_ASSERT_EQUAL_MEMORY(File_get_data(dst) + 4, content, content_len);
+    }
+
+    // Send to a pipe (small file, fits in the pipe buffer)
+    {
+        defer_file(small) = File_open(src_filename, FM_WRITE_ONLY);
+        TEST_ASSERT_TRUE(File_append(small, "through the pipe"));
+        int pipe_fds[2];
+        TEST_ASSERT_EQUAL_INT(pipe(pipe_fds), 0);
+        TEST_ASSERT_EQUAL(File_send_to_fd(small, pipe_fds[1]), FCM_SPLICE);
+        close(pipe_fds[1]);
+
+        char buffer[64] = {0};
+        TEST_ASSERT_EQUAL_INT(read(pipe_fds[0], buffer, sizeof(buffer)), 16);
+        TEST_ASSERT_EQUAL_STRING(buffer, "through the pipe");
+        close(pipe_fds[0]);
+
+        // Bad fd
+        TEST_ASSERT_EQUAL(File_send_to_fd(small, -1), FCM_FAILED);
+    }
+
+    // Not opened
+    defer_file(not_exists) = File_open("/not_exists_file", FM_READ_ONLY);
+    TEST_ASSERT_EQUAL(
+        File_copy(not_exists, dst_filename, (FileCopyOptions){0}),
+        FCM_FAILED);
+    TEST_ASSERT_EQUAL_STRING(File_get_error(not_exists), "File isn't opened");
+
+    free(content);
+    unlink(dst_filename);
+    unlink(src_filename);
+}
+
+void test_file_load_unknown_size(void) {
+    //
+    // `/proc` file: regular file with size `0`
+    //
+    {
+        defer_file(proc_file) = File_open("/proc/self/status", FM_READ_ONLY);
+        TEST_ASSERT_TRUE(File_is_open_successfully(proc_file));
+        TEST_ASSERT_EQUAL_UINT(File_get_size(proc_file), 0);
+
+        usize loaded = File_load_into_buffer(proc_file);
+        TEST_ASSERT_TRUE(loaded > 0);
+        TEST_ASSERT_EQUAL_UINT(File_get_size(proc_file), loaded);
+        TEST_ASSERT_EQUAL_UINT(strlen(File_get_data(proc_file)), loaded);
+        TEST_ASSERT_NOT_NULL(strstr(File_get_data(proc_file), "Name:"));
+    }
+
+    //
+    // Pipe: bigger than the pipe buffer and the initial loading buffer, the
+    // writer is a child process
+    //
+    const usize content_len = 1024 * 1024 + 17;
+    char *content           = malloc(content_len);
+    for (usize index = 0; index < content_len; index++) {
+        content[index] = 'a' + index % 26;
+    }
+
+    int pipe_fds[2];
+    TEST_ASSERT_EQUAL_INT(pipe(pipe_fds), 0);
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(pipe_fds[0]);
+        for (usize offset = 0; offset < content_len;) {
+            ssize_t written =
+                write(pipe_fds[1], content + offset, content_len - offset);
+            if (written <= 0) _exit(1);
+            offset += written;
+        }
+        _exit(0);
+    }
+    close(pipe_fds[1]);
+
+    {
+        defer_file(input) = File_from_fd(pipe_fds[0], "pipe", FM_READ_ONLY);
+        TEST_ASSERT_TRUE(File_is_open_successfully(input));
+        TEST_ASSERT_EQUAL_STRING(File_get_filename(input), "pipe");
+        TEST_ASSERT_EQUAL_UINT(File_load_into_buffer(input), content_len);
+        TEST_ASSERT_EQUAL_UINT(File_get_size(input), content_len);
+        TEST_ASSERT_EQUAL_MEMORY(File_get_data(input), content, content_len);
+        TEST_ASSERT_EQUAL_INT(File_get_data(input)[content_len], '\0');
+    }
+    waitpid(pid, NULL, 0);
+
+    // `fd` is closed by `File_free`
+    TEST_ASSERT_EQUAL_INT(fcntl(pipe_fds[0], F_GETFD), -1);
+
+    defer_file(invalid) = File_from_fd(-1, NULL, FM_READ_ONLY);
+    TEST_ASSERT_FALSE(File_is_open_successfully(invalid));
+    TEST_ASSERT_EQUAL_STRING(File_get_error(invalid), strerror(EBADF));
+    TEST_ASSERT_EQUAL_UINT(File_load_into_buffer(invalid), (usize)-1);
+
+    free(content);
+}
+
+static void write_test_file(const char *filename, const char *content) {
+    int fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    TEST_ASSERT_TRUE(fd >= 0);
+    TEST_ASSERT_EQUAL_INT(write(fd, content, strlen(content)),
+                          strlen(content));
+    close(fd);
+}
+
+/*
+ * Read the events and return the ones of `path`, `0` if not changed
+ */
+static u32 read_watch_events(FileWatch watch, const char *path) {
+    FileWatchEvent events[4];
+    usize count = FileWatch_read(watch, 1000, events, 4);
+
+    u32 result = 0;
+    for (usize index = 0; index < count; index++) {
+        if (strcmp(events[index].path, path) == 0) {
+            result |= events[index].events;
+        }
+    }
+
+    return result;
+}
+
+void test_file_watch_and_reload(void) {
+    char folder[] = "/tmp/c_utils_file_watch_XXXXXX";
+    TEST_ASSERT_NOT_NULL(mkdtemp(folder));
+
+    char config_path[64], temp_path[64], other_path[64];
+    sprintf(config_path, "%s/app.conf", folder);
+    sprintf(temp_path, "%s/app.conf.tmp", folder);
+    sprintf(other_path, "%s/other.conf", folder);
+    write_test_file(config_path, "port = 80\n");
+
+    defer_file_watch(watch) = FileWatch_new();
+    TEST_ASSERT_NULL(FileWatch_get_error(watch));
+    TEST_ASSERT_TRUE(FileWatch_get_fd(watch) >= 0);
+    TEST_ASSERT_TRUE(FileWatch_add(watch, config_path));
+    TEST_ASSERT_TRUE(FileWatch_add(watch, config_path));
+    TEST_ASSERT_FALSE(FileWatch_add(watch, "/folder-that-not-exists/a"));
+
+    //
+    // Not loaded yet, then nothing changed
+    //
+    defer_file(config) = File_open(config_path, FM_READ_ONLY);
+    TEST_ASSERT_EQUAL_INT(File_reload_if_changed(config), FRR_RELOADED);
+    TEST_ASSERT_EQUAL_STRING(File_get_data(config), "port = 80\n");
+    TEST_ASSERT_EQUAL_INT(File_reload_if_changed(config), FRR_UNCHANGED);
+
+    //
+    // The other files in the folder are not reported
+    //
+    write_test_file(other_path, "other\n");
+    FileWatchEvent events[4];
+    TEST_ASSERT_EQUAL_UINT(FileWatch_read(watch, 0, events, 4), 0);
+
+    //
+    // Modified in place
+    //
+    write_test_file(config_path, "port = 8080\n");
+    TEST_ASSERT_TRUE(read_watch_events(watch, config_path) & FWE_MODIFIED);
+    TEST_ASSERT_EQUAL_INT(File_reload_if_changed(config), FRR_RELOADED);
+    TEST_ASSERT_EQUAL_STRING(File_get_data(config), "port = 8080\n");
+    TEST_ASSERT_EQUAL_INT(File_reload_if_changed(config), FRR_UNCHANGED);
+
+    //
+    // Atomic save: the path is replaced by another inode, the mapped file
+    // is reopened and re-mapped
+    //
+    TEST_ASSERT_TRUE(File_map(config, (FileMapOptions){0}));
+    write_test_file(temp_path, "port = 443\n");
+    TEST_ASSERT_EQUAL_INT(rename(temp_path, config_path), 0);
+    TEST_ASSERT_TRUE(read_watch_events(watch, config_path) & FWE_CREATED);
+    TEST_ASSERT_EQUAL_INT(File_reload_if_changed(config), FRR_RELOADED);
+    TEST_ASSERT_TRUE(File_is_mapped(config));
+    TEST_ASSERT_EQUAL_UINT(File_get_size(config), 11);
+    TEST_ASSERT_EQUAL_MEMORY(File_get_data(config), "port = 443\n", 11);
+    TEST_ASSERT_EQUAL_INT(File_reload_if_changed(config), FRR_UNCHANGED);
+
+    //
+    // Deleted, the loaded content is kept
+    //
+    TEST_ASSERT_EQUAL_INT(unlink(config_path), 0);
+    TEST_ASSERT_TRUE(read_watch_events(watch, config_path) & FWE_DELETED);
+    TEST_ASSERT_EQUAL_INT(File_reload_if_changed(config), FRR_FAILED);
+    TEST_ASSERT_EQUAL_STRING(File_get_error(config), strerror(ENOENT));
+    TEST_ASSERT_EQUAL_MEMORY(File_get_data(config), "port = 443\n", 11);
+
+    //
+    // Removed path is not reported anymore
+    //
+    TEST_ASSERT_TRUE(FileWatch_remove(watch, config_path));
+    TEST_ASSERT_FALSE(FileWatch_remove(watch, config_path));
+    write_test_file(config_path, "port = 80\n");
+    TEST_ASSERT_EQUAL_UINT(FileWatch_read(watch, 0, events, 4), 0);
+
+    unlink(config_path);
+    unlink(other_path);
+    rmdir(folder);
+}
+
+/*
+ * Print to a temp file and return the output, the caller frees it
+ */
+static char *print_like_bat_output(File file, FilePrintOptions options) {
+    char output_filename[] = "/tmp/c_utils_file_print_XXXXXX";
+    int fd                 = mkstemp(output_filename);
+    TEST_ASSERT_TRUE(fd >= 0);
+
+    options.out_fd = fd;
+    TEST_ASSERT_TRUE(File_print_like_bat(file, options));
+
+    off_t size   = lseek(fd, 0, SEEK_END);
+    char *output = calloc(size + 1, 1);
+    TEST_ASSERT_EQUAL_INT(pread(fd, output, size, 0), size);
+    close(fd);
+    unlink(output_filename);
+
+    return output;
+}
+
+void test_file_print_like_bat(void) {
+    char test_filename[] = "/tmp/c_utils_file_bat_XXXXXX";
+    int fd               = mkstemp(test_filename);
+    TEST_ASSERT_TRUE(fd >= 0);
+    const char content[] = "first\r\n\nthird\nlast";
+    write(fd, content, sizeof(content) - 1);
+    close(fd);
+
+    //
+    // All lines, the line breaks are kept as they're
+    //
+    defer_file(file) = File_open(test_filename, FM_READ_ONLY);
+    char *output     = print_like_bat_output(file, (FilePrintOptions){0});
+    TEST_ASSERT_EQUAL_STRING(output,
+                             "     1 | first\r\n"
+                             "     2 | \n"
+                             "     3 | third\n"
+                             "     4 | last");
+    free(output);
+
+    //
+    // Ranges, from the file and from the loaded content
+    //
+    for (usize loaded = 0; loaded < 2; loaded++) {
+        if (loaded) File_load_into_buffer(file);
+
+        output = print_like_bat_output(
+            file, (FilePrintOptions){.first_line = 2, .last_line = 3});
+        TEST_ASSERT_EQUAL_STRING(output, "     2 | \n     3 | third\n");
+        free(output);
+
+        output = print_like_bat_output(file,
+                                       (FilePrintOptions){.first_line = 4});
+        TEST_ASSERT_EQUAL_STRING(output, "     4 | last");
+        free(output);
+
+        output = print_like_bat_output(file,
+                                       (FilePrintOptions){.first_line = 5});
+        TEST_ASSERT_EQUAL_STRING(output, "");
+        free(output);
+
+        output = print_like_bat_output(
+            file, (FilePrintOptions){.first_line = 3, .last_line = 2});
+        TEST_ASSERT_EQUAL_STRING(output, "");
+        free(output);
+    }
+
+    //
+    // Mapped then appended: only the mapped content is printed
+    //
+    {
+        defer_file(mapped) = File_open(test_filename, FM_READ_WRITE);
+        TEST_ASSERT_TRUE(File_map(mapped, (FileMapOptions){0}));
+        char lines[64 * 1024];
+        memset(lines, '\n', sizeof(lines));
+        for (usize index = 0; index < 128; index++) {
+            TEST_ASSERT_TRUE(File_append_bytes(mapped, lines, sizeof(lines)));
+        }
+
+        output = print_like_bat_output(mapped,
+                                       (FilePrintOptions){.first_line = 4});
+        TEST_ASSERT_EQUAL_STRING(output, "     4 | last");
+        free(output);
+
+        output = print_like_bat_output(mapped,
+                                       (FilePrintOptions){.first_line = 9});
+        TEST_ASSERT_EQUAL_STRING(output, "");
+        free(output);
+    }
+    unlink(test_filename);
+
+    //
+    // More than 1MB (the read chunk) and 99999 lines
+    //
+    char big_filename[] = "/tmp/c_utils_file_bat_XXXXXX";
+    fd                  = mkstemp(big_filename);
+    TEST_ASSERT_TRUE(fd >= 0);
+    close(fd);
+    {
+        defer_file(big) = File_open(big_filename, FM_WRITE_ONLY);
+        char line[32];
+        for (usize index = 1; index <= 150000; index++) {
+            File_append_bytes(big, line, sprintf(line, "line %lu\n", index));
+        }
+    }
+
+    defer_file(big) = File_open(big_filename, FM_READ_ONLY);
+    output          = print_like_bat_output(
+        big, (FilePrintOptions){.first_line = 99999, .last_line = 100001});
+    TEST_ASSERT_EQUAL_STRING(output,
+                             " 99999 | line 99999\n"
+                             " 100000 | line 100000\n"
+                             " 100001 | line 100001\n");
+    free(output);
+
+    output = print_like_bat_output(big, (FilePrintOptions){0});
+    TEST_ASSERT_NOT_NULL(strstr(output, "     1 | line 1\n     2 | line 2\n"));
+    TEST_ASSERT_NOT_NULL(strstr(output, " 150000 | line 150000\n"));
+    free(output);
+    unlink(big_filename);
+
+    //
+    // Write fails
+    //
+    TEST_ASSERT_FALSE(
+        File_print_like_bat(big, (FilePrintOptions){.out_fd = 1000}));
+    TEST_ASSERT_EQUAL_STRING(File_get_error(big), strerror(EBADF));
+}
@@ -4,5 +4,16 @@
 void test_file_open_should_fail(void);
 void test_file_open_should_success(void);
 void test_file_read_should_success(void);
+void test_file_map_should_success(void);
+void test_file_map_should_fail(void);
+void test_file_read_line(void);
+void test_file_append_and_save(void);
+void test_file_append_with_reads(void);
+void test_file_load_many(void);
+void test_dir_walk(void);
+void test_file_copy_and_send(void);
+void test_file_load_unknown_size(void);
+void test_file_watch_and_reload(void);
+void test_file_print_like_bat(void);
 
 #endif
@@ -1,5 +1,7 @@
 #include "../../utils/hex_buffer.h"
 
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <unity.h>
 
@@ -65,3 +67,353 @@ void test_hex_buffer_valid_buffer(void) {
     TEST_ASSERT_EQUAL_UINT(strlen(b2_str), 8);
     TEST_ASSERT_EQUAL_STRING(b2_str, "AABBCDEF");
 }
+
+///
+///
+///
+void test_hex_buffer_from_bytes(void) {
+    // Not null-terminated
+    const char input[] = {'0', '1', 'a', 'B', 'f', 'F', 'x', 'x'};
+    HexBuffer b1       = Hex_from_bytes(input, 6);
+    TEST_ASSERT_NOT_NULL(b1);
+    TEST_ASSERT_EQUAL_UINT(Hex_length(b1), 3);
+    HexBufferIteractor iter = Hex_iter(b1);
+    TEST_ASSERT_EQUAL_HEX8(iter.arr[0], 0x01);
+    TEST_ASSERT_EQUAL_HEX8(iter.arr[1], 0xAB);
+    TEST_ASSERT_EQUAL_HEX8(iter.arr[2], 0xFF);
+    Hex_free(b1);
+
+    //
+    // Long enough to run the SIMD path, with invalid characters in the
+    // middle and an odd nibble split by them
+    //
+    const char *long_hex =
+        "000102030405060708090a0b0c0d0e0f101112131415161718191A1B1C1D1E1F"
+        "20 21:22-2 3 2425262728292A2B2C2D2E2F303132333435363738393A3B3C3D";
+    HexBuffer b2 = Hex_from_bytes(long_hex, strlen(long_hex));
+    TEST_ASSERT_NOT_NULL(b2);
+    TEST_ASSERT_EQUAL_UINT(Hex_length(b2), 62);
+    HexBufferIteractor iter2 = Hex_iter(b2);
+    for (usize index = 0; index < iter2.length; index++) {
+        TEST_ASSERT_EQUAL_HEX8(iter2.arr[index], index);
+    }
+    Hex_free(b2);
+
+    TEST_ASSERT_NULL(Hex_from_bytes(NULL, 10));
+    TEST_ASSERT_NULL(Hex_from_bytes("ABC", 3));
+}
+
+///
+///
+///
+void test_hex_buffer_from_bytes_strict(void) {
+    const char *long_hex =
+        "000102030405060708090a0b0c0d0e0f101112131415161718191A1B1C1D1E1F"
+        "202122232425262728292A2B2C2D2E2F303132333435363738393A3B3C3D3E3F";
+    HexBuffer b1 = Hex_from_bytes_strict(long_hex, strlen(long_hex));
+    TEST_ASSERT_NOT_NULL(b1);
+    TEST_ASSERT_EQUAL_UINT(Hex_length(b1), 64);
+    HexBufferIteractor iter = Hex_iter(b1);
+    for (usize index = 0; index < iter.length; index++) {
+        TEST_ASSERT_EQUAL_HEX8(iter.arr[index], index);
+    }
+    Hex_free(b1);
+
+    // Any invalid character fails, no matter where it is
+    char invalid_hex[129];
+    for (usize index = 0; index < 128; index++) {
+        memcpy(invalid_hex, long_hex, 128);
+        invalid_hex[index] = (index % 2 == 0) ? 'g' : ' ';
+        TEST_ASSERT_NULL(Hex_from_bytes_strict(invalid_hex, 128));
+    }
+
+    TEST_ASSERT_NULL(Hex_from_bytes_strict("AABBC", 5));
+    TEST_ASSERT_NULL(Hex_from_bytes_strict("", 0));
+}
+
+///
+///
+///
+void test_hex_buffer_encode(void) {
+    u8 bytes[100];
+    for (usize index = 0; index < sizeof(bytes); index++) {
+        bytes[index] = (u8)(index * 37 + 11);
+    }
+
+    //
+    // Long enough to run the SIMD path, compare with `snprintf`
+    //
+    char expected_upper[sizeof(bytes) * 2 + 1];
+    char expected_lower[sizeof(bytes) * 2 + 1];
+    for (usize index = 0; index < sizeof(bytes); index++) {
+        snprintf(expected_upper + index * 2, 3, "%02X", bytes[index]);
+        snprintf(expected_lower + index * 2, 3, "%02x", bytes[index]);
+    }
+
+    char out[sizeof(bytes) * 3];
+    usize out_len =
+        Hex_encode(bytes, sizeof(bytes), out, (HexEncodeOptions){0});
+    TEST_ASSERT_EQUAL_UINT(out_len, sizeof(bytes) * 2);
+    TEST_ASSERT_EQUAL_STRING_LEN(out, expected_upper, out_len);
+
+    out_len = Hex_encode(bytes,
+                         sizeof(bytes),
+                         out,
+                         (HexEncodeOptions){.lower_case = true});
+    TEST_ASSERT_EQUAL_UINT(out_len, sizeof(bytes) * 2);
+    TEST_ASSERT_EQUAL_STRING_LEN(out, expected_lower, out_len);
+
+    // Separator
+    HexEncodeOptions options = {.lower_case = true, .separator = ':'};
+    u8 mac[]                 = {0x00, 0x1A, 0x2B, 0x3C, 0x4D, 0xFF};
+    TEST_ASSERT_EQUAL_UINT(Hex_encoded_length(sizeof(mac), options), 17);
+    out_len = Hex_encode(mac, sizeof(mac), out, options);
+    TEST_ASSERT_EQUAL_UINT(out_len, 17);
+    TEST_ASSERT_EQUAL_STRING_LEN(out, "00:1a:2b:3c:4d:ff", 17);
+}
+
+///
+///
+///
+void test_hex_buffer_encode_into_string(void) {
+    HexBuffer buffer = Hex_from_string("DEADBEEF00112233");
+
+    defer_string(str) = HS_from_str("hex: ");
+    Hex_encode_into(buffer, str, (HexEncodeOptions){0});
+    TEST_ASSERT_EQUAL_STRING(HS_as_str(str), "hex: DEADBEEF00112233");
+
+    HS_push_str(str, ", ");
+    Hex_encode_into(buffer,
+                    str,
+                    (HexEncodeOptions){.lower_case = true, .separator = ' '});
+    TEST_ASSERT_EQUAL_STRING(
+        HS_as_str(str),
+        "hex: DEADBEEF00112233, de ad be ef 00 11 22 33");
+
+    Hex_free(buffer);
+
+    //
+    // Bigger than the internal encode block, the separator between blocks
+    // is still in place
+    //
+    usize big_len   = 5000;
+    char *big_input = malloc(big_len * 2);
+    for (usize index = 0; index < big_len; index++) {
+        memcpy(big_input + index * 2, "A5", 2);
+    }
+    HexBuffer big_buffer = Hex_from_bytes_strict(big_input, big_len * 2);
+    free(big_input);
+
+    defer_string(big_str) = HS_from_empty();
+    Hex_encode_into(big_buffer, big_str, (HexEncodeOptions){.separator = '-'});
+    TEST_ASSERT_EQUAL_UINT(HS_length(big_str), big_len * 3 - 1);
+    const char *big_str_ptr = HS_as_str(big_str);
+    for (usize index = 0; index < big_len; index++) {
+        TEST_ASSERT_EQUAL_STRING_LEN(big_str_ptr + index * 3, "A5", 2);
+        if (index + 1 < big_len) {
+            TEST_ASSERT_EQUAL_INT(big_str_ptr[index * 3 + 2], '-');
+        }
+    }
+    Hex_free(big_buffer);
+}
+
+///
+///
+///
+void test_hex_buffer_streaming_decoder(void) {
+    const char *hex_str =
+        "00 01 02 03 04 05 06 07 08 09 0a 0b 0c 0d 0e 0f\n"
+        "10 11 12 13 14 15 16 17 18 19 1A 1B 1C 1D 1E 1F\n"
+        "202122232425262728292A2B2C2D2E2F303132333435363738393A3B3C3D3E3F";
+    usize hex_str_len = strlen(hex_str);
+
+    //
+    // Every chunk size, so every hex pair gets split at some point
+    //
+    for (usize chunk_size = 1; chunk_size <= 40; chunk_size++) {
+        HexDecoder decoder;
+        HexDecoder_init(&decoder, false);
+
+        u8 result[64];
+        usize result_len = 0;
+        for (usize index = 0; index < hex_str_len; index += chunk_size) {
+            usize len = hex_str_len - index < chunk_size ? hex_str_len - index
+                                                         : chunk_size;
+            u8 out[HEX_DECODER_MAX_OUTPUT(40)];
+            long out_len = HexDecoder_feed(&decoder, hex_str + index, len, out);
+            TEST_ASSERT_GREATER_THAN(-1, out_len);
+            memcpy(result + result_len, out, out_len);
+            result_len += out_len;
+        }
+
+        TEST_ASSERT_EQUAL(HexDecoder_finish(&decoder), true);
+        TEST_ASSERT_EQUAL_UINT(result_len, 64);
+        for (usize index = 0; index < result_len; index++) {
+            TEST_ASSERT_EQUAL_HEX8(result[index], index);
+        }
+    }
+
+    //
+    // Odd length input
+    //
+    HexDecoder decoder;
+    HexDecoder_init(&decoder, false);
+    u8 out[HEX_DECODER_MAX_OUTPUT(3)];
+    TEST_ASSERT_EQUAL_INT(HexDecoder_feed(&decoder, "A", 1, out), 0);
+    TEST_ASSERT_EQUAL_INT(HexDecoder_feed(&decoder, "BC", 2, out), 1);
+    TEST_ASSERT_EQUAL_HEX8(out[0], 0xAB);
+    TEST_ASSERT_EQUAL(HexDecoder_finish(&decoder), false);
+
+    //
+    // Strict mode fails on the invalid character and stays failed
+    //
+    HexDecoder_init(&decoder, true);
+    TEST_ASSERT_EQUAL_INT(HexDecoder_feed(&decoder, "ABC", 3, out), 1);
+    TEST_ASSERT_EQUAL_INT(HexDecoder_feed(&decoder, "D E", 3, out), -1);
+    TEST_ASSERT_EQUAL_UINT(HexDecoder_consumed(&decoder), 4);
+    TEST_ASSERT_EQUAL_INT(HexDecoder_feed(&decoder, "FF", 2, out), -1);
+    TEST_ASSERT_EQUAL(HexDecoder_finish(&decoder), false);
+
+    // `finish` resets the decoder
+    TEST_ASSERT_EQUAL_INT(HexDecoder_feed(&decoder, "FF", 2, out), 1);
+    TEST_ASSERT_EQUAL(HexDecoder_finish(&decoder), true);
+}
+
+///
+///
+///
+void test_hex_buffer_streaming_encoder(void) {
+    u8 bytes[] = {0xDE, 0xAD, 0xBE, 0xEF, 0x01};
+
+    HexEncoder encoder;
+    HexEncoder_init(&encoder,
+                    (HexEncodeOptions){.lower_case = true, .separator = ' '});
+
+    char result[HEX_ENCODER_MAX_OUTPUT(sizeof(bytes))];
+    usize result_len = 0;
+    result_len += HexEncoder_feed(&encoder, bytes, 2, result + result_len);
+    result_len += HexEncoder_feed(&encoder, bytes + 2, 0, result + result_len);
+    result_len += HexEncoder_feed(&encoder, bytes + 2, 3, result + result_len);
+    TEST_ASSERT_EQUAL_UINT(result_len, 14);
+    TEST_ASSERT_EQUAL_STRING_LEN(result, "de ad be ef 01", result_len);
+}
+
+///
+///
+///
+void test_hex_buffer_compare_and_xor(void) {
+    HexBuffer a     = Hex_from_string("DEADBEEF");
+    HexBuffer b     = Hex_from_string("DEADBEEF");
+    HexBuffer c     = Hex_from_string("DEADBEF0");
+    HexBuffer a_pre = Hex_from_string("DEAD");
+
+    TEST_ASSERT_TRUE(Hex_equals(a, b));
+    TEST_ASSERT_FALSE(Hex_equals(a, c));
+    TEST_ASSERT_FALSE(Hex_equals(a, a_pre));
+    TEST_ASSERT_FALSE(Hex_equals(a, NULL));
+    TEST_ASSERT_TRUE(Hex_equals(NULL, NULL));
+
+    TEST_ASSERT_EQUAL_INT(Hex_compare(a, b), 0);
+    TEST_ASSERT_EQUAL_INT(Hex_compare(a, c), -1);
+    TEST_ASSERT_EQUAL_INT(Hex_compare(c, a), 1);
+    TEST_ASSERT_EQUAL_INT(Hex_compare(a_pre, a), -1);
+    TEST_ASSERT_EQUAL_INT(Hex_compare(a, a_pre), 1);
+    TEST_ASSERT_EQUAL_INT(Hex_compare(NULL, a), -1);
+    TEST_ASSERT_EQUAL_INT(Hex_compare(NULL, NULL), 0);
+
+    // XOR twice with the same key gives back the original bytes
+    HexBuffer key = Hex_from_string("0102030405");
+    TEST_ASSERT_TRUE(Hex_xor_into(a, key));
+    char str[16];
+    Hex_to_string(a, str, sizeof(str));
+    TEST_ASSERT_EQUAL_STRING(str, "DFAFBDEB");
+    TEST_ASSERT_TRUE(Hex_xor_into(a, key));
+    TEST_ASSERT_TRUE(Hex_equals(a, b));
+
+    // The key is too short
+    TEST_ASSERT_FALSE(Hex_xor_into(a, a_pre));
+    TEST_ASSERT_FALSE(Hex_xor_into(a, NULL));
+
+    u8 magic[] = {0xBE, 0xEF};
+    TEST_ASSERT_EQUAL_INT(Hex_find(a, magic, 2), 2);
+    TEST_ASSERT_EQUAL_INT(Hex_find(a, magic, 1), 2);
+    TEST_ASSERT_EQUAL_INT(Hex_find(a_pre, magic, 2), -1);
+    TEST_ASSERT_EQUAL_INT(Hex_find(a, magic, 0), -1);
+    TEST_ASSERT_EQUAL_INT(Hex_find(NULL, magic, 2), -1);
+
+    TEST_ASSERT_EQUAL_UINT(Hex_count_byte(c, 0xDE), 1);
+    TEST_ASSERT_EQUAL_UINT(Hex_count_byte(NULL, 0xDE), 0);
+    TEST_ASSERT_EQUAL_UINT(Hex_popcount(a), 24);
+    TEST_ASSERT_EQUAL_UINT(Hex_popcount(NULL), 0);
+
+    Hex_free(key);
+    Hex_free(a_pre);
+    Hex_free(c);
+    Hex_free(b);
+    Hex_free(a);
+}
+
+///
+/// Every length and position around the SIMD block sizes gives the same
+/// result as the byte by byte loop
+///
+void test_hex_buffer_bytewise_operations(void) {
+    const usize max_len = 300;
+    u8 *bytes           = malloc(max_len);
+    for (usize index = 0; index < max_len; index++) {
+        // `0xF0 ~ 0xFF` never shows up, they are for the pattern below
+        bytes[index] = (index * 37 + 11) % 7 == 0 ? 0xAA : index * 13 % 0xF0;
+    }
+
+    for (usize len = 1; len <= max_len; len += (len < 70 ? 1 : 23)) {
+        HexBuffer buffer = Hex_from_raw(bytes, len);
+        HexBuffer clone  = Hex_from_raw(bytes, len);
+
+        usize expected_count    = 0;
+        usize expected_popcount = 0;
+        for (usize index = 0; index < len; index++) {
+            expected_count += bytes[index] == 0xAA;
+            expected_popcount += __builtin_popcount(bytes[index]);
+        }
+        TEST_ASSERT_EQUAL_UINT(Hex_count_byte(buffer, 0xAA), expected_count);
+        TEST_ASSERT_EQUAL_UINT(Hex_popcount(buffer), expected_popcount);
+
+        //
+        // Change a single byte at every position
+        //
+        HexBufferIteractor iter = Hex_iter(clone);
+        for (usize index = 0; index < len; index++) {
+            iter.arr[index] ^= 0x01;
+            TEST_ASSERT_FALSE(Hex_equals(buffer, clone));
+            TEST_ASSERT_EQUAL_INT(Hex_compare(buffer, clone),
+                                  bytes[index] < iter.arr[index] ? -1 : 1);
+            iter.arr[index] ^= 0x01;
+        }
+        TEST_ASSERT_TRUE(Hex_equals(buffer, clone));
+
+        //
+        // A pattern that only occurs once, at the end
+        //
+        u8 pattern[5] = {0xFF, 0xFE, 0xFD, 0xFC, 0xFB};
+        for (usize pattern_len = 1; pattern_len <= 5 && pattern_len <= len;
+             pattern_len++) {
+            TEST_ASSERT_EQUAL_INT(Hex_find(buffer, pattern, pattern_len), -1);
+            memcpy(iter.arr + len - pattern_len, pattern, pattern_len);
+            TEST_ASSERT_EQUAL_INT(Hex_find(clone, pattern, pattern_len),
+                                  len - pattern_len);
+            memcpy(iter.arr + len - pattern_len,
+                   bytes + len - pattern_len,
+                   pattern_len);
+        }
+
+        // XOR with itself
+        TEST_ASSERT_TRUE(Hex_xor_into(clone, buffer));
+        TEST_ASSERT_EQUAL_UINT(Hex_count_byte(clone, 0x00), len);
+        TEST_ASSERT_EQUAL_UINT(Hex_popcount(clone), 0);
+
+        Hex_free(clone);
+        Hex_free(buffer);
+    }
+
+    free(bytes);
+}
@@ -4,5 +4,13 @@
 void test_hex_buffer_empty_hex_buffer(void);
 void test_hex_buffer_invalid_buffer(void);
 void test_hex_buffer_valid_buffer(void);
+void test_hex_buffer_from_bytes(void);
+void test_hex_buffer_from_bytes_strict(void);
+void test_hex_buffer_encode(void);
+void test_hex_buffer_encode_into_string(void);
+void test_hex_buffer_streaming_decoder(void);
+void test_hex_buffer_streaming_encoder(void);
+void test_hex_buffer_compare_and_xor(void);
+void test_hex_buffer_bytewise_operations(void);
 
 #endif
@@ -0,0 +1,107 @@
+#include "./hexdump_test.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <unity.h>
+
+#include "../../utils/hexdump.h"
+
+static const u8 data[] = "Hello, world!\n\x00\x01\x02\xff";
+
+void test_hexdump_into_string(void) {
+    usize data_len = sizeof(data) - 1;
+
+    // Same with `xxd`
+    defer_string(dump) = HS_from_empty();
+    Hexdump_into(dump, data, data_len, (HexdumpOptions){0});
+    TEST_ASSERT_EQUAL_STRING(
+        HS_as_str(dump),
+        "00000000: 4865 6c6c 6f2c 2077 6f72 6c64 210a 0001  Hello, world!...\n"
+        "00000010: 02ff                                     ..\n");
+    TEST_ASSERT_EQUAL_UINT(
+        HS_length(dump),
+        Hexdump_output_length(data_len, (HexdumpOptions){0}));
+
+    // Empty input does nothing
+    Hexdump_into(dump, data, 0, (HexdumpOptions){0});
+    TEST_ASSERT_EQUAL_UINT(Hexdump_output_length(0, (HexdumpOptions){0}), 0);
+}
+
+void test_hexdump_options(void) {
+    usize data_len = sizeof(data) - 1;
+
+    // Same with `xxd -g 4 -c 8 -u`
+    HexdumpOptions options = {
+        .bytes_per_line = 8,
+        .group_size     = 4,
+        .upper_case     = true,
+    };
+    defer_string(dump) = HS_from_empty();
+    Hexdump_into(dump, data, data_len, options);
+    TEST_ASSERT_EQUAL_STRING(HS_as_str(dump),
+                             "00000000: 48656C6C 6F2C2077  Hello, w\n"
+                             "00000008: 6F726C64 210A0001  orld!...\n"
+                             "00000010: 02FF               ..\n");
+    TEST_ASSERT_EQUAL_UINT(HS_length(dump),
+                           Hexdump_output_length(data_len, options));
+
+    // No offset column and no ASCII gutter, the last line has no padding
+    HexdumpOptions hex_only = {
+        .bytes_per_line = 6,
+        .group_size     = 3,
+        .hide_offset    = true,
+        .hide_ascii     = true,
+    };
+    defer_string(hex_only_dump) = HS_from_empty();
+    Hexdump_into(hex_only_dump, data, data_len, hex_only);
+    TEST_ASSERT_EQUAL_STRING(HS_as_str(hex_only_dump),
+                             "48656c 6c6f2c\n"
+                             "20776f 726c64\n"
+                             "210a00 0102ff\n");
+    TEST_ASSERT_EQUAL_UINT(HS_length(hex_only_dump),
+                           Hexdump_output_length(data_len, hex_only));
+
+    // Wider offset column
+    HexdumpOptions big_offset = {.start_offset = 0xFFFFFFF8};
+    defer_string(big_offset_dump) = HS_from_empty();
+    Hexdump_into(big_offset_dump, data, 10, big_offset);
+    TEST_ASSERT_EQUAL_STRING(
+        HS_as_str(big_offset_dump),
+        "00000000fffffff8: 4865 6c6c 6f2c 2077 6f72"
+        "                 Hello, wor\n");
+    TEST_ASSERT_EQUAL_UINT(HS_length(big_offset_dump),
+                           Hexdump_output_length(10, big_offset));
+}
+
+void test_hexdump_to_fd(void) {
+    //
+    // Bigger than the internal block, the fd output should be the same with
+    // the `String` output
+    //
+    usize big_len = 10000;
+    u8 *big_data  = malloc(big_len);
+    for (usize index = 0; index < big_len; index++) {
+        big_data[index] = (u8)(index * 7);
+    }
+
+    defer_string(expected) = HS_from_empty();
+    Hexdump_into(expected, big_data, big_len, (HexdumpOptions){0});
+
+    char temp_filename[] = "/tmp/c_utils_hexdump_test_XXXXXX";
+    int fd               = mkstemp(temp_filename);
+    TEST_ASSERT_GREATER_THAN(-1, fd);
+    TEST_ASSERT_EQUAL(
+        Hexdump_to_fd(fd, big_data, big_len, (HexdumpOptions){0}),
+        true);
+
+    usize dump_len = HS_length(expected);
+    char *dump     = malloc(dump_len);
+    TEST_ASSERT_EQUAL_INT(pread(fd, dump, dump_len, 0), dump_len);
+    TEST_ASSERT_EQUAL_MEMORY(dump, HS_as_str(expected), dump_len);
+
+    close(fd);
+    unlink(temp_filename);
+    free(dump);
+    free(big_data);
+}
@@ -0,0 +1,8 @@
+#ifndef __HEXDUMP_TEST_H__
+#define __HEXDUMP_TEST_H__
+
+void test_hexdump_into_string(void);
+void test_hexdump_options(void);
+void test_hexdump_to_fd(void);
+
+#endif
@@ -0,0 +1,217 @@
+#include "./record_log_test.h"
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unity.h>
+
+#include "../../utils/record_log.h"
+
+//
+// Record `index`: `index % 200` bytes (include the empty one)
+//
+static usize test_record(usize index, char *out) {
+    usize len = index % 200;
+    for (usize offset = 0; offset < len; offset++) {
+        out[offset] = (char)(index * 31 + offset);
+    }
+
+    return len;
+}
+
+static void append_records(const char *folder,
+                           usize segment_size,
+                           usize from,
+                           usize to) {
+    defer_record_log(log) = RecordLog_open(
+        folder, (RecordLogOptions){.segment_size = segment_size});
+    TEST_ASSERT_NULL(RecordLog_get_error(log));
+
+    char record[256];
+    for (usize index = from; index < to; index++) {
+        usize len = test_record(index, record);
+        TEST_ASSERT_TRUE(RecordLog_append(log, record, len));
+    }
+}
+
+/*
+ * Read all records and check them, return the count
+ */
+static usize read_records(const char *folder) {
+    defer_record_log_reader(reader) = RecordLogReader_open(folder);
+    TEST_ASSERT_NOT_NULL(reader);
+
+    char expected[256];
+    StrView record;
+    usize count = 0;
+    while (RecordLogReader_next(reader, &record)) {
+        usize len = test_record(count, expected);
+        TEST_ASSERT_EQUAL_UINT(record.len, len);
+        TEST_ASSERT_EQUAL_MEMORY(record.ptr, expected, len);
+        count++;
+    }
+    TEST_ASSERT_NULL(RecordLogReader_get_error(reader));
+
+    return count;
+}
+
+static void remove_log_folder(const char *folder) {
+    defer_string_table(paths) = Dir_walk(folder, (DirWalkOptions){0});
+    for (usize index = 0; index < ST_len(paths); index++) {
+        unlink(ST_get(paths, index).ptr);
+    }
+    rmdir(folder);
+}
+
+/*
+ * The path of the last segment
+ */
+static void last_segment_path(const char *folder, char *out) {
+    defer_string_table(paths) =
+        Dir_walk(folder, (DirWalkOptions){.pattern = "*.log", .sort = true});
+    TEST_ASSERT_TRUE(ST_len(paths) > 0);
+    strcpy(out, ST_get(paths, ST_len(paths) - 1).ptr);
+}
+
+void test_record_log_append_and_read(void) {
+    char folder[] = "/tmp/c_utils_record_log_XXXXXX";
+    TEST_ASSERT_NOT_NULL(mkdtemp(folder));
+
+    //
+    // Empty log
+    //
+    TEST_ASSERT_NULL(RecordLogReader_open("/folder-that-not-exists"));
+    TEST_ASSERT_EQUAL_UINT(read_records(folder), 0);
+
+    //
+    // Small segments, so it rolls many times
+    //
+    append_records(folder, 4096, 0, 1000);
+    TEST_ASSERT_EQUAL_UINT(read_records(folder), 1000);
+
+    //
+    // Continue with the last segment
+    //
+    {
+        defer_record_log(log) =
+            RecordLog_open(folder, (RecordLogOptions){.segment_size = 4096});
+        TEST_ASSERT_NULL(RecordLog_get_error(log));
+        TEST_ASSERT_EQUAL_UINT(RecordLog_get_truncated_size(log), 0);
+        TEST_ASSERT_TRUE(RecordLog_get_segment(log) > 10);
+    }
+    append_records(folder, 4096, 1000, 1500);
+    TEST_ASSERT_EQUAL_UINT(read_records(folder), 1500);
+
+    //
+    // A record bigger than the segment size has a segment of its own
+    //
+    {
+        defer_record_log(log) =
+            RecordLog_open(folder, (RecordLogOptions){.segment_size = 64});
+        u64 segment = RecordLog_get_segment(log);
+
+        char big[1000];
+        memset(big, 'x', sizeof(big));
+        TEST_ASSERT_TRUE(RecordLog_append(log, big, sizeof(big)));
+        TEST_ASSERT_EQUAL_UINT(RecordLog_get_segment(log), segment + 1);
+        TEST_ASSERT_TRUE(RecordLog_append(log, "a", 1));
+        TEST_ASSERT_EQUAL_UINT(RecordLog_get_segment(log), segment + 2);
+    }
+
+    remove_log_folder(folder);
+}
+
+void test_record_log_torn_tail(void) {
+    char folder[] = "/tmp/c_utils_record_log_XXXXXX";
+    TEST_ASSERT_NOT_NULL(mkdtemp(folder));
+    append_records(folder, 0, 0, 100);
+
+    char segment_path[256];
+    last_segment_path(folder, segment_path);
+
+    //
+    // A crash in the middle of the record: half of the header, then the
+    // header without the payload, then the payload with the wrong `CRC`
+    //
+    const char *torn_tails[] = {
+        "\x05\x00\x00",
+        "\x05\x00\x00\x00\x12\x34\x56\x78",
+        "\x05\x00\x00\x00\x12\x34\x56\x78hello",
+    };
+    const usize torn_sizes[] = {3, 8, 13};
+    for (usize index = 0; index < 3; index++) {
+        int fd = open(segment_path, O_WRONLY | O_APPEND);
+        TEST_ASSERT_TRUE(fd >= 0);
+        TEST_ASSERT_EQUAL_INT(write(fd, torn_tails[index], torn_sizes[index]),
+                              torn_sizes[index]);
+        close(fd);
+
+        // The reader stops before the torn record without error
+        TEST_ASSERT_EQUAL_UINT(read_records(folder), 100 + index);
+
+        // Truncated on opening, then appended
+        defer_record_log(log) = RecordLog_open(folder, (RecordLogOptions){0});
+        TEST_ASSERT_NULL(RecordLog_get_error(log));
+        TEST_ASSERT_EQUAL_UINT(RecordLog_get_truncated_size(log),
+                               torn_sizes[index]);
+
+        char record[256];
+        usize len = test_record(100 + index, record);
+        TEST_ASSERT_TRUE(RecordLog_append(log, record, len));
+        TEST_ASSERT_TRUE(RecordLog_flush(log));
+        TEST_ASSERT_EQUAL_UINT(read_records(folder), 101 + index);
+    }
+
+    //
+    // Torn in the middle of the last record payload
+    //
+    struct stat segment_stat;
+    TEST_ASSERT_EQUAL_INT(stat(segment_path, &segment_stat), 0);
+    TEST_ASSERT_EQUAL_INT(truncate(segment_path, segment_stat.st_size - 1), 0);
+    TEST_ASSERT_EQUAL_UINT(read_records(folder), 102);
+    {
+        defer_record_log(log) = RecordLog_open(folder, (RecordLogOptions){0});
+        TEST_ASSERT_EQUAL_UINT(RecordLog_get_truncated_size(log),
+                               RECORD_LOG_HEADER_SIZE + 102 - 1);
+    }
+    TEST_ASSERT_EQUAL_UINT(read_records(folder), 102);
+
+    remove_log_folder(folder);
+}
+
+void test_record_log_broken_record(void) {
+    char folder[] = "/tmp/c_utils_record_log_XXXXXX";
+    TEST_ASSERT_NOT_NULL(mkdtemp(folder));
+    append_records(folder, 4096, 0, 200);
+
+    //
+    // Flip the payload byte of the 2nd record (the 1st one is empty) in the
+    // first segment, it's not a torn tail
+    //
+    char segment_path[256];
+    sprintf(segment_path, "%s/%020d.log", folder, 0);
+    int fd = open(segment_path, O_RDWR);
+    TEST_ASSERT_TRUE(fd >= 0);
+    char byte;
+    usize offset = 8 + RECORD_LOG_HEADER_SIZE * 2;
+    TEST_ASSERT_EQUAL_INT(pread(fd, &byte, 1, offset), 1);
+    byte ^= 0x01;
+    TEST_ASSERT_EQUAL_INT(pwrite(fd, &byte, 1, offset), 1);
+    close(fd);
+
+    defer_record_log_reader(reader) = RecordLogReader_open(folder);
+    StrView record;
+    TEST_ASSERT_TRUE(RecordLogReader_next(reader, &record));
+    TEST_ASSERT_EQUAL_UINT(record.len, 0);
+    TEST_ASSERT_FALSE(RecordLogReader_next(reader, &record));
+    TEST_ASSERT_NOT_NULL(RecordLogReader_get_error(reader));
+    TEST_ASSERT_NOT_NULL(strstr(RecordLogReader_get_error(reader),
+                                "Broken record at 16"));
+
+    // Stay at the error
+    TEST_ASSERT_FALSE(RecordLogReader_next(reader, &record));
+
+    remove_log_folder(folder);
+}
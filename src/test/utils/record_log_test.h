@@ -0,0 +1,8 @@
+#ifndef __RECORD_LOG_TEST_H__
+#define __RECORD_LOG_TEST_H__
+
+void test_record_log_append_and_read(void);
+void test_record_log_torn_tail(void);
+void test_record_log_broken_record(void);
+
+#endif
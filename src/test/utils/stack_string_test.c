@@ -0,0 +1,86 @@
+#include "./stack_string_test.h"
+
+#include <string.h>
+#include <unity.h>
+
+#include "../../utils/stack_string.h"
+
+void test_stack_string_push_and_insert(void) {
+    defer_stack_string(str, 32);
+    TEST_ASSERT_EQUAL_UINT(SS_length(str), 0);
+    TEST_ASSERT_EQUAL_UINT(SS_capacity(str), 32);
+    TEST_ASSERT_EQUAL_STRING(SS_as_str(str), "");
+
+    TEST_ASSERT_EQUAL(SS_push_str(str, "world"), true);
+    TEST_ASSERT_EQUAL(SS_insert_str_to_begin(str, "Hello, "), true);
+    TEST_ASSERT_EQUAL(
+        SS_push_view(str, (StrView){.ptr = "!!!???", .len = 3}),
+        true);
+    TEST_ASSERT_EQUAL_STRING(SS_as_str(str), "Hello, world!!!");
+    TEST_ASSERT_EQUAL_UINT(SS_length(str), 15);
+
+    defer_string(heap_str) = HS_from_str(" :)");
+    TEST_ASSERT_EQUAL(SS_push_other(str, heap_str), true);
+    TEST_ASSERT_EQUAL_STRING(SS_as_str(str), "Hello, world!!! :)");
+
+    StrView view = SS_as_view(str);
+    TEST_ASSERT_EQUAL_PTR(view.ptr, SS_as_str(str));
+    TEST_ASSERT_EQUAL_UINT(view.len, 18);
+
+    SS_reset_to_empty(str);
+    TEST_ASSERT_EQUAL_UINT(SS_length(str), 0);
+    TEST_ASSERT_EQUAL_STRING(SS_as_str(str), "");
+}
+
+void test_stack_string_overflow(void) {
+    StackString(8) storage = STACK_STRING_INIT(8);
+    StackStr str           = SS_from_storage(&storage);
+
+    // 7 characters + `\0` is exactly the capacity
+    TEST_ASSERT_EQUAL(SS_push_str(str, "1234567"), true);
+    TEST_ASSERT_EQUAL(SS_is_overflow(str), false);
+
+    // Doesn't fit, nothing changes
+    TEST_ASSERT_EQUAL(SS_push_str(str, "8"), false);
+    TEST_ASSERT_EQUAL(SS_insert_str_to_begin(str, "0"), false);
+    TEST_ASSERT_EQUAL(SS_is_overflow(str), true);
+    TEST_ASSERT_EQUAL_STRING(SS_as_str(str), "1234567");
+
+    SS_reset_to_empty(str);
+    TEST_ASSERT_EQUAL(SS_is_overflow(str), false);
+    TEST_ASSERT_EQUAL(SS_push_str(str, "12345678"), false);
+    TEST_ASSERT_EQUAL_UINT(SS_length(str), 0);
+}
+
+void test_stack_string_find_and_compare(void) {
+    defer_stack_string(path, 64);
+    SS_push_str(path, "/usr/Local/bin");
+
+    TEST_ASSERT_EQUAL_INT(SS_index_of(path, "local"), 5);
+    TEST_ASSERT_EQUAL_INT(SS_index_of_case_sensitive(path, "local"), -1);
+    TEST_ASSERT_EQUAL_INT(SS_index_of_case_sensitive(path, "Local"), 5);
+    TEST_ASSERT_EQUAL(SS_contains(path, "BIN"), true);
+    TEST_ASSERT_EQUAL(SS_contains(path, "sbin"), false);
+
+    defer_stack_string(other_path, 32);
+    SS_push_str(other_path, "/USR/LOCAL/BIN");
+    TEST_ASSERT_EQUAL(SS_equals_ignore_case(path, other_path), true);
+    TEST_ASSERT_EQUAL_INT(SS_compare_ignore_case(path, other_path), 0);
+    TEST_ASSERT_GREATER_THAN(0, SS_compare(path, other_path));
+    TEST_ASSERT_EQUAL_INT(SS_compare(path, path), 0);
+}
+
+void test_stack_string_to_string(void) {
+    defer_stack_string(str, 16);
+    SS_push_str(str, "promote me");
+
+    defer_string(heap_str) = SS_to_string(str);
+    TEST_ASSERT_EQUAL_UINT(HS_length(heap_str), 10);
+    TEST_ASSERT_EQUAL_UINT(HS_capacity(heap_str), 11);
+    TEST_ASSERT_EQUAL_STRING(HS_as_str(heap_str), "promote me");
+    TEST_ASSERT_TRUE(HS_as_str(heap_str) != SS_as_str(str));
+
+    defer_stack_string(empty_str, 16);
+    defer_string(empty_heap_str) = SS_to_string(empty_str);
+    TEST_ASSERT_EQUAL_UINT(HS_length(empty_heap_str), 0);
+}
@@ -0,0 +1,9 @@
+#ifndef __STACK_STRING_TEST_H__
+#define __STACK_STRING_TEST_H__
+
+void test_stack_string_push_and_insert(void);
+void test_stack_string_overflow(void);
+void test_stack_string_find_and_compare(void);
+void test_stack_string_to_string(void);
+
+#endif
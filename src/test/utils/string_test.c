@@ -3,7 +3,9 @@
 #include <string.h>
 #include <unity.h>
 
+#include "../../utils/arena.h"
 #include "../../utils/heap_string.h"
+#include "../../utils/utf8.h"
 
 void test_string_init(void) {
     struct HeapString str;
@@ -237,3 +239,185 @@ void test_string_move_semantic(void) {
     TEST_ASSERT_EQUAL_UINT(HS_capacity(clone_from_s1), 0);
     TEST_ASSERT_NULL(HS_as_str(clone_from_s1));
 }
+
+void test_string_utf8_validation(void) {
+    defer_string(empty_str) = HS_from_empty();
+    TEST_ASSERT_EQUAL(HS_is_valid_utf8(empty_str), true);
+
+    defer_string(ascii_str) = HS_from_str("Hello world:)");
+    TEST_ASSERT_EQUAL(HS_is_valid_utf8(ascii_str), true);
+
+    // "你好€😀" in the middle, longer than 32 bytes to use the SIMD path
+    defer_string(utf8_str) = HS_from_str(
+        "abcdefghijklmnopqrstuvwxyz0123456789\xE4\xBD\xA0\xE5\xA5\xBD"
+        "\xE2\x82\xAC\xF0\x9F\x98\x80"
+        "abcdefghijklmnopqrstuvwxyz0123456789");
+    TEST_ASSERT_EQUAL(HS_is_valid_utf8(utf8_str), true);
+
+    // Truncated sequence at the end
+    TEST_ASSERT_EQUAL(Utf8_is_valid("abc\xE2\x82", 5), false);
+
+    // Continuation without lead byte
+    TEST_ASSERT_EQUAL(Utf8_is_valid("abc\x80" "def", 7), false);
+
+    // Overlong `/`
+    TEST_ASSERT_EQUAL(Utf8_is_valid("\xC0\xAF", 2), false);
+
+    // Surrogate U+D800
+    TEST_ASSERT_EQUAL(Utf8_is_valid("\xED\xA0\x80", 3), false);
+
+    // Greater than U+10FFFF
+    TEST_ASSERT_EQUAL(Utf8_is_valid("\xF4\x90\x80\x80", 4), false);
+
+    //
+    // Sequence crosses the 32 bytes block boundary: 31 ASCII + "€"
+    //
+    char cross_block[35] = {0};
+    memset(cross_block, 'a', 31);
+    memcpy(cross_block + 31, "\xE2\x82\xAC", 3);
+    TEST_ASSERT_EQUAL(Utf8_is_valid(cross_block, 34), true);
+    TEST_ASSERT_EQUAL(Utf8_is_valid(cross_block, 33), false);
+
+    // Lead byte right at the end of the block: 31 ASCII + "\xE2"
+    TEST_ASSERT_EQUAL(Utf8_is_valid(cross_block, 32), false);
+}
+
+void test_string_utf8_char_count(void) {
+    defer_string(empty_str) = HS_from_empty();
+    TEST_ASSERT_EQUAL_UINT(HS_utf8_char_count(empty_str), 0);
+
+    defer_string(ascii_str) = HS_from_str("Hello world:)");
+    TEST_ASSERT_EQUAL_UINT(HS_utf8_char_count(ascii_str),
+                           HS_length(ascii_str));
+
+    defer_string(utf8_str) = HS_from_str(
+        "abcdefghijklmnopqrstuvwxyz0123456789\xE4\xBD\xA0\xE5\xA5\xBD"
+        "\xE2\x82\xAC\xF0\x9F\x98\x80"
+        "abcdefghijklmnopqrstuvwxyz0123456789");
+    TEST_ASSERT_EQUAL_UINT(HS_length(utf8_str), 36 + 6 + 3 + 4 + 36);
+    TEST_ASSERT_EQUAL_UINT(HS_utf8_char_count(utf8_str), 36 + 2 + 1 + 1 + 36);
+}
+
+void test_string_utf8_iterator(void) {
+    defer_string(utf8_str) =
+        HS_from_str("a\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80");
+
+    u32 expected[] = {0x61, 0xE9, 0x20AC, 0x1F600};
+    usize index    = 0;
+    u32 code_point = 0;
+
+    Utf8Iteractor iter = Utf8_iter(HS_as_view(utf8_str));
+    while (Utf8_iter_next(&iter, &code_point)) {
+        TEST_ASSERT_EQUAL_UINT(code_point, expected[index]);
+        index++;
+    }
+    TEST_ASSERT_EQUAL_UINT(index, 4);
+
+    //
+    // Invalid byte yields `U+FFFD` and skips one byte only
+    //
+    char invalid[] = "a\xFF" "b";
+    StrView view   = {.ptr = invalid, .len = 3};
+    iter           = Utf8_iter(view);
+    TEST_ASSERT_EQUAL(Utf8_iter_next(&iter, &code_point), true);
+    TEST_ASSERT_EQUAL_UINT(code_point, 'a');
+    TEST_ASSERT_EQUAL(Utf8_iter_next(&iter, &code_point), true);
+    TEST_ASSERT_EQUAL_UINT(code_point, UTF8_REPLACEMENT_CHAR);
+    TEST_ASSERT_EQUAL(Utf8_iter_next(&iter, &code_point), true);
+    TEST_ASSERT_EQUAL_UINT(code_point, 'b');
+    TEST_ASSERT_EQUAL(Utf8_iter_next(&iter, &code_point), false);
+}
+
+void test_string_case_conversion(void) {
+    defer_string(str) = HS_from_str(
+        "Content-Type: Text/HTML; charset=UTF-8 \xC3\x89t\xC3\xA9 [@`{~]");
+
+    HS_to_lower(str);
+    TEST_ASSERT_EQUAL_STRING(
+        HS_as_str(str),
+        "content-type: text/html; charset=utf-8 \xC3\x89t\xC3\xA9 [@`{~]");
+
+    HS_to_upper(str);
+    TEST_ASSERT_EQUAL_STRING(
+        HS_as_str(str),
+        "CONTENT-TYPE: TEXT/HTML; CHARSET=UTF-8 \xC3\x89T\xC3\xA9 [@`{~]");
+
+    defer_string(empty_str) = HS_from_empty();
+    HS_to_lower(empty_str);
+    TEST_ASSERT_NULL(HS_as_str(empty_str));
+}
+
+void test_string_compare(void) {
+    defer_string(s1) =
+        HS_from_str("X-Forwarded-For-Some-Very-Long-Header-Key-Name");
+    defer_string(s2) =
+        HS_from_str("x-forwarded-for-some-very-long-header-key-name");
+    defer_string(s3) =
+        HS_from_str("x-forwarded-for-some-very-long-header-key-namf");
+    defer_string(s4) = HS_from_str("x-forwarded-for");
+
+    TEST_ASSERT_EQUAL(HS_equals_ignore_case(s1, s2), true);
+    TEST_ASSERT_EQUAL(HS_equals_ignore_case(s1, s3), false);
+    TEST_ASSERT_EQUAL(HS_equals_ignore_case(s1, s4), false);
+    TEST_ASSERT_EQUAL(HS_equals_ignore_case(NULL, NULL), true);
+
+    TEST_ASSERT_EQUAL_INT(HS_compare_ignore_case(s1, s2), 0);
+    TEST_ASSERT_LESS_THAN(0, HS_compare_ignore_case(s2, s3));
+    TEST_ASSERT_GREATER_THAN(0, HS_compare_ignore_case(s3, s2));
+    TEST_ASSERT_GREATER_THAN(0, HS_compare_ignore_case(s2, s4));
+
+    // `X` (0x58) is less than `x` (0x78)
+    TEST_ASSERT_LESS_THAN(0, HS_compare(s1, s2));
+    TEST_ASSERT_EQUAL_INT(HS_compare(s2, s2), 0);
+    TEST_ASSERT_LESS_THAN(0, HS_compare(s4, s2));
+    TEST_ASSERT_GREATER_THAN(0, HS_compare(s4, NULL));
+}
+
+void test_string_hash_ignore_case(void) {
+    defer_string(s1) = HS_from_str("Content-Type");
+    defer_string(s2) = HS_from_str("content-type");
+    defer_string(s3) = HS_from_str("content-typf");
+
+    TEST_ASSERT_EQUAL(HS_hash_ignore_case(s1) == HS_hash_ignore_case(s2),
+                      true);
+    TEST_ASSERT_EQUAL(HS_hash_ignore_case(s1) == HS_hash_ignore_case(s3),
+                      false);
+}
+
+void test_string_arena_owned(void) {
+    defer_arena(arena) = Arena_new(0);
+
+    defer_string(s1) = HS_from_str_in(arena, "Hello");
+    TEST_ASSERT_EQUAL(HS_is_arena_owned(s1), true);
+    TEST_ASSERT_EQUAL_UINT(HS_length(s1), 5);
+    TEST_ASSERT_EQUAL_STRING(HS_as_str(s1), "Hello");
+
+    // Push and insert grow inside the arena
+    HS_push_str(s1, ", world");
+    HS_insert_str_to_begin(s1, ">>> ");
+    TEST_ASSERT_EQUAL_STRING(HS_as_str(s1), ">>> Hello, world");
+    TEST_ASSERT_EQUAL_UINT(HS_length(s1), 16);
+
+    defer_string(s2) = HS_from_empty_in(arena);
+    TEST_ASSERT_NULL(HS_as_str(s2));
+    HS_push_other(s2, s1);
+    TEST_ASSERT_EQUAL_STRING(HS_as_str(s2), ">>> Hello, world");
+
+    defer_string(heap_str) = HS_from_str("heap");
+    defer_string(s3)       = HS_clone_from_in(arena, heap_str);
+    TEST_ASSERT_EQUAL(HS_is_arena_owned(s3), true);
+    TEST_ASSERT_EQUAL(HS_is_arena_owned(heap_str), false);
+    TEST_ASSERT_EQUAL_STRING(HS_as_str(s3), "heap");
+
+    // Moved `String` stays in the same arena
+    defer_string(s4) = HS_move_from(s3);
+    TEST_ASSERT_EQUAL(HS_is_arena_owned(s4), true);
+    TEST_ASSERT_EQUAL_STRING(HS_as_str(s4), "heap");
+    TEST_ASSERT_NULL(HS_as_str(s3));
+
+    // Explicit free is a no-op as well, `defer_string` calls it again
+    HS_free(s2);
+    TEST_ASSERT_EQUAL_STRING(HS_as_str(s2), ">>> Hello, world");
+
+    TEST_ASSERT_NULL(HS_from_str_in(NULL, "no arena"));
+}
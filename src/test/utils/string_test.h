@@ -15,5 +15,12 @@ void test_string_reset_to_empty_without_freeing_buffer(void);
 void test_string_push(void);
 void test_string_insert_at_begin(void);
 void test_string_move_semantic(void);
+void test_string_utf8_validation(void);
+void test_string_utf8_char_count(void);
+void test_string_utf8_iterator(void);
+void test_string_case_conversion(void);
+void test_string_compare(void);
+void test_string_hash_ignore_case(void);
+void test_string_arena_owned(void);
 
 #endif
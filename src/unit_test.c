@@ -1,9 +1,19 @@
 #include <unity.h>
 
+#include "./test/utils/arena_test.h"
+#include "./test/utils/base64_test.h"
+#include "./test/utils/byte_buf_test.h"
+#include "./test/utils/checksum_test.h"
+#include "./test/utils/collections/string_table_test.h"
 #include "./test/utils/collections/vector_test.h"
+#include "./test/utils/csv_test.h"
 #include "./test/utils/data_types_test.h"
+#include "./test/utils/external_sort_test.h"
 #include "./test/utils/file_test.h"
 #include "./test/utils/hex_buffer_test.h"
+#include "./test/utils/hexdump_test.h"
+#include "./test/utils/record_log_test.h"
+#include "./test/utils/stack_string_test.h"
 #include "./test/utils/string_test.h"
 
 ///
@@ -29,6 +39,33 @@ int main(void) {
     RUN_TEST(test_hex_buffer_empty_hex_buffer);
     RUN_TEST(test_hex_buffer_invalid_buffer);
     RUN_TEST(test_hex_buffer_valid_buffer);
+    RUN_TEST(test_hex_buffer_from_bytes);
+    RUN_TEST(test_hex_buffer_from_bytes_strict);
+    RUN_TEST(test_hex_buffer_encode);
+    RUN_TEST(test_hex_buffer_encode_into_string);
+    RUN_TEST(test_hex_buffer_streaming_decoder);
+    RUN_TEST(test_hex_buffer_streaming_encoder);
+    RUN_TEST(test_hex_buffer_compare_and_xor);
+    RUN_TEST(test_hex_buffer_bytewise_operations);
+
+    RUN_TEST(test_hexdump_into_string);
+    RUN_TEST(test_hexdump_options);
+    RUN_TEST(test_hexdump_to_fd);
+
+    RUN_TEST(test_byte_buf_put_get);
+    RUN_TEST(test_byte_buf_varint);
+    RUN_TEST(test_byte_buf_slice_and_wrap);
+    RUN_TEST(test_byte_buf_hex_buffer);
+
+    RUN_TEST(test_checksum_known_values);
+    RUN_TEST(test_checksum_streaming);
+    RUN_TEST(test_checksum_hex_buffer);
+
+    RUN_TEST(test_base64_rfc4648_vectors);
+    RUN_TEST(test_base64_url_and_no_padding);
+    RUN_TEST(test_base64_strict_validation);
+    RUN_TEST(test_base64_big_buffer);
+    RUN_TEST(test_base64_streaming);
 
     RUN_TEST(test_data_types_type_name);
     RUN_TEST(test_data_types_is_the_same_type);
@@ -39,6 +76,31 @@ int main(void) {
     RUN_TEST(test_file_open_should_fail);
     RUN_TEST(test_file_open_should_success);
     RUN_TEST(test_file_read_should_success);
+    RUN_TEST(test_file_map_should_success);
+    RUN_TEST(test_file_map_should_fail);
+    RUN_TEST(test_file_read_line);
+    RUN_TEST(test_file_append_and_save);
+    RUN_TEST(test_file_append_with_reads);
+    RUN_TEST(test_file_load_many);
+    RUN_TEST(test_dir_walk);
+    RUN_TEST(test_file_copy_and_send);
+    RUN_TEST(test_file_load_unknown_size);
+    RUN_TEST(test_file_watch_and_reload);
+    RUN_TEST(test_file_print_like_bat);
+
+    RUN_TEST(test_csv_rfc4180);
+    RUN_TEST(test_csv_generated_rows);
+    RUN_TEST(test_csv_tsv_parallel);
+    RUN_TEST(test_csv_streaming_file);
+    RUN_TEST(test_csv_unterminated_quote);
+
+    RUN_TEST(test_record_log_append_and_read);
+    RUN_TEST(test_record_log_torn_tail);
+    RUN_TEST(test_record_log_broken_record);
+
+    RUN_TEST(test_external_sort_lines);
+    RUN_TEST(test_external_sort_runs);
+    RUN_TEST(test_external_sort_field_key);
 
     RUN_TEST(test_string_init);
     RUN_TEST(test_string_init_with_capacity);
@@ -54,6 +116,18 @@ int main(void) {
     RUN_TEST(test_string_push);
     RUN_TEST(test_string_insert_at_begin);
     RUN_TEST(test_string_move_semantic);
+    RUN_TEST(test_string_utf8_validation);
+    RUN_TEST(test_string_utf8_char_count);
+    RUN_TEST(test_string_utf8_iterator);
+    RUN_TEST(test_string_case_conversion);
+    RUN_TEST(test_string_compare);
+    RUN_TEST(test_string_hash_ignore_case);
+    RUN_TEST(test_string_arena_owned);
+
+    RUN_TEST(test_stack_string_push_and_insert);
+    RUN_TEST(test_stack_string_overflow);
+    RUN_TEST(test_stack_string_find_and_compare);
+    RUN_TEST(test_stack_string_to_string);
 
     RUN_TEST(test_vector_empty_vector);
     RUN_TEST(test_vector_empty_vector_with_capacity);
@@ -62,6 +136,17 @@ int main(void) {
     RUN_TEST(test_vector_immutable_get);
     RUN_TEST(test_vector_null);
 
+    RUN_TEST(test_string_table_empty);
+    RUN_TEST(test_string_table_split);
+    RUN_TEST(test_string_table_multi_char_delimiter);
+    RUN_TEST(test_string_table_sort);
+    RUN_TEST(test_string_table_to_vector);
+    RUN_TEST(test_string_table_from_packed);
+
+    RUN_TEST(test_arena_alloc);
+    RUN_TEST(test_arena_realloc);
+    RUN_TEST(test_arena_reset);
+
     UNITY_END();
     return 0;
 }
@@ -0,0 +1,243 @@
+#include "arena.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef ENABLE_DEBUG_LOG
+    #include "log.h"
+#endif
+
+//
+// Chunk, the bytes follow the header directly (one `malloc` per chunk). The
+// header is padded, so `_data` starts at an `ARENA_ALIGNMENT` boundary.
+//
+typedef struct _ArenaChunk {
+    struct _ArenaChunk *_prev;
+    usize _capacity;
+    usize _offset;
+    __attribute__((aligned(ARENA_ALIGNMENT))) u8 _data[];
+} ArenaChunk;
+
+/*
+ * Arena
+ */
+struct _Arena {
+    usize _chunk_size;
+
+    // Bytes used by all the chunks before `_current`
+    usize _used_in_prev_chunks;
+
+    // Current chunk, the older chunks are linked by `_prev`
+    ArenaChunk *_current;
+
+    // The latest allocation, only this one is able to grow in-place
+    u8 *_last_alloc;
+};
+
+//
+// Round up to `ARENA_ALIGNMENT`
+//
+static inline usize arena_align_up(usize size) {
+    return (size + (ARENA_ALIGNMENT - 1)) & ~(usize)(ARENA_ALIGNMENT - 1);
+}
+
+//
+// Allocate a new chunk that is able to hold at least `min_size` bytes and
+// make it the current chunk
+//
+static ArenaChunk *arena_add_chunk(Arena self, usize min_size) {
+    usize capacity =
+        (min_size > self->_chunk_size) ? arena_align_up(min_size)
+                                       : self->_chunk_size;
+
+    ArenaChunk *chunk = malloc(sizeof(ArenaChunk) + capacity);
+    if (chunk == NULL) return NULL;
+
+    chunk->_prev     = self->_current;
+    chunk->_capacity = capacity;
+    chunk->_offset   = 0;
+
+    if (self->_current != NULL) {
+        self->_used_in_prev_chunks += self->_current->_offset;
+    }
+    self->_current = chunk;
+
+#ifdef ENABLE_DEBUG_LOG
+    DEBUG_LOG(Arena,
+              add_chunk,
+              "self ptr: %p, chunk ptr: %p, capacity: %lu",
+              self,
+              chunk,
+              capacity);
+#endif
+
+    return chunk;
+}
+
+/*
+ * Create an arena
+ */
+Arena Arena_new(usize chunk_size) {
+    Arena arena = malloc(sizeof(struct _Arena));
+
+    *arena = (struct _Arena){
+        ._chunk_size = arena_align_up(
+            chunk_size > 0 ? chunk_size : ARENA_DEFAULT_CHUNK_SIZE),
+        ._used_in_prev_chunks = 0,
+        ._current             = NULL,
+        ._last_alloc          = NULL,
+    };
+
+#ifdef ENABLE_DEBUG_LOG
+    DEBUG_LOG(Arena,
+              new,
+              "self ptr: %p, chunk_size: %lu",
+              arena,
+              arena->_chunk_size);
+#endif
+
+    return arena;
+}
+
+/*
+ * Allocate `size` bytes (NOT zeroed)
+ */
+void *Arena_alloc(Arena self, usize size) {
+    if (self == NULL) return NULL;
+
+    usize aligned_size = arena_align_up(size > 0 ? size : 1);
+    ArenaChunk *chunk  = self->_current;
+
+    if (chunk == NULL || chunk->_capacity - chunk->_offset < aligned_size) {
+        chunk = arena_add_chunk(self, aligned_size);
+        if (chunk == NULL) return NULL;
+    }
+
+    u8 *ptr = chunk->_data + chunk->_offset;
+    chunk->_offset += aligned_size;
+    self->_last_alloc = ptr;
+
+    return ptr;
+}
+
+/*
+ * Resize the allocation `ptr` from `old_size` to `new_size` bytes
+ */
+void *Arena_realloc(Arena self, void *ptr, usize old_size, usize new_size) {
+    if (self == NULL) return NULL;
+    if (ptr == NULL) return Arena_alloc(self, new_size);
+
+    //
+    // The latest allocation only needs to move the offset
+    //
+    ArenaChunk *chunk = self->_current;
+    if (ptr == self->_last_alloc && chunk != NULL) {
+        usize start        = (u8 *)ptr - chunk->_data;
+        usize aligned_size = arena_align_up(new_size > 0 ? new_size : 1);
+        if (chunk->_capacity - start >= aligned_size) {
+            chunk->_offset = start + aligned_size;
+            return ptr;
+        }
+    }
+
+    if (new_size <= old_size) return ptr;
+
+    void *new_ptr = Arena_alloc(self, new_size);
+    if (new_ptr != NULL) memcpy(new_ptr, ptr, old_size);
+
+    return new_ptr;
+}
+
+/*
+ * Return the total bytes allocated since the last reset
+ */
+usize Arena_used(const Arena self) {
+    if (self == NULL) return 0;
+
+    return self->_used_in_prev_chunks +
+           (self->_current != NULL ? self->_current->_offset : 0);
+}
+
+/*
+ * Return the total bytes of all chunks
+ */
+usize Arena_capacity(const Arena self) {
+    if (self == NULL) return 0;
+
+    usize capacity    = 0;
+    ArenaChunk *chunk = self->_current;
+    while (chunk != NULL) {
+        capacity += chunk->_capacity;
+        chunk = chunk->_prev;
+    }
+
+    return capacity;
+}
+
+//
+// Free all chunks
+//
+static void arena_free_chunks(Arena self) {
+    ArenaChunk *chunk = self->_current;
+    while (chunk != NULL) {
+        ArenaChunk *prev = chunk->_prev;
+        free(chunk);
+        chunk = prev;
+    }
+
+    self->_current             = NULL;
+    self->_used_in_prev_chunks = 0;
+    self->_last_alloc          = NULL;
+}
+
+/*
+ * Release all allocations at once
+ */
+void Arena_reset(Arena self) {
+    if (self == NULL || self->_current == NULL) return;
+
+    //
+    // More than one chunk means the chunk size is too small for one round,
+    // replace them with a single chunk that is able to hold all of them.
+    //
+    if (self->_current->_prev != NULL) {
+        usize total_capacity = Arena_capacity(self);
+        arena_free_chunks(self);
+        arena_add_chunk(self, total_capacity);
+    } else {
+        self->_current->_offset = 0;
+        self->_last_alloc       = NULL;
+    }
+
+#ifdef ENABLE_DEBUG_LOG
+    DEBUG_LOG(Arena,
+              reset,
+              "self ptr: %p, capacity: %lu",
+              self,
+              Arena_capacity(self));
+#endif
+}
+
+/*
+ * Free all chunks and the arena itself
+ */
+void Arena_free(Arena self) {
+    if (self == NULL) return;
+
+    arena_free_chunks(self);
+    free(self);
+}
+
+/*
+ *
+ */
+void auto_free_arena(Arena *ptr) {
+#ifdef ENABLE_DEBUG_LOG
+    DEBUG_LOG(Arena,
+              auto_free_arena,
+              "out of scope with arena ptr: %p, used: %lu",
+              *ptr,
+              Arena_used(*ptr));
+#endif
+    Arena_free(*ptr);
+}
@@ -0,0 +1,90 @@
+#ifndef __UTILS_ARENA_H__
+#define __UTILS_ARENA_H__
+
+#include "data_types.h"
+
+/*
+ * Arena: Bump allocator for the short-lived memory (request-scoped, frame
+ * scoped, etc).
+ *
+ * Memory comes from a linked list of big chunks, each allocation only moves
+ * the current chunk offset forward. Nothing gets freed one by one,
+ * `Arena_reset` releases all allocations at once and keeps the memory for
+ * the next round, `Arena_free` gives everything back to the system.
+ */
+typedef struct _Arena *Arena;
+
+/*
+ * Default chunk size when `Arena_new` gets `0`
+ */
+#define ARENA_DEFAULT_CHUNK_SIZE 4096
+
+/*
+ * Every allocation is aligned to this value
+ */
+#define ARENA_ALIGNMENT 16
+
+/*
+ *
+ */
+void auto_free_arena(Arena *ptr);
+
+/*
+ * Define smart `Arena` var that calls `Arena_free()` automatically when the
+ * variable is out of the scope
+ *
+ * ```c
+ * defer_arena(request_arena) = Arena_new(0);
+ * ```
+ */
+#define defer_arena(x) __attribute__((cleanup(auto_free_arena))) Arena x
+
+/*
+ * Create an arena, `chunk_size` is the size of each chunk (`0` means
+ * `ARENA_DEFAULT_CHUNK_SIZE`). The first chunk is allocated lazily.
+ */
+Arena Arena_new(usize chunk_size);
+
+/*
+ * Allocate `size` bytes (NOT zeroed), return `NULL` if `self` is `NULL` or
+ * out of memory. The memory is valid until `Arena_reset` or `Arena_free`.
+ */
+void *Arena_alloc(Arena self, usize size);
+
+/*
+ * Resize the allocation `ptr` from `old_size` to `new_size` bytes:
+ *
+ * - If `ptr` is the latest allocation and the current chunk has enough
+ *   space, it grows in-place and returns `ptr`.
+ *
+ * - Otherwise, allocate a new block and copy `old_size` bytes to it, the old
+ *   block stays in the arena until reset.
+ *
+ * `ptr == NULL` works like `Arena_alloc`.
+ */
+void *Arena_realloc(Arena self, void *ptr, usize old_size, usize new_size);
+
+/*
+ * Return the total bytes allocated since the last reset
+ */
+usize Arena_used(const Arena self);
+
+/*
+ * Return the total bytes of all chunks
+ */
+usize Arena_capacity(const Arena self);
+
+/*
+ * Release all allocations at once without giving memory back to the system,
+ * all pointers allocated before become invalid. It's O(1) for a single chunk
+ * arena. If more than one chunk was needed, they're merged into one big
+ * chunk, so the next round fits in a single chunk.
+ */
+void Arena_reset(Arena self);
+
+/*
+ * Free all chunks and the arena itself
+ */
+void Arena_free(Arena self);
+
+#endif
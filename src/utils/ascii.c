@@ -0,0 +1,313 @@
+#include "ascii.h"
+
+#include <string.h>
+
+#include "simd.h"
+
+//
+// Every function below runs the widest path first, each path returns the
+// index it has processed (or the index it stopped at), then the narrower
+// path continues from there:
+//
+// AVX2 (32 bytes, runtime check) -> SSE2 (16 bytes) -> u64 (8 bytes) -> u8
+//
+
+#define ASCII_ONES 0x0101010101010101ULL
+#define ASCII_HIGH_BITS 0x8080808080808080ULL
+
+//
+// Lower case a single byte
+//
+static inline u8 ascii_lower_char(u8 c) {
+    return (u8)(c - 'A') < 26 ? c + ('a' - 'A') : c;
+}
+
+//
+// Flip the case of all bytes in range `first ~ first + 25` within a `u64`
+// word (8 bytes at a time, no SIMD instruction needed):
+//
+// - `first = 'A'` converts to lower case
+// - `first = 'a'` converts to upper case
+//
+static inline u64 ascii_flip_case_word(u64 word, u8 first) {
+    u64 heptets     = word & ~ASCII_HIGH_BITS;
+    u64 is_gt_last  = heptets + (0x7F - (first + 25)) * ASCII_ONES;
+    u64 is_ge_first = heptets + (0x80 - first) * ASCII_ONES;
+    u64 is_ascii    = ~word & ASCII_HIGH_BITS;
+    u64 in_range    = is_ascii & (is_ge_first ^ is_gt_last) & ASCII_HIGH_BITS;
+
+    // `0x80 >> 2` is the `0x20` case bit
+    return word ^ (in_range >> 2);
+}
+
+#ifdef SIMD_X86_64
+
+//
+// Byte range trick: shift the range so that `first` becomes `-128` (signed),
+// then a single signed compare tells whether a byte is in the 26 letters
+// range or not.
+//
+static inline __m128i ascii_flip_case_sse2(__m128i v, u8 first) {
+    __m128i shifted  = _mm_add_epi8(v, _mm_set1_epi8((char)(128 - first)));
+    __m128i in_range = _mm_cmplt_epi8(shifted, _mm_set1_epi8(-128 + 26));
+    return _mm_xor_si128(v, _mm_and_si128(in_range, _mm_set1_epi8(0x20)));
+}
+
+SIMD_TARGET("avx2")
+static inline __m256i ascii_flip_case_avx2(__m256i v, u8 first) {
+    __m256i shifted =
+        _mm256_add_epi8(v, _mm256_set1_epi8((char)(128 - first)));
+    __m256i in_range = _mm256_cmpgt_epi8(_mm256_set1_epi8(-128 + 26), shifted);
+    return _mm256_xor_si256(v,
+                            _mm256_and_si256(in_range, _mm256_set1_epi8(0x20)));
+}
+
+SIMD_TARGET("avx2")
+static usize ascii_flip_case_block_avx2(u8 *ptr, usize len, u8 first) {
+    usize index = 0;
+    for (; index + 32 <= len; index += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(ptr + index));
+        _mm256_storeu_si256((__m256i *)(ptr + index),
+                            ascii_flip_case_avx2(v, first));
+    }
+    return index;
+}
+
+SIMD_TARGET("avx2")
+static usize ascii_mismatch_ignore_case_avx2(const u8 *a,
+                                             const u8 *b,
+                                             usize len) {
+    usize index = 0;
+    for (; index + 32 <= len; index += 32) {
+        __m256i a_v = ascii_flip_case_avx2(
+            _mm256_loadu_si256((const __m256i *)(a + index)),
+            'A');
+        __m256i b_v = ascii_flip_case_avx2(
+            _mm256_loadu_si256((const __m256i *)(b + index)),
+            'A');
+        u32 equal_mask = (u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(a_v, b_v));
+        if (equal_mask != 0xFFFFFFFF) {
+            return index + __builtin_ctz(~equal_mask);
+        }
+    }
+    return index;
+}
+
+#endif
+
+//
+// Flip case with the widest path available
+//
+static void ascii_flip_case(u8 *ptr, usize len, u8 first) {
+    if (ptr == NULL || len == 0) return;
+
+    usize index = 0;
+
+#ifdef SIMD_X86_64
+    if (SIMD_CPU_HAS("avx2")) {
+        index = ascii_flip_case_block_avx2(ptr, len, first);
+    }
+    for (; index + 16 <= len; index += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(ptr + index));
+        _mm_storeu_si128((__m128i *)(ptr + index),
+                         ascii_flip_case_sse2(v, first));
+    }
+#endif
+
+    for (; index + 8 <= len; index += 8) {
+        u64 word;
+        memcpy(&word, ptr + index, sizeof(word));
+        word = ascii_flip_case_word(word, first);
+        memcpy(ptr + index, &word, sizeof(word));
+    }
+    for (; index < len; index++) {
+        if ((u8)(ptr[index] - first) < 26) ptr[index] ^= 0x20;
+    }
+}
+
+//
+// Return the index of the first case-insensitive mismatch, or `len` if
+// all bytes are equal
+//
+static usize ascii_mismatch_ignore_case(const u8 *a, const u8 *b, usize len) {
+    usize index = 0;
+
+#ifdef SIMD_X86_64
+    if (SIMD_CPU_HAS("avx2")) {
+        index = ascii_mismatch_ignore_case_avx2(a, b, len);
+    }
+    for (; index + 16 <= len; index += 16) {
+        __m128i a_v = ascii_flip_case_sse2(
+            _mm_loadu_si128((const __m128i *)(a + index)),
+            'A');
+        __m128i b_v = ascii_flip_case_sse2(
+            _mm_loadu_si128((const __m128i *)(b + index)),
+            'A');
+        u32 equal_mask = (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(a_v, b_v));
+        if (equal_mask != 0xFFFF) break;
+    }
+#endif
+
+    for (; index + 8 <= len; index += 8) {
+        u64 a_word, b_word;
+        memcpy(&a_word, a + index, sizeof(a_word));
+        memcpy(&b_word, b + index, sizeof(b_word));
+        if (ascii_flip_case_word(a_word, 'A') !=
+            ascii_flip_case_word(b_word, 'A')) {
+            break;
+        }
+    }
+    for (; index < len; index++) {
+        if (ascii_lower_char(a[index]) != ascii_lower_char(b[index])) break;
+    }
+
+    return index;
+}
+
+/*
+ * Convert `ptr[0..len]` to lower case in-place
+ */
+void Ascii_to_lower(char *ptr, usize len) {
+    ascii_flip_case((u8 *)ptr, len, 'A');
+}
+
+/*
+ * Convert `ptr[0..len]` to upper case in-place
+ */
+void Ascii_to_upper(char *ptr, usize len) {
+    ascii_flip_case((u8 *)ptr, len, 'a');
+}
+
+/*
+ * Case-insensitive compare on `len` bytes, return `true` if equal
+ */
+bool Ascii_equals_ignore_case(const char *a, const char *b, usize len) {
+    if (len == 0 || a == b) return true;
+    if (a == NULL || b == NULL) return false;
+
+    return ascii_mismatch_ignore_case((const u8 *)a, (const u8 *)b, len) ==
+           len;
+}
+
+/*
+ * Case-insensitive compare, return `< 0`, `0` or `> 0` like `strcasecmp`
+ */
+int Ascii_compare_ignore_case(const char *a,
+                              usize a_len,
+                              const char *b,
+                              usize b_len) {
+    usize min_len = a_len < b_len ? a_len : b_len;
+
+    if (min_len > 0) {
+        usize mismatch =
+            ascii_mismatch_ignore_case((const u8 *)a, (const u8 *)b, min_len);
+        if (mismatch < min_len) {
+            return (int)ascii_lower_char(((const u8 *)a)[mismatch]) -
+                   (int)ascii_lower_char(((const u8 *)b)[mismatch]);
+        }
+    }
+
+    return (a_len == b_len) ? 0 : (a_len < b_len ? -1 : 1);
+}
+
+//
+// Mix one 64bit word into the hash state
+//
+static inline u64 ascii_hash_mix(u64 hash, u64 word) {
+    hash ^= word * 0xFF51AFD7ED558CCDULL;
+    hash = (hash << 31) | (hash >> 33);
+    return hash * 0x9E3779B97F4A7C15ULL;
+}
+
+/*
+ * Case-insensitive 64bit hash
+ */
+u64 Ascii_hash_ignore_case(const char *ptr, usize len) {
+    u64 hash = 0x9E3779B97F4A7C15ULL ^ len;
+    if (ptr == NULL) return hash;
+
+    //
+    // Lower case 8 bytes at a time and mix the whole word, so hashing never
+    // needs a lower case copy of the input.
+    //
+    usize index = 0;
+    for (; index + 8 <= len; index += 8) {
+        u64 word;
+        memcpy(&word, ptr + index, sizeof(word));
+        hash = ascii_hash_mix(hash, ascii_flip_case_word(word, 'A'));
+    }
+
+    if (index < len) {
+        u8 tail[8] = {0};
+        memcpy(tail, ptr + index, len - index);
+        u64 word;
+        memcpy(&word, tail, sizeof(word));
+        hash = ascii_hash_mix(hash, ascii_flip_case_word(word, 'A'));
+    }
+
+    // `fmix64` finalizer from `MurmurHash3`
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDULL;
+    hash ^= hash >> 33;
+    hash *= 0xC4CEB9FE1A85EC53ULL;
+    hash ^= hash >> 33;
+
+    return hash;
+}
+
+/*
+ * Case-insensitive substring search
+ */
+long Ascii_index_of_ignore_case(const char *haystack,
+                                usize haystack_len,
+                                const char *needle,
+                                usize needle_len) {
+    if (haystack == NULL || needle == NULL || needle_len == 0 ||
+        needle_len > haystack_len) {
+        return -1;
+    }
+
+    const u8 *h = (const u8 *)haystack;
+    const u8 *n = (const u8 *)needle;
+    u8 first    = ascii_lower_char(n[0]);
+    usize index = 0;
+
+#ifdef SIMD_X86_64
+    //
+    // Only the positions where both the first and the last needle byte
+    // match are worth a full compare.
+    //
+    u8 last               = ascii_lower_char(n[needle_len - 1]);
+    const __m128i first_v = _mm_set1_epi8((char)first);
+    const __m128i last_v  = _mm_set1_epi8((char)last);
+    for (; index + needle_len - 1 + 16 <= haystack_len; index += 16) {
+        __m128i block_first = ascii_flip_case_sse2(
+            _mm_loadu_si128((const __m128i *)(h + index)),
+            'A');
+        __m128i block_last = ascii_flip_case_sse2(
+            _mm_loadu_si128((const __m128i *)(h + index + needle_len - 1)),
+            'A');
+        u32 candidates = (u32)_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(block_first, first_v),
+                          _mm_cmpeq_epi8(block_last, last_v)));
+        while (candidates != 0) {
+            usize offset = __builtin_ctz(candidates);
+            if (ascii_mismatch_ignore_case(h + index + offset, n, needle_len) ==
+                needle_len) {
+                return (long)(index + offset);
+            }
+            candidates &= candidates - 1;
+        }
+    }
+#endif
+
+    for (; index + needle_len <= haystack_len; index++) {
+        if (ascii_lower_char(h[index]) == first &&
+            ascii_mismatch_ignore_case(h + index, n, needle_len) ==
+                needle_len) {
+            return (long)index;
+        }
+    }
+
+    return -1;
+}
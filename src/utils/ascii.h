@@ -0,0 +1,53 @@
+#ifndef __UTILS_ASCII_H__
+#define __UTILS_ASCII_H__
+
+#include <stdbool.h>
+
+#include "data_types.h"
+
+//
+// ASCII only case folding helpers, all non `A~Z` `a~z` bytes (including all
+// UTF-8 multi-byte sequences) stay untouched. None of them requires
+// null-terminated input.
+//
+
+/*
+ * Convert `ptr[0..len]` to lower case in-place
+ */
+void Ascii_to_lower(char *ptr, usize len);
+
+/*
+ * Convert `ptr[0..len]` to upper case in-place
+ */
+void Ascii_to_upper(char *ptr, usize len);
+
+/*
+ * Case-insensitive compare on `len` bytes, return `true` if equal
+ */
+bool Ascii_equals_ignore_case(const char *a, const char *b, usize len);
+
+/*
+ * Case-insensitive compare, return `< 0`, `0` or `> 0` like `strcasecmp`. A
+ * shorter input which is the prefix of the longer one is the smaller one.
+ */
+int Ascii_compare_ignore_case(const char *a,
+                              usize a_len,
+                              const char *b,
+                              usize b_len);
+
+/*
+ * Case-insensitive 64bit hash, `"Content-Type"` and `"content-type"` have
+ * the same hash value. It's NOT a cryptographic hash.
+ */
+u64 Ascii_hash_ignore_case(const char *ptr, usize len);
+
+/*
+ * Case-insensitive substring search, return the index of the first match or
+ * `-1` if not found. An empty `needle` is not found.
+ */
+long Ascii_index_of_ignore_case(const char *haystack,
+                                usize haystack_len,
+                                const char *needle,
+                                usize needle_len);
+
+#endif
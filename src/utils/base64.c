@@ -0,0 +1,776 @@
+#include "base64.h"
+
+#include <string.h>
+
+#include "simd.h"
+
+#ifdef ENABLE_DEBUG_LOG
+    #include "log.h"
+#endif
+
+static const char BASE64_STANDARD_CHARS[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+static const char BASE64_URL_CHARS[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+//
+// Base64 character to 6 bits value, `0xFF` means invalid character
+//
+static const u8 BASE64_STANDARD_DECODE_TABLE[256] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  // 0x00
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  //
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  // 0x10
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  //
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  // 0x20
+    0xFF, 0xFF, 0xFF, 0x3E, 0xFF, 0xFF, 0xFF, 0x3F,  //      `+` `/`
+    0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x3B,  // 0x30 `0~7`
+    0x3C, 0x3D, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  //      `8~9`
+    0xFF, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06,  // 0x40 `A~G`
+    0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E,  //      `H~O`
+    0x0F, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16,  // 0x50 `P~W`
+    0x17, 0x18, 0x19, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  //      `X~Z`
+    0xFF, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F, 0x20,  // 0x60 `a~g`
+    0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,  //      `h~o`
+    0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F, 0x30,  // 0x70 `p~w`
+    0x31, 0x32, 0x33, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  //      `x~z`
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  // 0x80
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  //
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  // 0x90
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  //
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  // 0xA0
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  //
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  // 0xB0
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  //
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  // 0xC0
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  //
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  // 0xD0
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  //
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  // 0xE0
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  //
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  // 0xF0
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  //
+};
+
+static const u8 BASE64_URL_DECODE_TABLE[256] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  // 0x00
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  //
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  // 0x10
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  //
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  // 0x20
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x3E, 0xFF, 0xFF,  //      `-`
+    0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x3B,  // 0x30 `0~7`
+    0x3C, 0x3D, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  //      `8~9`
+    0xFF, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06,  // 0x40 `A~G`
+    0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E,  //      `H~O`
+    0x0F, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16,  // 0x50 `P~W`
+    0x17, 0x18, 0x19, 0xFF, 0xFF, 0xFF, 0xFF, 0x3F,  //      `X~Z` `_`
+    0xFF, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F, 0x20,  // 0x60 `a~g`
+    0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,  //      `h~o`
+    0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F, 0x30,  // 0x70 `p~w`
+    0x31, 0x32, 0x33, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  //      `x~z`
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  // 0x80
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  //
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  // 0x90
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  //
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  // 0xA0
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  //
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  // 0xB0
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  //
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  // 0xC0
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  //
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  // 0xD0
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  //
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  // 0xE0
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  //
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  // 0xF0
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  //
+};
+//
+// Everything the hot loops need for one alphabet
+//
+typedef struct {
+    const char *chars;
+    const u8 *decode_table;
+    char char_62;
+    char char_63;
+} Base64AlphabetInfo;
+
+static inline Base64AlphabetInfo base64_alphabet(Base64Alphabet alphabet) {
+    if (alphabet == B64_URL) {
+        return (Base64AlphabetInfo){
+            .chars        = BASE64_URL_CHARS,
+            .decode_table = BASE64_URL_DECODE_TABLE,
+            .char_62      = '-',
+            .char_63      = '_',
+        };
+    }
+
+    return (Base64AlphabetInfo){
+        .chars        = BASE64_STANDARD_CHARS,
+        .decode_table = BASE64_STANDARD_DECODE_TABLE,
+        .char_62      = '+',
+        .char_63      = '/',
+    };
+}
+
+#ifdef SIMD_X86_64
+
+//
+// `pshufb` control: bytes `b0 b1 b2` -> `b1 b0 b2 b1` in each 32bit lane
+//
+static const u8 BASE64_ENCODE_SPREAD_TABLE[32] = {
+    1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+    1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10};
+
+//
+// `pshufb` control: the 3 decoded bytes (big endian) of each 32bit lane,
+// the last 4 bytes of each 128bit lane are zeroed
+//
+static const u8 BASE64_DECODE_PACK_TABLE[32] = {
+    2,    1,    0,    6,    5,    4,    10,   9,    8,    14,   13,
+    12,   0x80, 0x80, 0x80, 0x80, 2,    1,    0,    6,    5,    4,
+    10,   9,    8,    14,   13,   12,   0x80, 0x80, 0x80, 0x80};
+
+//
+// Encode 24 bytes into 32 characters per iteration ("Faster Base64
+// Encoding and Decoding Using AVX2 Instructions", Muła & Lemire):
+//
+// 1. `pshufb` spreads every 3 bytes into a 32bit lane (`b1 b0 b2 b1`)
+// 2. `mulhi` / `mullo` move the four 6 bits fields into 4 separate bytes
+// 3. `pshufb` looks up the offset to add for each of the 5 ranges
+//
+// It reads 28 bytes per iteration, return the count of bytes processed.
+//
+SIMD_TARGET("avx2")
+static usize base64_encode_avx2(const u8 *src,
+                                usize len,
+                                char *out,
+                                Base64AlphabetInfo info) {
+    const __m256i spread =
+        _mm256_loadu_si256((const __m256i *)BASE64_ENCODE_SPREAD_TABLE);
+
+    //
+    // `[0]` for `a~z`, `[1..10]` for `0~9`, `[11]` and `[12]` for the 62
+    // and 63 characters, `[13]` for `A~Z`
+    //
+    const __m128i offsets_128 = _mm_setr_epi8('a' - 26,
+                                              '0' - 52,
+                                              '0' - 52,
+                                              '0' - 52,
+                                              '0' - 52,
+                                              '0' - 52,
+                                              '0' - 52,
+                                              '0' - 52,
+                                              '0' - 52,
+                                              '0' - 52,
+                                              '0' - 52,
+                                              info.char_62 - 62,
+                                              info.char_63 - 63,
+                                              'A',
+                                              0,
+                                              0);
+    const __m256i offsets = _mm256_broadcastsi128_si256(offsets_128);
+
+    usize index     = 0;
+    usize out_index = 0;
+    for (; index + 28 <= len; index += 24, out_index += 32) {
+        __m256i in = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(
+                _mm_loadu_si128((const __m128i *)(src + index))),
+            _mm_loadu_si128((const __m128i *)(src + index + 12)),
+            1);
+        in = _mm256_shuffle_epi8(in, spread);
+
+        __m256i t0 = _mm256_and_si256(in, _mm256_set1_epi32(0x0FC0FC00));
+        __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+        __m256i t2 = _mm256_and_si256(in, _mm256_set1_epi32(0x003F03F0));
+        __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+        __m256i indices = _mm256_or_si256(t1, t3);
+
+        // 0~25 -> 13, 26~51 -> 0, 52~61 -> 1~10, 62 -> 11, 63 -> 12
+        __m256i reduced  = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+        __m256i is_upper = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+        reduced = _mm256_or_si256(
+            reduced,
+            _mm256_and_si256(is_upper, _mm256_set1_epi8(13)));
+
+        __m256i chars =
+            _mm256_add_epi8(indices, _mm256_shuffle_epi8(offsets, reduced));
+        _mm256_storeu_si256((__m256i *)(out + out_index), chars);
+    }
+
+    return index;
+}
+
+//
+// Decode 32 characters into 24 bytes per iteration. The characters are
+// validated and translated by range compares (so both alphabets share the
+// same code), then `maddubs` + `madd` pack the 6 bits values and `pshufb`
+// drops the empty bytes.
+//
+// Stop at the first block that contains any invalid character (include
+// `=`), return the count of characters processed.
+//
+SIMD_TARGET("avx2")
+static usize base64_decode_avx2(const u8 *src,
+                                usize len,
+                                u8 *out,
+                                Base64AlphabetInfo info) {
+    const __m256i pack =
+        _mm256_loadu_si256((const __m256i *)BASE64_DECODE_PACK_TABLE);
+    const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7);
+
+    usize index     = 0;
+    usize out_index = 0;
+    for (; index + 32 <= len; index += 32, out_index += 24) {
+        __m256i in = _mm256_loadu_si256((const __m256i *)(src + index));
+
+        //
+        // Signed compares, so any byte `>= 0x80` is out of all ranges
+        //
+        __m256i upper = _mm256_and_si256(
+            _mm256_cmpgt_epi8(in, _mm256_set1_epi8('A' - 1)),
+            _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), in));
+        __m256i lower = _mm256_and_si256(
+            _mm256_cmpgt_epi8(in, _mm256_set1_epi8('a' - 1)),
+            _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), in));
+        __m256i digit = _mm256_and_si256(
+            _mm256_cmpgt_epi8(in, _mm256_set1_epi8('0' - 1)),
+            _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), in));
+        __m256i is_62 = _mm256_cmpeq_epi8(in, _mm256_set1_epi8(info.char_62));
+        __m256i is_63 = _mm256_cmpeq_epi8(in, _mm256_set1_epi8(info.char_63));
+
+        __m256i valid = _mm256_or_si256(
+            _mm256_or_si256(upper, lower),
+            _mm256_or_si256(digit, _mm256_or_si256(is_62, is_63)));
+        if ((u32)_mm256_movemask_epi8(valid) != 0xFFFFFFFF) break;
+
+        __m256i offsets = _mm256_or_si256(
+            _mm256_or_si256(
+                _mm256_and_si256(upper, _mm256_set1_epi8(-'A')),
+                _mm256_and_si256(lower, _mm256_set1_epi8(26 - 'a'))),
+            _mm256_or_si256(
+                _mm256_and_si256(digit, _mm256_set1_epi8(52 - '0')),
+                _mm256_or_si256(
+                    _mm256_and_si256(is_62,
+                                     _mm256_set1_epi8(62 - info.char_62)),
+                    _mm256_and_si256(is_63,
+                                     _mm256_set1_epi8(63 - info.char_63)))));
+        __m256i values = _mm256_add_epi8(in, offsets);
+
+        //
+        // `00aaaaaa 00bbbbbb 00cccccc 00dddddd` -> `aaaaaabb bbbbcccc
+        // ccdddddd` in each 32bit lane, then pack the 8 lanes (3 bytes each)
+        // into the first 24 bytes.
+        //
+        __m256i merged = _mm256_maddubs_epi16(values,
+                                              _mm256_set1_epi32(0x01400140));
+        __m256i packed = _mm256_madd_epi16(merged,
+                                           _mm256_set1_epi32(0x00011000));
+        packed         = _mm256_shuffle_epi8(packed, pack);
+        packed         = _mm256_permutevar8x32_epi32(packed, lanes);
+
+        _mm_storeu_si128((__m128i *)(out + out_index),
+                         _mm256_castsi256_si128(packed));
+        _mm_storel_epi64((__m128i *)(out + out_index + 16),
+                         _mm256_extracti128_si256(packed, 1));
+    }
+
+    return index;
+}
+
+#endif
+
+//
+// Encode `len` (a multiple of 3) bytes, return the count of characters
+//
+static usize base64_encode_blocks(const u8 *src,
+                                  usize len,
+                                  char *out,
+                                  Base64AlphabetInfo info) {
+    usize index = 0;
+
+#ifdef SIMD_X86_64
+    if (len >= 28 && SIMD_CPU_HAS("avx2")) {
+        index = base64_encode_avx2(src, len, out, info);
+    }
+#endif
+
+    char *out_ptr = out + index / 3 * 4;
+    for (; index + 3 <= len; index += 3) {
+        u32 block = (u32)src[index] << 16 | (u32)src[index + 1] << 8 |
+                    (u32)src[index + 2];
+        out_ptr[0] = info.chars[block >> 18];
+        out_ptr[1] = info.chars[(block >> 12) & 0x3F];
+        out_ptr[2] = info.chars[(block >> 6) & 0x3F];
+        out_ptr[3] = info.chars[block & 0x3F];
+        out_ptr += 4;
+    }
+
+    return out_ptr - out;
+}
+
+//
+// Encode the last 1 or 2 bytes, return the count of characters
+//
+static usize base64_encode_tail(const u8 *src,
+                                usize len,
+                                char *out,
+                                Base64AlphabetInfo info,
+                                bool no_padding) {
+    if (len == 0) return 0;
+
+    u32 block = (u32)src[0] << 16 | (len == 2 ? (u32)src[1] << 8 : 0);
+    out[0]    = info.chars[block >> 18];
+    out[1]    = info.chars[(block >> 12) & 0x3F];
+    if (len == 2) out[2] = info.chars[(block >> 6) & 0x3F];
+
+    if (no_padding) return len + 1;
+
+    if (len == 1) out[2] = '=';
+    out[3] = '=';
+    return 4;
+}
+
+//
+// Decode `len` (a multiple of 4) characters without padding, return the
+// count of bytes, or `-1` if there is any invalid character
+//
+static long base64_decode_blocks(const u8 *src,
+                                 usize len,
+                                 u8 *out,
+                                 Base64AlphabetInfo info) {
+    usize index = 0;
+
+#ifdef SIMD_X86_64
+    if (len >= 32 && SIMD_CPU_HAS("avx2")) {
+        index = base64_decode_avx2(src, len, out, info);
+    }
+#endif
+
+    const u8 *table = info.decode_table;
+    u8 *out_ptr     = out + index / 4 * 3;
+    for (; index + 4 <= len; index += 4) {
+        u8 a = table[src[index]];
+        u8 b = table[src[index + 1]];
+        u8 c = table[src[index + 2]];
+        u8 d = table[src[index + 3]];
+
+        // All valid values are `< 64`, so any `0xFF` shows up in the OR
+        if ((a | b | c | d) & 0x80) {
+#ifdef ENABLE_DEBUG_LOG
+            DEBUG_LOG(Base64,
+                      decode_blocks,
+                      "invalid character in block at: %lu",
+                      index);
+#endif
+            return -1;
+        }
+
+        u32 block  = (u32)a << 18 | (u32)b << 12 | (u32)c << 6 | (u32)d;
+        out_ptr[0] = (u8)(block >> 16);
+        out_ptr[1] = (u8)(block >> 8);
+        out_ptr[2] = (u8)block;
+        out_ptr += 3;
+    }
+
+    return out_ptr - out;
+}
+
+//
+// Decode the last block: 4 characters (with or without padding) or 2~3
+// characters (`no_padding`). Return the count of bytes, or `-1` if it's
+// invalid or the unused bits are not zero.
+//
+static long base64_decode_tail(const u8 *src,
+                               usize len,
+                               u8 *out,
+                               Base64AlphabetInfo info,
+                               bool no_padding) {
+    usize data_len = len;
+    if (!no_padding) {
+        if (len != 4) return -1;
+        if (src[3] == '=') data_len = (src[2] == '=') ? 2 : 3;
+    }
+    if (data_len < 2 || data_len > 4) return -1;
+
+    const u8 *table = info.decode_table;
+    u32 block       = 0;
+    for (usize index = 0; index < data_len; index++) {
+        u8 value = table[src[index]];
+        if (value == 0xFF) return -1;
+        block = block << 6 | value;
+    }
+
+    switch (data_len) {
+        case 2:
+            if (block & 0x0F) return -1;
+            out[0] = (u8)(block >> 4);
+            return 1;
+        case 3:
+            if (block & 0x03) return -1;
+            out[0] = (u8)(block >> 10);
+            out[1] = (u8)(block >> 2);
+            return 2;
+        default:
+            out[0] = (u8)(block >> 16);
+            out[1] = (u8)(block >> 8);
+            out[2] = (u8)block;
+            return 3;
+    }
+}
+
+/*
+ * Return the output length of `Base64_encode`
+ */
+usize Base64_encoded_length(usize len, Base64Options options) {
+    if (options.no_padding) return len / 3 * 4 + (len % 3 ? len % 3 + 1 : 0);
+
+    return (len + 2) / 3 * 4;
+}
+
+/*
+ * Encode `ptr[0..len]` into `out`
+ */
+usize Base64_encode(const u8 *ptr,
+                    usize len,
+                    char *out,
+                    Base64Options options) {
+    if (ptr == NULL || len == 0 || out == NULL) return 0;
+
+    Base64AlphabetInfo info = base64_alphabet(options.alphabet);
+    usize blocks_len        = len / 3 * 3;
+    usize out_len           = base64_encode_blocks(ptr, blocks_len, out, info);
+
+    return out_len + base64_encode_tail(ptr + blocks_len,
+                                        len - blocks_len,
+                                        out + out_len,
+                                        info,
+                                        options.no_padding);
+}
+
+/*
+ * Append the base64 string of `ptr[0..len]` to the given `String`
+ */
+void Base64_encode_into(const u8 *ptr,
+                        usize len,
+                        String out,
+                        Base64Options options) {
+    if (ptr == NULL || len == 0 || out == NULL) return;
+
+    HS_reserve(out, Base64_encoded_length(len, options));
+
+    //
+    // Encode block by block on the stack (3072 bytes -> 4096 characters),
+    // `HS_reserve` above makes sure `HS_push_view` never reallocs.
+    //
+    char block[4096];
+    const usize block_bytes = sizeof(block) / 4 * 3;
+    for (usize index = 0; index < len; index += block_bytes) {
+        usize bytes = len - index < block_bytes ? len - index : block_bytes;
+        usize encoded_len = Base64_encode(ptr + index, bytes, block, options);
+        HS_push_view(out, (StrView){.ptr = block, .len = encoded_len});
+    }
+}
+
+/*
+ * Encode all bytes in the given `HexBuffer` into a new `String`
+ */
+String Base64_from_hex_buffer(const HexBuffer hex_buffer,
+                              Base64Options options) {
+    String result = HS_from_empty();
+    if (hex_buffer == NULL) return result;
+
+    HexBufferIteractor iter = Hex_iter(hex_buffer);
+    Base64_encode_into(iter.arr, iter.length, result, options);
+
+    return result;
+}
+
+/*
+ * Decode `ptr[0..len]` into `out`
+ */
+long Base64_decode(const char *ptr,
+                   usize len,
+                   u8 *out,
+                   Base64Options options) {
+    if (ptr == NULL || len == 0) return 0;
+    if (out == NULL) return -1;
+
+    //
+    // The last block is decoded separately, because it's the only one that
+    // can have padding (or be shorter than 4 characters).
+    //
+    usize tail_len = len % 4;
+    if (!options.no_padding && tail_len != 0) return -1;
+    if (tail_len == 0) tail_len = 4;
+
+    Base64AlphabetInfo info = base64_alphabet(options.alphabet);
+    const u8 *src           = (const u8 *)ptr;
+    long out_len = base64_decode_blocks(src, len - tail_len, out, info);
+    if (out_len < 0) return -1;
+
+    long tail_out_len = base64_decode_tail(src + len - tail_len,
+                                           tail_len,
+                                           out + out_len,
+                                           info,
+                                           options.no_padding);
+    return (tail_out_len < 0) ? -1 : out_len + tail_out_len;
+}
+
+/*
+ * Decode `ptr[0..len]` into a new `HexBuffer`
+ */
+HexBuffer Base64_to_hex_buffer(const char *ptr,
+                               usize len,
+                               Base64Options options) {
+    if (ptr == NULL || len == 0) return NULL;
+
+    //
+    // The exact size is known from the length and padding, so the result
+    // buffer is allocated once and decoded into directly.
+    //
+    usize decoded_len = len / 4 * 3;
+    if (options.no_padding) {
+        decoded_len += (len % 4 > 1) ? len % 4 - 1 : 0;
+    } else if (len >= 4) {
+        decoded_len -= (ptr[len - 1] == '=') + (ptr[len - 2] == '=');
+    }
+    if (decoded_len == 0) return NULL;
+
+    HexBuffer buffer = Hex_with_length(decoded_len);
+    if (buffer == NULL) return NULL;
+
+    HexBufferIteractor iter = Hex_iter(buffer);
+    long out_len            = Base64_decode(ptr, len, iter.arr, options);
+    if (out_len != (long)decoded_len) {
+#ifdef ENABLE_DEBUG_LOG
+        DEBUG_LOG(Base64,
+                  to_hex_buffer,
+                  "invalid input, len: %lu, out_len: %ld",
+                  len,
+                  out_len);
+#endif
+        Hex_free(buffer);
+        return NULL;
+    }
+
+    return buffer;
+}
+
+/*
+ * Init the encoder
+ */
+void Base64Encoder_init(Base64Encoder *self, Base64Options options) {
+    if (self == NULL) return;
+
+    *self = (Base64Encoder){
+        ._options     = options,
+        ._pending     = {0},
+        ._pending_len = 0,
+    };
+}
+
+/*
+ * Encode `chunk[0..chunk_len]` into `out`
+ */
+usize Base64Encoder_feed(Base64Encoder *self,
+                         const u8 *chunk,
+                         usize chunk_len,
+                         char *out) {
+    if (self == NULL || chunk == NULL || chunk_len == 0 || out == NULL) {
+        return 0;
+    }
+
+    Base64AlphabetInfo info = base64_alphabet(self->_options.alphabet);
+    usize out_len           = 0;
+
+    //
+    // Complete the pending block first
+    //
+    if (self->_pending_len > 0) {
+        u8 block[3];
+        memcpy(block, self->_pending, self->_pending_len);
+        usize taken = 3 - self->_pending_len;
+        if (taken > chunk_len) taken = chunk_len;
+        memcpy(block + self->_pending_len, chunk, taken);
+        chunk += taken;
+        chunk_len -= taken;
+
+        if (self->_pending_len + taken < 3) {
+            memcpy(self->_pending, block, self->_pending_len + taken);
+            self->_pending_len += taken;
+            return 0;
+        }
+
+        out_len            = base64_encode_blocks(block, 3, out, info);
+        self->_pending_len = 0;
+    }
+
+    usize blocks_len = chunk_len / 3 * 3;
+    out_len += base64_encode_blocks(chunk, blocks_len, out + out_len, info);
+
+    self->_pending_len = chunk_len - blocks_len;
+    memcpy(self->_pending, chunk + blocks_len, self->_pending_len);
+
+    return out_len;
+}
+
+/*
+ * Encode the pending bytes (plus padding) into `out`
+ */
+usize Base64Encoder_finish(Base64Encoder *self, char *out) {
+    if (self == NULL || out == NULL) return 0;
+
+    usize out_len =
+        base64_encode_tail(self->_pending,
+                           self->_pending_len,
+                           out,
+                           base64_alphabet(self->_options.alphabet),
+                           self->_options.no_padding);
+    Base64Encoder_init(self, self->_options);
+
+    return out_len;
+}
+
+/*
+ * Init the decoder
+ */
+void Base64Decoder_init(Base64Decoder *self, Base64Options options) {
+    if (self == NULL) return;
+
+    *self = (Base64Decoder){
+        ._options      = options,
+        ._failed       = false,
+        ._padding_seen = false,
+        ._pending      = {0},
+        ._pending_len  = 0,
+    };
+}
+
+//
+// Decode 4 characters that could be the padded last block
+//
+static long base64_decoder_block(Base64Decoder *self,
+                                 const u8 *src,
+                                 u8 *out,
+                                 Base64AlphabetInfo info) {
+    if (!self->_options.no_padding && src[3] == '=') {
+        self->_padding_seen = true;
+        return base64_decode_tail(src, 4, out, info, false);
+    }
+
+    return base64_decode_blocks(src, 4, out, info);
+}
+
+/*
+ * Decode `chunk[0..chunk_len]` into `out`
+ */
+long Base64Decoder_feed(Base64Decoder *self,
+                        const char *chunk,
+                        usize chunk_len,
+                        u8 *out) {
+    if (self == NULL || self->_failed) return -1;
+    if (chunk == NULL || chunk_len == 0) return 0;
+
+    //
+    // Nothing is allowed after the padding
+    //
+    if (self->_padding_seen || out == NULL) {
+        self->_failed = true;
+        return -1;
+    }
+
+    Base64AlphabetInfo info = base64_alphabet(self->_options.alphabet);
+    const u8 *src           = (const u8 *)chunk;
+    long out_len            = 0;
+
+    //
+    // Complete the pending block first
+    //
+    if (self->_pending_len > 0) {
+        usize taken = 4 - self->_pending_len;
+        if (taken > chunk_len) taken = chunk_len;
+        memcpy(self->_pending + self->_pending_len, src, taken);
+        self->_pending_len += taken;
+        src += taken;
+        chunk_len -= taken;
+
+        if (self->_pending_len < 4) return 0;
+
+        out_len = base64_decoder_block(self,
+                                       (const u8 *)self->_pending,
+                                       out,
+                                       info);
+        self->_pending_len = 0;
+        if (out_len < 0 || (self->_padding_seen && chunk_len > 0)) {
+            self->_failed = true;
+            return -1;
+        }
+    }
+
+    //
+    // All complete blocks, the one that contains `=` (if any) has to be the
+    // last one.
+    //
+    usize blocks_len = chunk_len / 4 * 4;
+    if (blocks_len > 0) {
+        const u8 *padding =
+            self->_options.no_padding ? NULL : memchr(src, '=', blocks_len);
+        usize plain_len =
+            (padding != NULL) ? (usize)(padding - src) / 4 * 4 : blocks_len;
+
+        long decoded_len =
+            base64_decode_blocks(src, plain_len, out + out_len, info);
+        if (decoded_len < 0) {
+            self->_failed = true;
+            return -1;
+        }
+        out_len += decoded_len;
+
+        if (padding != NULL) {
+            decoded_len = base64_decoder_block(self,
+                                               src + plain_len,
+                                               out + out_len,
+                                               info);
+            if (decoded_len < 0 || plain_len + 4 != chunk_len) {
+                self->_failed = true;
+                return -1;
+            }
+            out_len += decoded_len;
+        }
+    }
+
+    self->_pending_len = chunk_len - blocks_len;
+    memcpy(self->_pending, src + blocks_len, self->_pending_len);
+
+    return out_len;
+}
+
+/*
+ * Finish decoding
+ */
+long Base64Decoder_finish(Base64Decoder *self, u8 *out) {
+    if (self == NULL) return -1;
+
+    long out_len = 0;
+    if (self->_failed) {
+        out_len = -1;
+    } else if (self->_pending_len > 0) {
+        //
+        // Only the unpadded last block can be shorter than 4 characters
+        //
+        out_len = (self->_options.no_padding && out != NULL)
+                      ? base64_decode_tail(
+                            (const u8 *)self->_pending,
+                            self->_pending_len,
+                            out,
+                            base64_alphabet(self->_options.alphabet),
+                            true)
+                      : -1;
+    }
+
+    Base64Decoder_init(self, self->_options);
+
+    return out_len;
+}
@@ -0,0 +1,207 @@
+#ifndef __UTILS_BASE64_H__
+#define __UTILS_BASE64_H__
+
+#include <stdbool.h>
+
+#include "data_types.h"
+#include "heap_string.h"
+#include "hex_buffer.h"
+
+//
+// Base64 (RFC 4648) encoder and decoder, the hot loops use `AVX2` (24 bytes
+// <-> 32 characters per iteration) on `x86_64` and fall back to the lookup
+// table scalar version on other CPUs.
+//
+// The decoder is strict, the input is rejected if it contains:
+//
+// - any character out of the alphabet (include whitespace and line breaks)
+// - misplaced or missing padding
+// - non-zero unused bits in the last character (non canonical encoding)
+//
+
+/*
+ * Alphabet:
+ *
+ * - `B64_STANDARD`: `A~Z a~z 0~9 + /`
+ * - `B64_URL`: `A~Z a~z 0~9 - _` (URL and filename safe)
+ */
+typedef enum Base64Alphabet {
+    B64_STANDARD = 0x00,
+    B64_URL      = 0x01,
+} Base64Alphabet;
+
+/*
+ * Base64 options, `(Base64Options){0}` is the standard alphabet with padding
+ *
+ * - `alphabet`: `B64_STANDARD` or `B64_URL`
+ * - `no_padding`: encoder doesn't add `=`, decoder rejects `=` and accepts
+ *   the unpadded last block
+ */
+typedef struct {
+    Base64Alphabet alphabet;
+    bool no_padding;
+} Base64Options;
+
+/*
+ * Return the output length (without the null-terminated character) of
+ * encoding `len` bytes with the given options
+ */
+usize Base64_encoded_length(usize len, Base64Options options);
+
+/*
+ * Encode `ptr[0..len]` into `out`, `out` should be able to hold
+ * `Base64_encoded_length(len, options)` characters. It does NOT add the
+ * null-terminated character.
+ *
+ * Return the count of characters written into `out`.
+ */
+usize Base64_encode(const u8 *ptr,
+                    usize len,
+                    char *out,
+                    Base64Options options);
+
+/*
+ * Append the base64 string of `ptr[0..len]` to the given `String`, the
+ * `String` grows only once.
+ */
+void Base64_encode_into(const u8 *ptr,
+                        usize len,
+                        String out,
+                        Base64Options options);
+
+/*
+ * Encode all bytes in the given `HexBuffer` into a new `String`, the caller
+ * owns the returned `String`.
+ */
+String Base64_from_hex_buffer(const HexBuffer hex_buffer,
+                              Base64Options options);
+
+/*
+ * The max output size of decoding `len` characters
+ */
+#define BASE64_DECODED_MAX_LENGTH(len) (((len) + 3) / 4 * 3)
+
+/*
+ * Decode `ptr[0..len]` into `out`, `out` should be able to hold
+ * `BASE64_DECODED_MAX_LENGTH(len)` bytes.
+ *
+ * Return the count of bytes written into `out`, return `-1` if the input is
+ * invalid.
+ */
+long Base64_decode(const char *ptr,
+                   usize len,
+                   u8 *out,
+                   Base64Options options);
+
+/*
+ * Decode `ptr[0..len]` into a new `HexBuffer`, the input is decoded straight
+ * into the result buffer.
+ *
+ * Return `NULL` if:
+ *
+ * - `ptr` is NULL or `len` is 0
+ * - the input is invalid
+ */
+HexBuffer Base64_to_hex_buffer(const char *ptr,
+                               usize len,
+                               Base64Options options);
+
+/*
+ * Streaming base64 encoder, encode a huge input chunk by chunk in constant
+ * memory. The output is the same with encoding all data in one go.
+ *
+ * ```c
+ * Base64Encoder encoder;
+ * Base64Encoder_init(&encoder, (Base64Options){0});
+ *
+ * u8 chunk[49152];
+ * char out[BASE64_ENCODER_MAX_OUTPUT(sizeof(chunk))];
+ * ssize_t read_size;
+ * while ((read_size = read(in_fd, chunk, sizeof(chunk))) > 0) {
+ *     usize out_len = Base64Encoder_feed(&encoder, chunk, read_size, out);
+ *     write(out_fd, out, out_len);
+ * }
+ * write(out_fd, out, Base64Encoder_finish(&encoder, out));
+ * ```
+ */
+typedef struct {
+    Base64Options _options;
+    u8 _pending[2];
+    usize _pending_len;
+} Base64Encoder;
+
+/*
+ * The max output size of feeding `chunk_len` bytes (or finishing)
+ */
+#define BASE64_ENCODER_MAX_OUTPUT(chunk_len) (((chunk_len) + 2) / 3 * 4 + 4)
+
+/*
+ * Init the encoder
+ */
+void Base64Encoder_init(Base64Encoder *self, Base64Options options);
+
+/*
+ * Encode `chunk[0..chunk_len]` into `out`, `out` should be able to hold
+ * `BASE64_ENCODER_MAX_OUTPUT(chunk_len)` characters. Up to 2 bytes are kept
+ * in the encoder until the next feed.
+ *
+ * Return the count of characters written into `out`.
+ */
+usize Base64Encoder_feed(Base64Encoder *self,
+                         const u8 *chunk,
+                         usize chunk_len,
+                         char *out);
+
+/*
+ * Encode the pending bytes (plus padding) into `out` (at least 4
+ * characters), the encoder is reset and ready for the next input.
+ *
+ * Return the count of characters written into `out`.
+ */
+usize Base64Encoder_finish(Base64Encoder *self, char *out);
+
+/*
+ * Streaming base64 decoder, a 4 characters block can be split between
+ * chunks, the pending characters are kept in the decoder.
+ */
+typedef struct {
+    Base64Options _options;
+    bool _failed;
+    bool _padding_seen;
+    char _pending[4];
+    usize _pending_len;
+} Base64Decoder;
+
+/*
+ * The max output size of feeding `chunk_len` characters
+ */
+#define BASE64_DECODER_MAX_OUTPUT(chunk_len) (((chunk_len) + 3) / 4 * 3 + 3)
+
+/*
+ * Init the decoder
+ */
+void Base64Decoder_init(Base64Decoder *self, Base64Options options);
+
+/*
+ * Decode `chunk[0..chunk_len]` into `out`, `out` should be able to hold
+ * `BASE64_DECODER_MAX_OUTPUT(chunk_len)` bytes.
+ *
+ * Return the count of bytes written into `out`, return `-1` if the chunk is
+ * invalid (the decoder stays in the failed state).
+ */
+long Base64Decoder_feed(Base64Decoder *self,
+                        const char *chunk,
+                        usize chunk_len,
+                        u8 *out);
+
+/*
+ * Finish decoding, the last unpadded block (if `no_padding`) is decoded
+ * into `out` (at least 3 bytes). The decoder is reset and ready for the
+ * next input.
+ *
+ * Return the count of bytes written into `out`, return `-1` if the decoder
+ * is in the failed state or the input is incomplete.
+ */
+long Base64Decoder_finish(Base64Decoder *self, u8 *out);
+
+#endif
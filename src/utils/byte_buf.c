@@ -0,0 +1,495 @@
+#include "byte_buf.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef ENABLE_DEBUG_LOG
+    #include "log.h"
+#endif
+
+//
+// The smallest capacity after the first grow
+//
+#define BYTE_BUF_MIN_CAPACITY 64
+
+//
+// `LEB128` encoded `u64` takes at most 10 bytes
+//
+#define BYTE_BUF_MAX_VARINT_LEN 10
+
+//
+// Convert between the native byte order and little/big endian, it's a no-op
+// for the native one.
+//
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    #define BB_LE16(v) __builtin_bswap16(v)
+    #define BB_LE32(v) __builtin_bswap32(v)
+    #define BB_LE64(v) __builtin_bswap64(v)
+    #define BB_BE16(v) (v)
+    #define BB_BE32(v) (v)
+    #define BB_BE64(v) (v)
+#else
+    #define BB_LE16(v) (v)
+    #define BB_LE32(v) (v)
+    #define BB_LE64(v) (v)
+    #define BB_BE16(v) __builtin_bswap16(v)
+    #define BB_BE32(v) __builtin_bswap32(v)
+    #define BB_BE64(v) __builtin_bswap64(v)
+#endif
+
+struct _ByteBuf {
+    u8 *_buffer;
+    usize _capacity;
+    usize _read_index;
+    usize _write_index;
+
+    //
+    // Created by `BB_wrap`, `_buffer` is borrowed and never written
+    //
+    bool _read_only;
+};
+
+/*
+ * Create an empty `ByteBuf`, nothing is allocated until the first write
+ */
+ByteBuf BB_new(void) {
+    ByteBuf self = malloc(sizeof(struct _ByteBuf));
+    if (self == NULL) return NULL;
+
+    *self = (struct _ByteBuf){
+        ._buffer      = NULL,
+        ._capacity    = 0,
+        ._read_index  = 0,
+        ._write_index = 0,
+        ._read_only   = false,
+    };
+
+    return self;
+}
+
+/*
+ * Create an empty `ByteBuf` with the given capacity
+ */
+ByteBuf BB_with_capacity(usize capacity) {
+    ByteBuf self = BB_new();
+    if (self == NULL || capacity == 0) return self;
+
+    self->_buffer = malloc(capacity);
+    if (self->_buffer == NULL) {
+        free(self);
+        return NULL;
+    }
+    self->_capacity = capacity;
+
+    return self;
+}
+
+/*
+ * Create `ByteBuf` by copying the bytes in `view`
+ */
+ByteBuf BB_from_view(ByteView view) {
+    ByteBuf self = BB_with_capacity(view.len);
+    if (self != NULL && view.ptr != NULL) BB_put_view(self, view);
+
+    return self;
+}
+
+/*
+ * Create a read-only `ByteBuf` on top of `view` without copying
+ */
+ByteBuf BB_wrap(ByteView view) {
+    ByteBuf self = BB_new();
+    if (self == NULL) return NULL;
+
+    if (view.ptr != NULL) {
+        self->_buffer      = (u8 *)view.ptr;
+        self->_capacity    = view.len;
+        self->_write_index = view.len;
+    }
+    self->_read_only = true;
+
+    return self;
+}
+
+/*
+ * Create `ByteBuf` by copying all bytes in the given `HexBuffer`
+ */
+ByteBuf BB_from_hex_buffer(const HexBuffer hex_buffer) {
+    if (hex_buffer == NULL) return BB_new();
+
+    HexBufferIteractor iter = Hex_iter(hex_buffer);
+    return BB_from_view((ByteView){.ptr = iter.arr, .len = iter.length});
+}
+
+/*
+ * Copy the readable bytes into a new `HexBuffer`
+ */
+HexBuffer BB_to_hex_buffer(const ByteBuf self) {
+    ByteView view = BB_as_view(self);
+    return Hex_from_raw(view.ptr, view.len);
+}
+
+/*
+ * Count of the readable bytes
+ */
+usize BB_remaining(const ByteBuf self) {
+    return (self != NULL) ? self->_write_index - self->_read_index : 0;
+}
+
+/*
+ * Count of all written bytes
+ */
+usize BB_length(const ByteBuf self) {
+    return (self != NULL) ? self->_write_index : 0;
+}
+
+/*
+ * Get back the capacity
+ */
+usize BB_capacity(const ByteBuf self) {
+    return (self != NULL) ? self->_capacity : 0;
+}
+
+/*
+ * Get back the read cursor
+ */
+usize BB_read_index(const ByteBuf self) {
+    return (self != NULL) ? self->_read_index : 0;
+}
+
+/*
+ * Move the read cursor
+ */
+bool BB_set_read_index(ByteBuf self, usize index) {
+    if (self == NULL || index > self->_write_index) return false;
+
+    self->_read_index = index;
+    return true;
+}
+
+/*
+ * Make sure `additional` bytes can be written without reallocating
+ */
+bool BB_reserve(ByteBuf self, usize additional) {
+    if (self == NULL || self->_read_only) return false;
+    if (self->_capacity - self->_write_index >= additional) return true;
+
+    //
+    // Double the capacity (at least `BYTE_BUF_MIN_CAPACITY`), or grow to the
+    // exact size if doubling is not enough.
+    //
+    usize required     = self->_write_index + additional;
+    usize new_capacity = self->_capacity * 2;
+    if (new_capacity < BYTE_BUF_MIN_CAPACITY) {
+        new_capacity = BYTE_BUF_MIN_CAPACITY;
+    }
+    if (new_capacity < required) new_capacity = required;
+
+    u8 *new_buffer = realloc(self->_buffer, new_capacity);
+    if (new_buffer == NULL) {
+#ifdef ENABLE_DEBUG_LOG
+        DEBUG_LOG(ByteBuf,
+                  reserve,
+                  "realloc failed, self ptr: %p, new_capacity: %lu",
+                  self,
+                  new_capacity);
+#endif
+        return false;
+    }
+
+    self->_buffer   = new_buffer;
+    self->_capacity = new_capacity;
+
+    return true;
+}
+
+/*
+ * Get back a view of the readable bytes
+ */
+ByteView BB_as_view(const ByteBuf self) {
+    if (self == NULL || self->_buffer == NULL) {
+        return (ByteView){.ptr = NULL, .len = 0};
+    }
+
+    return (ByteView){.ptr = self->_buffer + self->_read_index,
+                      .len = self->_write_index - self->_read_index};
+}
+
+/*
+ * Get back a view of `[offset..offset + len]` (relative to the read cursor)
+ */
+ByteView BB_slice(const ByteBuf self, usize offset, usize len) {
+    usize remaining = BB_remaining(self);
+    if (offset > remaining || len > remaining - offset) {
+        return (ByteView){.ptr = NULL, .len = 0};
+    }
+
+    return (ByteView){.ptr = self->_buffer + self->_read_index + offset,
+                      .len = len};
+}
+
+/*
+ * Read `len` bytes as a view and move the read cursor
+ */
+bool BB_get_view(ByteBuf self, usize len, ByteView *out) {
+    if (out == NULL || BB_remaining(self) < len) return false;
+
+    *out = (ByteView){.ptr = self->_buffer + self->_read_index, .len = len};
+    self->_read_index += len;
+
+    return true;
+}
+
+//
+// Append `ptr[0..len]` at the write cursor
+//
+static inline bool bb_put_raw(ByteBuf self, const void *ptr, usize len) {
+    if (!BB_reserve(self, len)) return false;
+    if (len == 0) return true;
+
+    memcpy(self->_buffer + self->_write_index, ptr, len);
+    self->_write_index += len;
+
+    return true;
+}
+
+//
+// Copy `len` bytes at the read cursor into `out`
+//
+static inline bool bb_get_raw(ByteBuf self, void *out, usize len) {
+    if (out == NULL || BB_remaining(self) < len) return false;
+    if (len == 0) return true;
+
+    memcpy(out, self->_buffer + self->_read_index, len);
+    self->_read_index += len;
+
+    return true;
+}
+
+bool BB_put_u8(ByteBuf self, u8 value) {
+    return bb_put_raw(self, &value, sizeof(value));
+}
+
+bool BB_put_u16_le(ByteBuf self, u16 value) {
+    u16 raw = BB_LE16(value);
+    return bb_put_raw(self, &raw, sizeof(raw));
+}
+
+bool BB_put_u16_be(ByteBuf self, u16 value) {
+    u16 raw = BB_BE16(value);
+    return bb_put_raw(self, &raw, sizeof(raw));
+}
+
+bool BB_put_u32_le(ByteBuf self, u32 value) {
+    u32 raw = BB_LE32(value);
+    return bb_put_raw(self, &raw, sizeof(raw));
+}
+
+bool BB_put_u32_be(ByteBuf self, u32 value) {
+    u32 raw = BB_BE32(value);
+    return bb_put_raw(self, &raw, sizeof(raw));
+}
+
+bool BB_put_u64_le(ByteBuf self, u64 value) {
+    u64 raw = BB_LE64(value);
+    return bb_put_raw(self, &raw, sizeof(raw));
+}
+
+bool BB_put_u64_be(ByteBuf self, u64 value) {
+    u64 raw = BB_BE64(value);
+    return bb_put_raw(self, &raw, sizeof(raw));
+}
+
+bool BB_put_bytes(ByteBuf self, const u8 *ptr, usize len) {
+    if (ptr == NULL) return len == 0 && self != NULL && !self->_read_only;
+
+    return bb_put_raw(self, ptr, len);
+}
+
+bool BB_put_view(ByteBuf self, ByteView view) {
+    return BB_put_bytes(self, view.ptr, view.len);
+}
+
+/*
+ * Write `value` as `LEB128` unsigned varint
+ */
+bool BB_put_varint(ByteBuf self, u64 value) {
+    //
+    // Encode on the stack first, so there is only one bounds check
+    //
+    u8 encoded[BYTE_BUF_MAX_VARINT_LEN];
+    usize len = 0;
+    while (value >= 0x80) {
+        encoded[len++] = (u8)(value | 0x80);
+        value >>= 7;
+    }
+    encoded[len++] = (u8)value;
+
+    return bb_put_raw(self, encoded, len);
+}
+
+/*
+ * Write `value` as `zigzag` encoded `LEB128` varint
+ */
+bool BB_put_varint_signed(ByteBuf self, i64 value) {
+    // 0 -> 0, -1 -> 1, 1 -> 2, -2 -> 3 ...
+    u64 zigzag = ((u64)value << 1) ^ (u64)(value >> 63);
+    return BB_put_varint(self, zigzag);
+}
+
+bool BB_get_u8(ByteBuf self, u8 *out) {
+    return bb_get_raw(self, out, sizeof(*out));
+}
+
+bool BB_get_u16_le(ByteBuf self, u16 *out) {
+    u16 raw;
+    if (out == NULL || !bb_get_raw(self, &raw, sizeof(raw))) return false;
+
+    *out = BB_LE16(raw);
+    return true;
+}
+
+bool BB_get_u16_be(ByteBuf self, u16 *out) {
+    u16 raw;
+    if (out == NULL || !bb_get_raw(self, &raw, sizeof(raw))) return false;
+
+    *out = BB_BE16(raw);
+    return true;
+}
+
+bool BB_get_u32_le(ByteBuf self, u32 *out) {
+    u32 raw;
+    if (out == NULL || !bb_get_raw(self, &raw, sizeof(raw))) return false;
+
+    *out = BB_LE32(raw);
+    return true;
+}
+
+bool BB_get_u32_be(ByteBuf self, u32 *out) {
+    u32 raw;
+    if (out == NULL || !bb_get_raw(self, &raw, sizeof(raw))) return false;
+
+    *out = BB_BE32(raw);
+    return true;
+}
+
+bool BB_get_u64_le(ByteBuf self, u64 *out) {
+    u64 raw;
+    if (out == NULL || !bb_get_raw(self, &raw, sizeof(raw))) return false;
+
+    *out = BB_LE64(raw);
+    return true;
+}
+
+bool BB_get_u64_be(ByteBuf self, u64 *out) {
+    u64 raw;
+    if (out == NULL || !bb_get_raw(self, &raw, sizeof(raw))) return false;
+
+    *out = BB_BE64(raw);
+    return true;
+}
+
+bool BB_get_bytes(ByteBuf self, u8 *out, usize len) {
+    return bb_get_raw(self, out, len);
+}
+
+/*
+ * Read a `LEB128` unsigned varint
+ */
+bool BB_get_varint(ByteBuf self, u64 *out) {
+    if (out == NULL) return false;
+
+    usize remaining = BB_remaining(self);
+    if (remaining == 0) return false;
+
+    const u8 *ptr = self->_buffer + self->_read_index;
+    u64 value     = 0;
+
+    for (usize index = 0;
+         index < remaining && index < BYTE_BUF_MAX_VARINT_LEN;
+         index++) {
+        u8 byte = ptr[index];
+
+        // The 10th byte can only carry the highest bit of `u64`
+        if (index == BYTE_BUF_MAX_VARINT_LEN - 1 && byte > 0x01) return false;
+
+        value |= (u64)(byte & 0x7F) << (index * 7);
+        if ((byte & 0x80) == 0) {
+            self->_read_index += index + 1;
+            *out = value;
+            return true;
+        }
+    }
+
+    // Truncated or too long
+    return false;
+}
+
+/*
+ * Read a `zigzag` encoded `LEB128` varint
+ */
+bool BB_get_varint_signed(ByteBuf self, i64 *out) {
+    u64 zigzag;
+    if (out == NULL || !BB_get_varint(self, &zigzag)) return false;
+
+    *out = (i64)((zigzag >> 1) ^ (~(zigzag & 1) + 1));
+    return true;
+}
+
+/*
+ * Return the encoded size of `value` as `LEB128` varint
+ */
+usize BB_varint_length(u64 value) {
+    if (value == 0) return 1;
+
+    usize bits = 64 - __builtin_clzll(value);
+    return (bits + 6) / 7;
+}
+
+/*
+ * Move the readable bytes to the beginning
+ */
+void BB_compact(ByteBuf self) {
+    if (self == NULL || self->_read_only || self->_read_index == 0) return;
+
+    usize remaining = BB_remaining(self);
+    if (remaining > 0) {
+        memmove(self->_buffer, self->_buffer + self->_read_index, remaining);
+    }
+    self->_read_index  = 0;
+    self->_write_index = remaining;
+}
+
+/*
+ * Reset both cursors to 0
+ */
+void BB_clear(ByteBuf self) {
+    if (self == NULL) return;
+
+    self->_read_index = 0;
+    if (!self->_read_only) self->_write_index = 0;
+}
+
+/*
+ * Free
+ */
+void BB_free(ByteBuf self) {
+    if (self == NULL) return;
+
+    if (!self->_read_only) free(self->_buffer);
+    free(self);
+}
+
+/*
+ *
+ */
+void auto_free_byte_buf(ByteBuf *ptr) {
+#ifdef ENABLE_DEBUG_LOG
+    DEBUG_LOG(ByteBuf,
+              auto_free_byte_buf,
+              "out of scope with byte buf ptr: %p, length: %lu",
+              *ptr,
+              BB_length(*ptr));
+#endif
+    BB_free(*ptr);
+}
@@ -0,0 +1,212 @@
+#ifndef __UTILS_BYTE_BUF_H__
+#define __UTILS_BYTE_BUF_H__
+
+#include <stdbool.h>
+
+#include "data_types.h"
+#include "hex_buffer.h"
+
+//
+// Growable byte buffer with a read cursor and a write cursor, for building
+// and parsing binary protocol frames:
+//
+// ```
+// +-------------------+------------------+------------------+
+// | already read      | readable         | writable         |
+// +-------------------+------------------+------------------+
+// 0              read_index        write_index          capacity
+// ```
+//
+// All multi-byte values are loaded and stored by `memcpy`, so it's safe for
+// any (unaligned) position.
+//
+
+/*
+ * Opaque pointer to `struct _ByteBuf`
+ */
+typedef struct _ByteBuf *ByteBuf;
+
+/*
+ * Immutable byte slice, it doesn't own the bytes
+ */
+typedef struct {
+    const u8 *ptr;
+    usize len;
+} ByteView;
+
+/*
+ * Create an empty `ByteBuf`, nothing is allocated until the first write
+ */
+ByteBuf BB_new(void);
+
+/*
+ * Create an empty `ByteBuf` with the given capacity
+ */
+ByteBuf BB_with_capacity(usize capacity);
+
+/*
+ * Create `ByteBuf` by copying the bytes in `view`, all bytes are readable
+ */
+ByteBuf BB_from_view(ByteView view);
+
+/*
+ * Create a read-only `ByteBuf` on top of `view` without copying, it's the
+ * way to parse a slice with `BB_get_xxx`. All `BB_put_xxx` return `false`.
+ * `view.ptr` must outlive the returned `ByteBuf`.
+ */
+ByteBuf BB_wrap(ByteView view);
+
+/*
+ * Create `ByteBuf` by copying all bytes in the given `HexBuffer`
+ */
+ByteBuf BB_from_hex_buffer(const HexBuffer hex_buffer);
+
+/*
+ * Copy the readable bytes into a new `HexBuffer`, return `NULL` if there is
+ * no readable byte. The caller owns the returned `HexBuffer`.
+ */
+HexBuffer BB_to_hex_buffer(const ByteBuf self);
+
+/*
+ * Count of the readable bytes (`write_index - read_index`)
+ */
+usize BB_remaining(const ByteBuf self);
+
+/*
+ * Count of all written bytes (`write_index`)
+ */
+usize BB_length(const ByteBuf self);
+
+/*
+ * Get back the capacity
+ */
+usize BB_capacity(const ByteBuf self);
+
+/*
+ * Get back the read cursor
+ */
+usize BB_read_index(const ByteBuf self);
+
+/*
+ * Move the read cursor, return `false` if `index > write_index`
+ */
+bool BB_set_read_index(ByteBuf self, usize index);
+
+/*
+ * Make sure `additional` bytes can be written without reallocating, return
+ * `false` if it's read-only or out of memory.
+ */
+bool BB_reserve(ByteBuf self, usize additional);
+
+/*
+ * Get back a view of the readable bytes (zero-copy). It's invalid after the
+ * next `BB_put_xxx`, `BB_compact` or `BB_clear`.
+ */
+ByteView BB_as_view(const ByteBuf self);
+
+/*
+ * Get back a view of `[offset..offset + len]` (relative to the read cursor)
+ * without moving the read cursor, return an empty view (`ptr == NULL`) if
+ * out of range.
+ */
+ByteView BB_slice(const ByteBuf self, usize offset, usize len);
+
+/*
+ * Read `len` bytes as a view (zero-copy) and move the read cursor, return
+ * `false` if there are not enough readable bytes.
+ */
+bool BB_get_view(ByteBuf self, usize len, ByteView *out);
+
+//
+// Write at the write cursor, the buffer grows as needed.
+//
+// Return `false` (nothing is written) if it's read-only or out of memory.
+//
+bool BB_put_u8(ByteBuf self, u8 value);
+bool BB_put_u16_le(ByteBuf self, u16 value);
+bool BB_put_u16_be(ByteBuf self, u16 value);
+bool BB_put_u32_le(ByteBuf self, u32 value);
+bool BB_put_u32_be(ByteBuf self, u32 value);
+bool BB_put_u64_le(ByteBuf self, u64 value);
+bool BB_put_u64_be(ByteBuf self, u64 value);
+bool BB_put_bytes(ByteBuf self, const u8 *ptr, usize len);
+bool BB_put_view(ByteBuf self, ByteView view);
+
+/*
+ * Write `value` as `LEB128` unsigned varint (1 ~ 10 bytes)
+ */
+bool BB_put_varint(ByteBuf self, u64 value);
+
+/*
+ * Write `value` as `zigzag` encoded `LEB128` varint, small negative values
+ * stay small (`-1` takes 1 byte).
+ */
+bool BB_put_varint_signed(ByteBuf self, i64 value);
+
+//
+// Read at the read cursor and move the read cursor.
+//
+// Return `false` (the read cursor doesn't move) if there are not enough
+// readable bytes.
+//
+bool BB_get_u8(ByteBuf self, u8 *out);
+bool BB_get_u16_le(ByteBuf self, u16 *out);
+bool BB_get_u16_be(ByteBuf self, u16 *out);
+bool BB_get_u32_le(ByteBuf self, u32 *out);
+bool BB_get_u32_be(ByteBuf self, u32 *out);
+bool BB_get_u64_le(ByteBuf self, u64 *out);
+bool BB_get_u64_be(ByteBuf self, u64 *out);
+bool BB_get_bytes(ByteBuf self, u8 *out, usize len);
+
+/*
+ * Read a `LEB128` unsigned varint, return `false` if it's truncated or
+ * longer than 10 bytes or overflows `u64`.
+ */
+bool BB_get_varint(ByteBuf self, u64 *out);
+
+/*
+ * Read a `zigzag` encoded `LEB128` varint
+ */
+bool BB_get_varint_signed(ByteBuf self, i64 *out);
+
+/*
+ * Return the encoded size of `value` as `LEB128` varint
+ */
+usize BB_varint_length(u64 value);
+
+/*
+ * Move the readable bytes to the beginning, so the already read space can be
+ * reused by the following writes.
+ */
+void BB_compact(ByteBuf self);
+
+/*
+ * Reset both cursors to 0, the capacity doesn't change. A read-only
+ * `ByteBuf` only rewinds the read cursor.
+ */
+void BB_clear(ByteBuf self);
+
+/*
+ * Free
+ */
+void BB_free(ByteBuf self);
+
+//
+//
+//
+void auto_free_byte_buf(ByteBuf *ptr);
+
+/*
+ * Define a `ByteBuf` that is freed when the variable is out of the scope
+ *
+ * ```c
+ * defer_byte_buf(frame) = BB_new();
+ * BB_put_u16_be(frame, 0xCAFE);
+ * BB_put_varint(frame, payload_len);
+ * BB_put_bytes(frame, payload, payload_len);
+ * ```
+ */
+#define defer_byte_buf(x)                                                      \
+    __attribute__((cleanup(auto_free_byte_buf))) ByteBuf x
+
+#endif
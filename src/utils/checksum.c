@@ -0,0 +1,616 @@
+#include "checksum.h"
+
+#include <string.h>
+
+#include "simd.h"
+
+//
+// Reflected polynomials
+//
+#define CRC32C_POLY 0x82F63B78
+#define CRC32_POLY 0xEDB88320
+
+//
+// `Adler-32` modulus, and the max bytes before `s2` could overflow `u32`
+//
+#define ADLER32_BASE 65521
+#define ADLER32_NMAX 5552
+
+//
+// "Slicing-by-8" tables, `[0]` is the classic byte-at-a-time table
+//
+static u32 CRC32C_TABLE[8][256];
+static u32 CRC32_TABLE[8][256];
+
+//
+// Operators to shift a `CRC32C` over `CRC32C_LONG` and `CRC32C_SHORT` zero
+// bytes, used to combine the 3 interleaved `crc32` instruction streams.
+//
+#define CRC32C_LONG 8192
+#define CRC32C_SHORT 256
+static u32 CRC32C_LONG_SHIFT[4][256];
+static u32 CRC32C_SHORT_SHIFT[4][256];
+
+//
+// Multiply the GF(2) 32x32 matrix `mat` by the vector `vec`
+//
+static u32 gf2_matrix_times(const u32 *mat, u32 vec) {
+    u32 sum = 0;
+    while (vec) {
+        if (vec & 1) sum ^= *mat;
+        vec >>= 1;
+        mat++;
+    }
+
+    return sum;
+}
+
+//
+//
+//
+static void gf2_matrix_square(u32 *square, const u32 *mat) {
+    for (usize n = 0; n < 32; n++) square[n] = gf2_matrix_times(mat, mat[n]);
+}
+
+//
+// Build the operator that applies `len` (a power of 2) zero bytes to a CRC
+//
+static void crc32c_zeros_operator(u32 *even, usize len) {
+    u32 odd[32];
+
+    // 1 zero bit
+    odd[0]  = CRC32C_POLY;
+    u32 row = 1;
+    for (usize n = 1; n < 32; n++) {
+        odd[n] = row;
+        row <<= 1;
+    }
+
+    // 2 and 4 zero bits
+    gf2_matrix_square(even, odd);
+    gf2_matrix_square(odd, even);
+
+    //
+    // Keep squaring (8 zero bits = 1 zero byte at the first round) until
+    // `len` is consumed, the last square ends up in `even` or `odd`.
+    //
+    do {
+        gf2_matrix_square(even, odd);
+        len >>= 1;
+        if (len == 0) return;
+
+        gf2_matrix_square(odd, even);
+        len >>= 1;
+    } while (len);
+
+    memcpy(even, odd, sizeof(odd));
+}
+
+//
+// Byte-wise lookup tables of the `len` zero bytes operator
+//
+static void crc32c_zeros_table(u32 table[4][256], usize len) {
+    u32 op[32];
+    crc32c_zeros_operator(op, len);
+
+    for (u32 n = 0; n < 256; n++) {
+        table[0][n] = gf2_matrix_times(op, n);
+        table[1][n] = gf2_matrix_times(op, n << 8);
+        table[2][n] = gf2_matrix_times(op, n << 16);
+        table[3][n] = gf2_matrix_times(op, n << 24);
+    }
+}
+
+//
+//
+//
+static void crc_slicing_table(u32 table[8][256], u32 poly) {
+    for (u32 n = 0; n < 256; n++) {
+        u32 crc = n;
+        for (usize bit = 0; bit < 8; bit++) {
+            crc = (crc & 1) ? (crc >> 1) ^ poly : crc >> 1;
+        }
+        table[0][n] = crc;
+    }
+
+    for (u32 n = 0; n < 256; n++) {
+        u32 crc = table[0][n];
+        for (usize k = 1; k < 8; k++) {
+            crc         = table[0][crc & 0xFF] ^ (crc >> 8);
+            table[k][n] = crc;
+        }
+    }
+}
+
+//
+// All tables are built once when the program loads, so there is no lazy
+// init (and no lock) on the hot path.
+//
+__attribute__((constructor)) static void checksum_init_tables(void) {
+    crc_slicing_table(CRC32C_TABLE, CRC32C_POLY);
+    crc_slicing_table(CRC32_TABLE, CRC32_POLY);
+    crc32c_zeros_table(CRC32C_LONG_SHIFT, CRC32C_LONG);
+    crc32c_zeros_table(CRC32C_SHORT_SHIFT, CRC32C_SHORT);
+}
+
+//
+// "Slicing-by-8": 8 bytes per iteration with 8 independent lookups.
+// `crc` is the internal (already inverted) state.
+//
+static u32 crc_slicing_by_8(u32 table[8][256],
+                            u32 crc,
+                            const u8 *ptr,
+                            usize len) {
+    while (len >= 8) {
+        u32 one = crc ^ ((u32)ptr[0] | (u32)ptr[1] << 8 | (u32)ptr[2] << 16 |
+                         (u32)ptr[3] << 24);
+        u32 two = (u32)ptr[4] | (u32)ptr[5] << 8 | (u32)ptr[6] << 16 |
+                  (u32)ptr[7] << 24;
+        crc = table[7][one & 0xFF] ^ table[6][(one >> 8) & 0xFF] ^
+              table[5][(one >> 16) & 0xFF] ^ table[4][one >> 24] ^
+              table[3][two & 0xFF] ^ table[2][(two >> 8) & 0xFF] ^
+              table[1][(two >> 16) & 0xFF] ^ table[0][two >> 24];
+        ptr += 8;
+        len -= 8;
+    }
+
+    while (len-- > 0) crc = table[0][(crc ^ *ptr++) & 0xFF] ^ (crc >> 8);
+
+    return crc;
+}
+
+#ifdef SIMD_X86_64
+
+//
+//
+//
+static inline u32 crc32c_shift(u32 table[4][256], u32 crc) {
+    return table[0][crc & 0xFF] ^ table[1][(crc >> 8) & 0xFF] ^
+           table[2][(crc >> 16) & 0xFF] ^ table[3][crc >> 24];
+}
+
+//
+// `crc32` instruction has 3 cycles latency but 1 cycle throughput, so 3
+// independent streams (over 3 adjacent blocks) run in parallel, then the
+// 3 results are combined by shifting over the zero bytes.
+//
+// `crc` is the internal (already inverted) state.
+//
+SIMD_TARGET("sse4.2")
+static u32 crc32c_sse42(u32 crc, const u8 *ptr, usize len) {
+    u64 crc0 = crc;
+
+    // Align to 8 bytes
+    while (len > 0 && ((usize)ptr & 7) != 0) {
+        crc0 = _mm_crc32_u8((u32)crc0, *ptr++);
+        len--;
+    }
+
+    #define CRC32C_SSE42_3_WAY(BLOCK_SIZE, SHIFT_TABLE)                        \
+        while (len >= (BLOCK_SIZE) * 3) {                                      \
+            u64 crc1      = 0;                                                 \
+            u64 crc2      = 0;                                                 \
+            const u8 *end = ptr + (BLOCK_SIZE);                                \
+            do {                                                               \
+                u64 word0, word1, word2;                                       \
+                memcpy(&word0, ptr, 8);                                        \
+                memcpy(&word1, ptr + (BLOCK_SIZE), 8);                         \
+                memcpy(&word2, ptr + (BLOCK_SIZE) * 2, 8);                     \
+                crc0 = _mm_crc32_u64(crc0, word0);                             \
+                crc1 = _mm_crc32_u64(crc1, word1);                             \
+                crc2 = _mm_crc32_u64(crc2, word2);                             \
+                ptr += 8;                                                      \
+            } while (ptr < end);                                               \
+            crc0 = crc32c_shift((SHIFT_TABLE), (u32)crc0) ^ crc1;              \
+            crc0 = crc32c_shift((SHIFT_TABLE), (u32)crc0) ^ crc2;              \
+            ptr += (BLOCK_SIZE) * 2;                                           \
+            len -= (BLOCK_SIZE) * 3;                                           \
+        }
+
+    CRC32C_SSE42_3_WAY(CRC32C_LONG, CRC32C_LONG_SHIFT)
+    CRC32C_SSE42_3_WAY(CRC32C_SHORT, CRC32C_SHORT_SHIFT)
+
+    #undef CRC32C_SSE42_3_WAY
+
+    while (len >= 8) {
+        u64 word;
+        memcpy(&word, ptr, 8);
+        crc0 = _mm_crc32_u64(crc0, word);
+        ptr += 8;
+        len -= 8;
+    }
+
+    while (len-- > 0) crc0 = _mm_crc32_u8((u32)crc0, *ptr++);
+
+    return (u32)crc0;
+}
+
+//
+// Fold 64 bytes per iteration with carry-less multiplication, then reduce
+// the 128 bits remainder to 32 bits with Barrett reduction ("Fast CRC
+// Computation for Generic Polynomials Using PCLMULQDQ Instruction", Intel).
+//
+// `len` must be `>= 64` and a multiple of 16, `crc` is the internal (already
+// inverted) state.
+//
+SIMD_TARGET("sse4.1,pclmul")
+static u32 crc32_pclmul(u32 crc, const u8 *ptr, usize len) {
+    //
+    // The bit-reflected constants for the zlib polynomial: `x^(n) mod P`
+    // for folding by 4 x 128 bits (k1, k2), 128 bits (k3, k4) and 64 bits
+    // (k5), plus the Barrett constants (P, mu).
+    //
+    const __m128i k1k2   = _mm_set_epi64x(0x01C6E41596, 0x0154442BD4);
+    const __m128i k3k4   = _mm_set_epi64x(0x00CCAA009E, 0x01751997D0);
+    const __m128i k5k0   = _mm_set_epi64x(0x0000000000, 0x0163CD6124);
+    const __m128i poly   = _mm_set_epi64x(0x01F7011641, 0x01DB710641);
+    const __m128i mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+
+    __m128i x1 = _mm_loadu_si128((const __m128i *)(ptr + 0x00));
+    __m128i x2 = _mm_loadu_si128((const __m128i *)(ptr + 0x10));
+    __m128i x3 = _mm_loadu_si128((const __m128i *)(ptr + 0x20));
+    __m128i x4 = _mm_loadu_si128((const __m128i *)(ptr + 0x30));
+    __m128i x5;
+
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128((int)crc));
+    ptr += 64;
+    len -= 64;
+
+    //
+    // Fold 4 x 128 bits in parallel
+    //
+    while (len >= 64) {
+        __m128i x6 = _mm_clmulepi64_si128(x2, k1k2, 0x00);
+        __m128i x7 = _mm_clmulepi64_si128(x3, k1k2, 0x00);
+        __m128i x8 = _mm_clmulepi64_si128(x4, k1k2, 0x00);
+        x5         = _mm_clmulepi64_si128(x1, k1k2, 0x00);
+
+        x1 = _mm_clmulepi64_si128(x1, k1k2, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, k1k2, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, k1k2, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, k1k2, 0x11);
+
+        x1 = _mm_xor_si128(
+            _mm_xor_si128(x1, x5),
+            _mm_loadu_si128((const __m128i *)(ptr + 0x00)));
+        x2 = _mm_xor_si128(
+            _mm_xor_si128(x2, x6),
+            _mm_loadu_si128((const __m128i *)(ptr + 0x10)));
+        x3 = _mm_xor_si128(
+            _mm_xor_si128(x3, x7),
+            _mm_loadu_si128((const __m128i *)(ptr + 0x20)));
+        x4 = _mm_xor_si128(
+            _mm_xor_si128(x4, x8),
+            _mm_loadu_si128((const __m128i *)(ptr + 0x30)));
+
+        ptr += 64;
+        len -= 64;
+    }
+
+    //
+    // Fold 4 x 128 bits into 128 bits
+    //
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+    //
+    // Fold the rest 16 bytes blocks
+    //
+    while (len >= 16) {
+        x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+        x1 = _mm_xor_si128(
+            _mm_xor_si128(x1, _mm_loadu_si128((const __m128i *)ptr)),
+            x5);
+
+        ptr += 16;
+        len -= 16;
+    }
+
+    //
+    // Fold 128 bits into 64 bits
+    //
+    x2 = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, mask32);
+    x1 = _mm_clmulepi64_si128(x1, k5k0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    //
+    // Barrett reduction to 32 bits
+    //
+    x2 = _mm_and_si128(x1, mask32);
+    x2 = _mm_clmulepi64_si128(x2, poly, 0x10);
+    x2 = _mm_and_si128(x2, mask32);
+    x2 = _mm_clmulepi64_si128(x2, poly, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    return (u32)_mm_extract_epi32(x1, 1);
+}
+
+//
+// The weight of each byte in a 32 bytes block
+//
+static const u8 ADLER32_TAPS[32] = {32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22,
+                                    21, 20, 19, 18, 17, 16, 15, 14, 13, 12, 11,
+                                    10, 9,  8,  7,  6,  5,  4,  3,  2,  1};
+
+//
+// `Adler-32` blocks of 32 bytes, for each block:
+//
+// - `s1 += sum(b[i])`
+// - `s2 += 32 * s1 + sum((32 - i) * b[i])`
+//
+// `sad` sums the bytes, `maddubs` + `madd` do the weighted sum. The `32 * s1`
+// part is delayed by accumulating `s1` of every block into `v_ps`.
+//
+// Return the count of bytes processed (a multiple of 32).
+//
+SIMD_TARGET("avx2")
+static usize adler32_avx2(u32 *s1_ptr, u32 *s2_ptr, const u8 *ptr, usize len) {
+    const __m256i taps = _mm256_loadu_si256((const __m256i *)ADLER32_TAPS);
+    const __m256i ones = _mm256_set1_epi16(1);
+    const __m256i zero = _mm256_setzero_si256();
+
+    u32 s1          = *s1_ptr;
+    u32 s2          = *s2_ptr;
+    usize blocks    = len / 32;
+    usize processed = blocks * 32;
+
+    while (blocks > 0) {
+        usize n = blocks < ADLER32_NMAX / 32 ? blocks : ADLER32_NMAX / 32;
+        blocks -= n;
+
+        __m256i v_ps = _mm256_setr_epi32((int)(s1 * n), 0, 0, 0, 0, 0, 0, 0);
+        __m256i v_s2 = _mm256_setr_epi32((int)s2, 0, 0, 0, 0, 0, 0, 0);
+        __m256i v_s1 = _mm256_setzero_si256();
+
+        while (n-- > 0) {
+            __m256i bytes = _mm256_loadu_si256((const __m256i *)ptr);
+            v_ps          = _mm256_add_epi32(v_ps, v_s1);
+            v_s1 = _mm256_add_epi32(v_s1, _mm256_sad_epu8(bytes, zero));
+            v_s2 = _mm256_add_epi32(
+                v_s2,
+                _mm256_madd_epi16(_mm256_maddubs_epi16(bytes, taps), ones));
+            ptr += 32;
+        }
+        v_s2 = _mm256_add_epi32(v_s2, _mm256_slli_epi32(v_ps, 5));
+
+        //
+        // Horizontal sum
+        //
+        __m128i sum1 = _mm_add_epi32(_mm256_castsi256_si128(v_s1),
+                                     _mm256_extracti128_si256(v_s1, 1));
+        __m128i sum2 = _mm_add_epi32(_mm256_castsi256_si128(v_s2),
+                                     _mm256_extracti128_si256(v_s2, 1));
+        sum1 = _mm_add_epi32(sum1, _mm_shuffle_epi32(sum1, 0x4E));
+        sum1 = _mm_add_epi32(sum1, _mm_shuffle_epi32(sum1, 0xB1));
+        sum2 = _mm_add_epi32(sum2, _mm_shuffle_epi32(sum2, 0x4E));
+        sum2 = _mm_add_epi32(sum2, _mm_shuffle_epi32(sum2, 0xB1));
+
+        s1 = (s1 + (u32)_mm_cvtsi128_si32(sum1)) % ADLER32_BASE;
+        s2 = (u32)_mm_cvtsi128_si32(sum2) % ADLER32_BASE;
+    }
+
+    *s1_ptr = s1;
+    *s2_ptr = s2;
+
+    return processed;
+}
+
+//
+// Same with `adler32_avx2`, but 2 x 16 bytes per block
+//
+SIMD_TARGET("ssse3")
+static usize adler32_ssse3(u32 *s1_ptr, u32 *s2_ptr, const u8 *ptr, usize len) {
+    const __m128i taps_1 = _mm_loadu_si128((const __m128i *)ADLER32_TAPS);
+    const __m128i taps_2 =
+        _mm_loadu_si128((const __m128i *)(ADLER32_TAPS + 16));
+    const __m128i ones = _mm_set1_epi16(1);
+    const __m128i zero = _mm_setzero_si128();
+
+    u32 s1          = *s1_ptr;
+    u32 s2          = *s2_ptr;
+    usize blocks    = len / 32;
+    usize processed = blocks * 32;
+
+    while (blocks > 0) {
+        usize n = blocks < ADLER32_NMAX / 32 ? blocks : ADLER32_NMAX / 32;
+        blocks -= n;
+
+        __m128i v_ps = _mm_setr_epi32((int)(s1 * n), 0, 0, 0);
+        __m128i v_s2 = _mm_setr_epi32((int)s2, 0, 0, 0);
+        __m128i v_s1 = _mm_setzero_si128();
+
+        while (n-- > 0) {
+            __m128i bytes_1 = _mm_loadu_si128((const __m128i *)ptr);
+            __m128i bytes_2 = _mm_loadu_si128((const __m128i *)(ptr + 16));
+            v_ps            = _mm_add_epi32(v_ps, v_s1);
+            v_s1 = _mm_add_epi32(v_s1, _mm_sad_epu8(bytes_1, zero));
+            v_s1 = _mm_add_epi32(v_s1, _mm_sad_epu8(bytes_2, zero));
+            v_s2 = _mm_add_epi32(
+                v_s2,
+                _mm_madd_epi16(_mm_maddubs_epi16(bytes_1, taps_1), ones));
+            v_s2 = _mm_add_epi32(
+                v_s2,
+                _mm_madd_epi16(_mm_maddubs_epi16(bytes_2, taps_2), ones));
+            ptr += 32;
+        }
+        v_s2 = _mm_add_epi32(v_s2, _mm_slli_epi32(v_ps, 5));
+
+        //
+        // Horizontal sum
+        //
+        v_s1 = _mm_add_epi32(v_s1, _mm_shuffle_epi32(v_s1, 0x4E));
+        v_s1 = _mm_add_epi32(v_s1, _mm_shuffle_epi32(v_s1, 0xB1));
+        v_s2 = _mm_add_epi32(v_s2, _mm_shuffle_epi32(v_s2, 0x4E));
+        v_s2 = _mm_add_epi32(v_s2, _mm_shuffle_epi32(v_s2, 0xB1));
+
+        s1 = (s1 + (u32)_mm_cvtsi128_si32(v_s1)) % ADLER32_BASE;
+        s2 = (u32)_mm_cvtsi128_si32(v_s2) % ADLER32_BASE;
+    }
+
+    *s1_ptr = s1;
+    *s2_ptr = s2;
+
+    return processed;
+}
+
+#endif
+
+/*
+ * Continue `CRC32C` from the previous result
+ */
+u32 Checksum_crc32c_update(u32 crc, const void *ptr, usize len) {
+    if (ptr == NULL || len == 0) return crc;
+
+    crc = ~crc;
+
+#ifdef SIMD_X86_64
+    if (SIMD_CPU_HAS("sse4.2")) {
+        return ~crc32c_sse42(crc, (const u8 *)ptr, len);
+    }
+#endif
+
+    return ~crc_slicing_by_8(CRC32C_TABLE, crc, (const u8 *)ptr, len);
+}
+
+/*
+ * `CRC32C` of `ptr[0..len]`
+ */
+u32 Checksum_crc32c(const void *ptr, usize len) {
+    return Checksum_crc32c_update(CHECKSUM_CRC32_INIT, ptr, len);
+}
+
+/*
+ * `CRC32C` of all bytes in the given `HexBuffer`
+ */
+u32 Checksum_crc32c_hex_buffer(const HexBuffer hex_buffer) {
+    if (hex_buffer == NULL) return 0;
+
+    HexBufferIteractor iter = Hex_iter(hex_buffer);
+    return Checksum_crc32c(iter.arr, iter.length);
+}
+
+/*
+ * Continue `CRC32` from the previous result
+ */
+u32 Checksum_crc32_update(u32 crc, const void *ptr, usize len) {
+    if (ptr == NULL || len == 0) return crc;
+
+    const u8 *bytes = (const u8 *)ptr;
+    crc             = ~crc;
+
+#ifdef SIMD_X86_64
+    if (len >= 64 && SIMD_CPU_HAS("pclmul") && SIMD_CPU_HAS("sse4.1")) {
+        usize folded_len = len & ~(usize)15;
+        crc              = crc32_pclmul(crc, bytes, folded_len);
+        bytes += folded_len;
+        len -= folded_len;
+    }
+#endif
+
+    return ~crc_slicing_by_8(CRC32_TABLE, crc, bytes, len);
+}
+
+/*
+ * `CRC32` of `ptr[0..len]`
+ */
+u32 Checksum_crc32(const void *ptr, usize len) {
+    return Checksum_crc32_update(CHECKSUM_CRC32_INIT, ptr, len);
+}
+
+/*
+ * `CRC32` of all bytes in the given `HexBuffer`
+ */
+u32 Checksum_crc32_hex_buffer(const HexBuffer hex_buffer) {
+    if (hex_buffer == NULL) return 0;
+
+    HexBufferIteractor iter = Hex_iter(hex_buffer);
+    return Checksum_crc32(iter.arr, iter.length);
+}
+
+/*
+ * Continue `Adler-32` from the previous result
+ */
+u32 Checksum_adler32_update(u32 adler, const void *ptr, usize len) {
+    if (ptr == NULL || len == 0) return adler;
+
+    const u8 *bytes = (const u8 *)ptr;
+    u32 s1          = adler & 0xFFFF;
+    u32 s2          = adler >> 16;
+
+#ifdef SIMD_X86_64
+    usize processed = 0;
+    if (SIMD_CPU_HAS("avx2")) {
+        processed = adler32_avx2(&s1, &s2, bytes, len);
+    } else if (SIMD_CPU_HAS("ssse3")) {
+        processed = adler32_ssse3(&s1, &s2, bytes, len);
+    }
+    bytes += processed;
+    len -= processed;
+#endif
+
+    while (len > 0) {
+        usize n = len < ADLER32_NMAX ? len : ADLER32_NMAX;
+        len -= n;
+
+        while (n >= 8) {
+            s1 += bytes[0];
+            s2 += s1;
+            s1 += bytes[1];
+            s2 += s1;
+            s1 += bytes[2];
+            s2 += s1;
+            s1 += bytes[3];
+            s2 += s1;
+            s1 += bytes[4];
+            s2 += s1;
+            s1 += bytes[5];
+            s2 += s1;
+            s1 += bytes[6];
+            s2 += s1;
+            s1 += bytes[7];
+            s2 += s1;
+            bytes += 8;
+            n -= 8;
+        }
+        while (n-- > 0) {
+            s1 += *bytes++;
+            s2 += s1;
+        }
+
+        s1 %= ADLER32_BASE;
+        s2 %= ADLER32_BASE;
+    }
+
+    return (s2 << 16) | s1;
+}
+
+/*
+ * `Adler-32` of `ptr[0..len]`
+ */
+u32 Checksum_adler32(const void *ptr, usize len) {
+    return Checksum_adler32_update(CHECKSUM_ADLER32_INIT, ptr, len);
+}
+
+/*
+ * `Adler-32` of all bytes in the given `HexBuffer`
+ */
+u32 Checksum_adler32_hex_buffer(const HexBuffer hex_buffer) {
+    if (hex_buffer == NULL) return CHECKSUM_ADLER32_INIT;
+
+    HexBufferIteractor iter = Hex_iter(hex_buffer);
+    return Checksum_adler32(iter.arr, iter.length);
+}
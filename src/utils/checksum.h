@@ -0,0 +1,86 @@
+#ifndef __UTILS_CHECKSUM_H__
+#define __UTILS_CHECKSUM_H__
+
+#include "data_types.h"
+#include "hex_buffer.h"
+
+//
+// Checksums for payload integrity:
+//
+// - `CRC32C` (Castagnoli, iSCSI/ext4/RocksDB): `SSE4.2` `crc32` instruction
+// - `CRC32` (zlib/gzip/PNG/Ethernet): `PCLMULQDQ` folding
+// - `Adler-32` (zlib): `AVX2` or `SSSE3`
+//
+// The instruction set is selected at runtime, the portable fallback is a
+// "slicing-by-8" table (CRC) or the unrolled scalar loop (Adler-32), so the
+// result is always the same on every machine.
+//
+// The `xxx_update` version continues from the previous result, which is the
+// way to checksum data chunk by chunk:
+//
+// ```c
+// u32 crc = 0;
+// while ((read_size = read(fd, chunk, sizeof(chunk))) > 0) {
+//     crc = Checksum_crc32c_update(crc, chunk, read_size);
+// }
+// ```
+//
+
+/*
+ * Initial value for `Checksum_crc32c_update` and `Checksum_crc32_update`
+ */
+#define CHECKSUM_CRC32_INIT 0
+
+/*
+ * Initial value for `Checksum_adler32_update`
+ */
+#define CHECKSUM_ADLER32_INIT 1
+
+/*
+ * `CRC32C` of `ptr[0..len]`, "123456789" is `0xE3069283`
+ */
+u32 Checksum_crc32c(const void *ptr, usize len);
+
+/*
+ * Continue `CRC32C` from the previous result (or `CHECKSUM_CRC32_INIT`)
+ */
+u32 Checksum_crc32c_update(u32 crc, const void *ptr, usize len);
+
+/*
+ * `CRC32C` of all bytes in the given `HexBuffer`, 0 if it's NULL
+ */
+u32 Checksum_crc32c_hex_buffer(const HexBuffer hex_buffer);
+
+/*
+ * `CRC32` (same with zlib `crc32()`) of `ptr[0..len]`, "123456789" is
+ * `0xCBF43926`
+ */
+u32 Checksum_crc32(const void *ptr, usize len);
+
+/*
+ * Continue `CRC32` from the previous result (or `CHECKSUM_CRC32_INIT`)
+ */
+u32 Checksum_crc32_update(u32 crc, const void *ptr, usize len);
+
+/*
+ * `CRC32` of all bytes in the given `HexBuffer`, 0 if it's NULL
+ */
+u32 Checksum_crc32_hex_buffer(const HexBuffer hex_buffer);
+
+/*
+ * `Adler-32` (same with zlib `adler32()`) of `ptr[0..len]`, "Wikipedia" is
+ * `0x11E60398`
+ */
+u32 Checksum_adler32(const void *ptr, usize len);
+
+/*
+ * Continue `Adler-32` from the previous result (or `CHECKSUM_ADLER32_INIT`)
+ */
+u32 Checksum_adler32_update(u32 adler, const void *ptr, usize len);
+
+/*
+ * `Adler-32` of all bytes in the given `HexBuffer`, 1 if it's NULL
+ */
+u32 Checksum_adler32_hex_buffer(const HexBuffer hex_buffer);
+
+#endif
@@ -0,0 +1,290 @@
+#include "string_table.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef ENABLE_DEBUG_LOG
+    #include "../log.h"
+#endif
+
+/*
+ * StringTable: Immutable table of strings created by splitting a `String`.
+ */
+struct _StringTable {
+    usize _len;
+
+    //
+    // All pieces live in this blob, each of them ends with `\0` (written over
+    // the first delimiter character)
+    //
+    char *_blob;
+
+    //
+    // `Flexible Array Member(FAM)`, allocated together with the table itself,
+    // each item points into `_blob`
+    //
+    StrView _items[];
+};
+
+//
+// Find the next `delimiter` in `ptr[0..end]`, `memchr` is vectorized by libc,
+// so only the candidates that match the first delimiter character need a
+// full compare.
+//
+static const char *string_table_find_delimiter(const char *ptr,
+                                               const char *end,
+                                               const char *delimiter,
+                                               usize delimiter_len) {
+    if (delimiter_len == 1) {
+        return memchr(ptr, delimiter[0], end - ptr);
+    }
+
+    while ((usize)(end - ptr) >= delimiter_len) {
+        const char *found =
+            memchr(ptr, delimiter[0], (end - ptr) - delimiter_len + 1);
+        if (found == NULL) return NULL;
+
+        if (memcmp(found + 1, delimiter + 1, delimiter_len - 1) == 0) {
+            return found;
+        }
+        ptr = found + 1;
+    }
+
+    return NULL;
+}
+
+/*
+ * Split `ptr[0..len]` by `delimiter` into a `StringTable`
+ */
+StringTable ST_split(const char *ptr, usize len, const char *delimiter) {
+    usize delimiter_len = (delimiter != NULL) ? strlen(delimiter) : 0;
+
+    //
+    // Count the pieces first, so the table and all items can be allocated
+    // in one go.
+    //
+    usize item_count = 0;
+    if (ptr != NULL && len > 0) {
+        item_count = 1;
+
+        if (delimiter_len > 0) {
+            const char *end   = ptr + len;
+            const char *found = ptr;
+            while ((found = string_table_find_delimiter(found,
+                                                        end,
+                                                        delimiter,
+                                                        delimiter_len)) !=
+                   NULL) {
+                item_count++;
+                found += delimiter_len;
+            }
+        }
+    }
+
+    StringTable table =
+        malloc(sizeof(struct _StringTable) + item_count * sizeof(StrView));
+    table->_len  = item_count;
+    table->_blob = NULL;
+
+#ifdef ENABLE_DEBUG_LOG
+    DEBUG_LOG(StringTable,
+              split,
+              "self ptr: %p, input len: %lu, delimiter: %s, item_count: %lu",
+              table,
+              len,
+              delimiter,
+              item_count);
+#endif
+
+    if (item_count == 0) return table;
+
+    //
+    // Copy the whole input into the blob, then replace the first character of
+    // each delimiter with `\0`, so every piece is null-terminated without
+    // moving any bytes.
+    //
+    table->_blob = malloc(len + 1);
+    memcpy(table->_blob, ptr, len);
+    table->_blob[len] = '\0';
+
+    char *piece_start = table->_blob;
+    const char *end   = table->_blob + len;
+    for (usize index = 0; index + 1 < item_count; index++) {
+        char *found = (char *)string_table_find_delimiter(piece_start,
+                                                          end,
+                                                          delimiter,
+                                                          delimiter_len);
+        *found = '\0';
+        table->_items[index] = (StrView){
+            .ptr = piece_start,
+            .len = found - piece_start,
+        };
+        piece_start = found + delimiter_len;
+    }
+    table->_items[item_count - 1] = (StrView){
+        .ptr = piece_start,
+        .len = end - piece_start,
+    };
+
+    return table;
+}
+
+/*
+ * Split the given `String` by `delimiter` into a `StringTable`
+ */
+StringTable HS_split_to_table(const String self, const char *delimiter) {
+    StrView view = HS_as_view(self);
+    return ST_split(view.ptr, view.len, delimiter);
+}
+
+/*
+ * Create a `StringTable` from packed null-terminated strings
+ */
+StringTable ST_from_packed(const char *ptr, usize len) {
+    if (ptr == NULL) len = 0;
+
+    usize item_count = 0;
+    const char *end  = ptr + len;
+    for (const char *found = ptr;
+         found < end && (found = memchr(found, '\0', end - found)) != NULL;
+         found++) {
+        item_count++;
+    }
+    bool has_tail = len > 0 && ptr[len - 1] != '\0';
+    if (has_tail) item_count++;
+
+    StringTable table =
+        malloc(sizeof(struct _StringTable) + item_count * sizeof(StrView));
+    table->_len  = item_count;
+    table->_blob = NULL;
+
+#ifdef ENABLE_DEBUG_LOG
+    DEBUG_LOG(StringTable,
+              from_packed,
+              "self ptr: %p, input len: %lu, item_count: %lu",
+              table,
+              len,
+              item_count);
+#endif
+
+    if (item_count == 0) return table;
+
+    table->_blob = malloc(len + 1);
+    memcpy(table->_blob, ptr, len);
+    table->_blob[len] = '\0';
+
+    char *piece_start = table->_blob;
+    for (usize index = 0; index < item_count; index++) {
+        usize piece_len      = strlen(piece_start);
+        table->_items[index] = (StrView){.ptr = piece_start, .len = piece_len};
+        piece_start += piece_len + 1;
+    }
+
+    return table;
+}
+
+/*
+ * Return the item count
+ */
+usize ST_len(const StringTable self) {
+    return (self != NULL) ? self->_len : 0;
+}
+
+/*
+ * Return the given index item in O(1), return `{NULL, 0}` if not exists.
+ */
+StrView ST_get(const StringTable self, usize index) {
+    if (self == NULL || index >= self->_len) {
+        return (StrView){.ptr = NULL, .len = 0};
+    }
+
+    return self->_items[index];
+}
+
+/*
+ * Return the item iterator
+ */
+StringTableIteractor ST_iter(const StringTable self) {
+    return (self == NULL)
+               ? (StringTableIteractor){.length = 0, .items = NULL}
+               : (StringTableIteractor){.length = self->_len,
+                                        .items  = self->_items};
+}
+
+//
+// `qsort` compare function
+//
+static int string_table_compare_item(const void *a, const void *b) {
+    const StrView *a_view = a;
+    const StrView *b_view = b;
+    usize min_len = a_view->len < b_view->len ? a_view->len : b_view->len;
+
+    if (min_len > 0) {
+        int result = memcmp(a_view->ptr, b_view->ptr, min_len);
+        if (result != 0) return result;
+    }
+
+    return (a_view->len > b_view->len) - (a_view->len < b_view->len);
+}
+
+/*
+ * Sort all items by content
+ */
+void ST_sort(StringTable self) {
+    if (self == NULL || self->_len < 2) return;
+
+    qsort(self->_items,
+          self->_len,
+          sizeof(StrView),
+          string_table_compare_item);
+}
+
+/*
+ * Create a `Vector` of `String` (copy every item)
+ */
+Vector ST_to_vector(const StringTable self) {
+    usize len  = ST_len(self);
+    Vector vec = Vec_with_capacity(HS_struct_size(),
+                                   TYPE_NAME_TO_STRING(String),
+                                   len,
+                                   NULL);
+
+    for (usize index = 0; index < len; index++) {
+        struct HeapString temp_str;
+        HS_init(&temp_str);
+        HS_push_view(&temp_str, self->_items[index]);
+
+        // `Vec_push` takes the ownership and resets `temp_str` to empty
+        Vec_push(vec, &temp_str);
+    }
+
+    return vec;
+}
+
+/*
+ * Free
+ */
+void ST_free(StringTable self) {
+    if (self == NULL) return;
+
+    if (self->_blob != NULL) {
+        free(self->_blob);
+        self->_blob = NULL;
+    }
+    self->_len = 0;
+    free(self);
+}
+
+/*
+ *
+ */
+void auto_free_string_table(StringTable *ptr) {
+#ifdef ENABLE_DEBUG_LOG
+    DEBUG_LOG(StringTable,
+              auto_free_string_table,
+              "out of scope with string table ptr: %p, length: %lu",
+              *ptr,
+              ST_len(*ptr));
+#endif
+    ST_free(*ptr);
+}
@@ -0,0 +1,106 @@
+#ifndef __UTILS_STRING_TABLE_H__
+#define __UTILS_STRING_TABLE_H__
+
+#include "../data_types.h"
+#include "../heap_string.h"
+#include "vector.h"
+
+/*
+ * StringTable: Immutable table of strings created by splitting a `String`.
+ *
+ * It only has 2 heap allocations no matter how many strings it holds:
+ *
+ * - The table itself with all the `StrView` items (flexible array member)
+ * - One contiguous blob that holds all the characters
+ *
+ * Each item is a `StrView` points to the blob, and it's null-terminated as
+ * well. So `HS_split_to_table` is much cheaper than creating a `String` per
+ * piece and pushing them into a `Vector`.
+ */
+typedef struct _StringTable *StringTable;
+
+/*
+ * Iteractor
+ */
+typedef struct {
+    usize length;
+    const StrView *items;
+} StringTableIteractor;
+
+/*
+ *
+ */
+void auto_free_string_table(StringTable *ptr);
+
+/*
+ * Define smart `StringTable` var that calls `ST_free()` automatically when
+ * the variable is out of the scope
+ *
+ * ```c
+ * defer_string_table(table) = HS_split_to_table(csv_line, ",");
+ * ```
+ */
+#define defer_string_table(x)                                                  \
+    __attribute__((cleanup(auto_free_string_table))) StringTable x
+
+/*
+ * Split `ptr[0..len]` by `delimiter` into a `StringTable`. Empty pieces are
+ * kept, so `"a,,b"` gives `"a"`, `""`, `"b"`.
+ *
+ * Return an empty table (`ST_len() == 0`) if `ptr` is `NULL` or `len` is 0,
+ * return a table with the whole input as the only item if `delimiter` is
+ * `NULL` or empty.
+ */
+StringTable ST_split(const char *ptr, usize len, const char *delimiter);
+
+/*
+ * Split the given `String` by `delimiter` into a `StringTable`, same rules
+ * with `ST_split`.
+ */
+StringTable HS_split_to_table(const String self, const char *delimiter);
+
+/*
+ * Create a `StringTable` from packed null-terminated strings, for example
+ * `"a\0bc\0\0d\0"` gives `"a"`, `"bc"`, `""`, `"d"`. `ptr[0..len]` is
+ * copied into the blob as it is, the last string without `\0` is kept as
+ * well.
+ *
+ * Return an empty table (`ST_len() == 0`) if `ptr` is `NULL` or `len` is 0.
+ */
+StringTable ST_from_packed(const char *ptr, usize len);
+
+/*
+ * Return the item count
+ */
+usize ST_len(const StringTable self);
+
+/*
+ * Return the given index item in O(1), return `{NULL, 0}` if not exists. The
+ * view is valid until `ST_free` gets called.
+ */
+StrView ST_get(const StringTable self, usize index);
+
+/*
+ * Return the item iterator
+ */
+StringTableIteractor ST_iter(const StringTable self);
+
+/*
+ * Sort all items by content (byte by byte compare, the shorter one goes
+ * first when it's the prefix of the longer one). Only the items get moved,
+ * the blob stays untouched.
+ */
+void ST_sort(StringTable self);
+
+/*
+ * Create a `Vector` of `String` (copy every item), only do this when you
+ * really need to own or modify the pieces.
+ */
+Vector ST_to_vector(const StringTable self);
+
+/*
+ * Free
+ */
+void ST_free(StringTable self);
+
+#endif
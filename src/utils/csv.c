@@ -0,0 +1,811 @@
+#include "csv.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "simd.h"
+
+#ifdef ENABLE_DEBUG_LOG
+    #include "log.h"
+#endif
+
+//
+// One parsed chunk, every worker thread has its own one
+//
+typedef struct {
+    char delimiter;
+    bool quotes;
+
+    // Input
+    const char *input;
+    usize input_len;
+    bool is_last;
+
+    // Stage 1: positions of the delimiters and newlines outside the quoted
+    // fields, relative to `input`
+    u32 *positions;
+    usize positions_capacity;
+
+    // Stage 2: all fields, and the field index after the last field of
+    // each row
+    StrView *fields;
+    usize field_count;
+    usize field_capacity;
+    usize *row_ends;
+    usize row_count;
+    usize row_capacity;
+    CsvRow *rows;
+    usize rows_capacity;
+
+    // The unescaped quoted fields (the ones contain `""`)
+    char *scratch;
+    usize scratch_len;
+    usize scratch_capacity;
+
+    // The end of the last complete row
+    usize consumed;
+    bool unterminated_quote;
+} CsvParsed;
+
+struct _CsvReader {
+    CsvOptions options;
+    bool parallel;
+
+    // In memory input
+    const char *data;
+    usize data_len;
+    usize data_offset;
+
+    // Streaming input
+    int fd;
+    char *buffer;
+    usize buffer_capacity;
+    usize buffer_start;
+    usize buffer_end;
+    bool eof;
+
+    // `parsed[0..parsed_ready]` are the chunks loaded in the last batch,
+    // rows are returned from `parsed[current].rows[current_row]`
+    CsvParsed *parsed;
+    usize parsed_count;
+    usize parsed_ready;
+    usize current;
+    usize current_row;
+
+    String error;
+};
+
+//
+// Stage 1: index
+//
+// Each 64 bytes block gives 2 bitmasks, the quotes and the separators
+// (delimiters + newlines). The prefix XOR of the quote bits is the "inside
+// quoted field" mask: the bit is 1 from an opening quote until the closing
+// one, an escaped `""` toggles it twice. The separators inside are dropped.
+//
+static inline u64 csv_prefix_xor(u64 bits) {
+    bits ^= bits << 1;
+    bits ^= bits << 2;
+    bits ^= bits << 4;
+    bits ^= bits << 8;
+    bits ^= bits << 16;
+    bits ^= bits << 32;
+
+    return bits;
+}
+
+/*
+ * Append the separator positions in the block to `positions`, `inside` is
+ * all 1 bits if the block starts inside a quoted field.
+ *
+ * Return the new count of `positions`.
+ */
+static inline usize csv_index_block(u64 quote_bits,
+                                    u64 separator_bits,
+                                    u64 *inside,
+                                    u32 base,
+                                    u32 *positions,
+                                    usize count) {
+    u64 quoted = csv_prefix_xor(quote_bits) ^ *inside;
+    *inside    = (u64)((i64)quoted >> 63);
+
+    separator_bits &= ~quoted;
+    while (separator_bits != 0) {
+        positions[count++] = base + (u32)__builtin_ctzll(separator_bits);
+        separator_bits &= separator_bits - 1;
+    }
+
+    return count;
+}
+
+static inline void csv_block_masks(const u8 *ptr,
+                                   u8 delimiter,
+                                   u64 *quote_bits,
+                                   u64 *separator_bits) {
+    u64 quotes     = 0;
+    u64 separators = 0;
+    for (usize index = 0; index < 64; index++) {
+        quotes |= (u64)(ptr[index] == '"') << index;
+        separators |= (u64)(ptr[index] == delimiter || ptr[index] == '\n')
+                      << index;
+    }
+
+    *quote_bits     = quotes;
+    *separator_bits = separators;
+}
+
+#ifdef SIMD_X86_64
+/*
+ * Index the `len` (multiple of 64) bytes with `AVX2`
+ */
+SIMD_TARGET("avx2")
+static usize csv_index_avx2(const u8 *ptr,
+                            usize len,
+                            u8 delimiter,
+                            u64 quote_enabled,
+                            u64 *inside,
+                            u32 *positions) {
+    const __m256i quote     = _mm256_set1_epi8('"');
+    const __m256i separator = _mm256_set1_epi8((char)delimiter);
+    const __m256i newline   = _mm256_set1_epi8('\n');
+
+    usize count = 0;
+    for (usize index = 0; index < len; index += 64) {
+        __m256i low  = _mm256_loadu_si256((const __m256i *)(ptr + index));
+        __m256i high = _mm256_loadu_si256((const __m256i *)(ptr + index + 32));
+
+        u64 quote_bits =
+            (u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(low, quote)) |
+            (u64)(u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(high, quote))
+                << 32;
+        u64 separator_bits =
+            (u32)_mm256_movemask_epi8(
+                _mm256_or_si256(_mm256_cmpeq_epi8(low, separator),
+                                _mm256_cmpeq_epi8(low, newline))) |
+            (u64)(u32)_mm256_movemask_epi8(
+                _mm256_or_si256(_mm256_cmpeq_epi8(high, separator),
+                                _mm256_cmpeq_epi8(high, newline)))
+                << 32;
+
+        count = csv_index_block(quote_bits & quote_enabled,
+                                separator_bits,
+                                inside,
+                                index,
+                                positions,
+                                count);
+    }
+
+    return count;
+}
+
+/*
+ * Index the `len` (multiple of 64) bytes with `SSE2`
+ */
+static usize csv_index_sse2(const u8 *ptr,
+                            usize len,
+                            u8 delimiter,
+                            u64 quote_enabled,
+                            u64 *inside,
+                            u32 *positions) {
+    const __m128i quote     = _mm_set1_epi8('"');
+    const __m128i separator = _mm_set1_epi8((char)delimiter);
+    const __m128i newline   = _mm_set1_epi8('\n');
+
+    usize count = 0;
+    for (usize index = 0; index < len; index += 64) {
+        u64 quote_bits     = 0;
+        u64 separator_bits = 0;
+        for (usize part = 0; part < 4; part++) {
+            __m128i v =
+                _mm_loadu_si128((const __m128i *)(ptr + index + part * 16));
+            quote_bits |= (u64)(u32)_mm_movemask_epi8(_mm_cmpeq_epi8(v, quote))
+                          << (part * 16);
+            separator_bits |=
+                (u64)(u32)_mm_movemask_epi8(
+                    _mm_or_si128(_mm_cmpeq_epi8(v, separator),
+                                 _mm_cmpeq_epi8(v, newline)))
+                << (part * 16);
+        }
+
+        count = csv_index_block(quote_bits & quote_enabled,
+                                separator_bits,
+                                inside,
+                                index,
+                                positions,
+                                count);
+    }
+
+    return count;
+}
+#endif
+
+/*
+ * Index `ptr[0..len]`, `positions` should be able to hold `len` items.
+ *
+ * Return the count of positions, `inside` is all 1 bits if the input ends
+ * inside a quoted field.
+ */
+static usize csv_index(const u8 *ptr,
+                       usize len,
+                       u8 delimiter,
+                       bool quotes,
+                       u64 *inside,
+                       u32 *positions) {
+    u64 quote_enabled = quotes ? ~(u64)0 : 0;
+    usize full_len    = len & ~(usize)63;
+    usize count       = 0;
+    usize index       = 0;
+
+#ifdef SIMD_X86_64
+    if (full_len > 0) {
+        count = SIMD_CPU_HAS("avx2")
+                    ? csv_index_avx2(ptr,
+                                     full_len,
+                                     delimiter,
+                                     quote_enabled,
+                                     inside,
+                                     positions)
+                    : csv_index_sse2(ptr,
+                                     full_len,
+                                     delimiter,
+                                     quote_enabled,
+                                     inside,
+                                     positions);
+        index = full_len;
+    }
+#endif
+
+    u64 quote_bits;
+    u64 separator_bits;
+    for (; index < full_len; index += 64) {
+        csv_block_masks(ptr + index, delimiter, &quote_bits, &separator_bits);
+        count = csv_index_block(quote_bits & quote_enabled,
+                                separator_bits,
+                                inside,
+                                index,
+                                positions,
+                                count);
+    }
+
+    //
+    // The last partial block, padded with `\0` (never a separator, as the
+    // delimiter can't be `\0`)
+    //
+    if (index < len) {
+        u8 tail[64] = {0};
+        memcpy(tail, ptr + index, len - index);
+        csv_block_masks(tail, delimiter, &quote_bits, &separator_bits);
+        count = csv_index_block(quote_bits & quote_enabled,
+                                separator_bits,
+                                inside,
+                                index,
+                                positions,
+                                count);
+    }
+
+    return count;
+}
+
+//
+// Stage 2: walk the positions
+//
+
+static void csv_push_field(CsvParsed *self,
+                           const char *start,
+                           const char *end) {
+    if (self->field_count == self->field_capacity) {
+        self->field_capacity =
+            self->field_capacity == 0 ? 1024 : self->field_capacity * 2;
+        self->fields =
+            realloc(self->fields, self->field_capacity * sizeof(StrView));
+    }
+
+    if (!self->quotes || start == end || *start != '"') {
+        self->fields[self->field_count++] =
+            (StrView){.ptr = start, .len = end - start};
+        return;
+    }
+
+    //
+    // Quoted field: remove the quotes, unescape `""` into the scratch
+    // buffer only if there is any
+    //
+    const char *content     = start + 1;
+    const char *content_end = end;
+    if (content_end > content && content_end[-1] == '"') content_end--;
+
+    usize content_len = content_end - content;
+    if (memchr(content, '"', content_len) == NULL) {
+        self->fields[self->field_count++] =
+            (StrView){.ptr = content, .len = content_len};
+        return;
+    }
+
+    if (self->scratch_capacity < self->input_len) {
+        free(self->scratch);
+        self->scratch          = malloc(self->input_len);
+        self->scratch_capacity = self->input_len;
+    }
+
+    char *unescaped = self->scratch + self->scratch_len;
+    usize len       = 0;
+    for (const char *ptr = content; ptr < content_end; ptr++) {
+        unescaped[len++] = *ptr;
+        if (*ptr == '"' && ptr + 1 < content_end && ptr[1] == '"') ptr++;
+    }
+    self->scratch_len += len;
+
+    self->fields[self->field_count++] = (StrView){.ptr = unescaped, .len = len};
+}
+
+static void csv_push_row(CsvParsed *self) {
+    if (self->row_count == self->row_capacity) {
+        self->row_capacity =
+            self->row_capacity == 0 ? 256 : self->row_capacity * 2;
+        self->row_ends =
+            realloc(self->row_ends, self->row_capacity * sizeof(usize));
+    }
+
+    self->row_ends[self->row_count++] = self->field_count;
+}
+
+/*
+ * Parse `self->input[0..input_len]` into rows, the incomplete last row is
+ * left for the next chunk unless `is_last`.
+ */
+static void csv_parse(CsvParsed *self) {
+    const char *input = self->input;
+    usize len         = self->input_len;
+
+    self->field_count        = 0;
+    self->row_count          = 0;
+    self->scratch_len        = 0;
+    self->consumed           = 0;
+    self->unterminated_quote = false;
+
+    if (self->positions_capacity < len + 1) {
+        free(self->positions);
+        self->positions          = malloc((len + 1) * sizeof(u32));
+        self->positions_capacity = len + 1;
+    }
+
+    u64 inside  = 0;
+    usize count = csv_index((const u8 *)input,
+                            len,
+                            (u8)self->delimiter,
+                            self->quotes,
+                            &inside,
+                            self->positions);
+
+    //
+    // The last row doesn't need the newline, a virtual one at the end
+    //
+    if (self->is_last) {
+        if (inside != 0) {
+            self->unterminated_quote = true;
+        } else {
+            self->positions[count++] = (u32)len;
+        }
+    }
+
+    usize field_start = 0;
+    usize row_start   = 0;
+    usize row_field   = 0;
+    for (usize index = 0; index < count; index++) {
+        usize position  = self->positions[index];
+        bool is_newline = position == len || input[position] == '\n';
+
+        usize field_end = position;
+        if (is_newline && field_end > field_start &&
+            input[field_end - 1] == '\r') {
+            field_end--;
+        }
+        csv_push_field(self, input + field_start, input + field_end);
+        field_start = position + 1;
+
+        if (!is_newline) continue;
+
+        //
+        // Skip the empty line
+        //
+        if (self->field_count - row_field == 1 && field_end == row_start) {
+            self->field_count--;
+        } else {
+            csv_push_row(self);
+        }
+        row_field      = self->field_count;
+        row_start      = position + 1;
+        self->consumed = position < len ? position + 1 : len;
+    }
+
+    // Drop the fields of the incomplete row
+    self->field_count = row_field;
+
+    //
+    // All fields are in place, so the rows can point to them
+    //
+    if (self->rows_capacity < self->row_count) {
+        free(self->rows);
+        self->rows          = malloc(self->row_count * sizeof(CsvRow));
+        self->rows_capacity = self->row_count;
+    }
+    usize first_field = 0;
+    for (usize index = 0; index < self->row_count; index++) {
+        self->rows[index] = (CsvRow){
+            .fields      = self->fields + first_field,
+            .field_count = self->row_ends[index] - first_field,
+        };
+        first_field = self->row_ends[index];
+    }
+}
+
+static void *csv_parse_worker(void *arg) {
+    csv_parse(arg);
+    return NULL;
+}
+
+//
+// Reader
+//
+
+static void csv_set_error(CsvReader self, const char *error) {
+    if (self->error != NULL) HS_free(self->error);
+    self->error = HS_from_str(error);
+}
+
+static CsvReader csv_new(CsvOptions options) {
+    if (options.delimiter == '\0') options.delimiter = ',';
+    if (options.chunk_size == 0) options.chunk_size = CSV_DEFAULT_CHUNK_SIZE;
+
+    CsvReader self = malloc(sizeof(struct _CsvReader));
+    *self          = (struct _CsvReader){.options = options, .fd = -1};
+
+    return self;
+}
+
+/*
+ * Create `count` parsers
+ */
+static void csv_init_parsed(CsvReader self, usize count) {
+    self->parsed       = calloc(count, sizeof(CsvParsed));
+    self->parsed_count = count;
+    for (usize index = 0; index < count; index++) {
+        self->parsed[index].delimiter = self->options.delimiter;
+        self->parsed[index].quotes    = !self->options.no_quotes;
+    }
+}
+
+/*
+ * Check the chunk size, the positions are `u32`
+ */
+static bool csv_check_chunk_size(CsvReader self, usize len) {
+    if (len <= 0xFFFFFFFF) return true;
+
+    csv_set_error(self, "Row is too big");
+    return false;
+}
+
+/*
+ * Load the next chunk of the in memory input
+ */
+static bool csv_load_memory_chunk(CsvReader self) {
+    usize remaining = self->data_len - self->data_offset;
+    if (remaining == 0) return false;
+
+    CsvParsed *parsed = &self->parsed[0];
+    usize chunk_size  = self->options.chunk_size;
+    for (;;) {
+        usize len = chunk_size < remaining ? chunk_size : remaining;
+        if (!csv_check_chunk_size(self, len)) return false;
+
+        parsed->input     = self->data + self->data_offset;
+        parsed->input_len = len;
+        parsed->is_last   = len == remaining;
+        csv_parse(parsed);
+
+        // A row bigger than the chunk
+        if (parsed->consumed > 0 || parsed->is_last) break;
+        chunk_size *= 2;
+    }
+
+    if (parsed->unterminated_quote) {
+        csv_set_error(self, "Unterminated quoted field");
+    }
+    self->data_offset += parsed->consumed;
+    self->parsed_ready = 1;
+
+    return true;
+}
+
+/*
+ * Load the next `threads` chunks of the in memory input (no quotes) and
+ * parse them at the same time. Every chunk ends after a newline, so they
+ * can be parsed independently.
+ */
+static bool csv_load_memory_chunks_parallel(CsvReader self) {
+    usize ready = 0;
+    while (ready < self->parsed_count && self->data_offset < self->data_len) {
+        usize start = self->data_offset;
+        usize end   = start + self->options.chunk_size;
+        if (end >= self->data_len) {
+            end = self->data_len;
+        } else {
+            const char *newline =
+                memchr(self->data + end, '\n', self->data_len - end);
+            end = newline != NULL ? (usize)(newline - self->data) + 1
+                                  : self->data_len;
+        }
+        if (!csv_check_chunk_size(self, end - start)) return false;
+
+        CsvParsed *parsed = &self->parsed[ready++];
+        parsed->input     = self->data + start;
+        parsed->input_len = end - start;
+        parsed->is_last   = true;
+        self->data_offset = end;
+    }
+    if (ready == 0) return false;
+
+    //
+    // The calling thread parses the first chunk
+    //
+    pthread_t thread_ids[ready];
+    bool started[ready];
+    for (usize index = 1; index < ready; index++) {
+        started[index] = pthread_create(&thread_ids[index],
+                                        NULL,
+                                        csv_parse_worker,
+                                        &self->parsed[index]) == 0;
+    }
+    csv_parse(&self->parsed[0]);
+    for (usize index = 1; index < ready; index++) {
+        if (started[index]) {
+            pthread_join(thread_ids[index], NULL);
+        } else {
+            csv_parse(&self->parsed[index]);
+        }
+    }
+    self->parsed_ready = ready;
+
+    return true;
+}
+
+/*
+ * Load the next chunk from the fd, the incomplete last row is moved to the
+ * beginning of the buffer and completed by the next read
+ */
+static bool csv_load_stream_chunk(CsvReader self) {
+    CsvParsed *parsed = &self->parsed[0];
+
+    for (;;) {
+        if (self->buffer_start > 0) {
+            memmove(self->buffer,
+                    self->buffer + self->buffer_start,
+                    self->buffer_end - self->buffer_start);
+            self->buffer_end -= self->buffer_start;
+            self->buffer_start = 0;
+        }
+
+        while (!self->eof && self->buffer_end < self->buffer_capacity) {
+            ssize_t read_size = read(self->fd,
+                                     self->buffer + self->buffer_end,
+                                     self->buffer_capacity - self->buffer_end);
+            if (read_size < 0) {
+                if (errno == EINTR) continue;
+
+                csv_set_error(self, strerror(errno));
+                return false;
+            }
+            if (read_size == 0) {
+                self->eof = true;
+            } else {
+                self->buffer_end += read_size;
+            }
+        }
+        if (self->buffer_end == 0) return false;
+
+        parsed->input     = self->buffer;
+        parsed->input_len = self->buffer_end;
+        parsed->is_last   = self->eof;
+        csv_parse(parsed);
+        if (parsed->consumed > 0 || self->eof) break;
+
+        //
+        // A row bigger than the buffer
+        //
+        usize new_capacity = self->buffer_capacity * 2;
+        if (!csv_check_chunk_size(self, new_capacity)) return false;
+
+        self->buffer          = realloc(self->buffer, new_capacity);
+        self->buffer_capacity = new_capacity;
+    }
+
+    if (parsed->unterminated_quote) {
+        csv_set_error(self, "Unterminated quoted field");
+    }
+    self->buffer_start = parsed->consumed;
+    if (self->eof && parsed->consumed == 0) {
+        // Nothing left but the unterminated quoted field
+        self->buffer_start = self->buffer_end;
+    }
+    self->parsed_ready = 1;
+
+    return true;
+}
+
+/*
+ * Move to the next parsed chunk, load new chunks if needed
+ */
+static bool csv_next_chunk(CsvReader self) {
+    if (self->current + 1 < self->parsed_ready) {
+        self->current++;
+        self->current_row = 0;
+        return true;
+    }
+
+    if (self->error != NULL) return false;
+
+    self->current      = 0;
+    self->current_row  = 0;
+    self->parsed_ready = 0;
+    if (self->fd >= 0) return csv_load_stream_chunk(self);
+    if (self->parallel) return csv_load_memory_chunks_parallel(self);
+
+    return csv_load_memory_chunk(self);
+}
+
+static bool csv_has_rows(CsvReader self) {
+    return self->current < self->parsed_ready &&
+           self->current_row < self->parsed[self->current].row_count;
+}
+
+/*
+ * Create a reader on the given `File`
+ */
+CsvReader Csv_open(File file, CsvOptions options) {
+    if (file == NULL || !File_is_open_successfully(file)) return NULL;
+
+    //
+    // Loaded or mapped
+    //
+    if (File_get_data(file) != NULL) {
+        StrView data = File_as_view(file);
+        return Csv_from_memory(data.ptr, data.len, options);
+    }
+
+    //
+    // The buffered appends go to the file first
+    //
+    if (!File_flush(file)) return NULL;
+    if (file->mode != FM_READ_ONLY) fflush(file->inner);
+
+    CsvReader self = csv_new(options);
+    self->fd       = fileno(file->inner);
+    csv_init_parsed(self, 1);
+
+    // Read from the beginning, it fails on a pipe which is fine
+    lseek(self->fd, 0, SEEK_SET);
+
+    self->buffer          = malloc(self->options.chunk_size);
+    self->buffer_capacity = self->options.chunk_size;
+
+#ifdef ENABLE_DEBUG_LOG
+    DEBUG_LOG(Csv,
+              open,
+              "self ptr: %p, filename: %s, chunk_size: %lu",
+              self,
+              File_get_filename(file),
+              self->options.chunk_size);
+#endif
+
+    return self;
+}
+
+/*
+ * Create a reader on `ptr[0..len]`
+ */
+CsvReader Csv_from_memory(const char *ptr, usize len, CsvOptions options) {
+    CsvReader self = csv_new(options);
+    self->data     = ptr;
+    self->data_len = ptr != NULL ? len : 0;
+
+    usize threads = 1;
+    if (options.parallel && options.no_quotes) {
+        threads = options.threads;
+        if (threads == 0) {
+            long cpu_count = sysconf(_SC_NPROCESSORS_ONLN);
+            threads        = cpu_count > 0 ? (usize)cpu_count : 1;
+        }
+        self->parallel = true;
+    }
+    csv_init_parsed(self, threads);
+
+#ifdef ENABLE_DEBUG_LOG
+    DEBUG_LOG(Csv,
+              from_memory,
+              "self ptr: %p, len: %lu, chunk_size: %lu, threads: %lu",
+              self,
+              self->data_len,
+              self->options.chunk_size,
+              threads);
+#endif
+
+    return self;
+}
+
+/*
+ * Read the next row
+ */
+bool Csv_read_row(CsvReader self, CsvRow *row) {
+    if (self == NULL || row == NULL) return false;
+
+    while (!csv_has_rows(self)) {
+        if (!csv_next_chunk(self)) return false;
+    }
+
+    *row = self->parsed[self->current].rows[self->current_row++];
+
+    return true;
+}
+
+/*
+ * Read all the rows left in the current chunk
+ */
+bool Csv_read_chunk(CsvReader self, CsvChunk *chunk) {
+    if (self == NULL || chunk == NULL) return false;
+
+    while (!csv_has_rows(self)) {
+        if (!csv_next_chunk(self)) return false;
+    }
+
+    CsvParsed *parsed = &self->parsed[self->current];
+    *chunk            = (CsvChunk){
+                   .rows      = parsed->rows + self->current_row,
+                   .row_count = parsed->row_count - self->current_row,
+    };
+    self->current_row = parsed->row_count;
+
+    return true;
+}
+
+/*
+ * Return the error
+ */
+const char *Csv_get_error(const CsvReader self) {
+    return (self != NULL && self->error != NULL) ? HS_as_str(self->error)
+                                                 : NULL;
+}
+
+/*
+ * Free
+ */
+void Csv_free(CsvReader self) {
+    if (self == NULL) return;
+
+    for (usize index = 0; index < self->parsed_count; index++) {
+        CsvParsed *parsed = &self->parsed[index];
+        free(parsed->positions);
+        free(parsed->fields);
+        free(parsed->row_ends);
+        free(parsed->rows);
+        free(parsed->scratch);
+    }
+    free(self->parsed);
+    free(self->buffer);
+    if (self->error != NULL) HS_free(self->error);
+
+#ifdef ENABLE_DEBUG_LOG
+    DEBUG_LOG(Csv, free, "self ptr: %p", self);
+#endif
+
+    free(self);
+}
+
+/*
+ * Auto free csv reader
+ */
+void auto_free_csv_reader(CsvReader *ptr) {
+    Csv_free(*ptr);
+}
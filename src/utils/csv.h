@@ -0,0 +1,149 @@
+#ifndef __UTILS_CSV_H__
+#define __UTILS_CSV_H__
+
+#include <stdbool.h>
+
+#include "data_types.h"
+#include "file.h"
+#include "heap_string.h"
+
+//
+// Streaming CSV / TSV (RFC 4180) reader.
+//
+// The input is parsed chunk by chunk in 2 stages:
+//
+// 1. Index: find all quotes, delimiters and newlines 64 bytes at a time as
+//    bitmasks (`AVX2` / `SSE2` / scalar), drop the ones inside the quoted
+//    fields (prefix XOR of the quote bits), and keep the positions of the
+//    rest.
+// 2. Walk the positions, each field is a `StrView` points to the chunk (no
+//    copy). Only the quoted fields that contain `""` are unescaped into a
+//    per chunk buffer.
+//
+// Rules:
+//
+// - A field can be quoted by `"`, the quoted field can contain delimiters,
+//   newlines and `""` (an escaped `"`)
+// - Rows end with `\n` or `\r\n`, the last row doesn't need the newline
+// - Empty lines are skipped
+//
+
+/*
+ * Opaque pointer to `struct _CsvReader`
+ */
+typedef struct _CsvReader *CsvReader;
+
+/*
+ * The default chunk size, a row bigger than the chunk grows the chunk
+ */
+#define CSV_DEFAULT_CHUNK_SIZE (1024 * 1024)
+
+/*
+ * Reader options, `(CsvOptions){0}` is the standard CSV
+ *
+ * - `delimiter`: `\0` means `,`, use `\t` for TSV
+ * - `no_quotes`: `"` is a normal character (most TSV files)
+ * - `chunk_size`: `0` means `CSV_DEFAULT_CHUNK_SIZE`
+ * - `parallel`: parse `threads` chunks at the same time, it only works for
+ *   `no_quotes` in memory input (`Csv_from_memory`, or `Csv_open` on a
+ *   loaded or mapped `File`), as the row boundaries are unknown with quotes
+ *   until parsing from the beginning. It's ignored otherwise.
+ * - `threads`: `0` means the count of online CPUs
+ */
+typedef struct {
+    char delimiter;
+    bool no_quotes;
+    usize chunk_size;
+    bool parallel;
+    usize threads;
+} CsvOptions;
+
+/*
+ * A row, `fields[0..field_count]` (NOT null-terminated) are valid until the
+ * next chunk is loaded
+ */
+typedef struct {
+    const StrView *fields;
+    usize field_count;
+} CsvRow;
+
+/*
+ * All rows in a chunk, valid until the next chunk is loaded
+ */
+typedef struct {
+    const CsvRow *rows;
+    usize row_count;
+} CsvChunk;
+
+//
+//
+//
+void auto_free_csv_reader(CsvReader *ptr);
+
+/*
+ * Define smart `CsvReader` var that calls `Csv_free()` automatically when
+ * the variable is out of the scope
+ *
+ * ```c
+ * defer_file(file)      = File_open("export.csv", FM_READ_ONLY);
+ * defer_csv_reader(csv) = Csv_open(file, (CsvOptions){0});
+ *
+ * CsvRow row;
+ * while (Csv_read_row(csv, &row)) {
+ *     for (usize index = 0; index < row.field_count; index++) {
+ *         printf("%.*s ", (int)row.fields[index].len, row.fields[index].ptr);
+ *     }
+ * }
+ *
+ * if (Csv_get_error(csv) != NULL) {
+ *     printf("\n>>> Invalid CSV: %s", Csv_get_error(csv));
+ * }
+ * ```
+ */
+#define defer_csv_reader(x)                                                    \
+    __attribute__((cleanup(auto_free_csv_reader))) CsvReader x
+
+/*
+ * Create a reader on the given `File`:
+ *
+ * - the file is loaded or mapped: parse `File_as_view` in memory
+ * - otherwise: write the buffered appends (if any), then read the file (or
+ *   pipe) from the beginning chunk by chunk
+ *
+ * The `File` should outlive the reader. Return `NULL` if the file isn't
+ * opened, or the buffered appends can't be written (`File_get_error`).
+ */
+CsvReader Csv_open(File file, CsvOptions options);
+
+/*
+ * Create a reader on `ptr[0..len]`, `ptr` should outlive the reader
+ */
+CsvReader Csv_from_memory(const char *ptr, usize len, CsvOptions options);
+
+/*
+ * Read the next row, return `false` at the end of input or on error
+ * (`Csv_get_error` is not `NULL`).
+ */
+bool Csv_read_row(CsvReader self, CsvRow *row);
+
+/*
+ * Read all the rows left in the current chunk (or load the next chunk), the
+ * same rows are not returned by `Csv_read_row` again. Return `false` at the
+ * end of input or on error.
+ */
+bool Csv_read_chunk(CsvReader self, CsvChunk *chunk);
+
+/*
+ * Return the error, `NULL` if no error:
+ *
+ * - a quoted field isn't closed at the end of input
+ * - reading the file fails
+ */
+const char *Csv_get_error(const CsvReader self);
+
+/*
+ * Free
+ */
+void Csv_free(CsvReader self);
+
+#endif
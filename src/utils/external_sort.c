@@ -0,0 +1,815 @@
+#include "external_sort.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "collections/vector.h"
+#include "heap_string.h"
+
+#ifdef ENABLE_DEBUG_LOG
+    #include "log.h"
+#endif
+
+//
+// Input read buffer size, and the limits of the run read buffer size when
+// merging (it's `memory_budget / (runs + 1)` in between)
+//
+#define EXTERNAL_SORT_INPUT_BUFFER_SIZE (1024 * 1024)
+#define EXTERNAL_SORT_MIN_RUN_BUFFER_SIZE (64 * 1024)
+#define EXTERNAL_SORT_MAX_RUN_BUFFER_SIZE (4 * 1024 * 1024)
+
+//
+// Blocks of this many lines are sorted by insertion sort before merging
+//
+#define EXTERNAL_SORT_INSERTION_SIZE 16
+
+//
+// A line in the run buffer, most of the compares are done by `prefix`:
+// the first 8 bytes of the key (big endian, zero padded), or the number
+// with the sign bit flipped for `numeric`
+//
+typedef struct {
+    u64 prefix;
+    usize offset;
+    u32 len;
+    u32 key_start;
+    u32 key_len;
+} ExternalSortLine;
+
+//
+// A sorted run in a temp file, `order` is the position of its first line
+// in the input (the runs merged by a pass take the smallest one), the
+// lines with the same key are merged in that order
+//
+typedef struct {
+    File file;
+    usize order;
+} ExternalSortRun;
+
+//
+// The current line of a run when merging
+//
+typedef struct {
+    File file;
+    usize order;
+    StrView line;
+    u64 prefix;
+    const char *key;
+    usize key_len;
+} ExternalSortCursor;
+
+struct _ExternalSort {
+    ExternalSortOptions options;
+    const char *temp_folder;
+
+    // The lines of the current run: `buffer[0..buffer_len]` has the lines
+    // (each ends with `\n`), `lines[0..line_count]` points to them,
+    // `sort_temp` is the merge sort temp array
+    char *buffer;
+    usize buffer_len;
+    usize buffer_capacity;
+    ExternalSortLine *lines;
+    ExternalSortLine *sort_temp;
+    usize line_count;
+    usize line_capacity;
+
+    // Runs in the temp files, `runs[0..merged_runs]` are merged (freed) or
+    // moved to the end by the extra passes
+    Vector runs;
+    usize merged_runs;
+
+    usize total_lines;
+    usize run_count;
+    String error;
+};
+
+static void external_sort_set_error(ExternalSort self, const char *error) {
+    if (self->error != NULL) HS_free(self->error);
+    self->error = HS_from_str(error != NULL ? error : "Unknown error");
+}
+
+//
+// Key
+//
+
+/*
+ * Find the key of `line[0..len]`, set `start` and `key_len`
+ */
+static void external_sort_find_key(const ExternalSortOptions *options,
+                                   const char *line,
+                                   usize len,
+                                   usize *start,
+                                   usize *key_len) {
+    if (options->key == ESK_LINE) {
+        *start   = 0;
+        *key_len = len;
+        return;
+    }
+
+    usize offset = 0;
+    for (usize field = 1; field < options->field; field++) {
+        const char *delimiter =
+            memchr(line + offset, options->delimiter, len - offset);
+        if (delimiter == NULL) {
+            *start   = len;
+            *key_len = 0;
+            return;
+        }
+        offset = delimiter - line + 1;
+    }
+
+    const char *end = memchr(line + offset, options->delimiter, len - offset);
+    *start          = offset;
+    *key_len        = (end != NULL ? (usize)(end - line) : len) - offset;
+}
+
+/*
+ * The compare prefix of `key[0..len]`
+ */
+static u64 external_sort_prefix(bool numeric, const char *key, usize len) {
+    u64 prefix = 0;
+    if (!numeric) {
+        for (usize index = 0; index < 8; index++) {
+            prefix = prefix << 8 | (index < len ? (u8)key[index] : 0);
+        }
+        return prefix;
+    }
+
+    usize index = 0;
+    while (index < len && key[index] == ' ') index++;
+
+    bool negative = index < len && key[index] == '-';
+    if (index < len && (key[index] == '-' || key[index] == '+')) index++;
+
+    // Saturate at `i64` max (min)
+    u64 limit = negative ? (u64)1 << 63 : ((u64)1 << 63) - 1;
+    for (; index < len && key[index] >= '0' && key[index] <= '9'; index++) {
+        u64 digit = key[index] - '0';
+        prefix = prefix > (limit - digit) / 10 ? limit : prefix * 10 + digit;
+    }
+
+    // Flip the sign bit, so the unsigned order is the signed order
+    return (negative ? (u64)0 - prefix : prefix) ^ ((u64)1 << 63);
+}
+
+/*
+ * Compare 2 keys, `< 0` if `a` goes first
+ */
+static inline int external_sort_compare(bool numeric,
+                                        u64 a_prefix,
+                                        const char *a_key,
+                                        usize a_len,
+                                        u64 b_prefix,
+                                        const char *b_key,
+                                        usize b_len) {
+    if (a_prefix != b_prefix) return a_prefix < b_prefix ? -1 : 1;
+    if (numeric) return 0;
+
+    // The first 8 bytes are the same
+    usize min_len = a_len < b_len ? a_len : b_len;
+    if (min_len > 8) {
+        int result = memcmp(a_key + 8, b_key + 8, min_len - 8);
+        if (result != 0) return result;
+    }
+
+    return (a_len > b_len) - (a_len < b_len);
+}
+
+static inline int external_sort_compare_lines(const ExternalSort self,
+                                              const ExternalSortLine *a,
+                                              const ExternalSortLine *b) {
+    return external_sort_compare(self->options.numeric,
+                                 a->prefix,
+                                 self->buffer + a->offset + a->key_start,
+                                 a->key_len,
+                                 b->prefix,
+                                 self->buffer + b->offset + b->key_start,
+                                 b->key_len);
+}
+
+//
+// Run
+//
+
+/*
+ * Stable merge sort `self->lines[0..line_count]`: insertion sort the small
+ * blocks, then merge them bottom up between `lines` and `sort_temp`
+ */
+static void external_sort_lines(ExternalSort self) {
+    ExternalSortLine *from = self->lines;
+    ExternalSortLine *to   = self->sort_temp;
+    usize count            = self->line_count;
+
+    for (usize start = 0; start < count;
+         start += EXTERNAL_SORT_INSERTION_SIZE) {
+        usize end = start + EXTERNAL_SORT_INSERTION_SIZE < count
+                        ? start + EXTERNAL_SORT_INSERTION_SIZE
+                        : count;
+        for (usize index = start + 1; index < end; index++) {
+            ExternalSortLine line = from[index];
+            usize position        = index;
+            while (position > start &&
+                   external_sort_compare_lines(self,
+                                               &from[position - 1],
+                                               &line) > 0) {
+                from[position] = from[position - 1];
+                position--;
+            }
+            from[position] = line;
+        }
+    }
+
+    for (usize width = EXTERNAL_SORT_INSERTION_SIZE; width < count;
+         width *= 2) {
+        for (usize start = 0; start < count; start += width * 2) {
+            usize middle = start + width < count ? start + width : count;
+            usize end    = middle + width < count ? middle + width : count;
+            usize left   = start;
+            usize right  = middle;
+            usize out    = start;
+
+            // Take the right one only if it's smaller, so it's stable
+            while (left < middle && right < end) {
+                if (external_sort_compare_lines(self,
+                                                &from[right],
+                                                &from[left]) < 0) {
+                    to[out++] = from[right++];
+                } else {
+                    to[out++] = from[left++];
+                }
+            }
+            while (left < middle) to[out++] = from[left++];
+            while (right < end) to[out++] = from[right++];
+        }
+
+        ExternalSortLine *swap = from;
+        from                   = to;
+        to                     = swap;
+    }
+
+    if (from != self->lines) {
+        memcpy(self->lines, from, count * sizeof(ExternalSortLine));
+    }
+}
+
+/*
+ * Write the sorted lines of the current run to `output`
+ */
+static bool external_sort_write_lines(ExternalSort self, File output) {
+    for (usize index = 0; index < self->line_count; index++) {
+        const ExternalSortLine *line = &self->lines[index];
+        if (!File_append_bytes(output,
+                               self->buffer + line->offset,
+                               (usize)line->len + 1)) {
+            external_sort_set_error(self, File_get_error(output));
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*
+ * Create a temp run file, it's removed right away and only lives with the
+ * returned `File`
+ */
+static File external_sort_create_run(ExternalSort self) {
+    char path[4096];
+    usize path_len = snprintf(path,
+                              sizeof(path),
+                              "%s/c_utils_external_sort_XXXXXX",
+                              self->temp_folder);
+    if (path_len >= sizeof(path)) {
+        external_sort_set_error(self, strerror(ENAMETOOLONG));
+        return NULL;
+    }
+
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        external_sort_set_error(self, strerror(errno));
+        return NULL;
+    }
+    unlink(path);
+
+    File run = File_from_fd(fd, path, FM_READ_WRITE);
+    if (!File_is_open_successfully(run)) {
+        external_sort_set_error(self, File_get_error(run));
+        File_free(run);
+        close(fd);
+        return NULL;
+    }
+
+    return run;
+}
+
+/*
+ * Sort the lines in the buffer, write them to a new run (or to `output`
+ * if it's the only run), then empty the buffer
+ */
+static bool external_sort_flush_run(ExternalSort self,
+                                    File output,
+                                    bool is_last) {
+    if (self->line_count == 0) return true;
+
+    external_sort_lines(self);
+
+    bool only_run = is_last && Vec_len(self->runs) == 0;
+    File run      = only_run ? output : external_sort_create_run(self);
+    if (run == NULL) return false;
+
+    bool success = external_sort_write_lines(self, run);
+    if (only_run) return success;
+
+    ExternalSortRun element = {
+        .file  = run,
+        .order = self->total_lines - self->line_count,
+    };
+    Vec_push(self->runs, &element);
+    self->run_count++;
+
+    if (success && !File_flush(run)) {
+        external_sort_set_error(self, File_get_error(run));
+        success = false;
+    }
+
+#ifdef ENABLE_DEBUG_LOG
+    DEBUG_LOG(ExternalSort,
+              flush_run,
+              "run: %lu, lines: %lu, bytes: %lu",
+              self->run_count,
+              self->line_count,
+              self->buffer_len);
+#endif
+
+    self->buffer_len = 0;
+    self->line_count = 0;
+
+    return success;
+}
+
+/*
+ * Make space for one more line of `len` bytes (plus `\n`)
+ */
+static bool external_sort_reserve(ExternalSort self, usize len) {
+    if (self->buffer_len + len + 1 > self->buffer_capacity) {
+        usize capacity = self->buffer_capacity * 2;
+        if (capacity > self->options.memory_budget) {
+            capacity = self->options.memory_budget;
+        }
+        if (capacity < self->buffer_len + len + 1) {
+            capacity = self->buffer_len + len + 1;
+        }
+
+        char *buffer = realloc(self->buffer, capacity);
+        if (buffer == NULL) return false;
+        self->buffer          = buffer;
+        self->buffer_capacity = capacity;
+    }
+
+    if (self->line_count == self->line_capacity) {
+        usize capacity = self->line_capacity > 0 ? self->line_capacity * 2
+                                                 : 1024;
+        ExternalSortLine *lines =
+            realloc(self->lines, capacity * sizeof(ExternalSortLine));
+        if (lines == NULL) return false;
+        self->lines = lines;
+
+        ExternalSortLine *temp =
+            realloc(self->sort_temp, capacity * sizeof(ExternalSortLine));
+        if (temp == NULL) return false;
+        self->sort_temp     = temp;
+        self->line_capacity = capacity;
+    }
+
+    return true;
+}
+
+/*
+ * Read all the lines of `input` into sorted runs
+ */
+static bool external_sort_split(ExternalSort self, File input, File output) {
+    if (!File_lines(input, EXTERNAL_SORT_INPUT_BUFFER_SIZE)) {
+        external_sort_set_error(self, File_get_error(input));
+        return false;
+    }
+
+    const ExternalSortOptions *options = &self->options;
+    StrView line;
+    while (File_read_line(input, &line)) {
+        if (line.len >= 0xFFFFFFFF) {
+            external_sort_set_error(self, "Line is too big");
+            return false;
+        }
+
+        //
+        // The line and its 2 `ExternalSortLine` (`lines` and `sort_temp`)
+        // count in the budget
+        //
+        usize used = self->buffer_len +
+                     self->line_count * 2 * sizeof(ExternalSortLine);
+        usize need = line.len + 1 + 2 * sizeof(ExternalSortLine);
+        if (used + need > options->memory_budget &&
+            !external_sort_flush_run(self, output, false)) {
+            return false;
+        }
+
+        if (!external_sort_reserve(self, line.len)) {
+            external_sort_set_error(self, strerror(ENOMEM));
+            return false;
+        }
+
+        char *copy = self->buffer + self->buffer_len;
+        memcpy(copy, line.ptr, line.len);
+        copy[line.len] = '\n';
+
+        usize key_start;
+        usize key_len;
+        external_sort_find_key(options, copy, line.len, &key_start, &key_len);
+
+        self->lines[self->line_count++] = (ExternalSortLine){
+            .prefix    = external_sort_prefix(options->numeric,
+                                           copy + key_start,
+                                           key_len),
+            .offset    = self->buffer_len,
+            .len       = (u32)line.len,
+            .key_start = (u32)key_start,
+            .key_len   = (u32)key_len,
+        };
+        self->buffer_len += line.len + 1;
+        self->total_lines++;
+    }
+
+    if (File_get_error(input) != NULL) {
+        external_sort_set_error(self, File_get_error(input));
+        return false;
+    }
+
+    return external_sort_flush_run(self, output, true);
+}
+
+/*
+ * Free the run buffer before merging, the memory goes to the read buffers
+ */
+static void external_sort_free_buffer(ExternalSort self) {
+    free(self->buffer);
+    free(self->lines);
+    free(self->sort_temp);
+    self->buffer          = NULL;
+    self->lines           = NULL;
+    self->sort_temp       = NULL;
+    self->buffer_len      = 0;
+    self->buffer_capacity = 0;
+    self->line_count      = 0;
+    self->line_capacity   = 0;
+}
+
+//
+// Merge
+//
+
+/*
+ * Read the next line of the cursor, return `false` at the end of the run
+ * or on error
+ */
+static bool external_sort_next(ExternalSort self, ExternalSortCursor *cursor) {
+    if (!File_read_line(cursor->file, &cursor->line)) {
+        if (File_get_error(cursor->file) != NULL) {
+            external_sort_set_error(self, File_get_error(cursor->file));
+        }
+        return false;
+    }
+
+    usize key_start;
+    external_sort_find_key(&self->options,
+                           cursor->line.ptr,
+                           cursor->line.len,
+                           &key_start,
+                           &cursor->key_len);
+    cursor->key    = cursor->line.ptr + key_start;
+    cursor->prefix = external_sort_prefix(self->options.numeric,
+                                          cursor->key,
+                                          cursor->key_len);
+
+    return true;
+}
+
+/*
+ * `true` if cursor `a` goes before cursor `b`
+ */
+static inline bool external_sort_cursor_less(const ExternalSort self,
+                                             const ExternalSortCursor *a,
+                                             const ExternalSortCursor *b) {
+    int result = external_sort_compare(self->options.numeric,
+                                       a->prefix,
+                                       a->key,
+                                       a->key_len,
+                                       b->prefix,
+                                       b->key,
+                                       b->key_len);
+    return result < 0 || (result == 0 && a->order < b->order);
+}
+
+/*
+ * Move `heap[index]` down to its place in the min heap
+ */
+static void external_sort_sift_down(const ExternalSort self,
+                                    ExternalSortCursor *cursors,
+                                    usize *heap,
+                                    usize count,
+                                    usize index) {
+    for (;;) {
+        usize smallest = index;
+        usize left     = index * 2 + 1;
+        usize right    = left + 1;
+        if (left < count &&
+            external_sort_cursor_less(self,
+                                      &cursors[heap[left]],
+                                      &cursors[heap[smallest]]))
+            smallest = left;
+        if (right < count &&
+            external_sort_cursor_less(self,
+                                      &cursors[heap[right]],
+                                      &cursors[heap[smallest]]))
+            smallest = right;
+        if (smallest == index) return;
+
+        usize swap     = heap[index];
+        heap[index]    = heap[smallest];
+        heap[smallest] = swap;
+        index          = smallest;
+    }
+}
+
+/*
+ * Merge the runs `[first..first + count]` into `output`
+ */
+static bool external_sort_merge(ExternalSort self,
+                                usize first,
+                                usize count,
+                                File output) {
+    usize buffer_size = self->options.memory_budget / (count + 1);
+    if (buffer_size < EXTERNAL_SORT_MIN_RUN_BUFFER_SIZE)
+        buffer_size = EXTERNAL_SORT_MIN_RUN_BUFFER_SIZE;
+    if (buffer_size > EXTERNAL_SORT_MAX_RUN_BUFFER_SIZE)
+        buffer_size = EXTERNAL_SORT_MAX_RUN_BUFFER_SIZE;
+
+    ExternalSortCursor *cursors = malloc(count * sizeof(ExternalSortCursor));
+    usize *heap                 = malloc(count * sizeof(usize));
+    if (cursors == NULL || heap == NULL) {
+        free(cursors);
+        free(heap);
+        external_sort_set_error(self, strerror(ENOMEM));
+        return false;
+    }
+
+    bool success     = true;
+    usize heap_count = 0;
+    for (usize index = 0; index < count && success; index++) {
+        const ExternalSortRun *run = Vec_get(self->runs, first + index);
+        cursors[index] = (ExternalSortCursor){
+            .file  = run->file,
+            .order = run->order,
+        };
+
+        if (!File_lines(run->file, buffer_size)) {
+            external_sort_set_error(self, File_get_error(run->file));
+            success = false;
+        } else if (external_sort_next(self, &cursors[index])) {
+            heap[heap_count++] = index;
+        } else {
+            success = self->error == NULL;
+        }
+    }
+
+    for (usize index = heap_count / 2; index-- > 0;) {
+        external_sort_sift_down(self, cursors, heap, heap_count, index);
+    }
+
+    while (success && heap_count > 0) {
+        ExternalSortCursor *cursor = &cursors[heap[0]];
+        if (!File_append_bytes(output, cursor->line.ptr, cursor->line.len) ||
+            !File_append_bytes(output, "\n", 1)) {
+            external_sort_set_error(self, File_get_error(output));
+            success = false;
+            break;
+        }
+
+        if (!external_sort_next(self, cursor)) {
+            if (self->error != NULL) {
+                success = false;
+                break;
+            }
+            heap[0] = heap[--heap_count];
+        }
+        external_sort_sift_down(self, cursors, heap, heap_count, 0);
+    }
+
+    free(cursors);
+    free(heap);
+
+    return success;
+}
+
+/*
+ * Merge the runs `[first..first + count]` into a new run at the end of
+ * `self->runs`, then free them
+ */
+static bool external_sort_merge_into_run(ExternalSort self,
+                                         usize first,
+                                         usize count) {
+    File run = external_sort_create_run(self);
+    if (run == NULL) return false;
+
+    // The runs are next to each other in the input, the first one has the
+    // smallest order
+    const ExternalSortRun *first_run = Vec_get(self->runs, first);
+    ExternalSortRun element = {.file = run, .order = first_run->order};
+    Vec_push(self->runs, &element);
+    self->run_count++;
+
+    bool success = external_sort_merge(self, first, count, run);
+    if (success && !File_flush(run)) {
+        external_sort_set_error(self, File_get_error(run));
+        success = false;
+    }
+
+    for (usize index = first; index < first + count; index++) {
+        const ExternalSortRun *merged = Vec_get(self->runs, index);
+        File_free(merged->file);
+    }
+    self->merged_runs = first + count;
+
+    return success;
+}
+
+/*
+ * Merge the runs into `output`. More than `max_runs` runs are merged pass
+ * by pass: every `max_runs` runs of the pass are merged into a new run at
+ * the end (a single run left is moved to the end as it is), so the runs of
+ * the next pass are still in the input order, and the sort is stable.
+ */
+static bool external_sort_merge_runs(ExternalSort self, File output) {
+    usize max_runs = self->options.max_runs;
+    while (Vec_len(self->runs) - self->merged_runs > max_runs) {
+        usize pass_end = Vec_len(self->runs);
+        while (self->merged_runs < pass_end) {
+            usize first = self->merged_runs;
+            usize count = pass_end - first;
+            if (count > max_runs) count = max_runs;
+
+            if (count == 1) {
+                const ExternalSortRun *run = Vec_get(self->runs, first);
+                ExternalSortRun left       = *run;
+                Vec_push(self->runs, &left);
+                self->merged_runs++;
+            } else if (!external_sort_merge_into_run(self, first, count)) {
+                return false;
+            }
+        }
+    }
+
+    usize first = self->merged_runs;
+    usize count = Vec_len(self->runs) - first;
+    return external_sort_merge(self, first, count, output);
+}
+
+/*
+ * Free the runs that are not merged yet (on error), and the run list
+ */
+static void external_sort_free_runs(ExternalSort self) {
+    if (self->runs == NULL) return;
+
+    for (usize index = self->merged_runs; index < Vec_len(self->runs);
+         index++) {
+        const ExternalSortRun *run = Vec_get(self->runs, index);
+        File_free(run->file);
+    }
+
+    Vec_free(self->runs);
+    self->runs = NULL;
+}
+
+//
+// Public
+//
+
+/*
+ * Create a sorter
+ */
+ExternalSort ExternalSort_new(ExternalSortOptions options) {
+    if (options.memory_budget == 0)
+        options.memory_budget = EXTERNAL_SORT_DEFAULT_MEMORY_BUDGET;
+    if (options.field == 0) options.field = 1;
+    if (options.delimiter == '\0') options.delimiter = '\t';
+    if (options.max_runs < 2) options.max_runs = EXTERNAL_SORT_DEFAULT_MAX_RUNS;
+
+    const char *temp_folder = options.temp_folder;
+    if (temp_folder == NULL) temp_folder = getenv("TMPDIR");
+    if (temp_folder == NULL || temp_folder[0] == '\0') temp_folder = "/tmp";
+
+    ExternalSort self = malloc(sizeof(struct _ExternalSort));
+    *self = (struct _ExternalSort){
+        .options     = options,
+        .temp_folder = temp_folder,
+    };
+
+#ifdef ENABLE_DEBUG_LOG
+    DEBUG_LOG(ExternalSort,
+              new,
+              "self ptr: %p, memory_budget: %lu, temp_folder: %s",
+              self,
+              options.memory_budget,
+              temp_folder);
+#endif
+
+    return self;
+}
+
+/*
+ * Sort the lines of `input` into `output`
+ */
+bool ExternalSort_sort(ExternalSort self, File input, File output) {
+    if (self == NULL) return false;
+
+    if (self->error != NULL) HS_free(self->error);
+    self->error       = NULL;
+    self->total_lines = 0;
+    self->run_count   = 0;
+    self->merged_runs = 0;
+    self->runs = Vec_new(sizeof(ExternalSortRun), "ExternalSortRun", NULL);
+
+    bool success = false;
+    if (input == NULL || output == NULL) {
+        external_sort_set_error(self, strerror(EBADF));
+    } else {
+        success = external_sort_split(self, input, output);
+        external_sort_free_buffer(self);
+        success = success && external_sort_merge_runs(self, output);
+        if (success && !File_flush(output)) {
+            external_sort_set_error(self, File_get_error(output));
+            success = false;
+        }
+    }
+
+    external_sort_free_runs(self);
+
+#ifdef ENABLE_DEBUG_LOG
+    DEBUG_LOG(ExternalSort,
+              sort,
+              "lines: %lu, runs: %lu, success: %d",
+              self->total_lines,
+              self->run_count,
+              success);
+#endif
+
+    return success;
+}
+
+/*
+ * Return the count of sorted lines
+ */
+usize ExternalSort_get_line_count(const ExternalSort self) {
+    return self != NULL ? self->total_lines : 0;
+}
+
+/*
+ * Return the count of runs
+ */
+usize ExternalSort_get_run_count(const ExternalSort self) {
+    return self != NULL ? self->run_count : 0;
+}
+
+/*
+ * Return the error, `NULL` if no error
+ */
+const char *ExternalSort_get_error(const ExternalSort self) {
+    if (self == NULL || self->error == NULL) return NULL;
+    return HS_as_str(self->error);
+}
+
+/*
+ * Free
+ */
+void ExternalSort_free(ExternalSort self) {
+    if (self == NULL) return;
+
+    external_sort_free_buffer(self);
+    external_sort_free_runs(self);
+    if (self->error != NULL) HS_free(self->error);
+
+#ifdef ENABLE_DEBUG_LOG
+    DEBUG_LOG(ExternalSort, free, "self ptr: %p", self);
+#endif
+
+    free(self);
+}
+
+/*
+ * Auto free external sort
+ */
+void auto_free_external_sort(ExternalSort *ptr) {
+    ExternalSort_free(*ptr);
+}
@@ -0,0 +1,147 @@
+#ifndef __UTILS_EXTERNAL_SORT_H__
+#define __UTILS_EXTERNAL_SORT_H__
+
+#include <stdbool.h>
+
+#include "data_types.h"
+#include "file.h"
+
+//
+// External merge sort: sort the lines of a file bigger than the memory.
+//
+// 1. Read the input line by line into a buffer until `memory_budget` is
+//    used up, sort the lines (stable merge sort on a key prefix) and write
+//    them to a temp file (a "run"). Repeat until the end of input.
+// 2. Merge the runs with a min heap, every run is read through its own
+//    line buffer and the output goes through the `File_append` write
+//    buffer. If there are more than `max_runs` runs, the first `max_runs`
+//    runs are merged into a new run first (another pass).
+//
+// If the whole input fits in `memory_budget`, it's sorted in memory and
+// written to the output directly (no temp file).
+//
+// The sort is stable: lines with the same key keep the input order. The
+// output lines always end with `\n` (`\r\n` in the input becomes `\n`).
+//
+
+/*
+ * Opaque pointer to `struct _ExternalSort`
+ */
+typedef struct _ExternalSort *ExternalSort;
+
+/*
+ * The default memory budget
+ */
+#define EXTERNAL_SORT_DEFAULT_MEMORY_BUDGET (256 * 1024 * 1024)
+
+/*
+ * The default count of runs merged in one pass
+ */
+#define EXTERNAL_SORT_DEFAULT_MAX_RUNS 128
+
+/*
+ * Sort key
+ */
+typedef enum ExternalSortKey {
+    ESK_LINE  = 0x00,
+    ESK_FIELD = 0x01,
+} ExternalSortKey;
+
+/*
+ * Sort options, `(ExternalSortOptions){0}` sorts the whole lines by bytes
+ * (`memcmp`) within `EXTERNAL_SORT_DEFAULT_MEMORY_BUDGET`:
+ *
+ * - `memory_budget`: the memory for the lines of a run (and the read
+ *   buffers of the runs when merging), `0` means
+ *   `EXTERNAL_SORT_DEFAULT_MEMORY_BUDGET`
+ * - `temp_folder`: where the runs go, `NULL` means `$TMPDIR` or `/tmp`. The
+ *   run files are removed right after creating, nothing is left behind
+ *   even the process crashes.
+ * - `key`: `ESK_LINE` or `ESK_FIELD`
+ * - `field`: the field number of `ESK_FIELD` (starts from `1`), `0` means
+ *   `1`. A line without that field has an empty key.
+ * - `delimiter`: the field delimiter, `\0` means `\t`
+ * - `numeric`: compare the keys as signed integers (leading spaces are
+ *   skipped, the digits after the number are ignored, `0` if it's not a
+ *   number)
+ * - `max_runs`: the count of runs merged in one pass, `0` means
+ *   `EXTERNAL_SORT_DEFAULT_MAX_RUNS`
+ */
+typedef struct {
+    usize memory_budget;
+    const char *temp_folder;
+    ExternalSortKey key;
+    usize field;
+    char delimiter;
+    bool numeric;
+    usize max_runs;
+} ExternalSortOptions;
+
+//
+//
+//
+void auto_free_external_sort(ExternalSort *ptr);
+
+/*
+ * Define smart `ExternalSort` var that calls `ExternalSort_free()`
+ * automatically when the variable is out of the scope
+ *
+ * ```c
+ * defer_file(input)  = File_open("huge.log", FM_READ_ONLY);
+ * defer_file(output) = File_open("huge.sorted.log", FM_WRITE_ONLY);
+ *
+ * // Sort by the 3rd field (tab separated) as numbers within 1GB
+ * defer_external_sort(sorter) = ExternalSort_new((ExternalSortOptions){
+ *     .memory_budget = 1024 * 1024 * 1024,
+ *     .key           = ESK_FIELD,
+ *     .field         = 3,
+ *     .numeric       = true,
+ * });
+ *
+ * if (!ExternalSort_sort(sorter, input, output)) {
+ *     printf("\n>>> Sort failed: %s", ExternalSort_get_error(sorter));
+ * }
+ * ```
+ */
+#define defer_external_sort(x)                                                 \
+    __attribute__((cleanup(auto_free_external_sort))) ExternalSort x
+
+/*
+ * Create a sorter, it can sort many files one by one
+ */
+ExternalSort ExternalSort_new(ExternalSortOptions options);
+
+/*
+ * Sort the lines of `input` (read from the beginning, or from the current
+ * position of a pipe) and append them to `output` (opened with
+ * `FM_WRITE_ONLY`, `FM_READ_WRITE` or `FM_APPEND`), the output is flushed
+ * before returning.
+ *
+ * Return `false` if reading, writing or the temp files fail (the reason is
+ * in `ExternalSort_get_error`), the output may have part of the lines.
+ */
+bool ExternalSort_sort(ExternalSort self, File input, File output);
+
+/*
+ * Return the count of lines sorted by the last `ExternalSort_sort`
+ */
+usize ExternalSort_get_line_count(const ExternalSort self);
+
+/*
+ * Return the count of runs written to the temp files by the last
+ * `ExternalSort_sort` (include the ones of the extra merge passes), `0`
+ * means it's sorted in memory
+ */
+usize ExternalSort_get_run_count(const ExternalSort self);
+
+/*
+ * Return the error of the last `ExternalSort_sort`, `NULL` if no error
+ */
+const char *ExternalSort_get_error(const ExternalSort self);
+
+/*
+ * Free
+ */
+void ExternalSort_free(ExternalSort self);
+
+#endif
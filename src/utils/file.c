@@ -1,11 +1,57 @@
 #include "file.h"
 
+#include <dirent.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <fnmatch.h>
+#include <poll.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
 
+#include "simd.h"
 #include "string.h"
+#include "timer.h"
+
+#if defined(__linux__)
+    #include <linux/fs.h>
+    #include <sys/ioctl.h>
+    #include <sys/inotify.h>
+    #include <sys/sendfile.h>
+    #include <sys/syscall.h>
+    #define FILE_HAS_INOTIFY
+    #if defined(SYS_getdents64)
+        #define FILE_HAS_GETDENTS64
+    #endif
+#endif
+
+//
+// `io_uring` is used through raw syscalls, only the kernel headers are needed
+//
+#if defined(__linux__) && defined(__has_include)
+    #if __has_include(<linux/io_uring.h>)
+        #include <linux/io_uring.h>
+        #include <linux/stat.h>
+        #include <stdint.h>
+        #if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+            #define FILE_HAS_IO_URING
+        #endif
+    #endif
+#endif
+
+//
+// The modification time of a `struct stat` as a `struct timespec`
+//
+#if defined(__APPLE__)
+    #define FILE_STAT_MTIME(st) ((st)->st_mtimespec)
+#else
+    #define FILE_STAT_MTIME(st) ((st)->st_mtim)
+#endif
 
 #ifdef ENABLE_DEBUG_LOG
     #include "log.h"
@@ -25,8 +71,9 @@ void file_mode_to_string(FileMode *mode, char *out) {
         out[0] = 'a';
         out[1] = '\0';
     } else if (*mode == FM_READ_WRITE) {
+        // `rw` isn't a valid `fopen` mode, it was opened as read-only
         out[0] = 'r';
-        out[1] = 'w';
+        out[1] = '+';
         out[2] = '\0';
     } else {
         out[0] = 'r';
@@ -35,11 +82,336 @@ void file_mode_to_string(FileMode *mode, char *out) {
 }
 
 /*
- * Open a file with the given mode
+ * Replace the last error
  */
-File File_open(const char *filename, FileMode mode) {
-    File open_file = malloc(sizeof(struct _File));
-    *open_file     = (struct _File){
+static void file_set_error(File self, const char *error) {
+    if (self->error != NULL) HS_free(self->error);
+    self->error = HS_from_str(error);
+}
+
+//
+// Streaming line reader, the unread bytes are `buffer[start..end]`:
+//
+// ```
+// +-----------------+-------------------------+------------------+
+// | returned lines  | unread                  | free             |
+// +-----------------+-------------------------+------------------+
+// 0               start                      end             capacity
+// ```
+//
+// When there is no line break in the unread bytes, they're moved to the
+// beginning (so a line can straddle 2 `read` calls), and the buffer is
+// doubled only if it's full of a single line.
+//
+struct _FileLineReader {
+    char *buffer;
+    usize capacity;
+    usize start;
+    usize end;
+
+    // Where to continue searching `\n`, no need to search the same bytes
+    // again after a refill
+    usize scan;
+
+    bool eof;
+};
+
+/*
+ * Free the line reader (if exists)
+ */
+static void file_free_line_reader(File self) {
+    if (self->line_reader == NULL) return;
+
+    free(self->line_reader->buffer);
+    free(self->line_reader);
+    self->line_reader = NULL;
+}
+
+//
+// `File_append` write buffer, `buffer[0..len]` is not written yet
+//
+struct _FileWriter {
+    char *buffer;
+    usize capacity;
+    usize len;
+
+    // The end of the file that the buffer goes to. The file descriptor
+    // offset is shared with the reads (`File_read_line`, ...), so the writes
+    // are positioned (`pwritev`), except `FM_APPEND` (always at the end).
+    off_t end_offset;
+    bool positioned;
+
+    // Written bytes since the last `fdatasync` (`FS_EVERY_N_BYTES`)
+    usize unsynced;
+};
+
+/*
+ * `fdatasync` (only the data and the size, not the other metadata), macOS
+ * doesn't have it
+ */
+static int file_data_sync(int fd) {
+#if defined(__APPLE__)
+    return fsync(fd);
+#else
+    return fdatasync(fd);
+#endif
+}
+
+/*
+ * Write all `iov[0..count]`, partial writes and `EINTR` are retried. Write
+ * at `*offset` (and move it) if it's not `NULL`, otherwise at the current
+ * position. Return `false` and keep `errno` if the write fails.
+ */
+static bool file_write_all(int fd,
+                           struct iovec *iov,
+                           int count,
+                           off_t *offset) {
+    while (count > 0) {
+        ssize_t written = offset != NULL ? pwritev(fd, iov, count, *offset)
+                                         : writev(fd, iov, count);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        if (offset != NULL) *offset += written;
+
+        //
+        // Skip the fully written buffers, then move the partial one
+        //
+        usize remaining = written;
+        while (count > 0 && remaining >= iov->iov_len) {
+            remaining -= iov->iov_len;
+            iov++;
+            count--;
+        }
+        if (count > 0) {
+            iov->iov_base = (char *)iov->iov_base + remaining;
+            iov->iov_len -= remaining;
+        }
+    }
+
+    return true;
+}
+
+/*
+ * Write the buffered data plus `ptr[0..len]` (can be empty) in one `writev`
+ * call, then apply the `FS_EVERY_N_BYTES` policy
+ */
+static bool file_writer_write(File self, const void *ptr, usize len) {
+    struct _FileWriter *writer = self->writer;
+    int fd                     = fileno(self->inner);
+
+    struct iovec iov[2];
+    int count = 0;
+    if (writer->len > 0) {
+        iov[count++] = (struct iovec){.iov_base = writer->buffer,
+                                      .iov_len  = writer->len};
+    }
+    if (len > 0) {
+        iov[count++] = (struct iovec){.iov_base = (void *)ptr, .iov_len = len};
+    }
+    if (count == 0) return true;
+
+    off_t *offset = writer->positioned ? &writer->end_offset : NULL;
+    if (!file_write_all(fd, iov, count, offset)) {
+        file_set_error(self, strerror(errno));
+        return false;
+    }
+
+#ifdef ENABLE_DEBUG_LOG
+    DEBUG_LOG(File,
+              writer_write,
+              "filename: %s, buffered: %lu, direct: %lu",
+              HS_as_str(self->filename),
+              writer->len,
+              len);
+#endif
+
+    writer->unsynced += writer->len + len;
+    writer->len = 0;
+
+    if (self->write_options.sync == FS_EVERY_N_BYTES &&
+        writer->unsynced >= self->write_options.sync_every_bytes) {
+        if (file_data_sync(fd) != 0) {
+            file_set_error(self, strerror(errno));
+            return false;
+        }
+        writer->unsynced = 0;
+    }
+
+    return true;
+}
+
+/*
+ * Flush and free the write buffer (if exists), `FS_ON_CLOSE` syncs here
+ */
+static bool file_free_writer(File self, bool is_closing) {
+    if (self->writer == NULL) return true;
+
+    bool result = file_writer_write(self, NULL, 0);
+    if (result && is_closing && self->write_options.sync == FS_ON_CLOSE &&
+        file_data_sync(fileno(self->inner)) != 0) {
+        file_set_error(self, strerror(errno));
+        result = false;
+    }
+
+    free(self->writer->buffer);
+    free(self->writer);
+    self->writer = NULL;
+
+    return result;
+}
+
+/*
+ * Unmap the mapping created by `File_map` (if exists)
+ */
+static void file_unmap(File self) {
+    if (self->mapping == NULL) return;
+
+    int unmap_result = munmap(self->mapping, self->mapping_size);
+
+#ifdef ENABLE_DEBUG_LOG
+    DEBUG_LOG(File,
+              unmap,
+              "mapping: %p, mapping_size: %lu, result: %d",
+              self->mapping,
+              self->mapping_size,
+              unmap_result);
+#else
+    (void)unmap_result;
+#endif
+
+    self->mapping      = NULL;
+    self->mapping_size = 0;
+}
+
+//
+// The initial buffer size when the file size is unknown (pipes, `/proc`)
+//
+#define FILE_READ_UNKNOWN_SIZE_BUFFER_SIZE (64 * 1024)
+
+/*
+ * Return the size of a regular file, return `0` for others (pipes, sockets,
+ * terminals), as their size is unknown until reading to the end. `/proc`
+ * and `/sys` files are regular files with size `0` as well.
+ */
+static usize file_size_hint(int fd) {
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0 || !S_ISREG(file_stat.st_mode)) return 0;
+
+    return file_stat.st_size;
+}
+
+/*
+ * Record the identity of the loaded (or mapped) content
+ */
+static void file_set_stamp(File self,
+                           const struct stat *file_stat,
+                           bool mapped,
+                           FileMapOptions map_options) {
+    self->stamp = (FileStamp){
+        .valid       = true,
+        .mapped      = mapped,
+        .map_options = map_options,
+        .device      = file_stat->st_dev,
+        .inode       = file_stat->st_ino,
+        .size        = file_stat->st_size,
+        .mtime_sec   = FILE_STAT_MTIME(file_stat).tv_sec,
+        .mtime_nsec  = FILE_STAT_MTIME(file_stat).tv_nsec,
+    };
+}
+
+/*
+ * Create the `String` for loading `capacity - 1` bytes, the buffer isn't
+ * zeroed as it's overwritten by `read` straight away
+ */
+static String file_alloc_data(usize capacity) {
+    String data = malloc(sizeof(struct HeapString));
+    *data       = (struct HeapString){
+              ._capacity = capacity,
+              ._len      = 0,
+              ._buffer   = malloc(capacity),
+    };
+    data->_buffer[0] = '\0';
+
+    return data;
+}
+
+/*
+ * Read from `fd` (starting at `offset`) into `self->data` until the end of
+ * file, `self->data[0..offset]` is already loaded.
+ *
+ * `size_hint` is the `fstat` size, it stops after reading `size_hint` bytes
+ * without the extra `read` that returns `0`. `0` means the size is unknown
+ * (pipes, `/proc` files), the buffer doubles until the end of file.
+ *
+ * It reads by `pread` from the `offset`, except the non-seekable fd (pipes,
+ * terminals) that reads by `read` from the current position.
+ *
+ * Return `false` and set the error if the read fails.
+ */
+static bool file_read_fd_to_end(File self,
+                                int fd,
+                                usize offset,
+                                usize size_hint) {
+    if (self->data == NULL) {
+        self->data = file_alloc_data(size_hint > 0
+                                         ? size_hint + 1
+                                         : FILE_READ_UNKNOWN_SIZE_BUFFER_SIZE);
+    }
+
+    String data     = self->data;
+    bool positional = true;
+    while (size_hint == 0 || offset < size_hint) {
+        //
+        // Keep 1 byte for the null-terminated character, grow if full
+        //
+        if (offset + 1 >= data->_capacity) {
+            usize new_capacity =
+                data->_capacity < FILE_READ_UNKNOWN_SIZE_BUFFER_SIZE
+                    ? FILE_READ_UNKNOWN_SIZE_BUFFER_SIZE
+                    : data->_capacity * 2;
+            char *new_buffer = realloc(data->_buffer, new_capacity);
+            if (new_buffer == NULL) {
+                file_set_error(self, strerror(ENOMEM));
+                return false;
+            }
+            data->_buffer   = new_buffer;
+            data->_capacity = new_capacity;
+        }
+
+        char *read_ptr    = data->_buffer + offset;
+        usize read_len    = data->_capacity - 1 - offset;
+        ssize_t read_size = positional ? pread(fd, read_ptr, read_len, offset)
+                                       : read(fd, read_ptr, read_len);
+        if (read_size < 0) {
+            if (errno == EINTR) continue;
+            if (errno == ESPIPE && positional) {
+                positional = false;
+                continue;
+            }
+
+            file_set_error(self, strerror(errno));
+            return false;
+        }
+        if (read_size == 0) break;
+
+        offset += read_size;
+    }
+
+    data->_buffer[offset] = '\0';
+    data->_len            = offset;
+    self->size            = offset;
+
+    return true;
+}
+
+/*
+ * Create a `File` that isn't opened yet
+ */
+static File file_new(const char *filename, FileMode mode) {
+    File file = malloc(sizeof(struct _File));
+    *file     = (struct _File){
             .inner             = NULL,
             .mode              = mode,
             .open_successfully = false,
@@ -47,8 +419,23 @@ File File_open(const char *filename, FileMode mode) {
             .error             = NULL,
             .data              = NULL,
             .size              = 0,
+            .mapping           = NULL,
+            .mapping_size      = 0,
+            .line_reader       = NULL,
+            .write_options     = {0},
+            .writer            = NULL,
+            .stamp             = {0},
     };
 
+    return file;
+}
+
+/*
+ * Open a file with the given mode
+ */
+File File_open(const char *filename, FileMode mode) {
+    File open_file = file_new(filename, mode);
+
     char temp_mode[3] = {0};
     file_mode_to_string(&mode, temp_mode);
 
@@ -81,16 +468,52 @@ File File_open(const char *filename, FileMode mode) {
         open_file->open_successfully = true;
 
         //
-        // Get the file size and rewind back to the beginning postion
+        // `fstat` instead of `fseek` + `ftell`, the size is `0` for pipes
+        // and `/proc` files, it's known after loading
         //
-        fseek(file_handle, 0L, SEEK_END);
-        open_file->size = ftell(file_handle);
-        rewind(file_handle);
+        struct stat file_stat;
+        if (fstat(fileno(file_handle), &file_stat) == 0) {
+            open_file->size = file_stat.st_size;
+        }
     }
 
     return open_file;
 }
 
+/*
+ * Create `File` from an opened fd
+ */
+File File_from_fd(int fd, const char *name, FileMode mode) {
+    File file = file_new(name != NULL ? name : "", mode);
+
+    char temp_mode[3] = {0};
+    file_mode_to_string(&mode, temp_mode);
+
+    FILE *file_handle = fd >= 0 ? fdopen(fd, temp_mode) : NULL;
+    if (file_handle == NULL) {
+        file->error = HS_from_str(strerror(fd >= 0 ? errno : EBADF));
+    } else {
+        file->inner             = file_handle;
+        file->open_successfully = true;
+
+        struct stat file_stat;
+        if (fstat(fd, &file_stat) == 0) file->size = file_stat.st_size;
+    }
+
+#ifdef ENABLE_DEBUG_LOG
+    DEBUG_LOG(File,
+              from_fd,
+              "self ptr: %p, fd: %d, name: %s, open mode: %s, success: %d",
+              file,
+              fd,
+              HS_as_str(file->filename),
+              temp_mode,
+              file->open_successfully);
+#endif
+
+    return file;
+}
+
 /*
  * Load the entire file into `self->data` if the file has been opened already.
  * It returns total bytes loaded from file, otherwise, return -1 when error
@@ -101,15 +524,12 @@ usize File_load_into_buffer(File self) {
         return -1;
 
     //
-    // Get the file size and rewind back to the beginning postion
+    // The bytes buffered by `File_append` and `FILE *` go to the file first
     //
-    fseek(self->inner, 0L, SEEK_END);
-    self->size = ftell(self->inner);
-    rewind(self->inner);
+    if (self->writer != NULL) File_flush(self);
+    if (self->mode != FM_READ_ONLY) fflush(self->inner);
 
-#ifdef ENABLE_DEBUG_LOG
-    DEBUG_LOG(File, load_into_buffer, "file_size: %lu", self->size);
-#endif
+    file_unmap(self);
 
     //
     // Free the orignal `self->data` if exists
@@ -127,30 +547,32 @@ usize File_load_into_buffer(File self) {
     }
 
     //
-    // Create `struct Str *` buffer with enough capacity to hold the entire
-    // file content
+    // `fstat` instead of `fseek` + `ftell`, which gives `0` or `-1` for
+    // pipes and `/proc` files. The unknown size file is read in a growing
+    // buffer until the end of file.
     //
-    usize file_str_size    = self->size + 1;
-    struct HeapString *str_buffer = malloc(sizeof(struct HeapString));
-    HS_init_with_capacity(str_buffer, file_str_size);
-    memset(str_buffer->_buffer, 0, file_str_size);
-
-    //
-    // Here, we write to `str_buffer->_buffer` in an unusual way for performance
-    // purpose, that's why we need to set the correct `str_buffer->_len` value
-    // manually!!!
+    // The stamp is taken before reading, so a change in the middle of the
+    // read is reloaded by the next `File_reload_if_changed`
     //
-    // `read_bytes` means the number of object has been read which should
-    // be `1`!!!
-    //
-    usize read_bytes = fread(str_buffer->_buffer, self->size, 1, self->inner);
-    str_buffer->_buffer[self->size] = '\0';
-    str_buffer->_len                = self->size;
+    int fd          = fileno(self->inner);
+    usize size_hint = 0;
+    struct stat file_stat;
+    self->stamp = (FileStamp){0};
+    if (fstat(fd, &file_stat) == 0 && S_ISREG(file_stat.st_mode)) {
+        size_hint = file_stat.st_size;
+        file_set_stamp(self, &file_stat, false, (FileMapOptions){0});
+    }
 
-    //
-    // Move `str_buffer` into `self->data`
-    //
-    self->data = HS_move_from(str_buffer);
+#ifdef ENABLE_DEBUG_LOG
+    DEBUG_LOG(File, load_into_buffer, "file_size: %lu", size_hint);
+#endif
+
+    if (!file_read_fd_to_end(self, fd, 0, size_hint)) {
+        HS_free(self->data);
+        self->data  = NULL;
+        self->stamp = (FileStamp){0};
+        return -1;
+    }
 
 #ifdef ENABLE_DEBUG_LOG
     DEBUG_LOG(File,
@@ -160,140 +582,2627 @@ usize File_load_into_buffer(File self) {
               HS_as_str(self->data));
 #endif
 
-    //
-    // Free the `str_buffer`
-    //
-    HS_free(str_buffer);
-
-    // `number of object has been read` * object size
-    return read_bytes * self->size;
+    return self->size;
 }
 
 /*
- * Write the modified `self->data` back to `self->filename`
+ * Map the entire file read-only into memory
  */
-void File_save(File self);
+bool File_map(File self, FileMapOptions options) {
+    if (self == NULL || !self->open_successfully || self->inner == NULL)
+        return false;
 
-/*
- * Append to file, update the `self->data` as well
- */
-void File_append(File self, char *content);
+    //
+    // The size from `File_open` might be out of date (the buffered appends
+    // go to the file first), and `mmap` only works on regular files.
+    //
+    if (self->writer != NULL && !File_flush(self)) return false;
 
-/*
- * Get back filename
- */
-const char *File_get_filename(File self) {
-    return (self != NULL && self->filename != NULL) ? HS_as_str(self->filename)
-                                                    : NULL;
-}
+    int fd = fileno(self->inner);
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0) {
+        file_set_error(self, strerror(errno));
+        return false;
+    }
+    if (!S_ISREG(file_stat.st_mode)) {
+        file_set_error(self, "Not a regular file");
+        return false;
+    }
 
-/*
- * Whether open successfully or not
- */
-bool File_is_open_successfully(File self) {
-    return (self != NULL) ? self->open_successfully : false;
-}
+    file_unmap(self);
+    if (self->data != NULL) {
+        HS_free(self->data);
+        self->data = NULL;
+    }
+    self->size = file_stat.st_size;
+    file_set_stamp(self, &file_stat, true, options);
 
-/*
- * Get back error
- */
-const char *File_get_error(File self) {
-    return (self != NULL && self->error != NULL) ? HS_as_str(self->error)
-                                                 : (char *)NULL;
+    //
+    // `mmap` doesn't accept 0 length, an empty file is an empty view
+    //
+    if (self->size == 0) return true;
+
+    int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+    if (options.populate) flags |= MAP_POPULATE;
+#endif
+
+    void *mapping = mmap(NULL, self->size, PROT_READ, flags, fd, 0);
+    if (mapping == MAP_FAILED) {
+        file_set_error(self, strerror(errno));
+        self->stamp = (FileStamp){0};
+
+#ifdef ENABLE_DEBUG_LOG
+        DEBUG_LOG(File,
+                  map,
+                  "mmap failed - '%s': %s",
+                  HS_as_str(self->filename),
+                  HS_as_str(self->error));
+#endif
+        return false;
+    }
+
+    //
+    // The advice is a hint only, the mapping works no matter it fails or not
+    //
+    if (options.sequential) madvise(mapping, self->size, MADV_SEQUENTIAL);
+    if (options.will_need) madvise(mapping, self->size, MADV_WILLNEED);
+
+    self->mapping      = mapping;
+    self->mapping_size = self->size;
+
+#ifdef ENABLE_DEBUG_LOG
+    DEBUG_LOG(File,
+              map,
+              "mapping: %p, size: %lu, populate: %d, sequential: %d, "
+              "will_need: %d",
+              mapping,
+              self->size,
+              options.populate,
+              options.sequential,
+              options.will_need);
+#endif
+
+    return true;
 }
 
 /*
- * Get back internal buffer data
+ * Whether the file is mapped by `File_map` or not
  */
-const char *File_get_data(File self) {
-    return (self != NULL && self->data != NULL) ? HS_as_str(self->data)
-                                                : (char *)NULL;
+bool File_is_mapped(File self) {
+    return (self != NULL) ? self->mapping != NULL : false;
 }
 
 /*
- * Get back file size
+ * Get back the file content as `StrView`
  */
-usize File_get_size(File self) {
-    return (self != NULL) ? self->size : 0;
+StrView File_as_view(File self) {
+    if (self == NULL) return (StrView){.ptr = NULL, .len = 0};
+
+    if (self->mapping != NULL) {
+        return (StrView){.ptr = self->mapping, .len = self->mapping_size};
+    }
+
+    return HS_as_view(self->data);
 }
 
 /*
- * Print out file like `bat`
+ * Start reading lines through a reusable buffer
  */
-void File_print_out_file_like_bat(File self) {
-    if (self == NULL || self->inner == NULL) return;
+bool File_lines(File self, usize buffer_size) {
+    if (self == NULL || !self->open_successfully || self->inner == NULL)
+        return false;
 
-    usize line_buffer_size = 255;
-    char line_buffer[line_buffer_size];
-    memset(line_buffer, 0, line_buffer_size);
+    if (buffer_size == 0) buffer_size = FILE_LINES_DEFAULT_BUFFER_SIZE;
+
+    file_free_line_reader(self);
+
+    struct _FileLineReader *reader = malloc(sizeof(struct _FileLineReader));
+    char *buffer                   = malloc(buffer_size);
+    if (reader == NULL || buffer == NULL) {
+        free(reader);
+        free(buffer);
+        file_set_error(self, strerror(ENOMEM));
+        return false;
+    }
+
+    *reader = (struct _FileLineReader){
+        .buffer   = buffer,
+        .capacity = buffer_size,
+        .start    = 0,
+        .end      = 0,
+        .scan     = 0,
+        .eof      = false,
+    };
+    self->line_reader = reader;
 
     //
-    // Read each line and add line number at the beginning
-    //
-    // Line number ` XXXXX | ` holds 9 spaces, add more if you need to print
-    // lines more than `99999`!!!
-    //
-    // ` XXXXX │ LINE_CONTENT_HERE`
-    //
-    // So, that's why max buffer size to read should be `255 - 9`
+    // Lines are read by `read(2)` on the file descriptor directly (no
+    // `FILE *` buffering). `rewind` drops whatever `FILE *` has buffered,
+    // but it doesn't always move the descriptor, so `lseek` it as well.
+    // Both do nothing on a pipe.
     //
-    u32 line_no_buffer_str_len = 9;
-    u32 line_no_buffer_size    = line_no_buffer_str_len + 1;
+    rewind(self->inner);
+    lseek(fileno(self->inner), 0, SEEK_SET);
 
-    u32 current_line_no            = 1;
-    usize max_line_buffer_to_write = line_buffer_size - line_no_buffer_str_len;
+#ifdef ENABLE_DEBUG_LOG
+    DEBUG_LOG(File,
+              lines,
+              "filename: %s, buffer_size: %lu",
+              HS_as_str(self->filename),
+              buffer_size);
+#endif
 
-    while (fgets(line_buffer, max_line_buffer_to_write, self->inner) != NULL) {
-        //
-        // `line_buffer` always end with `\n\0`!!!
-        //
-        // line_buffer[line_str_len - 1] == '\n'
-        // line_buffer[line_str_len] == '\0'
-        //
+    return true;
+}
+
+/*
+ * Read the next line as a zero-copy view
+ */
+bool File_read_line(File self, StrView *line) {
+    if (self == NULL || line == NULL) return false;
 
-        usize line_str_len = strlen(line_buffer);
+    if (self->line_reader == NULL && !File_lines(self, 0)) return false;
 
-        struct HeapString line_str_added_line_no;
-        HS_init_with_capacity(&line_str_added_line_no,
-                               line_no_buffer_str_len + line_str_len + 1);
+    struct _FileLineReader *reader = self->line_reader;
+    int fd                         = fileno(self->inner);
 
-        //
-        // Formatted line number
-        //
-        char line_no_buffer[line_no_buffer_size];
-        memset(line_no_buffer, 0, line_no_buffer_size);
-        snprintf(line_no_buffer,
-                 line_no_buffer_size,
-                 " %5u | ",
-                 current_line_no);
-        /* printf("\n>>> %s, len: %lu", line_no_buffer, */
-        /*        strlen(line_no_buffer)); */
+    for (;;) {
+        char *line_break = reader->scan < reader->end
+                               ? memchr(reader->buffer + reader->scan,
+                                        '\n',
+                                        reader->end - reader->scan)
+                               : NULL;
+        bool last_line = reader->eof && reader->start < reader->end;
+        if (line_break != NULL || last_line) {
+            char *line_start = reader->buffer + reader->start;
+            char *line_end =
+                line_break != NULL ? line_break : reader->buffer + reader->end;
+            usize next = line_break != NULL
+                             ? (usize)(line_break - reader->buffer) + 1
+                             : reader->end;
 
-        HS_push_str(&line_str_added_line_no, line_no_buffer);
+            // CRLF
+            if (line_break != NULL && line_end > line_start &&
+                line_end[-1] == '\r') {
+                line_end--;
+            }
+
+            *line         = (StrView){.ptr = line_start,
+                                      .len = line_end - line_start};
+            reader->start = next;
+            reader->scan  = next;
+            return true;
+        }
+
+        if (reader->eof) return false;
 
         //
-        // Orignal line content
+        // No line break in the unread bytes, make space and read more
         //
-        HS_push_str(&line_str_added_line_no, line_buffer);
+        usize unread = reader->end - reader->start;
+        if (reader->start > 0) {
+            memmove(reader->buffer, reader->buffer + reader->start, unread);
+            reader->start = 0;
+            reader->end   = unread;
+        } else if (reader->end == reader->capacity) {
+            usize new_capacity = reader->capacity * 2;
+            char *new_buffer   = realloc(reader->buffer, new_capacity);
+            if (new_buffer == NULL) {
+                file_set_error(self, strerror(ENOMEM));
+                return false;
+            }
 
-        current_line_no++;
+#ifdef ENABLE_DEBUG_LOG
+            DEBUG_LOG(File,
+                      read_line,
+                      "line longer than the buffer, grow buffer to: %lu",
+                      new_capacity);
+#endif
+            reader->buffer   = new_buffer;
+            reader->capacity = new_capacity;
+        }
+        reader->scan = reader->end;
 
-        // Print out
-        printf("%s", HS_as_str(&line_str_added_line_no));
+        ssize_t read_size = read(fd,
+                                 reader->buffer + reader->end,
+                                 reader->capacity - reader->end);
+        if (read_size < 0) {
+            if (errno == EINTR) continue;
 
-        HS_free_buffer_only(&line_str_added_line_no);
+            file_set_error(self, strerror(errno));
+            return false;
+        }
+        if (read_size == 0) {
+            reader->eof = true;
+        } else {
+            reader->end += read_size;
+        }
     }
 }
 
-#ifdef ENABLE_DEBUG_LOG
 /*
- * Print out self for debugging purpose
+ * Change the write options
  */
-void File_print_debug_info(File self) {
-    // SMART_STRING(debug_info) = HS_from_empty_with_capacity(100);
-
-    char file_handler[20] = {0};
-    snprintf(file_handler, sizeof(file_handler), "%p", (void *)self->inner);
+void File_set_write_options(File self, FileWriteOptions options) {
+    if (self == NULL) return;
+
+    //
+    // The buffer is created again (with the new size) by the next append
+    //
+    if (self->inner != NULL) file_free_writer(self, false);
+
+    self->write_options = options;
+}
+
+/*
+ * Write `ptr[0..len]` to a new temp file next to `self->filename`, then
+ * `rename` it over `self->filename`
+ */
+static bool file_save_atomic(File self, const char *ptr, usize len) {
+    const char *filename = HS_as_str(self->filename);
+    usize filename_len   = HS_length(self->filename);
+
+    char temp_filename[filename_len + sizeof(".tmp.XXXXXX")];
+    memcpy(temp_filename, filename, filename_len);
+    memcpy(temp_filename + filename_len, ".tmp.XXXXXX", sizeof(".tmp.XXXXXX"));
+
+    int fd = mkstemp(temp_filename);
+    if (fd < 0) {
+        file_set_error(self, strerror(errno));
+        return false;
+    }
+
+    //
+    // `mkstemp` creates the file with `0600`, keep the original permission
+    //
+    struct stat file_stat;
+    if (stat(filename, &file_stat) == 0) {
+        fchmod(fd, file_stat.st_mode & 07777);
+    }
+
+    struct iovec iov = {.iov_base = (void *)ptr, .iov_len = len};
+    bool result      = file_write_all(fd, &iov, 1, NULL) && fsync(fd) == 0;
+    if (close(fd) != 0) result = false;
+
+    if (!result || rename(temp_filename, filename) != 0) {
+        file_set_error(self, strerror(errno));
+        unlink(temp_filename);
+        return false;
+    }
+
+    //
+    // `fsync` the folder as well, so the `rename` itself is durable
+    //
+    const char *last_slash = strrchr(filename, '/');
+    usize folder_len       = last_slash == NULL     ? 0
+                             : last_slash == filename ? 1
+                                                      : last_slash - filename;
+    char folder[folder_len + 2];
+    if (folder_len == 0) {
+        memcpy(folder, ".", 2);
+    } else {
+        memcpy(folder, filename, folder_len);
+        folder[folder_len] = '\0';
+    }
+
+    int folder_fd = open(folder, O_RDONLY);
+    if (folder_fd >= 0) {
+        fsync(folder_fd);
+        close(folder_fd);
+    }
+
+    //
+    // `self->inner` still points to the replaced file, reopen it without
+    // truncating the new content
+    //
+    const char *reopen_mode = self->mode == FM_READ_ONLY ? "r"
+                              : self->mode == FM_APPEND  ? "a"
+                                                         : "r+";
+    FILE *reopened          = fopen(filename, reopen_mode);
+    if (reopened != NULL) {
+        file_free_line_reader(self);
+        fclose(self->inner);
+        self->inner = reopened;
+    }
+
+    return true;
+}
+
+/*
+ * Write the modified `self->data` back to `self->filename`
+ */
+bool File_save(File self) {
+    if (self == NULL || !self->open_successfully || self->inner == NULL ||
+        self->data == NULL) {
+        return false;
+    }
+
+    //
+    // The pending appends go to the file first, then get replaced
+    //
+    if (!file_free_writer(self, false)) return false;
+
+    StrView view = HS_as_view(self->data);
+
+#ifdef ENABLE_DEBUG_LOG
+    DEBUG_LOG(File,
+              save,
+              "filename: %s, len: %lu, atomic: %d",
+              HS_as_str(self->filename),
+              view.len,
+              self->write_options.atomic_save);
+#endif
+
+    if (self->write_options.atomic_save) {
+        if (!file_save_atomic(self, view.ptr, view.len)) return false;
+    } else {
+        int fd = open(HS_as_str(self->filename), O_WRONLY | O_TRUNC);
+        if (fd < 0) {
+            file_set_error(self, strerror(errno));
+            return false;
+        }
+
+        struct iovec iov = {.iov_base = (void *)view.ptr, .iov_len = view.len};
+        bool result      = file_write_all(fd, &iov, 1, NULL);
+        if (result && self->write_options.sync != FS_NONE) {
+            result = file_data_sync(fd) == 0;
+        }
+        if (!result) file_set_error(self, strerror(errno));
+        close(fd);
+
+        if (!result) return false;
+    }
+
+    self->size = view.len;
+
+    return true;
+}
+
+/*
+ * Append to file, update the `self->data` as well
+ */
+bool File_append(File self, const char *content) {
+    if (content == NULL) return false;
+
+    return File_append_bytes(self, content, strlen(content));
+}
+
+/*
+ * Append `ptr[0..len]` to file, update the `self->data` as well
+ */
+bool File_append_bytes(File self, const void *ptr, usize len) {
+    if (self == NULL || !self->open_successfully || self->inner == NULL ||
+        ptr == NULL) {
+        return false;
+    }
+    if (self->mode == FM_READ_ONLY) {
+        file_set_error(self, "File isn't opened for writing");
+        return false;
+    }
+
+    if (self->writer == NULL) {
+        usize capacity = self->write_options.buffer_size > 0
+                             ? self->write_options.buffer_size
+                             : FILE_WRITE_DEFAULT_BUFFER_SIZE;
+
+        struct _FileWriter *writer = malloc(sizeof(struct _FileWriter));
+        char *buffer               = malloc(capacity);
+        if (writer == NULL || buffer == NULL) {
+            free(writer);
+            free(buffer);
+            file_set_error(self, strerror(ENOMEM));
+            return false;
+        }
+        //
+        // Writes go to the file descriptor directly, so drop whatever
+        // `FILE *` has buffered and append at the end (`FM_APPEND` is
+        // always at the end already).
+        //
+        fflush(self->inner);
+        off_t end_offset = lseek(fileno(self->inner), 0, SEEK_END);
+
+        *writer = (struct _FileWriter){
+            .buffer     = buffer,
+            .capacity   = capacity,
+            .len        = 0,
+            .end_offset = end_offset,
+            .positioned = self->mode != FM_APPEND && end_offset >= 0,
+            .unsynced   = 0,
+        };
+        self->writer = writer;
+    }
+
+    struct _FileWriter *writer = self->writer;
+    if (writer->len + len <= writer->capacity) {
+        memcpy(writer->buffer + writer->len, ptr, len);
+        writer->len += len;
+    } else if (len >= writer->capacity) {
+        if (!file_writer_write(self, ptr, len)) return false;
+    } else {
+        if (!file_writer_write(self, NULL, 0)) return false;
+        memcpy(writer->buffer, ptr, len);
+        writer->len = len;
+    }
+
+    //
+    // The mapping doesn't grow, the size stays with the mapped content that
+    // `File_get_data` returns (`File_map` again to see the appends)
+    //
+    if (self->data != NULL) {
+        HS_push_view(self->data, (StrView){.ptr = ptr, .len = len});
+    }
+    if (self->mapping == NULL) self->size += len;
+
+    return true;
+}
+
+/*
+ * Write the buffered data (if any) to the file
+ */
+bool File_flush(File self) {
+    if (self == NULL || self->writer == NULL) return true;
+
+    return file_writer_write(self, NULL, 0);
+}
+
+//
+// `File_load_many` implementation
+//
+
+/*
+ * `Vector` element destructor, the element is a `File`
+ */
+static void file_vector_element_destructor(void *ptr) {
+    File_free(*(File *)ptr);
+}
+
+/*
+ * Load a single file with `open` + `fstat` + `pread` + `close`
+ */
+static void file_load_sync(File self) {
+    int fd = open(HS_as_str(self->filename), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        file_set_error(self, strerror(errno));
+        return;
+    }
+
+    self->open_successfully =
+        file_read_fd_to_end(self, fd, 0, file_size_hint(fd));
+    close(fd);
+}
+
+//
+// `pread` thread pool, each worker takes the next file index until all
+// files are taken
+//
+typedef struct {
+    File *files;
+    usize count;
+    usize next_index;
+} FileLoadPool;
+
+static void *file_load_pool_worker(void *arg) {
+    FileLoadPool *pool = arg;
+
+    for (;;) {
+        usize index =
+            __atomic_fetch_add(&pool->next_index, 1, __ATOMIC_RELAXED);
+        if (index >= pool->count) break;
+
+        file_load_sync(pool->files[index]);
+    }
+
+    return NULL;
+}
+
+static void file_load_with_thread_pool(File *files,
+                                       usize count,
+                                       usize threads) {
+    if (threads == 0) {
+        long cpu_count = sysconf(_SC_NPROCESSORS_ONLN);
+        threads        = cpu_count > 0 ? (usize)cpu_count : 1;
+    }
+    if (threads > count) threads = count;
+
+    FileLoadPool pool = {.files = files, .count = count, .next_index = 0};
+
+    //
+    // The calling thread is one of the workers
+    //
+    pthread_t thread_ids[threads];
+    usize started = 0;
+    for (usize index = 1; index < threads; index++) {
+        if (pthread_create(&thread_ids[started],
+                           NULL,
+                           file_load_pool_worker,
+                           &pool) == 0) {
+            started++;
+        }
+    }
+    file_load_pool_worker(&pool);
+
+    for (usize index = 0; index < started; index++) {
+        pthread_join(thread_ids[index], NULL);
+    }
+}
+
+#ifdef FILE_HAS_IO_URING
+
+//
+// Minimal `io_uring` (no `liburing`): the submission queue, the completion
+// queue and the SQE array are mapped from the ring fd, the rings are only
+// touched by this thread.
+//
+typedef struct {
+    int fd;
+    u32 *sq_tail;
+    u32 *sq_mask;
+    u32 *sq_array;
+    u32 sq_entries;
+    struct io_uring_sqe *sqes;
+    u32 *cq_head;
+    u32 *cq_tail;
+    u32 *cq_mask;
+    struct io_uring_cqe *cqes;
+    void *sq_ring;
+    usize sq_ring_size;
+    void *cq_ring;
+    usize cq_ring_size;
+    usize sqes_size;
+
+    // SQEs queued since the last submit
+    u32 pending;
+
+    // SQEs given to the kernel but not submitted by `io_uring_enter` yet
+    u32 to_submit;
+
+    // SQEs submitted but their CQEs are not reaped yet
+    u32 in_flight;
+} FileUring;
+
+#define FILE_URING_ENTRIES 256
+
+//
+// `user_data`: the file index plus the operation in the lowest 2 bits
+//
+#define FILE_URING_OP_OPEN 0x00
+#define FILE_URING_OP_STATX 0x01
+#define FILE_URING_OP_READ 0x02
+#define FILE_URING_OP_CLOSE 0x03
+
+static bool file_uring_init(FileUring *ring) {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+
+    int fd = (int)syscall(__NR_io_uring_setup, FILE_URING_ENTRIES, &params);
+    if (fd < 0) return false;
+
+    *ring = (FileUring){.fd = fd, .sq_entries = params.sq_entries};
+
+    ring->sq_ring_size =
+        params.sq_off.array + params.sq_entries * sizeof(u32);
+    ring->cq_ring_size = params.cq_off.cqes +
+                         params.cq_entries * sizeof(struct io_uring_cqe);
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+
+    //
+    // Both rings share one mapping since 5.4
+    //
+    bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single_mmap && ring->cq_ring_size > ring->sq_ring_size) {
+        ring->sq_ring_size = ring->cq_ring_size;
+    }
+
+    ring->sq_ring = mmap(NULL,
+                         ring->sq_ring_size,
+                         PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_POPULATE,
+                         fd,
+                         IORING_OFF_SQ_RING);
+    ring->cq_ring = single_mmap ? ring->sq_ring
+                                : mmap(NULL,
+                                       ring->cq_ring_size,
+                                       PROT_READ | PROT_WRITE,
+                                       MAP_SHARED | MAP_POPULATE,
+                                       fd,
+                                       IORING_OFF_CQ_RING);
+    ring->sqes    = mmap(NULL,
+                      ring->sqes_size,
+                      PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE,
+                      fd,
+                      IORING_OFF_SQES);
+    if (ring->sq_ring == MAP_FAILED || ring->cq_ring == MAP_FAILED ||
+        ring->sqes == MAP_FAILED) {
+        if (ring->sqes != MAP_FAILED) munmap(ring->sqes, ring->sqes_size);
+        if (!single_mmap && ring->cq_ring != MAP_FAILED) {
+            munmap(ring->cq_ring, ring->cq_ring_size);
+        }
+        if (ring->sq_ring != MAP_FAILED) {
+            munmap(ring->sq_ring, ring->sq_ring_size);
+        }
+        close(fd);
+        return false;
+    }
+
+    u8 *sq         = ring->sq_ring;
+    u8 *cq         = ring->cq_ring;
+    ring->sq_tail  = (u32 *)(sq + params.sq_off.tail);
+    ring->sq_mask  = (u32 *)(sq + params.sq_off.ring_mask);
+    ring->sq_array = (u32 *)(sq + params.sq_off.array);
+    ring->cq_head  = (u32 *)(cq + params.cq_off.head);
+    ring->cq_tail  = (u32 *)(cq + params.cq_off.tail);
+    ring->cq_mask  = (u32 *)(cq + params.cq_off.ring_mask);
+    ring->cqes     = (struct io_uring_cqe *)(cq + params.cq_off.cqes);
+
+    return true;
+}
+
+static void file_uring_free(FileUring *ring) {
+    munmap(ring->sqes, ring->sqes_size);
+    if (ring->cq_ring != ring->sq_ring) {
+        munmap(ring->cq_ring, ring->cq_ring_size);
+    }
+    munmap(ring->sq_ring, ring->sq_ring_size);
+    close(ring->fd);
+}
+
+/*
+ * Get the next free SQE (zeroed), the caller makes sure there are no more
+ * than `sq_entries` pending SQEs
+ */
+static struct io_uring_sqe *file_uring_get_sqe(FileUring *ring) {
+    u32 tail  = *ring->sq_tail + ring->pending;
+    u32 index = tail & *ring->sq_mask;
+
+    ring->sq_array[index]    = index;
+    struct io_uring_sqe *sqe = &ring->sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    ring->pending++;
+
+    return sqe;
+}
+
+/*
+ * Submit the SQEs given to the kernel and wait until nothing is in flight,
+ * `on_complete` is called for each CQE. Return `false` if `io_uring_enter`
+ * fails, call it again to reap the rest.
+ */
+static bool file_uring_wait(FileUring *ring,
+                            void (*on_complete)(void *context,
+                                                u64 user_data,
+                                                i32 result),
+                            void *context) {
+    while (ring->to_submit > 0 || ring->in_flight > 0) {
+        u32 head = *ring->cq_head;
+        u32 tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+        if (head == tail || ring->to_submit > 0) {
+            long submitted = syscall(__NR_io_uring_enter,
+                                     ring->fd,
+                                     ring->to_submit,
+                                     head == tail ? 1 : 0,
+                                     IORING_ENTER_GETEVENTS,
+                                     NULL,
+                                     0);
+            if (submitted < 0) {
+                if (errno == EINTR || errno == EAGAIN || errno == EBUSY) {
+                    continue;
+                }
+                return false;
+            }
+            ring->to_submit -= (u32)submitted;
+            ring->in_flight += (u32)submitted;
+            continue;
+        }
+
+        for (; head != tail; head++, ring->in_flight--) {
+            struct io_uring_cqe *cqe = &ring->cqes[head & *ring->cq_mask];
+            on_complete(context, cqe->user_data, cqe->res);
+        }
+        __atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+    }
+
+    return true;
+}
+
+/*
+ * Submit all pending SQEs and wait until all of them complete, see
+ * `file_uring_wait`
+ */
+static bool file_uring_submit_and_wait(FileUring *ring,
+                                       void (*on_complete)(void *context,
+                                                           u64 user_data,
+                                                           i32 result),
+                                       void *context) {
+    __atomic_store_n(ring->sq_tail,
+                     *ring->sq_tail + ring->pending,
+                     __ATOMIC_RELEASE);
+    ring->to_submit += ring->pending;
+    ring->pending = 0;
+
+    return file_uring_wait(ring, on_complete, context);
+}
+
+//
+// Per file state in a batch
+//
+typedef struct {
+    int fd;
+    i32 open_result;
+    i32 statx_result;
+    i32 read_result;
+    struct statx statx;
+
+    // Loaded (or failed) by the batch, nothing is left to do
+    bool finished;
+} FileUringSlot;
+
+typedef struct {
+    File *files;
+    FileUringSlot *slots;
+    usize first_index;
+} FileUringBatch;
+
+static void file_uring_on_complete(void *context, u64 user_data, i32 result) {
+    FileUringBatch *batch = context;
+    usize index           = (user_data >> 2) - batch->first_index;
+    FileUringSlot *slot   = &batch->slots[index];
+
+    switch (user_data & 0x03) {
+        case FILE_URING_OP_OPEN:
+            slot->open_result = result;
+            slot->fd          = result;
+            break;
+        case FILE_URING_OP_STATX:
+            slot->statx_result = result;
+            break;
+        case FILE_URING_OP_READ:
+            slot->read_result = result;
+            break;
+        default:
+            break;
+    }
+}
+
+/*
+ * Load `files[first..first + batch_count]` with `io_uring`, 3 round trips:
+ *
+ * 1. `openat` + `statx` (by path, so they don't depend on each other)
+ * 2. `read` the whole file into a buffer of the `statx` size
+ * 3. `close`
+ *
+ * Any file that doesn't fit the fast path (unsupported operation, short
+ * read, non-regular file, bigger than 1GB) is finished by `pread`.
+ *
+ * Return `false` if `io_uring_enter` fails, the requests might be still in
+ * flight then: they have to be reaped (`file_uring_wait`) before freeing the
+ * buffers, the files that are not `finished` have to be loaded again.
+ */
+static bool file_uring_load_batch(FileUring *ring,
+                                  File *files,
+                                  FileUringSlot *slots,
+                                  usize first,
+                                  usize batch_count) {
+    const usize read_limit = 1024 * 1024 * 1024;
+    FileUringBatch batch   = {
+        .files       = files,
+        .slots       = slots,
+        .first_index = first,
+    };
+
+    for (usize index = 0; index < batch_count; index++) {
+        FileUringSlot *slot = &slots[index];
+        *slot               = (FileUringSlot){.fd = -1};
+        const char *path    = HS_as_str(files[first + index]->filename);
+        u64 user_data       = (u64)(first + index) << 2;
+
+        struct io_uring_sqe *sqe = file_uring_get_sqe(ring);
+        sqe->opcode              = IORING_OP_OPENAT;
+        sqe->fd                  = AT_FDCWD;
+        sqe->addr                = (u64)(uintptr_t)path;
+        sqe->open_flags          = O_RDONLY | O_CLOEXEC;
+        sqe->user_data           = user_data | FILE_URING_OP_OPEN;
+
+        sqe              = file_uring_get_sqe(ring);
+        sqe->opcode      = IORING_OP_STATX;
+        sqe->fd          = AT_FDCWD;
+        sqe->addr        = (u64)(uintptr_t)path;
+        sqe->len         = STATX_TYPE | STATX_SIZE;
+        sqe->off         = (u64)(uintptr_t)&slot->statx;
+        sqe->statx_flags = 0;
+        sqe->user_data   = user_data | FILE_URING_OP_STATX;
+    }
+    if (!file_uring_submit_and_wait(ring, file_uring_on_complete, &batch))
+        return false;
+
+    //
+    // Read the regular files in one go
+    //
+    for (usize index = 0; index < batch_count; index++) {
+        FileUringSlot *slot = &slots[index];
+        File file           = files[first + index];
+        if (slot->open_result < 0 || slot->statx_result < 0 ||
+            !S_ISREG(slot->statx.stx_mode) ||
+            slot->statx.stx_size > read_limit) {
+            continue;
+        }
+
+        usize size = slot->statx.stx_size;
+        file->data = file_alloc_data(size + 1);
+        if (size == 0) continue;
+
+        struct io_uring_sqe *sqe = file_uring_get_sqe(ring);
+        sqe->opcode              = IORING_OP_READ;
+        sqe->fd                  = slot->fd;
+        sqe->addr                = (u64)(uintptr_t)file->data->_buffer;
+        sqe->len                 = (u32)size;
+        sqe->off                 = 0;
+        sqe->user_data = ((u64)(first + index) << 2) | FILE_URING_OP_READ;
+    }
+    if (!file_uring_submit_and_wait(ring, file_uring_on_complete, &batch))
+        return false;
+
+    //
+    // Finish every file, then close them all in one go
+    //
+    for (usize index = 0; index < batch_count; index++) {
+        FileUringSlot *slot = &slots[index];
+        File file           = files[first + index];
+        slot->finished      = true;
+
+        if (slot->open_result == -EINVAL || slot->open_result == -EOPNOTSUPP) {
+            //
+            // `IORING_OP_OPENAT` is not supported (before 5.6)
+            //
+            HS_free(file->data);
+            file->data = NULL;
+            file_load_sync(file);
+            continue;
+        }
+        if (slot->open_result < 0) {
+            file_set_error(file, strerror(-slot->open_result));
+            continue;
+        }
+
+        //
+        // Only the empty, non-regular or short read files read again
+        //
+        usize loaded = 0;
+        if (file->data != NULL && slot->read_result > 0) {
+            loaded = slot->read_result;
+        }
+        usize size_hint =
+            slot->statx_result == 0 && S_ISREG(slot->statx.stx_mode)
+                ? slot->statx.stx_size
+                : 0;
+        file->open_successfully =
+            file_read_fd_to_end(file, slot->fd, loaded, size_hint);
+
+        struct io_uring_sqe *sqe = file_uring_get_sqe(ring);
+        sqe->opcode              = IORING_OP_CLOSE;
+        sqe->fd                  = slot->fd;
+        sqe->user_data = ((u64)(first + index) << 2) | FILE_URING_OP_CLOSE;
+
+        // The ring owns the fd now, even if the close isn't submitted
+        slot->fd = -1;
+    }
+
+    return file_uring_submit_and_wait(ring, file_uring_on_complete, &batch);
+}
+
+/*
+ * Load all files with `io_uring` batch by batch (`file_uring_load_batch`).
+ * If `io_uring_enter` fails in the middle, the files that are not loaded
+ * yet are loaded by `pread`.
+ *
+ * Return `false` if `io_uring` isn't available at all.
+ */
+static bool file_load_with_io_uring(File *files, usize count) {
+    FileUring ring;
+    if (!file_uring_init(&ring)) return false;
+
+    const usize batch_size = ring.sq_entries / 2;
+    FileUringSlot *slots   = malloc(batch_size * sizeof(FileUringSlot));
+    if (slots == NULL) {
+        file_uring_free(&ring);
+        return false;
+    }
+
+    usize first       = 0;
+    usize batch_count = 0;
+    bool ring_ok      = true;
+    while (first < count && ring_ok) {
+        batch_count = count - first < batch_size ? count - first : batch_size;
+        ring_ok =
+            file_uring_load_batch(&ring, files, slots, first, batch_count);
+        if (ring_ok) first += batch_count;
+    }
+
+    //
+    // Closing the ring doesn't wait for the in-flight requests (the kernel
+    // only queues the cleanup), they might still write the read buffers and
+    // the `statx` results. Reap them all first, if even that fails, leak
+    // the buffers of the batch instead of freeing them.
+    //
+    FileUringBatch batch = {
+        .files       = files,
+        .slots       = slots,
+        .first_index = first,
+    };
+    bool drained =
+        ring_ok || file_uring_wait(&ring, file_uring_on_complete, &batch);
+    file_uring_free(&ring);
+
+    if (!ring_ok) {
+        for (usize index = 0; index < batch_count; index++) {
+            FileUringSlot *slot = &slots[index];
+            File file           = files[first + index];
+            if (slot->finished) continue;
+
+            if (slot->fd >= 0) close(slot->fd);
+            if (drained) HS_free(file->data);
+            file->data = NULL;
+            file_load_sync(file);
+        }
+        for (usize index = first + batch_count; index < count; index++) {
+            file_load_sync(files[index]);
+        }
+
+#ifdef ENABLE_DEBUG_LOG
+        DEBUG_LOG(File,
+                  load_with_io_uring,
+                  "io_uring_enter failed at file %lu, the rest %lu files "
+                  "are loaded by pread, drained: %s",
+                  first,
+                  count - first,
+                  drained ? "true" : "false");
+#endif
+    }
+
+    if (drained) free(slots);
+
+    return true;
+}
+
+#endif
+
+/*
+ * Load `count` files in one go
+ */
+Vector File_load_many(const char **paths,
+                      usize count,
+                      FileLoadManyOptions options,
+                      FileLoadManyStats *stats) {
+    long double start_time = Timer_get_current_time(TU_MILLISECONDS);
+
+    Vector result = Vec_with_capacity(sizeof(File),
+                                      "File",
+                                      count > 0 ? count : 1,
+                                      file_vector_element_destructor);
+    if (paths == NULL || count == 0) {
+        if (stats != NULL) *stats = (FileLoadManyStats){0};
+        return result;
+    }
+
+    File *files = malloc(count * sizeof(File));
+    for (usize index = 0; index < count; index++) {
+        files[index] = file_new(paths[index], FM_READ_ONLY);
+    }
+
+    bool io_uring_used = false;
+#ifdef FILE_HAS_IO_URING
+    if (!options.no_io_uring) {
+        io_uring_used = file_load_with_io_uring(files, count);
+    }
+#endif
+    if (!io_uring_used) {
+        file_load_with_thread_pool(files, count, options.threads);
+    }
+
+    FileLoadManyStats summary = {.io_uring_used = io_uring_used};
+    for (usize index = 0; index < count; index++) {
+        if (files[index]->open_successfully) {
+            summary.loaded++;
+            summary.total_bytes += files[index]->size;
+        } else {
+            summary.failed++;
+        }
+        Vec_push(result, &files[index]);
+    }
+    free(files);
+
+    summary.elapsed_ms = Timer_get_current_time(TU_MILLISECONDS) - start_time;
+
+#ifdef ENABLE_DEBUG_LOG
+    DEBUG_LOG(File,
+              load_many,
+              "count: %lu, loaded: %lu, failed: %lu, total_bytes: %lu, "
+              "io_uring: %d, elapsed: %.3Lf ms",
+              count,
+              summary.loaded,
+              summary.failed,
+              summary.total_bytes,
+              summary.io_uring_used,
+              summary.elapsed_ms);
+#endif
+
+    if (stats != NULL) *stats = summary;
+
+    return result;
+}
+
+//
+// `Dir_walk` implementation
+//
+// All workers share a stack of folders to walk, each worker pops a folder,
+// lists its entries and pushes the sub folders back. The found paths are
+// packed into a per worker buffer (`path\0path\0...`) and merged into one
+// `StringTable` at the end. The non-parallel walk is the same code with the
+// calling thread as the only worker.
+//
+
+#define DIR_WALK_BUFFER_SIZE (128 * 1024)
+
+typedef struct {
+    char *path;
+    usize depth;
+} DirWalkFolder;
+
+//
+// Visited folders for `DWS_FOLLOW` (open addressing hash set), `{0, 0}` is
+// an empty slot
+//
+typedef struct {
+    u64 dev;
+    u64 ino;
+} DirWalkFolderId;
+
+typedef struct {
+    DirWalkOptions options;
+    pthread_mutex_t lock;
+    pthread_cond_t has_folder;
+    DirWalkFolder *folders;
+    usize folder_count;
+    usize folder_capacity;
+    usize active_workers;
+    DirWalkFolderId *visited;
+    usize visited_count;
+    usize visited_capacity;
+} DirWalker;
+
+typedef struct {
+    DirWalker *walker;
+
+    // Found paths, packed as `path\0path\0...`
+    char *output;
+    usize output_len;
+    usize output_capacity;
+
+    // `folder path + /`, the entry name is appended after `path_prefix_len`
+    char *path;
+    usize path_prefix_len;
+    usize path_capacity;
+
+    // `getdents64` buffer
+    char *buffer;
+} DirWalkWorker;
+
+#ifdef FILE_HAS_GETDENTS64
+//
+// The record layout of `getdents64`
+//
+struct dir_walk_dirent64 {
+    u64 d_ino;
+    i64 d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[];
+};
+#endif
+
+static void dir_walk_output_push(DirWalkWorker *worker,
+                                 const char *path,
+                                 usize len) {
+    if (worker->output_len + len + 1 > worker->output_capacity) {
+        usize new_capacity = worker->output_capacity < 64 * 1024
+                                 ? 64 * 1024
+                                 : worker->output_capacity * 2;
+        while (new_capacity < worker->output_len + len + 1) new_capacity *= 2;
+        worker->output          = realloc(worker->output, new_capacity);
+        worker->output_capacity = new_capacity;
+    }
+
+    memcpy(worker->output + worker->output_len, path, len);
+    worker->output[worker->output_len + len] = '\0';
+    worker->output_len += len + 1;
+}
+
+static void dir_walk_push_folder(DirWalker *walker,
+                                 const char *path,
+                                 usize len,
+                                 usize depth) {
+    char *folder_path = malloc(len + 1);
+    memcpy(folder_path, path, len);
+    folder_path[len] = '\0';
+
+    pthread_mutex_lock(&walker->lock);
+    if (walker->folder_count == walker->folder_capacity) {
+        walker->folder_capacity =
+            walker->folder_capacity == 0 ? 64 : walker->folder_capacity * 2;
+        walker->folders = realloc(walker->folders,
+                                  walker->folder_capacity *
+                                      sizeof(DirWalkFolder));
+    }
+    walker->folders[walker->folder_count++] =
+        (DirWalkFolder){.path = folder_path, .depth = depth};
+    pthread_cond_signal(&walker->has_folder);
+    pthread_mutex_unlock(&walker->lock);
+}
+
+/*
+ * Return `true` if the folder is walked for the first time, the caller
+ * holds the lock
+ */
+static bool dir_walk_visit(DirWalker *walker, DirWalkFolderId id) {
+    if ((walker->visited_count + 1) * 2 > walker->visited_capacity) {
+        usize old_capacity       = walker->visited_capacity;
+        DirWalkFolderId *old_ids = walker->visited;
+        walker->visited_capacity = old_capacity == 0 ? 256 : old_capacity * 2;
+        walker->visited_count    = 0;
+        walker->visited =
+            calloc(walker->visited_capacity, sizeof(DirWalkFolderId));
+        for (usize index = 0; index < old_capacity; index++) {
+            if (old_ids[index].dev != 0 || old_ids[index].ino != 0) {
+                dir_walk_visit(walker, old_ids[index]);
+            }
+        }
+        free(old_ids);
+    }
+
+    usize mask  = walker->visited_capacity - 1;
+    usize index = (id.ino * 0x9E3779B97F4A7C15ULL ^ id.dev) & mask;
+    for (;;) {
+        DirWalkFolderId *slot = &walker->visited[index];
+        if (slot->dev == 0 && slot->ino == 0) {
+            *slot = id;
+            walker->visited_count++;
+            return true;
+        }
+        if (slot->dev == id.dev && slot->ino == id.ino) return false;
+
+        index = (index + 1) & mask;
+    }
+}
+
+/*
+ * Handle one folder entry, `worker->path[0..path_prefix_len]` is the folder
+ * path with the ending `/`
+ */
+static void dir_walk_entry(DirWalkWorker *worker,
+                           const DirWalkFolder *folder,
+                           int folder_fd,
+                           const char *name,
+                           unsigned char type) {
+    const DirWalkOptions *options = &worker->walker->options;
+
+    if (name[0] == '.' &&
+        (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))) {
+        return;
+    }
+    if (options->skip_hidden && name[0] == '.') return;
+
+    //
+    // Only `stat` when the file system doesn't fill `d_type`, or when
+    // following a link
+    //
+    struct stat entry_stat;
+    if (type == DT_UNKNOWN) {
+        if (fstatat(folder_fd, name, &entry_stat, AT_SYMLINK_NOFOLLOW) != 0) {
+            return;
+        }
+        type = S_ISDIR(entry_stat.st_mode)   ? DT_DIR
+               : S_ISLNK(entry_stat.st_mode) ? DT_LNK
+                                             : DT_REG;
+    }
+
+    bool is_dir = type == DT_DIR;
+    if (type == DT_LNK) {
+        if (options->symlinks == DWS_SKIP) return;
+        if (options->symlinks == DWS_FOLLOW &&
+            fstatat(folder_fd, name, &entry_stat, 0) == 0) {
+            is_dir = S_ISDIR(entry_stat.st_mode);
+        }
+    }
+
+    bool matched = options->pattern == NULL ||
+                   fnmatch(options->pattern, name, 0) == 0;
+    if (!matched && !is_dir) return;
+
+    usize name_len = strlen(name);
+    usize path_len = worker->path_prefix_len + name_len;
+    if (path_len + 1 > worker->path_capacity) {
+        worker->path_capacity = (path_len + 1) * 2;
+        worker->path          = realloc(worker->path, worker->path_capacity);
+    }
+    memcpy(worker->path + worker->path_prefix_len, name, name_len + 1);
+
+    if (matched && (!is_dir || options->include_dirs)) {
+        dir_walk_output_push(worker, worker->path, path_len);
+    }
+
+    if (is_dir &&
+        (options->max_depth == 0 || folder->depth + 1 < options->max_depth)) {
+        dir_walk_push_folder(worker->walker,
+                             worker->path,
+                             path_len,
+                             folder->depth + 1);
+    }
+}
+
+static void dir_walk_read_folder(DirWalkWorker *worker,
+                                 const DirWalkFolder *folder) {
+    DirWalker *walker = worker->walker;
+
+    int fd = open(folder->path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) {
+#ifdef ENABLE_DEBUG_LOG
+        DEBUG_LOG(Dir,
+                  walk,
+                  "Skip folder - '%s': %s",
+                  folder->path,
+                  strerror(errno));
+#endif
+        return;
+    }
+
+    //
+    // Every folder is walked once when following links, it breaks the loops
+    //
+    if (walker->options.symlinks == DWS_FOLLOW) {
+        struct stat folder_stat;
+        bool first_time = false;
+        if (fstat(fd, &folder_stat) == 0) {
+            pthread_mutex_lock(&walker->lock);
+            first_time = dir_walk_visit(
+                walker,
+                (DirWalkFolderId){.dev = (u64)folder_stat.st_dev,
+                                  .ino = (u64)folder_stat.st_ino});
+            pthread_mutex_unlock(&walker->lock);
+        }
+        if (!first_time) {
+            close(fd);
+            return;
+        }
+    }
+
+    usize folder_len = strlen(folder->path);
+    if (folder_len + 2 > worker->path_capacity) {
+        worker->path_capacity = (folder_len + 2) * 2;
+        worker->path          = realloc(worker->path, worker->path_capacity);
+    }
+    memcpy(worker->path, folder->path, folder_len);
+    if (folder_len == 0 || folder->path[folder_len - 1] != '/') {
+        worker->path[folder_len++] = '/';
+    }
+    worker->path_prefix_len = folder_len;
+
+#ifdef FILE_HAS_GETDENTS64
+    for (;;) {
+        long read_size = syscall(SYS_getdents64,
+                                 fd,
+                                 worker->buffer,
+                                 DIR_WALK_BUFFER_SIZE);
+        if (read_size <= 0) break;
+
+        for (long offset = 0; offset < read_size;) {
+            struct dir_walk_dirent64 *entry =
+                (struct dir_walk_dirent64 *)(worker->buffer + offset);
+            dir_walk_entry(worker, folder, fd, entry->d_name, entry->d_type);
+            offset += entry->d_reclen;
+        }
+    }
+    close(fd);
+#else
+    DIR *dir = fdopendir(fd);
+    if (dir == NULL) {
+        close(fd);
+        return;
+    }
+
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        dir_walk_entry(worker, folder, fd, entry->d_name, entry->d_type);
+    }
+    closedir(dir);
+#endif
+}
+
+static void *dir_walk_worker(void *arg) {
+    DirWalkWorker *worker = arg;
+    DirWalker *walker     = worker->walker;
+
+    pthread_mutex_lock(&walker->lock);
+    for (;;) {
+        while (walker->folder_count == 0 && walker->active_workers > 0) {
+            pthread_cond_wait(&walker->has_folder, &walker->lock);
+        }
+
+        //
+        // No folder left and no worker can push more, wake up all others
+        //
+        if (walker->folder_count == 0) {
+            pthread_cond_broadcast(&walker->has_folder);
+            break;
+        }
+
+        DirWalkFolder folder = walker->folders[--walker->folder_count];
+        walker->active_workers++;
+        pthread_mutex_unlock(&walker->lock);
+
+        dir_walk_read_folder(worker, &folder);
+        free(folder.path);
+
+        pthread_mutex_lock(&walker->lock);
+        walker->active_workers--;
+    }
+    pthread_mutex_unlock(&walker->lock);
+
+    return NULL;
+}
+
+/*
+ * Walk the `root` folder recursively
+ */
+StringTable Dir_walk(const char *root, DirWalkOptions options) {
+    if (root == NULL || root[0] == '\0') return NULL;
+
+    int root_fd = open(root, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (root_fd < 0) return NULL;
+    close(root_fd);
+
+    usize threads = 1;
+    if (options.parallel) {
+        threads = options.threads;
+        if (threads == 0) {
+            long cpu_count = sysconf(_SC_NPROCESSORS_ONLN);
+            threads        = cpu_count > 0 ? (usize)cpu_count : 1;
+        }
+    }
+
+    DirWalker walker = {.options = options};
+    pthread_mutex_init(&walker.lock, NULL);
+    pthread_cond_init(&walker.has_folder, NULL);
+
+    //
+    // Remove the ending `/` (except the `/` itself)
+    //
+    usize root_len = strlen(root);
+    while (root_len > 1 && root[root_len - 1] == '/') root_len--;
+    dir_walk_push_folder(&walker, root, root_len, 0);
+
+    DirWalkWorker workers[threads];
+    for (usize index = 0; index < threads; index++) {
+        workers[index] = (DirWalkWorker){
+            .walker = &walker,
+            .buffer = malloc(DIR_WALK_BUFFER_SIZE),
+        };
+    }
+
+    //
+    // The calling thread is one of the workers
+    //
+    pthread_t thread_ids[threads];
+    usize started = 0;
+    for (usize index = 1; index < threads; index++) {
+        if (pthread_create(&thread_ids[started],
+                           NULL,
+                           dir_walk_worker,
+                           &workers[index]) == 0) {
+            started++;
+        }
+    }
+    dir_walk_worker(&workers[0]);
+    for (usize index = 0; index < started; index++) {
+        pthread_join(thread_ids[index], NULL);
+    }
+
+    //
+    // Merge all outputs into one `StringTable`
+    //
+    StringTable result = NULL;
+    if (threads == 1) {
+        result = ST_from_packed(workers[0].output, workers[0].output_len);
+    } else {
+        usize total_len = 0;
+        for (usize index = 0; index < threads; index++) {
+            total_len += workers[index].output_len;
+        }
+
+        char *packed = malloc(total_len > 0 ? total_len : 1);
+        usize offset = 0;
+        for (usize index = 0; index < threads; index++) {
+            if (workers[index].output_len == 0) continue;
+
+            memcpy(packed + offset,
+                   workers[index].output,
+                   workers[index].output_len);
+            offset += workers[index].output_len;
+        }
+        result = ST_from_packed(packed, total_len);
+        free(packed);
+    }
+    if (options.sort) ST_sort(result);
+
+#ifdef ENABLE_DEBUG_LOG
+    DEBUG_LOG(Dir,
+              walk,
+              "root: %s, threads: %lu, paths: %lu",
+              root,
+              threads,
+              ST_len(result));
+#endif
+
+    for (usize index = 0; index < threads; index++) {
+        free(workers[index].output);
+        free(workers[index].path);
+        free(workers[index].buffer);
+    }
+    free(walker.folders);
+    free(walker.visited);
+    pthread_cond_destroy(&walker.has_folder);
+    pthread_mutex_destroy(&walker.lock);
+
+    return result;
+}
+
+//
+// `File_copy` / `File_send_to_fd` implementation
+//
+
+#define FILE_COPY_CHUNK_SIZE (1024 * 1024)
+
+//
+// The in kernel copy is at most 1GB per call, so it can be interrupted
+//
+#define FILE_COPY_KERNEL_CHUNK_SIZE (1024 * 1024 * 1024)
+
+/*
+ * Make sure the bytes buffered by `File_append` / `FILE *` are in the file
+ * before copying it by fd
+ */
+static bool file_copy_prepare(File self) {
+    if (self == NULL) return false;
+
+    if (!self->open_successfully || self->inner == NULL) {
+        file_set_error(self, "File isn't opened");
+        return false;
+    }
+
+    if (!File_flush(self)) return false;
+    if (self->mode != FM_READ_ONLY) fflush(self->inner);
+
+    return true;
+}
+
+/*
+ * Return a readable fd of `self`, the write-only (`FM_WRITE_ONLY`,
+ * `FM_APPEND`) file is opened again for reading, the caller closes it if
+ * it's not `fileno(self->inner)`.
+ */
+static int file_copy_source_fd(File self) {
+    int fd = fileno(self->inner);
+    if ((fcntl(fd, F_GETFL) & O_ACCMODE) != O_WRONLY) return fd;
+
+    fd = open(HS_as_str(self->filename), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) file_set_error(self, strerror(errno));
+
+    return fd;
+}
+
+/*
+ * Copy `in_fd[offset..]` to the current position of `out_fd` with the
+ * given in kernel method, `offset` is moved forward.
+ *
+ * Return `1` when done, `0` if the method isn't supported for these fds
+ * (nothing copied, try the next one), `-1` on error.
+ */
+static int file_copy_in_kernel(int in_fd,
+                               int out_fd,
+                               usize *offset,
+                               usize size_hint,
+                               FileCopyMethod method) {
+#if defined(__linux__)
+    usize start = *offset;
+
+    for (;;) {
+        long copied = -1;
+        if (method == FCM_COPY_FILE_RANGE) {
+    #if defined(SYS_copy_file_range)
+            loff_t in_offset = *offset;
+
+            copied = syscall(SYS_copy_file_range,
+                             in_fd,
+                             &in_offset,
+                             out_fd,
+                             NULL,
+                             FILE_COPY_KERNEL_CHUNK_SIZE,
+                             0);
+    #else
+            errno = ENOSYS;
+    #endif
+        } else if (method == FCM_SENDFILE) {
+            off_t in_offset = *offset;
+
+            copied = sendfile(out_fd,
+                              in_fd,
+                              &in_offset,
+                              FILE_COPY_KERNEL_CHUNK_SIZE);
+        } else if (method == FCM_SPLICE) {
+    #if defined(SYS_splice)
+            loff_t in_offset = *offset;
+
+            copied = syscall(SYS_splice,
+                             in_fd,
+                             &in_offset,
+                             out_fd,
+                             NULL,
+                             FILE_COPY_KERNEL_CHUNK_SIZE,
+                             0);
+    #else
+            errno = ENOSYS;
+    #endif
+        }
+
+        if (copied < 0) {
+            if (errno == EINTR) continue;
+
+            bool unsupported = errno == ENOSYS || errno == EXDEV ||
+                               errno == EINVAL || errno == EOPNOTSUPP;
+            return (unsupported && *offset == start) ? 0 : -1;
+        }
+
+        //
+        // Some file systems (e.g. `/proc` before 5.3) return 0 straight
+        // away for `copy_file_range` instead of an error
+        //
+        if (copied == 0) {
+            return (*offset == start && size_hint > 0) ? 0 : 1;
+        }
+
+        *offset += copied;
+    }
+#else
+    (void)in_fd;
+    (void)out_fd;
+    (void)offset;
+    (void)size_hint;
+    (void)method;
+    return 0;
+#endif
+}
+
+/*
+ * Copy `in_fd[offset..]` to the current position of `out_fd` through a user
+ * space buffer, `offset` is moved forward. Return `false` on error.
+ */
+static bool file_copy_read_write(int in_fd, int out_fd, usize *offset) {
+    char *buffer = malloc(FILE_COPY_CHUNK_SIZE);
+    if (buffer == NULL) {
+        errno = ENOMEM;
+        return false;
+    }
+
+    bool result = true;
+    for (;;) {
+        ssize_t read_size =
+            pread(in_fd, buffer, FILE_COPY_CHUNK_SIZE, *offset);
+        if (read_size < 0) {
+            if (errno == EINTR) continue;
+            result = false;
+            break;
+        }
+        if (read_size == 0) break;
+
+        struct iovec iov = {.iov_base = buffer, .iov_len = read_size};
+        if (!file_write_all(out_fd, &iov, 1, NULL)) {
+            result = false;
+            break;
+        }
+        *offset += read_size;
+    }
+
+    free(buffer);
+
+    return result;
+}
+
+/*
+ * Copy the whole `in_fd` to `out_fd`, try the given methods in order then
+ * fall back to `FCM_READ_WRITE`
+ */
+static FileCopyMethod file_copy_fd(File self,
+                                   int in_fd,
+                                   int out_fd,
+                                   const FileCopyMethod *methods,
+                                   usize method_count) {
+    struct stat in_stat;
+    usize size_hint = 0;
+    if (fstat(in_fd, &in_stat) == 0 && S_ISREG(in_stat.st_mode)) {
+        size_hint = in_stat.st_size;
+    }
+
+    usize offset = 0;
+    for (usize index = 0; index < method_count; index++) {
+        int result = file_copy_in_kernel(in_fd,
+                                         out_fd,
+                                         &offset,
+                                         size_hint,
+                                         methods[index]);
+        if (result == 1) return methods[index];
+        if (result < 0) {
+            file_set_error(self, strerror(errno));
+            return FCM_FAILED;
+        }
+    }
+
+    if (!file_copy_read_write(in_fd, out_fd, &offset)) {
+        file_set_error(self, strerror(errno));
+        return FCM_FAILED;
+    }
+
+    return FCM_READ_WRITE;
+}
+
+/*
+ * Copy `in_fd` to `dst_filename`, the caller closes `in_fd`
+ */
+static FileCopyMethod file_copy_to_filename(File self,
+                                            int in_fd,
+                                            const char *dst_filename,
+                                            FileCopyOptions options) {
+    struct stat in_stat;
+    if (fstat(in_fd, &in_stat) != 0) {
+        file_set_error(self, strerror(errno));
+        return FCM_FAILED;
+    }
+
+    //
+    // Don't truncate before checking, the destination can be the source
+    // itself
+    //
+    int out_fd = open(dst_filename,
+                      O_WRONLY | O_CREAT | O_CLOEXEC,
+                      in_stat.st_mode & 07777);
+    if (out_fd < 0) {
+        file_set_error(self, strerror(errno));
+        return FCM_FAILED;
+    }
+
+    struct stat out_stat;
+    if (fstat(out_fd, &out_stat) == 0 && out_stat.st_dev == in_stat.st_dev &&
+        out_stat.st_ino == in_stat.st_ino) {
+        close(out_fd);
+        file_set_error(self, "Source and destination are the same file");
+        return FCM_FAILED;
+    }
+    if (ftruncate(out_fd, 0) != 0) {
+        file_set_error(self, strerror(errno));
+        close(out_fd);
+        return FCM_FAILED;
+    }
+
+    FileCopyMethod method = FCM_FAILED;
+
+#if defined(__linux__) && defined(FICLONE)
+    if (!options.no_clone && !options.no_kernel_copy &&
+        ioctl(out_fd, FICLONE, in_fd) == 0) {
+        method = FCM_CLONE;
+    }
+#endif
+
+    if (method == FCM_FAILED) {
+        const FileCopyMethod methods[] = {FCM_COPY_FILE_RANGE, FCM_SENDFILE};
+        usize method_count             = options.no_kernel_copy ? 0 : 2;
+
+        method = file_copy_fd(self, in_fd, out_fd, methods, method_count);
+    }
+
+    if (method != FCM_FAILED && options.sync && file_data_sync(out_fd) != 0) {
+        file_set_error(self, strerror(errno));
+        method = FCM_FAILED;
+    }
+    if (close(out_fd) != 0 && method != FCM_FAILED) {
+        file_set_error(self, strerror(errno));
+        method = FCM_FAILED;
+    }
+
+    return method;
+}
+
+/*
+ * Copy the whole file to `dst_filename`
+ */
+FileCopyMethod File_copy(File self,
+                         const char *dst_filename,
+                         FileCopyOptions options) {
+    if (!file_copy_prepare(self)) return FCM_FAILED;
+    if (dst_filename == NULL || dst_filename[0] == '\0') {
+        file_set_error(self, "Invalid destination filename");
+        return FCM_FAILED;
+    }
+
+    int in_fd = file_copy_source_fd(self);
+    if (in_fd < 0) return FCM_FAILED;
+
+    FileCopyMethod method =
+        file_copy_to_filename(self, in_fd, dst_filename, options);
+    if (in_fd != fileno(self->inner)) close(in_fd);
+
+#ifdef ENABLE_DEBUG_LOG
+    DEBUG_LOG(File,
+              copy,
+              "'%s' -> '%s', method: %d",
+              HS_as_str(self->filename),
+              dst_filename,
+              method);
+#endif
+
+    return method;
+}
+
+/*
+ * Write the whole file to `out_fd`
+ */
+FileCopyMethod File_send_to_fd(File self, int out_fd) {
+    if (!file_copy_prepare(self)) return FCM_FAILED;
+
+    struct stat out_stat;
+    if (out_fd < 0 || fstat(out_fd, &out_stat) != 0) {
+        file_set_error(self, strerror(EBADF));
+        return FCM_FAILED;
+    }
+
+    //
+    // `splice` needs a pipe on one side
+    //
+    FileCopyMethod method = S_ISFIFO(out_stat.st_mode) ? FCM_SPLICE
+                                                       : FCM_SENDFILE;
+
+    int in_fd = file_copy_source_fd(self);
+    if (in_fd < 0) return FCM_FAILED;
+
+    method = file_copy_fd(self, in_fd, out_fd, &method, 1);
+    if (in_fd != fileno(self->inner)) close(in_fd);
+
+    return method;
+}
+
+/*
+ * Reopen `self->filename` after the path is replaced, with the same mode
+ * except `FM_WRITE_ONLY` (`w` truncates the new content)
+ */
+static bool file_reopen(File self) {
+    if (!file_free_writer(self, false)) return false;
+    file_free_line_reader(self);
+
+    FileMode mode = self->mode == FM_WRITE_ONLY ? FM_READ_WRITE : self->mode;
+    char temp_mode[3] = {0};
+    file_mode_to_string(&mode, temp_mode);
+
+    FILE *file_handle = fopen(HS_as_str(self->filename), temp_mode);
+    if (file_handle == NULL) {
+        file_set_error(self, strerror(errno));
+        return false;
+    }
+
+    if (self->mode != FM_READ_ONLY) fflush(self->inner);
+    fclose(self->inner);
+    self->inner = file_handle;
+
+    return true;
+}
+
+/*
+ * Whether the stamp matches the file on disk
+ */
+static bool file_stamp_matches(const FileStamp *stamp,
+                               const struct stat *file_stat) {
+    return stamp->valid && stamp->device == (u64)file_stat->st_dev &&
+           stamp->inode == (u64)file_stat->st_ino &&
+           stamp->size == (usize)file_stat->st_size &&
+           stamp->mtime_sec == FILE_STAT_MTIME(file_stat).tv_sec &&
+           stamp->mtime_nsec == FILE_STAT_MTIME(file_stat).tv_nsec;
+}
+
+/*
+ * Reload (or re-map) only if the file on disk is changed
+ */
+FileReloadResult File_reload_if_changed(File self) {
+    if (self == NULL || !self->open_successfully || self->inner == NULL)
+        return FRR_FAILED;
+
+    struct stat path_stat;
+    if (stat(HS_as_str(self->filename), &path_stat) != 0) {
+        file_set_error(self, strerror(errno));
+        return FRR_FAILED;
+    }
+    if (file_stamp_matches(&self->stamp, &path_stat)) return FRR_UNCHANGED;
+
+    //
+    // Replaced by `rename`, the opened fd still points to the old inode
+    //
+    struct stat fd_stat;
+    if (fstat(fileno(self->inner), &fd_stat) != 0 ||
+        fd_stat.st_dev != path_stat.st_dev ||
+        fd_stat.st_ino != path_stat.st_ino) {
+        if (!file_reopen(self)) return FRR_FAILED;
+    }
+
+    bool mapped = self->stamp.valid && self->stamp.mapped;
+    bool reloaded =
+        mapped ? File_map(self, self->stamp.map_options)
+               : File_load_into_buffer(self) != (usize)-1;
+
+#ifdef ENABLE_DEBUG_LOG
+    DEBUG_LOG(File,
+              reload_if_changed,
+              "filename: %s, mapped: %d, reloaded: %d, size: %lu",
+              HS_as_str(self->filename),
+              mapped,
+              reloaded,
+              self->size);
+#endif
+
+    return reloaded ? FRR_RELOADED : FRR_FAILED;
+}
+
+//
+// A watched path: the parent folder is watched by `inotify`, the events are
+// matched by the watch descriptor and the file name
+//
+typedef struct {
+    String path;
+    String name;
+    int wd;
+
+    // `FileWatchEventType` bits not returned yet
+    u32 pending;
+} FileWatchEntry;
+
+struct _FileWatch {
+    int fd;
+    FileWatchEntry *entries;
+    usize count;
+    usize capacity;
+    String error;
+};
+
+#ifdef FILE_HAS_INOTIFY
+    #define FILE_WATCH_FOLDER_MASK                                             \
+        (IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB | IN_CREATE | IN_MOVED_TO |   \
+         IN_MOVED_FROM | IN_DELETE | IN_ONLYDIR)
+#endif
+
+static void file_watch_set_error(FileWatch self, const char *error) {
+    if (self->error != NULL) HS_free(self->error);
+    self->error = HS_from_str(error);
+}
+
+static FileWatchEntry *file_watch_find(FileWatch self, const char *path) {
+    for (usize index = 0; index < self->count; index++) {
+        if (strcmp(HS_as_str(self->entries[index].path), path) == 0) {
+            return &self->entries[index];
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * Create a watch
+ */
+FileWatch FileWatch_new(void) {
+    FileWatch self = malloc(sizeof(struct _FileWatch));
+    *self          = (struct _FileWatch){.fd = -1};
+
+#ifdef FILE_HAS_INOTIFY
+    self->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (self->fd < 0) file_watch_set_error(self, strerror(errno));
+#else
+    file_watch_set_error(self, "inotify isn't supported");
+#endif
+
+#ifdef ENABLE_DEBUG_LOG
+    DEBUG_LOG(FileWatch, new, "self ptr: %p, fd: %d", self, self->fd);
+#endif
+
+    return self;
+}
+
+/*
+ * Watch the given file path
+ */
+bool FileWatch_add(FileWatch self, const char *path) {
+    if (self == NULL || path == NULL) return false;
+    if (file_watch_find(self, path) != NULL) return true;
+    if (self->fd < 0) return false;
+
+    //
+    // Split into the parent folder and the file name
+    //
+    const char *slash = strrchr(path, '/');
+    const char *name  = slash != NULL ? slash + 1 : path;
+    if (*name == '\0') {
+        file_watch_set_error(self, "Not a file path");
+        return false;
+    }
+
+    String folder;
+    if (slash == NULL) {
+        folder = HS_from_str(".");
+    } else if (slash == path) {
+        folder = HS_from_str("/");
+    } else {
+        folder = HS_from_str_with_pos(path, 0, slash - path);
+    }
+
+#ifdef FILE_HAS_INOTIFY
+    int wd = inotify_add_watch(self->fd,
+                               HS_as_str(folder),
+                               FILE_WATCH_FOLDER_MASK);
+#else
+    int wd = -1;
+#endif
+    if (wd < 0) file_watch_set_error(self, strerror(errno));
+
+#ifdef ENABLE_DEBUG_LOG
+    DEBUG_LOG(FileWatch,
+              add,
+              "path: %s, folder: %s, wd: %d",
+              path,
+              HS_as_str(folder),
+              wd);
+#endif
+
+    HS_free(folder);
+    if (wd < 0) return false;
+
+    if (self->count == self->capacity) {
+        self->capacity = self->capacity == 0 ? 8 : self->capacity * 2;
+        self->entries =
+            realloc(self->entries, self->capacity * sizeof(FileWatchEntry));
+    }
+    self->entries[self->count++] = (FileWatchEntry){
+        .path    = HS_from_str(path),
+        .name    = HS_from_str(name),
+        .wd      = wd,
+        .pending = 0,
+    };
+
+    return true;
+}
+
+/*
+ * Stop watching the given path
+ */
+bool FileWatch_remove(FileWatch self, const char *path) {
+    if (self == NULL || path == NULL) return false;
+
+    FileWatchEntry *entry = file_watch_find(self, path);
+    if (entry == NULL) return false;
+
+    //
+    // The folder watch is shared by all the paths in the same folder
+    //
+    bool shared = false;
+    for (usize index = 0; index < self->count; index++) {
+        shared |= &self->entries[index] != entry &&
+                  self->entries[index].wd == entry->wd;
+    }
+#ifdef FILE_HAS_INOTIFY
+    if (!shared && entry->wd >= 0) inotify_rm_watch(self->fd, entry->wd);
+#endif
+
+    HS_free(entry->path);
+    HS_free(entry->name);
+
+    usize index = entry - self->entries;
+    memmove(entry,
+            entry + 1,
+            (self->count - index - 1) * sizeof(FileWatchEntry));
+    self->count--;
+
+    return true;
+}
+
+/*
+ * Return the `inotify` fd
+ */
+int FileWatch_get_fd(FileWatch self) {
+    return self != NULL ? self->fd : -1;
+}
+
+#ifdef FILE_HAS_INOTIFY
+/*
+ * Convert the `inotify` mask
+ */
+static u32 file_watch_event_type(u32 mask) {
+    u32 events = 0;
+    if (mask & (IN_MODIFY | IN_CLOSE_WRITE)) events |= FWE_MODIFIED;
+    if (mask & IN_ATTRIB) events |= FWE_ATTRIB;
+    if (mask & (IN_CREATE | IN_MOVED_TO)) events |= FWE_CREATED;
+    if (mask & IN_MOVED_FROM) events |= FWE_MOVED;
+    if (mask & IN_DELETE) events |= FWE_DELETED;
+
+    return events;
+}
+
+/*
+ * Add the `inotify` event to the matched paths
+ */
+static void file_watch_on_event(FileWatch self,
+                                const struct inotify_event *event) {
+    for (usize index = 0; index < self->count; index++) {
+        FileWatchEntry *entry = &self->entries[index];
+
+        if (event->mask & IN_Q_OVERFLOW) {
+            entry->pending |= FWE_OVERFLOW;
+        } else if (entry->wd != event->wd) {
+            continue;
+        } else if (event->mask & IN_IGNORED) {
+            // The folder is deleted (or unmounted), the watch is gone
+            entry->pending |= FWE_DELETED;
+            entry->wd = -1;
+        } else if (event->len > 0 &&
+                   strcmp(event->name, HS_as_str(entry->name)) == 0) {
+            entry->pending |= file_watch_event_type(event->mask);
+        }
+    }
+}
+#endif
+
+/*
+ * Read all the queued `inotify` events (the fd is non-blocking)
+ */
+static void file_watch_drain(FileWatch self) {
+#ifdef FILE_HAS_INOTIFY
+    char buffer[16 * 1024]
+        __attribute__((aligned(__alignof__(struct inotify_event))));
+
+    for (;;) {
+        ssize_t read_size = read(self->fd, buffer, sizeof(buffer));
+        if (read_size < 0 && errno == EINTR) continue;
+        if (read_size <= 0) break;
+
+        for (char *ptr = buffer; ptr < buffer + read_size;) {
+            const struct inotify_event *event =
+                (const struct inotify_event *)ptr;
+            file_watch_on_event(self, event);
+            ptr += sizeof(struct inotify_event) + event->len;
+        }
+    }
+#else
+    (void)self;
+#endif
+}
+
+/*
+ * Move the pending changes into `events`
+ */
+static usize file_watch_take(FileWatch self,
+                             FileWatchEvent *events,
+                             usize capacity) {
+    usize count = 0;
+    for (usize index = 0; index < self->count && count < capacity; index++) {
+        FileWatchEntry *entry = &self->entries[index];
+        if (entry->pending == 0) continue;
+
+        events[count++] = (FileWatchEvent){
+            .path   = HS_as_str(entry->path),
+            .events = entry->pending,
+        };
+        entry->pending = 0;
+    }
+
+    return count;
+}
+
+/*
+ * Wait for changes
+ */
+usize FileWatch_read(FileWatch self,
+                     int timeout_ms,
+                     FileWatchEvent *events,
+                     usize capacity) {
+    if (self == NULL || self->fd < 0 || events == NULL || capacity == 0)
+        return 0;
+
+    file_watch_drain(self);
+    usize count = file_watch_take(self, events, capacity);
+
+    //
+    // The events of the other files in the watched folders don't count, so
+    // keep waiting until a watched path changes or timeout
+    //
+    long double deadline =
+        Timer_get_current_time(TU_MILLISECONDS) + (long double)timeout_ms;
+    while (count == 0 && timeout_ms != 0) {
+        int wait_ms = -1;
+        if (timeout_ms > 0) {
+            long double left =
+                deadline - Timer_get_current_time(TU_MILLISECONDS);
+            if (left <= 0) break;
+            wait_ms = (int)left + 1;
+        }
+
+        struct pollfd poll_fd = {.fd = self->fd, .events = POLLIN};
+        int ready             = poll(&poll_fd, 1, wait_ms);
+        if (ready < 0 && errno != EINTR) {
+            file_watch_set_error(self, strerror(errno));
+            break;
+        }
+        if (ready > 0) {
+            file_watch_drain(self);
+            count = file_watch_take(self, events, capacity);
+        }
+    }
+
+    return count;
+}
+
+/*
+ * Return the last error
+ */
+const char *FileWatch_get_error(FileWatch self) {
+    return (self != NULL && self->error != NULL) ? HS_as_str(self->error)
+                                                 : NULL;
+}
+
+/*
+ * Free
+ */
+void FileWatch_free(FileWatch self) {
+    if (self == NULL) return;
+
+    for (usize index = 0; index < self->count; index++) {
+        HS_free(self->entries[index].path);
+        HS_free(self->entries[index].name);
+    }
+    free(self->entries);
+    if (self->fd >= 0) close(self->fd);
+    if (self->error != NULL) HS_free(self->error);
+
+#ifdef ENABLE_DEBUG_LOG
+    DEBUG_LOG(FileWatch, free, "self ptr: %p", self);
+#endif
+
+    free(self);
+}
+
+/*
+ * Auto free file watch
+ */
+void auto_free_file_watch(FileWatch *ptr) {
+    FileWatch_free(*ptr);
+}
+
+/*
+ * Get back filename
+ */
+const char *File_get_filename(File self) {
+    return (self != NULL && self->filename != NULL) ? HS_as_str(self->filename)
+                                                    : NULL;
+}
+
+/*
+ * Whether open successfully or not
+ */
+bool File_is_open_successfully(File self) {
+    return (self != NULL) ? self->open_successfully : false;
+}
+
+/*
+ * Get back error
+ */
+const char *File_get_error(File self) {
+    return (self != NULL && self->error != NULL) ? HS_as_str(self->error)
+                                                 : (char *)NULL;
+}
+
+/*
+ * Get back internal buffer data
+ */
+const char *File_get_data(File self) {
+    if (self != NULL && self->mapping != NULL) return self->mapping;
+
+    return (self != NULL && self->data != NULL) ? HS_as_str(self->data)
+                                                : (char *)NULL;
+}
+
+/*
+ * Get back file size
+ */
+usize File_get_size(File self) {
+    return (self != NULL) ? self->size : 0;
+}
+
+//
+// `File_print_like_bat` implementation
+//
+
+//
+// The read chunk and the output buffer size
+//
+#define FILE_PRINT_BUFFER_SIZE (1024 * 1024)
+
+//
+// `00` to `99`, 2 digits at a time
+//
+static const char FILE_DIGIT_PAIRS[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233"
+    "34353637383940414243444546474849505152535455565758596061626364656667"
+    "6869707172737475767778798081828384858687888990919293949596979899";
+
+/*
+ * Format `value` in decimal into `out` (no null-terminated), return the
+ * length (at most 20)
+ */
+static usize file_format_u64(u64 value, char *out) {
+    char digits[20];
+    char *ptr = digits + sizeof(digits);
+
+    while (value >= 100) {
+        const char *pair = FILE_DIGIT_PAIRS + (value % 100) * 2;
+        value /= 100;
+        *--ptr = pair[1];
+        *--ptr = pair[0];
+    }
+    if (value >= 10) {
+        const char *pair = FILE_DIGIT_PAIRS + value * 2;
+        *--ptr           = pair[1];
+        *--ptr           = pair[0];
+    } else {
+        *--ptr = (char)('0' + value);
+    }
+
+    usize len = digits + sizeof(digits) - ptr;
+    memcpy(out, ptr, len);
+
+    return len;
+}
+
+typedef struct {
+    int fd;
+
+    // Output buffer, `buffer[0..len]` isn't written yet
+    char *buffer;
+    usize len;
+
+    // The `errno` of the failed `write`, `0` if no error
+    int write_error;
+
+    // The line number of the line is being printed (or skipped)
+    usize line_no;
+    usize last_line;
+    bool at_line_start;
+    bool done;
+} FilePrinter;
+
+/*
+ * Write the buffered output
+ */
+static void file_printer_flush(FilePrinter *printer) {
+    usize offset = 0;
+    while (offset < printer->len && printer->write_error == 0) {
+        ssize_t written = write(printer->fd,
+                                printer->buffer + offset,
+                                printer->len - offset);
+        if (written < 0) {
+            if (errno != EINTR) printer->write_error = errno;
+            continue;
+        }
+        offset += written;
+    }
+
+    printer->len = 0;
+}
+
+static void file_printer_push(FilePrinter *printer,
+                              const char *ptr,
+                              usize len) {
+    while (len > 0) {
+        if (printer->len == FILE_PRINT_BUFFER_SIZE) file_printer_flush(printer);
+
+        usize copy_len = FILE_PRINT_BUFFER_SIZE - printer->len;
+        if (copy_len > len) copy_len = len;
+
+        memcpy(printer->buffer + printer->len, ptr, copy_len);
+        printer->len += copy_len;
+        ptr += copy_len;
+        len -= copy_len;
+    }
+}
+
+/*
+ * ` XXXXX | `, the line number is right aligned in 5 columns at least
+ */
+static void file_printer_push_line_no(FilePrinter *printer) {
+    if (FILE_PRINT_BUFFER_SIZE - printer->len < 32) file_printer_flush(printer);
+
+    char number[20];
+    usize number_len = file_format_u64(printer->line_no, number);
+
+    char *out = printer->buffer + printer->len;
+    *out++    = ' ';
+    for (usize pad = number_len; pad < 5; pad++) *out++ = ' ';
+    memcpy(out, number, number_len);
+    out += number_len;
+    memcpy(out, " | ", 3);
+    out += 3;
+
+    printer->len = out - printer->buffer;
+}
+
+//
+// The lines before `first_line` are counted in blocks of this size, the
+// block that has the first line is searched line by line
+//
+#define FILE_PRINT_SKIP_BLOCK_SIZE (64 * 1024)
+
+//
+// Count `\n` by comparing 16 / 32 bytes at a time: each matched byte is
+// `0xFF` (-1), subtracting it adds 1 to the byte counter, the counters are
+// summed by `sad` before they overflow (255 rounds).
+//
+#ifdef SIMD_X86_64
+SIMD_TARGET("avx2")
+static usize file_count_newlines_avx2(const char *ptr, usize len) {
+    const __m256i newline = _mm256_set1_epi8('\n');
+    const __m256i zero    = _mm256_setzero_si256();
+
+    usize count = 0;
+    usize index = 0;
+    while (index + 32 <= len) {
+        __m256i counters = zero;
+        for (usize round = 0; round < 255 && index + 32 <= len;
+             round++, index += 32) {
+            const __m256i *block = (const __m256i *)(ptr + index);
+            __m256i matched = _mm256_cmpeq_epi8(_mm256_loadu_si256(block),
+                                                newline);
+            counters        = _mm256_sub_epi8(counters, matched);
+        }
+
+        __m256i sums = _mm256_sad_epu8(counters, zero);
+        count += _mm256_extract_epi64(sums, 0) + _mm256_extract_epi64(sums, 1) +
+                 _mm256_extract_epi64(sums, 2) + _mm256_extract_epi64(sums, 3);
+    }
+    for (; index < len; index++) count += ptr[index] == '\n';
+
+    return count;
+}
+#endif
+
+static usize file_count_newlines(const char *ptr, usize len) {
+    usize count = 0;
+    usize index = 0;
+
+#ifdef SIMD_X86_64
+    if (SIMD_CPU_HAS("avx2")) return file_count_newlines_avx2(ptr, len);
+
+    const __m128i newline = _mm_set1_epi8('\n');
+    const __m128i zero    = _mm_setzero_si128();
+    while (index + 16 <= len) {
+        __m128i counters = zero;
+        for (usize round = 0; round < 255 && index + 16 <= len;
+             round++, index += 16) {
+            const __m128i *block = (const __m128i *)(ptr + index);
+            __m128i matched = _mm_cmpeq_epi8(_mm_loadu_si128(block), newline);
+            counters        = _mm_sub_epi8(counters, matched);
+        }
+
+        __m128i sums = _mm_sad_epu8(counters, zero);
+        count += (usize)_mm_cvtsi128_si64(sums) +
+                 (usize)_mm_cvtsi128_si64(_mm_unpackhi_epi64(sums, sums));
+    }
+#endif
+
+    for (; index < len; index++) count += ptr[index] == '\n';
+
+    return count;
+}
+
+/*
+ * Skip the lines before `first_line` in `ptr[0..len]`, return the skipped
+ * bytes
+ */
+static usize file_printer_skip(FilePrinter *printer,
+                               const char *ptr,
+                               usize len,
+                               usize first_line) {
+    usize offset = 0;
+    while (printer->line_no < first_line && offset < len) {
+        usize block_size = len - offset < FILE_PRINT_SKIP_BLOCK_SIZE
+                               ? len - offset
+                               : FILE_PRINT_SKIP_BLOCK_SIZE;
+        usize newlines   = file_count_newlines(ptr + offset, block_size);
+        if (printer->line_no + newlines < first_line) {
+            printer->line_no += newlines;
+            offset += block_size;
+            continue;
+        }
+
+        //
+        // The first line starts in this block
+        //
+        while (printer->line_no < first_line) {
+            const char *newline = memchr(ptr + offset, '\n', len - offset);
+            offset              = newline - ptr + 1;
+            printer->line_no++;
+        }
+    }
+
+    return offset;
+}
+
+/*
+ * Print the lines in `ptr[0..len]`, the last line can continue in the next
+ * chunk
+ */
+static void file_printer_print(FilePrinter *printer,
+                               const char *ptr,
+                               usize len) {
+    const char *end = ptr + len;
+    while (ptr < end) {
+        if (printer->at_line_start) {
+            if (printer->last_line != 0 &&
+                printer->line_no > printer->last_line) {
+                printer->done = true;
+                return;
+            }
+            file_printer_push_line_no(printer);
+            printer->at_line_start = false;
+        }
+
+        const char *newline  = memchr(ptr, '\n', end - ptr);
+        const char *line_end = newline != NULL ? newline + 1 : end;
+        file_printer_push(printer, ptr, line_end - ptr);
+        ptr = line_end;
+
+        if (newline != NULL) {
+            printer->line_no++;
+            printer->at_line_start = true;
+        }
+    }
+}
+
+/*
+ * Read the file chunk by chunk from the beginning (or from the current
+ * position if it's not seekable) and print
+ */
+static bool file_printer_print_fd(File self,
+                                  FilePrinter *printer,
+                                  usize first_line) {
+    char *chunk = malloc(FILE_PRINT_BUFFER_SIZE);
+    if (chunk == NULL) {
+        file_set_error(self, strerror(ENOMEM));
+        return false;
+    }
+
+    int fd          = fileno(self->inner);
+    usize offset    = 0;
+    bool positional = true;
+    bool result     = true;
+    while (!printer->done && printer->write_error == 0) {
+        ssize_t read_size =
+            positional ? pread(fd, chunk, FILE_PRINT_BUFFER_SIZE, offset)
+                       : read(fd, chunk, FILE_PRINT_BUFFER_SIZE);
+        if (read_size < 0) {
+            if (errno == EINTR) continue;
+            if (errno == ESPIPE && positional) {
+                positional = false;
+                continue;
+            }
+
+            file_set_error(self, strerror(errno));
+            result = false;
+            break;
+        }
+        if (read_size == 0) break;
+        offset += read_size;
+
+        usize skipped =
+            file_printer_skip(printer, chunk, read_size, first_line);
+        file_printer_print(printer, chunk + skipped, read_size - skipped);
+    }
+
+    free(chunk);
+
+    return result;
+}
+
+/*
+ * Print out the lines like `bat`
+ */
+bool File_print_like_bat(File self, FilePrintOptions options) {
+    if (self == NULL || !self->open_successfully || self->inner == NULL)
+        return false;
+
+    usize first_line = options.first_line > 0 ? options.first_line : 1;
+    if (options.last_line != 0 && options.last_line < first_line) return true;
+
+    FilePrinter printer = {
+        .fd            = options.out_fd > 0 ? options.out_fd : STDOUT_FILENO,
+        .buffer        = malloc(FILE_PRINT_BUFFER_SIZE),
+        .len           = 0,
+        .write_error   = 0,
+        .line_no       = 1,
+        .last_line     = options.last_line,
+        .at_line_start = true,
+        .done          = false,
+    };
+    if (printer.buffer == NULL) {
+        file_set_error(self, strerror(ENOMEM));
+        return false;
+    }
+
+    // Keep the order with the `printf` output before
+    if (printer.fd == STDOUT_FILENO) fflush(stdout);
+
+    //
+    // The loaded (or mapped) content, otherwise the file itself (the
+    // unflushed appends go to the file first)
+    //
+    bool result  = true;
+    StrView data = File_get_data(self) != NULL ? File_as_view(self)
+                                               : (StrView){.ptr = NULL};
+    if (data.ptr != NULL) {
+        usize skipped =
+            file_printer_skip(&printer, data.ptr, data.len, first_line);
+        file_printer_print(&printer, data.ptr + skipped, data.len - skipped);
+    } else {
+        if (self->writer != NULL) File_flush(self);
+        if (self->mode != FM_READ_ONLY) fflush(self->inner);
+
+        result = file_printer_print_fd(self, &printer, first_line);
+    }
+    file_printer_flush(&printer);
+    free(printer.buffer);
+
+    if (printer.write_error != 0) {
+        file_set_error(self, strerror(printer.write_error));
+        return false;
+    }
+
+#ifdef ENABLE_DEBUG_LOG
+    DEBUG_LOG(File,
+              print_like_bat,
+              "filename: %s, first_line: %lu, last_line: %lu, result: %d",
+              HS_as_str(self->filename),
+              first_line,
+              options.last_line,
+              result);
+#endif
+
+    return result;
+}
+
+/*
+ * Print out all lines like `bat`
+ */
+void File_print_out_file_like_bat(File self) {
+    File_print_like_bat(self, (FilePrintOptions){0});
+}
+
+#ifdef ENABLE_DEBUG_LOG
+/*
+ * Print out self for debugging purpose
+ */
+void File_print_debug_info(File self) {
+    // SMART_STRING(debug_info) = HS_from_empty_with_capacity(100);
+
+    char file_handler[20] = {0};
+    snprintf(file_handler, sizeof(file_handler), "%p", (void *)self->inner);
 
     char file_mode[4] = {0};
     file_mode_to_string(&self->mode, file_mode);
@@ -331,7 +3240,12 @@ void File_free(File self) {
         self->data = NULL;
     }
 
+    file_unmap(self);
+    file_free_line_reader(self);
+
     if (self->inner != NULL) {
+        file_free_writer(self, true);
+
         // Flush before closing
         if (self->mode != FM_READ_ONLY) {
             fflush(self->inner);
@@ -3,6 +3,8 @@
 
 #include <stdio.h>
 
+#include "collections/string_table.h"
+#include "collections/vector.h"
 #include "heap_string.h"
 
 //
@@ -15,6 +17,73 @@ typedef enum FileMode {
     FM_APPEND,
 } FileMode;
 
+/*
+ * When to flush the written data from the page cache to the disk:
+ *
+ * - `FS_NONE`: never, leave it to the kernel (fastest)
+ * - `FS_EVERY_N_BYTES`: `fdatasync` every `sync_every_bytes` written bytes
+ * - `FS_ON_CLOSE`: `fdatasync` once in `File_free`
+ */
+typedef enum FileSync {
+    FS_NONE          = 0x00,
+    FS_EVERY_N_BYTES = 0x01,
+    FS_ON_CLOSE      = 0x02,
+} FileSync;
+
+/*
+ * Default `File_append` write buffer size
+ */
+#define FILE_WRITE_DEFAULT_BUFFER_SIZE (1024 * 1024)
+
+/*
+ * Write options, `(FileWriteOptions){0}` is the default:
+ *
+ * - `buffer_size`: `File_append` write buffer size, `0` means
+ *   `FILE_WRITE_DEFAULT_BUFFER_SIZE`
+ * - `sync`: durability policy
+ * - `sync_every_bytes`: only for `FS_EVERY_N_BYTES`
+ * - `atomic_save`: `File_save` writes to a temp file in the same folder,
+ *   `fsync` it and `rename` it over the original file, so the file is
+ *   either the old content or the new content even the process crashes
+ */
+typedef struct {
+    usize buffer_size;
+    FileSync sync;
+    usize sync_every_bytes;
+    bool atomic_save;
+} FileWriteOptions;
+
+/*
+ * `File_map` options
+ *
+ * - `populate`: prefault all pages when mapping (`MAP_POPULATE`, Linux
+ *   only), so the first access doesn't page fault
+ * - `sequential`: `madvise(MADV_SEQUENTIAL)`, aggressive read-ahead and the
+ *   pages can be dropped soon after they're read
+ * - `will_need`: `madvise(MADV_WILLNEED)`, start reading the file into the
+ *   page cache in the background
+ */
+typedef struct {
+    bool populate;
+    bool sequential;
+    bool will_need;
+} FileMapOptions;
+
+//
+// The identity of the loaded (or mapped) file content, it's recorded by
+// `File_load_into_buffer` and `File_map` for `File_reload_if_changed`
+//
+typedef struct {
+    bool valid;
+    bool mapped;
+    FileMapOptions map_options;
+    u64 device;
+    u64 inode;
+    usize size;
+    i64 mtime_sec;
+    i64 mtime_nsec;
+} FileStamp;
+
 //
 //
 //
@@ -35,6 +104,24 @@ struct _File {
 
     // File size
     usize size;
+
+    // Read-only mapping created by `File_map`, `NULL` if not mapped
+    void *mapping;
+
+    // Mapping length for `munmap`
+    usize mapping_size;
+
+    // Streaming line reader state for `File_read_line`, `NULL` if not used
+    struct _FileLineReader *line_reader;
+
+    // Set by `File_set_write_options`
+    FileWriteOptions write_options;
+
+    // `File_append` write buffer, `NULL` before the first append
+    struct _FileWriter *writer;
+
+    // Set by `File_load_into_buffer` and `File_map`
+    FileStamp stamp;
 };
 
 typedef struct _File *File;
@@ -59,22 +146,496 @@ void auto_free_file(File *ptr);
  */
 File File_open(const char *filename, FileMode mode);
 
+/*
+ * Create `File` from an already opened fd, e.g. `STDIN_FILENO` or a pipe.
+ * `name` is only for `File_get_filename`, `mode` should match the fd.
+ *
+ * The `File` takes the ownership of `fd`, it's closed by `File_free` (pass
+ * `dup(fd)` to keep `fd` open).
+ *
+ * ```c
+ * // cat huge.log | ./app
+ * defer_file(input) = File_from_fd(STDIN_FILENO, "stdin", FM_READ_ONLY);
+ * File_load_into_buffer(input);
+ * ```
+ */
+File File_from_fd(int fd, const char *name, FileMode mode);
+
 /*
  * Load the entire file into `self->data` if the file has been opened already.
  * It returns total bytes loaded from file, otherwise, return -1 when error
  * happens.
+ *
+ * The regular file is read straight into a buffer of the `fstat` size. The
+ * pipes, terminals, sockets and `/proc` files (their size is unknown) are
+ * read until the end of file in a buffer that doubles when full.
  */
 usize File_load_into_buffer(File self);
 
 /*
- * Write the modified `self->data` back to `self->filename`
+ * Map the entire file read-only into memory instead of copying it into
+ * `self->data`. Nothing is read until the pages are touched, the pages are
+ * shared with the page cache (and other processes), so mapping a 4GB file
+ * is instantaneous and doesn't increase the heap size.
+ *
+ * After mapping, `File_get_data`, `File_get_size` and `File_as_view` point
+ * to the mapping, `self->data` is freed (if it's loaded). The mapping is
+ * unmapped by `File_free` or the next `File_load_into_buffer`.
+ *
+ * The mapping is NOT null-terminated, always use it with `File_get_size`.
+ *
+ * Return `false` if the file isn't opened or not a regular file or `mmap`
+ * fails, the reason is in `File_get_error`.
+ *
+ * ```c
+ * defer_file(log) = File_open("huge.log", FM_READ_ONLY);
+ * if (File_map(log, (FileMapOptions){.sequential = true})) {
+ *     StrView content = File_as_view(log);
+ *     ...
+ * }
+ * ```
+ */
+bool File_map(File self, FileMapOptions options);
+
+/*
+ * Whether the file is mapped by `File_map` or not
+ */
+bool File_is_mapped(File self);
+
+/*
+ * Get back the file content (the mapping or the loaded `self->data`) as
+ * `StrView` (zero-copy), an empty view if nothing is loaded.
+ */
+StrView File_as_view(File self);
+
+/*
+ * Default `File_lines` buffer size
+ */
+#define FILE_LINES_DEFAULT_BUFFER_SIZE (256 * 1024)
+
+/*
+ * Start reading lines from the beginning of the file (or from the current
+ * position if it's not seekable, e.g. a pipe) through a reusable buffer of
+ * `buffer_size` bytes (`0` means `FILE_LINES_DEFAULT_BUFFER_SIZE`), so the
+ * memory usage doesn't depend on the file size. The buffer only grows when
+ * a single line is longer than it.
+ *
+ * `File_read_line` calls it automatically (with the default buffer size) if
+ * it's not called yet.
+ *
+ * Return `false` if the file isn't opened or out of memory.
+ */
+bool File_lines(File self, usize buffer_size);
+
+/*
+ * Read the next line as a zero-copy view into the reusable buffer, the line
+ * break (`\n` or `\r\n`) is NOT included. The view is invalid after the next
+ * `File_read_line` call. The last line doesn't need to end with a line
+ * break.
+ *
+ * Return `false` at the end of file or when the read fails (the reason is
+ * in `File_get_error`).
+ *
+ * ```c
+ * defer_file(log) = File_open("huge.log", FM_READ_ONLY);
+ * File_lines(log, 1024 * 1024);
+ *
+ * StrView line;
+ * while (File_read_line(log, &line)) {
+ *     printf("%.*s\n", (int)line.len, line.ptr);
+ * }
+ * ```
+ */
+bool File_read_line(File self, StrView *line);
+
+/*
+ * Change the write options, the pending data (if any) is flushed first
+ */
+void File_set_write_options(File self, FileWriteOptions options);
+
+/*
+ * Write the modified `self->data` back to `self->filename` (the file is
+ * replaced), it works for all modes. With `atomic_save`, the file is
+ * replaced by `rename` and reopened, otherwise it's truncated and written
+ * in place (`fdatasync` unless the policy is `FS_NONE`).
+ *
+ * Return `false` if `self->data` is `NULL` or the write fails (the reason
+ * is in `File_get_error`).
+ */
+bool File_save(File self);
+
+/*
+ * Append to file, update the `self->data` as well (if it's loaded). The
+ * file has to be opened with `FM_WRITE_ONLY`, `FM_READ_WRITE` or
+ * `FM_APPEND`. A mapped file keeps the mapped content (and
+ * `File_get_size`) as it is, `File_map` again to see the appends.
+ *
+ * The content is copied into a big write buffer, nothing is written until
+ * the buffer is full or `File_flush` or `File_free`, so lots of small
+ * appends only cost a few `write` calls. A content bigger than the buffer
+ * is written straight away (`writev` with the buffered data, no copy).
+ *
+ * Return `false` if the write fails (the reason is in `File_get_error`).
+ *
+ * ```c
+ * defer_file(log) = File_open("app.log", FM_APPEND);
+ * File_set_write_options(log, (FileWriteOptions){.sync = FS_ON_CLOSE});
+ * for (usize index = 0; index < 1000000; index++) {
+ *     File_append(log, "request done\n");
+ * }
+ * ```
+ */
+bool File_append(File self, const char *content);
+
+/*
+ * Same with `File_append`, but for `ptr[0..len]`
+ */
+bool File_append_bytes(File self, const void *ptr, usize len);
+
+/*
+ * Write the buffered data (if any) to the file, the durability policy is
+ * applied as well.
+ *
+ * Return `false` if the write fails (the reason is in `File_get_error`).
+ */
+bool File_flush(File self);
+
+/*
+ * `File_load_many` options
+ *
+ * - `no_io_uring`: don't try `io_uring`, always use the `pread` thread pool
+ * - `threads`: thread pool size, `0` means the count of online CPUs
+ */
+typedef struct {
+    bool no_io_uring;
+    usize threads;
+} FileLoadManyOptions;
+
+/*
+ * `File_load_many` result summary
+ */
+typedef struct {
+    usize loaded;
+    usize failed;
+    usize total_bytes;
+    long double elapsed_ms;
+    bool io_uring_used;
+} FileLoadManyStats;
+
+/*
+ * Load `count` files in one go, it's for loading thousands of small files
+ * (configs, templates) where one `open` + `stat` + `read` + `close` per
+ * file is syscall latency bound.
+ *
+ * On Linux, the opens, `statx` and reads are submitted in batches through
+ * `io_uring` (raw syscalls, no `liburing` needed), one `io_uring_enter` for
+ * the whole batch. When `io_uring` isn't available (old kernel, disabled by
+ * `sysctl` or seccomp, not Linux), the files are loaded by a thread pool
+ * with `pread`.
+ *
+ * Return a `Vector` of `File` in the same order with `paths`, the caller
+ * owns it (`Vec_free` frees all `File` as well). Each `File`:
+ *
+ * - loaded: `File_is_open_successfully` is `true`, the content is in
+ *   `File_get_data` / `File_get_size`
+ * - failed: `File_get_error` has the reason
+ *
+ * The files are closed after loading, only the loaded data is available.
+ * `stats` can be `NULL`.
+ *
+ * ```c
+ * const char *paths[] = {"a.conf", "b.conf", "c.conf"};
+ * FileLoadManyStats stats;
+ * Vector files = File_load_many(paths, 3, (FileLoadManyOptions){0}, &stats);
+ *
+ * File first = *(const File *)Vec_get(files, 0);
+ * ...
+ * Vec_free(files);
+ * ```
+ */
+Vector File_load_many(const char **paths,
+                      usize count,
+                      FileLoadManyOptions options,
+                      FileLoadManyStats *stats);
+
+/*
+ * `Dir_walk` symbolic link policy:
+ *
+ * - `DWS_LIST`: list the link itself (same with `find`), never follow it
+ * - `DWS_SKIP`: ignore all links
+ * - `DWS_FOLLOW`: list the links to files, walk into the links to folders
+ *   (every folder is walked once, so link loops are safe)
+ */
+typedef enum DirWalkSymlink {
+    DWS_LIST   = 0x00,
+    DWS_SKIP   = 0x01,
+    DWS_FOLLOW = 0x02,
+} DirWalkSymlink;
+
+/*
+ * `Dir_walk` options, `(DirWalkOptions){0}` lists all files (include the
+ * hidden ones) in all sub folders, in the walking order.
+ *
+ * - `pattern`: glob (`fnmatch`) on the entry name, e.g. `"*.conf"`, `NULL`
+ *   means all entries. Folders are always walked into, no matter the
+ *   pattern matches or not.
+ * - `symlinks`: symbolic link policy
+ * - `include_dirs`: list the folders as well
+ * - `skip_hidden`: skip the entries (and folders) start with `.`
+ * - `max_depth`: `1` means only the entries in `root`, `0` means no limit
+ * - `sort`: sort the result paths (byte by byte)
+ * - `parallel`: walk the sub folders on worker threads
+ * - `threads`: worker thread count, `0` means the count of online CPUs
+ */
+typedef struct {
+    const char *pattern;
+    DirWalkSymlink symlinks;
+    bool include_dirs;
+    bool skip_hidden;
+    usize max_depth;
+    bool sort;
+    bool parallel;
+    usize threads;
+} DirWalkOptions;
+
+/*
+ * Walk the `root` folder recursively and return all matched paths (`root`
+ * + `/` + relative path), the caller owns the returned `StringTable`. All
+ * paths are stored in one blob, `ST_to_vector` gives a `Vector` of `String`
+ * if needed.
+ *
+ * On Linux, the folder entries are read by `getdents64` with a big buffer
+ * and the entry type comes from `d_type`, so there is no `stat` per entry
+ * (only for the file systems that don't fill `d_type`). The folders can't
+ * be opened (e.g. no permission) are skipped.
+ *
+ * Return `NULL` if `root` can't be opened as a folder.
+ *
+ * ```c
+ * defer_string_table(paths) = Dir_walk(
+ *     "/etc", (DirWalkOptions){.pattern = "*.conf", .sort = true});
+ *
+ * for (usize index = 0; index < ST_len(paths); index++) {
+ *     printf("\n>>> %s", ST_get(paths, index).ptr);
+ * }
+ * ```
+ */
+StringTable Dir_walk(const char *root, DirWalkOptions options);
+
+/*
+ * How `File_copy` / `File_send_to_fd` moved the bytes, the first one that
+ * works is used:
+ *
+ * - `FCM_CLONE`: `FICLONE` reflink (`btrfs`, `xfs`), no data copy at all
+ * - `FCM_COPY_FILE_RANGE`: `copy_file_range`, in kernel (or server side on
+ *   `NFS`/`SMB`) copy
+ * - `FCM_SENDFILE`: `sendfile`, in kernel copy to any fd (e.g. socket)
+ * - `FCM_SPLICE`: `splice`, in kernel copy to a pipe
+ * - `FCM_READ_WRITE`: chunked `pread` + `write` through a user space buffer
+ * - `FCM_FAILED`: nothing copied (or partially copied), `File_get_error`
+ *   has the reason
+ */
+typedef enum FileCopyMethod {
+    FCM_FAILED          = 0x00,
+    FCM_CLONE           = 0x01,
+    FCM_COPY_FILE_RANGE = 0x02,
+    FCM_SENDFILE        = 0x03,
+    FCM_SPLICE          = 0x04,
+    FCM_READ_WRITE      = 0x05,
+} FileCopyMethod;
+
+/*
+ * `File_copy` options, `(FileCopyOptions){0}` tries the fastest way first
+ *
+ * - `no_clone`: don't reflink, always copy the bytes (the copy doesn't
+ *   share the disk blocks with the source)
+ * - `no_kernel_copy`: only use `FCM_READ_WRITE`
+ * - `sync`: `fdatasync` the destination before closing it
+ */
+typedef struct {
+    bool no_clone;
+    bool no_kernel_copy;
+    bool sync;
+} FileCopyOptions;
+
+/*
+ * Copy the whole file to `dst_filename` without loading it into
+ * `self->data`, the destination is created (or truncated) with the same
+ * permission. The unflushed `File_append` bytes are flushed first, and the
+ * current read position of `self` doesn't change.
+ *
+ * Return the method used, return `FCM_FAILED` and set the error if:
+ *
+ * - `self` isn't opened
+ * - `dst_filename` can't be opened for writing
+ * - `dst_filename` is the same file with `self`
+ * - the copy fails in the middle
+ */
+FileCopyMethod File_copy(File self,
+                         const char *dst_filename,
+                         FileCopyOptions options);
+
+/*
+ * Write the whole file to `out_fd` (socket, pipe, `STDOUT_FILENO` or
+ * another file), by `splice` for pipes or `sendfile` for others, and fall
+ * back to `FCM_READ_WRITE`. `out_fd` is not closed.
+ *
+ * Return the method used, return `FCM_FAILED` and set the error if `self`
+ * isn't opened or the write fails.
+ */
+FileCopyMethod File_send_to_fd(File self, int out_fd);
+
+/*
+ * `File_reload_if_changed` result
+ */
+typedef enum FileReloadResult {
+    FRR_FAILED    = 0x00,
+    FRR_UNCHANGED = 0x01,
+    FRR_RELOADED  = 0x02,
+} FileReloadResult;
+
+/*
+ * Reload (or re-map if it's mapped by `File_map`) the content only if the
+ * file on disk is changed since the last load: it `stat`s the filename and
+ * compares the device, inode, size and `mtime` (nanoseconds) with the ones
+ * recorded by the last `File_load_into_buffer` / `File_map`. A file that
+ * hasn't been loaded yet is loaded.
+ *
+ * If the path points to another inode (replaced by `rename`, e.g. the
+ * atomic save of the most editors or `File_save` with `atomic_save`), the
+ * file is reopened first (`FM_WRITE_ONLY` is reopened as `r+`, so the new
+ * content isn't truncated).
+ *
+ * Return `FRR_FAILED` and set the error if the file isn't opened, or the
+ * path doesn't exist anymore (the loaded content is kept), or the reload
+ * fails.
+ *
+ * ```c
+ * defer_file(config) = File_open("app.conf", FM_READ_ONLY);
+ * File_load_into_buffer(config);
+ *
+ * // Every few seconds, or after `FileWatch_read` reports it
+ * if (File_reload_if_changed(config) == FRR_RELOADED) {
+ *     apply_config(File_as_view(config));
+ * }
+ * ```
+ */
+FileReloadResult File_reload_if_changed(File self);
+
+/*
+ * Opaque pointer to `struct _FileWatch`
+ */
+typedef struct _FileWatch *FileWatch;
+
+/*
+ * What happened to a watched path, `FileWatchEvent.events` is the bitwise
+ * OR of all the changes since the last `FileWatch_read`:
+ *
+ * - `FWE_MODIFIED`: the content is written
+ * - `FWE_ATTRIB`: the metadata is changed, e.g. `touch`, `chmod`
+ * - `FWE_CREATED`: created, or another file is renamed to the path (the
+ *   atomic save: write a temp file then rename it over the path)
+ * - `FWE_MOVED`: renamed to another path
+ * - `FWE_DELETED`: deleted (or the parent folder is gone)
+ * - `FWE_OVERFLOW`: the kernel event queue overflowed and the events are
+ *   lost, all paths are reported with it, treat them as changed
+ */
+typedef enum FileWatchEventType {
+    FWE_MODIFIED = 0x01,
+    FWE_ATTRIB   = 0x02,
+    FWE_CREATED  = 0x04,
+    FWE_MOVED    = 0x08,
+    FWE_DELETED  = 0x10,
+    FWE_OVERFLOW = 0x20,
+} FileWatchEventType;
+
+/*
+ * `path` is the one passed to `FileWatch_add`, it's valid until the path
+ * is removed or the watch is freed
+ */
+typedef struct {
+    const char *path;
+    u32 events;
+} FileWatchEvent;
+
+//
+//
+//
+void auto_free_file_watch(FileWatch *ptr);
+
+/*
+ * Define smart `FileWatch` var that calls `FileWatch_free` automatically
+ * when the variable is out of the scope
+ *
+ * ```c
+ * defer_file_watch(watch) = FileWatch_new();
+ * FileWatch_add(watch, "app.conf");
+ * FileWatch_add(watch, "/etc/hosts");
+ *
+ * FileWatchEvent events[8];
+ * for (;;) {
+ *     usize count = FileWatch_read(watch, -1, events, 8);
+ *     for (usize index = 0; index < count; index++) {
+ *         printf("\n>>> %s changed: 0x%02X",
+ *                events[index].path,
+ *                events[index].events);
+ *     }
+ * }
+ * ```
  */
-void File_save(File self);
+#define defer_file_watch(x)                                                    \
+    __attribute__((cleanup(auto_free_file_watch))) FileWatch x
 
 /*
- * Append to file, update the `self->data` as well
+ * Create a watch (Linux `inotify`), `FileWatch_get_error` has the reason if
+ * `inotify` isn't available.
  */
-void File_append(File self, char *content);
+FileWatch FileWatch_new(void);
+
+/*
+ * Watch the given file path. The parent folder is watched (and filtered by
+ * the file name), so the path is still watched after it's deleted or
+ * replaced by `rename`, and it doesn't need to exist yet (the parent folder
+ * does).
+ *
+ * Return `false` and set the error if the parent folder can't be watched.
+ * Adding the same path again does nothing.
+ */
+bool FileWatch_add(FileWatch self, const char *path);
+
+/*
+ * Stop watching the given path, return `false` if it's not watched
+ */
+bool FileWatch_remove(FileWatch self, const char *path);
+
+/*
+ * Return the `inotify` fd for `poll` / `epoll` (readable when there are
+ * events), `-1` if not available
+ */
+int FileWatch_get_fd(FileWatch self);
+
+/*
+ * Wait up to `timeout_ms` (`-1` forever, `0` doesn't wait) for changes,
+ * and fill `events[0..capacity]` with one event per changed path (the
+ * changes of the same path are merged). The paths that don't fit are
+ * returned by the next call.
+ *
+ * Return the count of events, `0` if timeout.
+ */
+usize FileWatch_read(FileWatch self,
+                     int timeout_ms,
+                     FileWatchEvent *events,
+                     usize capacity);
+
+/*
+ * Return the last error, `NULL` if no error
+ */
+const char *FileWatch_get_error(FileWatch self);
+
+/*
+ * Free
+ */
+void FileWatch_free(FileWatch self);
 
 /*
  * Get back filename
@@ -92,7 +653,8 @@ bool File_is_open_successfully(File self);
 const char *File_get_error(File self);
 
 /*
- * Get back internal buffer data
+ * Get back internal buffer data, or the mapping if `File_map` is used (NOT
+ * null-terminated)
  */
 const char *File_get_data(File self);
 
@@ -102,7 +664,48 @@ const char *File_get_data(File self);
 usize File_get_size(File self);
 
 /*
- * Print out file like `bat`
+ * `File_print_like_bat` options, `(FilePrintOptions){0}` prints all lines
+ * to `stdout`
+ *
+ * - `first_line`: the first line to print (starts from `1`), `0` means `1`
+ * - `last_line`: the last line to print (included), `0` means to the end
+ * - `out_fd`: where to write, `0` means `STDOUT_FILENO`
+ */
+typedef struct {
+    usize first_line;
+    usize last_line;
+    int out_fd;
+} FilePrintOptions;
+
+/*
+ * Print out the lines with the line number like `bat`:
+ *
+ * ```
+ *      1 | first line
+ *      2 | second line
+ * ```
+ *
+ * It streams the file from the beginning in big chunks (or the loaded /
+ * mapped content), so the file size doesn't matter. The lines before
+ * `first_line` are skipped by searching the line breaks only, nothing is
+ * formatted for them. The output goes to a big buffer that is written by
+ * `write` when full.
+ *
+ * Return `false` and set the error if the read or write fails.
+ *
+ * ```c
+ * defer_file(log) = File_open("huge.log", FM_READ_ONLY);
+ * File_print_like_bat(log, (FilePrintOptions){
+ *     .first_line = 10000000,
+ *     .last_line  = 10000050,
+ * });
+ * ```
+ */
+bool File_print_like_bat(File self, FilePrintOptions options);
+
+/*
+ * Print out all lines like `bat`, same with `File_print_like_bat` with the
+ * default options
  */
 void File_print_out_file_like_bat(File self);
 
@@ -4,6 +4,9 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "ascii.h"
+#include "utf8.h"
+
 #if ENABLE_DEBUG_LOG
     #include <stdio.h>
 
@@ -23,6 +26,21 @@ usize HS_struct_size(void) {
     return sizeof(struct HeapString);
 }
 
+//
+// Grow the buffer to `new_capacity`, the arena-owned `String` grows inside
+// its arena (in-place when the buffer is the latest arena allocation).
+//
+static char *hs_realloc_buffer(String self, usize new_capacity) {
+    if (self->_arena != NULL) {
+        return Arena_realloc(self->_arena,
+                             self->_buffer,
+                             self->_capacity,
+                             new_capacity);
+    }
+
+    return realloc(self->_buffer, new_capacity);
+}
+
 /*
  * Init empty `struct HeapString`
  */
@@ -216,6 +234,91 @@ String HS_from_str_with_pos(const char *str, int start_pos, int count) {
     return string;
 }
 
+/*
+ * Create from empty in the given arena that ability to hold `capacity`
+ * characters
+ */
+String HS_from_empty_with_capacity_in(Arena arena, usize capacity) {
+    if (arena == NULL) return NULL;
+
+    String string = Arena_alloc(arena, sizeof(struct HeapString));
+    if (string == NULL) return NULL;
+
+    *string = (struct HeapString){
+        ._capacity = 0,
+        ._len      = 0,
+        ._buffer   = NULL,
+        ._arena    = arena,
+    };
+
+    if (capacity > 0) {
+        string->_buffer = Arena_alloc(arena, capacity);
+        if (string->_buffer != NULL) {
+            string->_buffer[0] = '\0';
+            string->_capacity  = capacity;
+        }
+    }
+
+#if ENABLE_DEBUG_LOG
+    DEBUG_LOG(String,
+              from_empty_with_capacity_in,
+              "self ptr: %p, capacity: %lu, arena ptr: %p, buffer ptr: %p",
+              string,
+              string->_capacity,
+              arena,
+              string->_buffer);
+#endif
+
+    return string;
+}
+
+/*
+ * Create from empty in the given arena
+ */
+String HS_from_empty_in(Arena arena) {
+    return HS_from_empty_with_capacity_in(arena, 0);
+}
+
+/*
+ * Create from `StrView` in the given arena
+ */
+String HS_from_view_in(Arena arena, StrView view) {
+    usize temp_len = (view.ptr != NULL) ? view.len : 0;
+
+    String string =
+        HS_from_empty_with_capacity_in(arena, temp_len > 0 ? temp_len + 1 : 0);
+    if (string == NULL || temp_len == 0) return string;
+
+    memcpy(string->_buffer, view.ptr, temp_len);
+    string->_buffer[temp_len] = '\0';
+    string->_len              = temp_len;
+
+    return string;
+}
+
+/*
+ * Create from `char*` in the given arena
+ */
+String HS_from_str_in(Arena arena, const char *str) {
+    return HS_from_view_in(
+        arena,
+        (StrView){.ptr = str, .len = (str != NULL) ? strlen(str) : 0});
+}
+
+/*
+ * Clone from the given `String` instance into the given arena
+ */
+String HS_clone_from_in(Arena arena, const String other) {
+    return HS_from_view_in(arena, HS_as_view(other));
+}
+
+/*
+ * Check whether it's an arena-owned `String` or not
+ */
+bool HS_is_arena_owned(const String self) {
+    return self != NULL && self->_arena != NULL;
+}
+
 /*
  * Clone from the given `String` instance but don't touch the heap-allocated
  * memory it owned
@@ -264,12 +367,19 @@ String HS_clone_from(const String other) {
  * heap-allocated memory to the newly created `String` instance
  */
 String HS_move_from(String other) {
-    String string = malloc(sizeof(struct HeapString));
+    //
+    // The arena-owned buffer can't be owned by a heap allocated `String`, as
+    // `HS_free` would free the buffer, so keep it in the same arena.
+    //
+    Arena arena   = (other != NULL) ? other->_arena : NULL;
+    String string = (arena != NULL) ? Arena_alloc(arena, HS_struct_size())
+                                    : malloc(sizeof(struct HeapString));
 
     *string = (struct HeapString){
         ._capacity = 0,
         ._len      = 0,
         ._buffer   = NULL,
+        ._arena    = arena,
     };
 
     if (other != NULL && other->_len > 0 && other->_buffer != NULL) {
@@ -333,7 +443,20 @@ void HS_push_str(String self, const char *str_to_push) {
         return;
     }
 
-    usize str_to_push_len = strlen(str_to_push);
+    HS_push_view(self,
+                 (StrView){.ptr = str_to_push, .len = strlen(str_to_push)});
+}
+
+/*
+ * Push the given `StrView` at the end
+ */
+void HS_push_view(String self, StrView view) {
+    if (self == NULL || view.ptr == NULL) {
+        return;
+    }
+
+    const char *str_to_push = view.ptr;
+    usize str_to_push_len   = view.len;
     if (str_to_push_len <= 0) {
         return;
     }
@@ -341,6 +464,16 @@ void HS_push_str(String self, const char *str_to_push) {
     usize new_len_with_null_terminated_char = self->_len + str_to_push_len + 1;
     bool need_realloc                       = false;
 
+    //
+    // The view may point into `_buffer` itself (e.g. push a part of the same
+    // string), keep its offset as the realloc below may move or free it.
+    //
+    bool is_self_view = self->_buffer != NULL &&
+                        str_to_push >= self->_buffer &&
+                        str_to_push < self->_buffer + self->_capacity;
+    usize self_view_offset =
+        is_self_view ? (usize)(str_to_push - self->_buffer) : 0;
+
 #ifdef ENABLE_PRINT_STRING_MEMORY
     PRINT_MEMORY_BLOCK_FOR_SMART_TYPE("char *", self->_buffer, self->_capacity);
 #endif
@@ -352,12 +485,16 @@ void HS_push_str(String self, const char *str_to_push) {
     if (new_len_with_null_terminated_char > self->_capacity) {
         need_realloc = true;
         self->_buffer =
-            realloc(self->_buffer, new_len_with_null_terminated_char);
+            hs_realloc_buffer(self, new_len_with_null_terminated_char);
+
+        if (is_self_view) {
+            str_to_push = self->_buffer + self_view_offset;
+        }
 
 #ifdef ENABLE_DEBUG_LOG
         usize old_capacity = self->_capacity;
         DEBUG_LOG(String,
-                  HS_push_str,
+                  HS_push_view,
                   "Realloc needed, current capacity: %lu, new capacity: %lu, "
                   "self->_buffer: %p",
                   old_capacity,
@@ -400,6 +537,34 @@ void HS_push_str(String self, const char *str_to_push) {
     }
 }
 
+/*
+ * Make sure it's able to hold `additional` more characters
+ */
+void HS_reserve(String self, usize additional) {
+    if (self == NULL) return;
+
+    usize required_capacity = self->_len + additional + 1;
+    if (required_capacity <= self->_capacity) return;
+
+    char *new_buffer = hs_realloc_buffer(self, required_capacity);
+    if (new_buffer == NULL) return;
+
+    // Keep it null-terminated if it was empty before
+    if (self->_buffer == NULL) new_buffer[0] = '\0';
+
+    self->_buffer   = new_buffer;
+    self->_capacity = required_capacity;
+
+#ifdef ENABLE_DEBUG_LOG
+    DEBUG_LOG(String,
+              reserve,
+              "self ptr: %p, len: %lu, new capacity: %lu",
+              self,
+              self->_len,
+              self->_capacity);
+#endif
+}
+
 /*
  * Insert `String *` to the beginning
  */
@@ -434,7 +599,7 @@ void HS_insert_str_to_begin(String self, const char *str_to_insert) {
     if (new_len_with_null_terminated_char > self->_capacity) {
         need_realloc = true;
         self->_buffer =
-            realloc(self->_buffer, new_len_with_null_terminated_char);
+            hs_realloc_buffer(self, new_len_with_null_terminated_char);
 
 #ifdef ENABLE_DEBUG_LOG
         usize old_capacity = self->_capacity;
@@ -509,6 +674,108 @@ const char *HS_as_str(const String self) {
     return (self != NULL && self->_buffer != NULL) ? self->_buffer : NULL;
 }
 
+/*
+ * Get back a `StrView` that points to the internal buffer
+ */
+StrView HS_as_view(const String self) {
+    return (self != NULL && self->_buffer != NULL)
+               ? (StrView){.ptr = self->_buffer, .len = self->_len}
+               : (StrView){.ptr = NULL, .len = 0};
+}
+
+/*
+ * Check whether the internal buffer is a valid UTF-8 sequence or not
+ */
+bool HS_is_valid_utf8(const String self) {
+    if (self == NULL || self->_buffer == NULL) return true;
+
+    return Utf8_is_valid(self->_buffer, self->_len);
+}
+
+/*
+ * Get back the UTF-8 code point count (not the byte length)
+ */
+usize HS_utf8_char_count(const String self) {
+    if (self == NULL || self->_buffer == NULL) return 0;
+
+    return Utf8_char_count(self->_buffer, self->_len);
+}
+
+/*
+ * Convert ASCII letters to lower case in-place
+ */
+void HS_to_lower(String self) {
+    if (self == NULL || self->_buffer == NULL) return;
+
+    Ascii_to_lower(self->_buffer, self->_len);
+}
+
+/*
+ * Convert ASCII letters to upper case in-place
+ */
+void HS_to_upper(String self) {
+    if (self == NULL || self->_buffer == NULL) return;
+
+    Ascii_to_upper(self->_buffer, self->_len);
+}
+
+/*
+ * Case-insensitive (ASCII only) compare, return `true` if equal
+ */
+bool HS_equals_ignore_case(const String self, const String other) {
+    StrView self_view  = HS_as_view(self);
+    StrView other_view = HS_as_view(other);
+
+    if (self_view.len != other_view.len) return false;
+
+    return Ascii_equals_ignore_case(self_view.ptr,
+                                    other_view.ptr,
+                                    self_view.len);
+}
+
+/*
+ * Byte by byte compare, return `< 0`, `0` or `> 0` like `strcmp`
+ */
+int HS_compare(const String self, const String other) {
+    StrView self_view  = HS_as_view(self);
+    StrView other_view = HS_as_view(other);
+    usize min_len =
+        self_view.len < other_view.len ? self_view.len : other_view.len;
+
+    //
+    // `memcmp` is already vectorized by libc, and it doesn't stop at `\0`
+    //
+    if (min_len > 0) {
+        int result = memcmp(self_view.ptr, other_view.ptr, min_len);
+        if (result != 0) return result;
+    }
+
+    if (self_view.len == other_view.len) return 0;
+    return self_view.len < other_view.len ? -1 : 1;
+}
+
+/*
+ * Case-insensitive (ASCII only) version of `HS_compare`
+ */
+int HS_compare_ignore_case(const String self, const String other) {
+    StrView self_view  = HS_as_view(self);
+    StrView other_view = HS_as_view(other);
+
+    return Ascii_compare_ignore_case(self_view.ptr,
+                                     self_view.len,
+                                     other_view.ptr,
+                                     other_view.len);
+}
+
+/*
+ * Case-insensitive (ASCII only) 64bit hash
+ */
+u64 HS_hash_ignore_case(const String self) {
+    StrView view = HS_as_view(self);
+
+    return Ascii_hash_ignore_case(view.ptr, view.len);
+}
+
 /*
  * Find implementation (not public)
  */
@@ -523,13 +790,18 @@ long HS_find_substring(const String self,
         return -1;
     }
 
-#ifdef __APPLE__
-    char *temp_ptr = (case_sensitive) ? strstr(self->_buffer, str_to_find)
-                                      : strcasestr(self->_buffer, str_to_find);
-#else
-    char *temp_ptr = (case_sensitive) ? strstr(self->_buffer, str_to_find)
-                                      : strcasestr(self->_buffer, str_to_find);
-#endif
+    //
+    // Case-insensitive search doesn't use `strcasestr`, as it lower cases
+    // byte by byte (and it's not available on Linux without `_GNU_SOURCE`).
+    //
+    if (!case_sensitive) {
+        return Ascii_index_of_ignore_case(self->_buffer,
+                                          self->_len,
+                                          str_to_find,
+                                          strlen(str_to_find));
+    }
+
+    char *temp_ptr = strstr(self->_buffer, str_to_find);
 
 #if ENABLE_LINK_LIST_DEBUG
     printf(
@@ -573,7 +845,7 @@ void HS_reset_to_empty(String self) {
         self->_len      = 0;
         self->_capacity = 0;
         if (self->_buffer != NULL) {
-            free(self->_buffer);
+            if (self->_arena == NULL) free(self->_buffer);
             self->_buffer = NULL;
         }
     }
@@ -598,7 +870,10 @@ void HS_reset_to_empty_without_freeing_buffer(String self) {
  * Free allocated memory, reset length to 0 and internal buffer to `NULL`
  */
 void HS_free(String self) {
-    if (self == NULL) return;
+    //
+    // The arena-owned `String` is released by `Arena_reset` or `Arena_free`
+    //
+    if (self == NULL || self->_arena != NULL) return;
 
     if (self->_buffer != NULL) {
         void *ptr_to_free = self->_buffer;
@@ -621,7 +896,7 @@ void HS_free_buffer_only(String self) {
     if (self->_buffer != NULL) {
         void *ptr_to_free = self->_buffer;
         self->_buffer     = NULL;
-        free(ptr_to_free);
+        if (self->_arena == NULL) free(ptr_to_free);
     }
 
     self->_len      = 0;
@@ -3,15 +3,21 @@
 
 #include <stdbool.h>
 
+#include "arena.h"
 #include "data_types.h"
 
 //
 // Heap allocated string
 //
+// `_arena` is `NULL` for the normal heap allocated string. Otherwise, both
+// the `struct HeapString` and the `_buffer` live in that arena, all free
+// functions don't free them and the arena releases them on reset.
+//
 struct HeapString {
     usize _capacity;
     usize _len;
     char *_buffer;
+    Arena _arena;
 };
 
 //
@@ -19,6 +25,16 @@ struct HeapString {
 //
 typedef struct HeapString *String;
 
+//
+// Read-only view into a chunk of characters, it's NOT null-terminated and it
+// doesn't own the memory it points to. So the view is only valid while the
+// `String` (or `char *`) it comes from is still alive and unchanged.
+//
+typedef struct {
+    const char *ptr;
+    usize len;
+} StrView;
+
 //
 // `String` is an opaque pointer which uses to hide the `struct Str` detail,
 // which means `struct Str` doesn't exists in the outside world. If you want
@@ -34,7 +50,7 @@ void auto_free_string(String *ptr);
 
 /*
  * Define smart `String` var that calls `HS_free()` automatically when the
- * variable is out of the scope
+ * variable is out of the scope, it's a no-op for the arena-owned `String`.
  *
  * ```c
  * defer_string(src_str) = HS_from_str("Hey:)");
@@ -81,6 +97,42 @@ String HS_from_str(const char *str);
  */
 String HS_from_str_with_pos(const char *str, int start_pos, int count);
 
+/*
+ * Create from empty in the given arena. The `String` (and all the memory it
+ * needs when growing) comes from the arena, `HS_free` and `defer_string` are
+ * no-op for it and it's released by `Arena_reset` or `Arena_free`.
+ *
+ * All other `HS_xxx` functions work on the arena-owned `String` as usual,
+ * push and insert grow the buffer inside the same arena.
+ */
+String HS_from_empty_in(Arena arena);
+
+/*
+ * Create from empty in the given arena that ability to hold `capacity`
+ * characters
+ */
+String HS_from_empty_with_capacity_in(Arena arena, usize capacity);
+
+/*
+ * Create from `char*` in the given arena
+ */
+String HS_from_str_in(Arena arena, const char *str);
+
+/*
+ * Create from `StrView` in the given arena
+ */
+String HS_from_view_in(Arena arena, StrView view);
+
+/*
+ * Clone from the given `String` instance into the given arena
+ */
+String HS_clone_from_in(Arena arena, const String other);
+
+/*
+ * Check whether it's an arena-owned `String` or not
+ */
+bool HS_is_arena_owned(const String self);
+
 /*
  * Clone from the given `String` instance but don't touch the heap-allocated
  * memory it owned
@@ -89,7 +141,8 @@ String HS_clone_from(const String other);
 
 /*
  * Move from the given `String` instance and move ownership of the
- * heap-allocated memory to the newly created `String` instance
+ * heap-allocated memory to the newly created `String` instance. If `other` is
+ * arena-owned, the newly created `String` lives in the same arena.
  */
 String HS_move_from(String other);
 
@@ -108,6 +161,19 @@ void HS_push_other(String self, String other);
  */
 void HS_push_str(String self, const char *str_to_push);
 
+/*
+ * Push the given `StrView` at the end, the view doesn't need to be
+ * null-terminated.
+ */
+void HS_push_view(String self, StrView view);
+
+/*
+ * Make sure it's able to hold `additional` more characters (plus the
+ * null-terminated character) without any further realloc. Use it before
+ * pushing lots of small pieces.
+ */
+void HS_reserve(String self, usize additional);
+
 /*
  * Insert `String *` to the beginning
  */
@@ -139,6 +205,57 @@ usize HS_capacity(const String self);
  */
 const char *HS_as_str(const String self);
 
+/*
+ * Get back a `StrView` that points to the internal buffer
+ */
+StrView HS_as_view(const String self);
+
+/*
+ * Check whether the internal buffer is a valid UTF-8 sequence or not. An
+ * empty string is valid.
+ */
+bool HS_is_valid_utf8(const String self);
+
+/*
+ * Get back the UTF-8 code point count (not the byte length), it's what you
+ * need for the column alignment. Only meaningful when `HS_is_valid_utf8`
+ * returns `true`.
+ */
+usize HS_utf8_char_count(const String self);
+
+/*
+ * Convert ASCII letters to lower case in-place
+ */
+void HS_to_lower(String self);
+
+/*
+ * Convert ASCII letters to upper case in-place
+ */
+void HS_to_upper(String self);
+
+/*
+ * Case-insensitive (ASCII only) compare, return `true` if equal. `NULL` is
+ * treated as an empty string.
+ */
+bool HS_equals_ignore_case(const String self, const String other);
+
+/*
+ * Byte by byte compare, return `< 0`, `0` or `> 0` like `strcmp`. `NULL` is
+ * treated as an empty string.
+ */
+int HS_compare(const String self, const String other);
+
+/*
+ * Case-insensitive (ASCII only) version of `HS_compare`
+ */
+int HS_compare_ignore_case(const String self, const String other);
+
+/*
+ * Case-insensitive (ASCII only) 64bit hash, use it as the hash function when
+ * the key is case-insensitive (HTTP header key, etc).
+ */
+u64 HS_hash_ignore_case(const String self);
+
 /*
  * Find the given `char *` index, return `-1` if not found.
  */
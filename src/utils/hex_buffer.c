@@ -1,10 +1,10 @@
 #include "hex_buffer.h"
 
-#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include "data_types.h"
+#include "simd.h"
 
 #ifdef ENABLE_DEBUG_LOG
     #include "log.h"
@@ -27,93 +27,1042 @@ struct _HexBuffer {
     u8 _buffer[];
 };
 
+//
+// Hex character to nibble value, `0xFF` means invalid hex character
+//
+static const u8 HEX_DECODE_TABLE[256] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  // 0x00
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  //
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  // 0x10
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  //
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  // 0x20
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  //
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,  // 0x30 `0~7`
+    0x08, 0x09, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  //      `8~9`
+    0xFF, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0xFF,  // 0x40 `A~F`
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  //
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  // 0x50
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  //
+    0xFF, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0xFF,  // 0x60 `a~f`
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  //
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  // 0x70
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  //
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  // 0x80
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  //
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  // 0x90
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  //
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  // 0xA0
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  //
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  // 0xB0
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  //
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  // 0xC0
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  //
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  // 0xD0
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  //
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  // 0xE0
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  //
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  // 0xF0
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  //
+};
+
+#ifdef SIMD_X86_64
+
+//
+// Convert 16 hex characters to 16 nibbles, `valid_mask` gets one bit per
+// character (`0xFFFF` means all valid). It uses the same signed compare range
+// trick in `ascii.c`:
+//
+// - `0~9`: `c - '0'` in range `0 ~ 9`
+// - `a~f` `A~F`: `(c | 0x20) - 'a'` in range `0 ~ 5`
+//
+static inline __m128i hex_nibbles_sse2(__m128i v, u32 *valid_mask) {
+    __m128i digit = _mm_sub_epi8(v, _mm_set1_epi8('0'));
+    __m128i is_digit =
+        _mm_cmplt_epi8(_mm_add_epi8(digit, _mm_set1_epi8(-128)),
+                       _mm_set1_epi8(-128 + 10));
+
+    __m128i letter = _mm_sub_epi8(_mm_or_si128(v, _mm_set1_epi8(0x20)),
+                                  _mm_set1_epi8('a'));
+    __m128i is_letter =
+        _mm_cmplt_epi8(_mm_add_epi8(letter, _mm_set1_epi8(-128)),
+                       _mm_set1_epi8(-128 + 6));
+
+    *valid_mask =
+        (u32)_mm_movemask_epi8(_mm_or_si128(is_digit, is_letter));
+
+    return _mm_or_si128(
+        _mm_and_si128(is_digit, digit),
+        _mm_and_si128(is_letter,
+                      _mm_add_epi8(letter, _mm_set1_epi8(10))));
+}
+
+//
+// Every 16bit lane holds `hi` (low byte) and `lo` (high byte) nibbles, the
+// result byte `(hi << 4) | lo` sits in the low byte of the lane.
+//
+static inline __m128i hex_join_nibbles_sse2(__m128i nibbles) {
+    return _mm_or_si128(
+        _mm_and_si128(_mm_slli_epi16(nibbles, 4), _mm_set1_epi16(0x00F0)),
+        _mm_srli_epi16(nibbles, 8));
+}
+
+SIMD_TARGET("avx2")
+static usize hex_decode_strict_avx2(const u8 *src, usize pair_count, u8 *out) {
+    usize index = 0;
+    for (; index + 16 <= pair_count; index += 16) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(src + index * 2));
+
+        __m256i digit    = _mm256_sub_epi8(v, _mm256_set1_epi8('0'));
+        __m256i is_digit = _mm256_cmpgt_epi8(
+            _mm256_set1_epi8(-128 + 10),
+            _mm256_add_epi8(digit, _mm256_set1_epi8(-128)));
+
+        __m256i letter =
+            _mm256_sub_epi8(_mm256_or_si256(v, _mm256_set1_epi8(0x20)),
+                            _mm256_set1_epi8('a'));
+        __m256i is_letter = _mm256_cmpgt_epi8(
+            _mm256_set1_epi8(-128 + 6),
+            _mm256_add_epi8(letter, _mm256_set1_epi8(-128)));
+
+        u32 valid_mask = (u32)_mm256_movemask_epi8(
+            _mm256_or_si256(is_digit, is_letter));
+        if (valid_mask != 0xFFFFFFFF) break;
+
+        __m256i nibbles = _mm256_or_si256(
+            _mm256_and_si256(is_digit, digit),
+            _mm256_and_si256(is_letter,
+                             _mm256_add_epi8(letter, _mm256_set1_epi8(10))));
+        __m256i bytes = _mm256_or_si256(
+            _mm256_and_si256(_mm256_slli_epi16(nibbles, 4),
+                             _mm256_set1_epi16(0x00F0)),
+            _mm256_srli_epi16(nibbles, 8));
+
+        //
+        // `packus` works per 128bit lane, result bytes are in qword 0 and 2
+        //
+        __m256i packed = _mm256_permute4x64_epi64(
+            _mm256_packus_epi16(bytes, bytes),
+            0x08);
+        _mm_storeu_si128((__m128i *)(out + index),
+                         _mm256_castsi256_si128(packed));
+    }
+    return index;
+}
+
+#endif
+
+//
+// Decode `pair_count` hex character pairs from `src` into `out`, stop at the
+// first pair that contains an invalid character. Return the count of the
+// decoded pairs (`pair_count` means all valid).
+//
+// AVX2 (32 chars, runtime check) -> SSE2 (16 chars) -> table (2 chars)
+//
+static usize hex_decode_strict(const u8 *src, usize pair_count, u8 *out) {
+    usize index = 0;
+
+#ifdef SIMD_X86_64
+    if (pair_count >= 16 && SIMD_CPU_HAS("avx2")) {
+        index = hex_decode_strict_avx2(src, pair_count, out);
+    }
+    for (; index + 8 <= pair_count; index += 8) {
+        u32 valid_mask;
+        __m128i nibbles = hex_nibbles_sse2(
+            _mm_loadu_si128((const __m128i *)(src + index * 2)),
+            &valid_mask);
+        if (valid_mask != 0xFFFF) break;
+
+        __m128i bytes = hex_join_nibbles_sse2(nibbles);
+        _mm_storel_epi64((__m128i *)(out + index),
+                         _mm_packus_epi16(bytes, bytes));
+    }
+#endif
+
+    for (; index < pair_count; index++) {
+        u8 hi = HEX_DECODE_TABLE[src[index * 2]];
+        u8 lo = HEX_DECODE_TABLE[src[index * 2 + 1]];
+        if ((hi | lo) > 0x0F) break;
+
+        out[index] = (u8)((hi << 4) | lo);
+    }
+
+    return index;
+}
+
+//
+// Allocate a `HexBuffer` that is able to hold `len` bytes
+//
+static HexBuffer hex_buffer_alloc(usize len) {
+    HexBuffer buffer = malloc(sizeof(struct _HexBuffer) + len);
+    if (buffer != NULL) buffer->_len = len;
+
+    return buffer;
+}
+
 /*
  * Create `HexBuffer` from the given `char *`. Only accept `0~9` `a~f` `A~F`
  * characters, all another characters will be ignored.
- *
- * Return `NULL` if:
- *
- * - `hex_str` is NULL or empty string
- * - `hex_str` (after ignored all invalid characters) has an odd length
  */
 HexBuffer Hex_from_string(const char *hex_str) {
     if (hex_str == NULL) return NULL;
 
-    usize hex_str_len = strlen(hex_str);
+    return Hex_from_bytes(hex_str, strlen(hex_str));
+}
+
+/*
+ * Create `HexBuffer` from `ptr[0..len]`, all non hex characters will be
+ * ignored.
+ */
+HexBuffer Hex_from_bytes(const char *ptr, usize len) {
+    if (ptr == NULL || len < 2) return NULL;
+
     //
-    // Remove all non `0~9` `a~z` `A~Z` characters
+    // Decode into the biggest possible buffer directly (no filtered copy of
+    // the input), then shrink it to the real size.
     //
-    char valid_hex_str[hex_str_len + 1];
-    usize valid_str_index = 0;
-    for (usize t = 0; t < hex_str_len; t++) {
-        char temp_char = hex_str[t];
+    HexBuffer buffer = hex_buffer_alloc(len / 2);
+    if (buffer == NULL) return NULL;
+
+    const u8 *src    = (const u8 *)ptr;
+    usize src_index  = 0;
+    usize out_index  = 0;
+    u8 pending_hi    = 0;
+    bool has_pending = false;
+
+    while (src_index < len) {
+        //
+        // Run the strict (SIMD) decoder until it hits an invalid character,
+        // then skip it byte by byte.
+        //
+        if (!has_pending) {
+            usize decoded = hex_decode_strict(src + src_index,
+                                              (len - src_index) / 2,
+                                              buffer->_buffer + out_index);
+            src_index += decoded * 2;
+            out_index += decoded;
+            if (src_index >= len) break;
+        }
+
+        u8 nibble = HEX_DECODE_TABLE[src[src_index++]];
+        if (nibble > 0x0F) continue;
 
-        if ((temp_char >= 48 && temp_char <= 57) ||
-            (temp_char >= 65 && temp_char <= 70) ||
-            (temp_char >= 97 && temp_char <= 102)) {
-            valid_hex_str[valid_str_index] = temp_char;
-            valid_str_index++;
+        if (has_pending) {
+            buffer->_buffer[out_index++] = (u8)((pending_hi << 4) | nibble);
+            has_pending                  = false;
+        } else {
+            pending_hi  = nibble;
+            has_pending = true;
         }
     }
-    valid_hex_str[valid_str_index] = '\0';
 
-    usize valid_hex_str_len = strlen(valid_hex_str);
 #ifdef ENABLE_DEBUG_LOG
     DEBUG_LOG(HexBuffer,
-              Hex_from_string,
-              "valid_hex_str len: %lu, value: %s",
-              valid_hex_str_len,
-              valid_hex_str);
+              Hex_from_bytes,
+              "input len: %lu, decoded len: %lu, has_pending: %d",
+              len,
+              out_index,
+              has_pending);
 #endif
 
-    if (valid_hex_str_len <= 0 || valid_hex_str_len % 2 != 0) {
+    //
+    // Empty or odd length (after ignored all invalid characters)
+    //
+    if (out_index == 0 || has_pending) {
+        free(buffer);
+        return NULL;
+    }
+
+    buffer->_len = out_index;
+    if (out_index < len / 2) {
+        HexBuffer shrunk =
+            realloc(buffer, sizeof(struct _HexBuffer) + out_index);
+        if (shrunk != NULL) buffer = shrunk;
+    }
+
+    return buffer;
+}
+
+/*
+ * Create `HexBuffer` from `ptr[0..len]` in strict mode
+ */
+HexBuffer Hex_from_bytes_strict(const char *ptr, usize len) {
+    if (ptr == NULL || len == 0 || len % 2 != 0) return NULL;
+
+    HexBuffer buffer = hex_buffer_alloc(len / 2);
+    if (buffer == NULL) return NULL;
+
+    usize decoded =
+        hex_decode_strict((const u8 *)ptr, len / 2, buffer->_buffer);
+    if (decoded != len / 2) {
 #ifdef ENABLE_DEBUG_LOG
         DEBUG_LOG(HexBuffer,
-                  Hex_from_string,
-                  "valid_hex_str length <= 0 or is odd length, return NULL.",
-                  valid_hex_str_len,
-                  valid_hex_str);
+                  Hex_from_bytes_strict,
+                  "invalid hex character around index: %lu, return NULL.",
+                  decoded * 2);
 #endif
+        free(buffer);
         return NULL;
     }
 
+    return buffer;
+}
+
+/*
+ * Create `HexBuffer` by copying the raw bytes `ptr[0..len]`
+ */
+HexBuffer Hex_from_raw(const u8 *ptr, usize len) {
+    if (ptr == NULL || len == 0) return NULL;
+
+    HexBuffer buffer = hex_buffer_alloc(len);
+    if (buffer == NULL) return NULL;
+
+    memcpy(buffer->_buffer, ptr, len);
+
+    return buffer;
+}
+
+/*
+ * Create `HexBuffer` with `len` uninitialized bytes
+ */
+HexBuffer Hex_with_length(usize len) {
+    if (len == 0) return NULL;
+
+    return hex_buffer_alloc(len);
+}
+
+//
+// Byte to 2 hex digits, byte `b` is at `[b * 2]` and `[b * 2 + 1]`
+//
+static const char HEX_UPPER_DIGIT_PAIRS[513] =
+    "000102030405060708090A0B0C0D0E0F"
+    "101112131415161718191A1B1C1D1E1F"
+    "202122232425262728292A2B2C2D2E2F"
+    "303132333435363738393A3B3C3D3E3F"
+    "404142434445464748494A4B4C4D4E4F"
+    "505152535455565758595A5B5C5D5E5F"
+    "606162636465666768696A6B6C6D6E6F"
+    "707172737475767778797A7B7C7D7E7F"
+    "808182838485868788898A8B8C8D8E8F"
+    "909192939495969798999A9B9C9D9E9F"
+    "A0A1A2A3A4A5A6A7A8A9AAABACADAEAF"
+    "B0B1B2B3B4B5B6B7B8B9BABBBCBDBEBF"
+    "C0C1C2C3C4C5C6C7C8C9CACBCCCDCECF"
+    "D0D1D2D3D4D5D6D7D8D9DADBDCDDDEDF"
+    "E0E1E2E3E4E5E6E7E8E9EAEBECEDEEEF"
+    "F0F1F2F3F4F5F6F7F8F9FAFBFCFDFEFF";
+static const char HEX_LOWER_DIGIT_PAIRS[513] =
+    "000102030405060708090a0b0c0d0e0f"
+    "101112131415161718191a1b1c1d1e1f"
+    "202122232425262728292a2b2c2d2e2f"
+    "303132333435363738393a3b3c3d3e3f"
+    "404142434445464748494a4b4c4d4e4f"
+    "505152535455565758595a5b5c5d5e5f"
+    "606162636465666768696a6b6c6d6e6f"
+    "707172737475767778797a7b7c7d7e7f"
+    "808182838485868788898a8b8c8d8e8f"
+    "909192939495969798999a9b9c9d9e9f"
+    "a0a1a2a3a4a5a6a7a8a9aaabacadaeaf"
+    "b0b1b2b3b4b5b6b7b8b9babbbcbdbebf"
+    "c0c1c2c3c4c5c6c7c8c9cacbcccdcecf"
+    "d0d1d2d3d4d5d6d7d8d9dadbdcdddedf"
+    "e0e1e2e3e4e5e6e7e8e9eaebecedeeef"
+    "f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff";
+
+#ifdef SIMD_X86_64
+
+//
+// Byte to 2 hex digits with `pshufb`: split every byte into 2 nibbles, look
+// up both of them in the 16 digits table, then interleave them back.
+//
+SIMD_TARGET("ssse3")
+static usize hex_encode_ssse3(const u8 *src,
+                              usize len,
+                              char *out,
+                              const char *digits) {
+    const __m128i table = _mm_loadu_si128((const __m128i *)digits);
+    const __m128i mask  = _mm_set1_epi8(0x0F);
+
+    usize index = 0;
+    for (; index + 16 <= len; index += 16) {
+        __m128i v  = _mm_loadu_si128((const __m128i *)(src + index));
+        __m128i hi = _mm_shuffle_epi8(
+            table,
+            _mm_and_si128(_mm_srli_epi16(v, 4), mask));
+        __m128i lo = _mm_shuffle_epi8(table, _mm_and_si128(v, mask));
+
+        _mm_storeu_si128((__m128i *)(out + index * 2),
+                         _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128((__m128i *)(out + index * 2 + 16),
+                         _mm_unpackhi_epi8(hi, lo));
+    }
+    return index;
+}
+
+SIMD_TARGET("avx2")
+static usize hex_encode_avx2(const u8 *src,
+                             usize len,
+                             char *out,
+                             const char *digits) {
+    const __m256i table = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128((const __m128i *)digits));
+    const __m256i mask = _mm256_set1_epi8(0x0F);
+
+    usize index = 0;
+    for (; index + 32 <= len; index += 32) {
+        __m256i v  = _mm256_loadu_si256((const __m256i *)(src + index));
+        __m256i hi = _mm256_shuffle_epi8(
+            table,
+            _mm256_and_si256(_mm256_srli_epi16(v, 4), mask));
+        __m256i lo = _mm256_shuffle_epi8(table, _mm256_and_si256(v, mask));
+
+        //
+        // `unpack` works per 128bit lane, so the first 32 digits are the
+        // low lanes of both results and the rest are the high lanes.
+        //
+        __m256i first  = _mm256_unpacklo_epi8(hi, lo);
+        __m256i second = _mm256_unpackhi_epi8(hi, lo);
+        _mm256_storeu_si256((__m256i *)(out + index * 2),
+                            _mm256_permute2x128_si256(first, second, 0x20));
+        _mm256_storeu_si256((__m256i *)(out + index * 2 + 32),
+                            _mm256_permute2x128_si256(first, second, 0x31));
+    }
+    return index;
+}
+
+#endif
+
+/*
+ * Return the output length of `Hex_encode`
+ */
+usize Hex_encoded_length(usize len, HexEncodeOptions options) {
+    if (len == 0) return 0;
+
+    return len * 2 + (options.separator != '\0' ? len - 1 : 0);
+}
+
+/*
+ * Encode `ptr[0..len]` into hex characters
+ */
+usize Hex_encode(const u8 *ptr,
+                 usize len,
+                 char *out,
+                 HexEncodeOptions options) {
+    if (ptr == NULL || len == 0 || out == NULL) return 0;
+
+    const char *pairs =
+        options.lower_case ? HEX_LOWER_DIGIT_PAIRS : HEX_UPPER_DIGIT_PAIRS;
+
     //
-    // `_buffer` is a fixed array and it's the last member in the struct, so
-    // `malloc` supports allocated the continuous memory block to container the
-    // enitre `HexBuffer` and that fixed array space.
+    // With separator: 3 characters per byte, the separator goes between
+    // bytes only.
     //
-    usize buffer_size = sizeof(char) * valid_hex_str_len / 2;
-    HexBuffer buffer  = malloc(sizeof(HexBuffer) + buffer_size);
-    buffer->_len      = buffer_size;
+    if (options.separator != '\0') {
+        char *out_ptr = out;
+        for (usize index = 0; index < len; index++) {
+            if (index > 0) *out_ptr++ = options.separator;
+            memcpy(out_ptr, pairs + ptr[index] * 2, 2);
+            out_ptr += 2;
+        }
+        return out_ptr - out;
+    }
 
-    char *copy_str = (char *)valid_hex_str;
-    for (usize index = 0; index < buffer_size; index++) {
-        char temp_hex_str[3] = {0};
-        strncpy(temp_hex_str, copy_str, 2);
+    usize index = 0;
 
-#ifdef ENABLE_DEBUG_LOG
-        DEBUG_LOG(HexBuffer,
-                  Hex_from_string,
-                  "temp_hex_str: %s, strlen: %lu",
-                  temp_hex_str,
-                  strlen(temp_hex_str));
+#ifdef SIMD_X86_64
+    //
+    // The first 16 pairs start with `0`, their second digits are exactly the
+    // 16 digits table that `pshufb` needs.
+    //
+    char digits[16];
+    for (usize digit = 0; digit < 16; digit++) {
+        digits[digit] = pairs[digit * 2 + 1];
+    }
+
+    if (len >= 32 && SIMD_CPU_HAS("avx2")) {
+        index = hex_encode_avx2(ptr, len, out, digits);
+    }
+    if (len - index >= 16 && SIMD_CPU_HAS("ssse3")) {
+        index += hex_encode_ssse3(ptr + index,
+                                  len - index,
+                                  out + index * 2,
+                                  digits);
+    }
 #endif
 
-        // `strtol` converts the 16 base ASCII to long
-        buffer->_buffer[index] = (u8)strtol(temp_hex_str, NULL, 16);
+    for (; index < len; index++) {
+        memcpy(out + index * 2, pairs + ptr[index] * 2, 2);
+    }
+
+    return len * 2;
+}
+
+/*
+ * Append the hex string to the given `String`
+ */
+void Hex_encode_into(const HexBuffer self,
+                     String out,
+                     HexEncodeOptions options) {
+    if (self == NULL || self->_len == 0 || out == NULL) return;
+
+    HS_reserve(out, Hex_encoded_length(self->_len, options));
+
+    //
+    // Encode block by block on the stack, `HS_reserve` above makes sure
+    // `HS_push_view` never reallocs.
+    //
+    char block[4096];
+    usize block_bytes = (options.separator != '\0') ? sizeof(block) / 3
+                                                    : sizeof(block) / 2;
+    for (usize index = 0; index < self->_len; index += block_bytes) {
+        usize bytes = self->_len - index < block_bytes ? self->_len - index
+                                                       : block_bytes;
+        usize encoded_len =
+            Hex_encode(self->_buffer + index, bytes, block, options);
+
+        if (index > 0 && options.separator != '\0') {
+            HS_push_view(out, (StrView){.ptr = &options.separator, .len = 1});
+        }
+        HS_push_view(out, (StrView){.ptr = block, .len = encoded_len});
+    }
+}
+
+/*
+ * Init the decoder
+ */
+void HexDecoder_init(HexDecoder *self, bool strict) {
+    if (self == NULL) return;
+
+    *self = (HexDecoder){
+        ._strict      = strict,
+        ._failed      = false,
+        ._has_pending = false,
+        ._pending_hi  = 0,
+        ._consumed    = 0,
+    };
+}
+
+/*
+ * Decode `chunk[0..chunk_len]` into `out`
+ */
+long HexDecoder_feed(HexDecoder *self,
+                     const char *chunk,
+                     usize chunk_len,
+                     u8 *out) {
+    if (self == NULL || self->_failed) return -1;
+    if (chunk == NULL || chunk_len == 0 || out == NULL) return 0;
+
+    const u8 *src   = (const u8 *)chunk;
+    usize src_index = 0;
+    usize out_index = 0;
+
+    //
+    // Same loop with `Hex_from_bytes`: the strict (SIMD) decoder runs when
+    // there is no pending nibble, the pending nibble from the previous chunk
+    // and the invalid characters go through the table.
+    //
+    while (src_index < chunk_len) {
+        if (!self->_has_pending) {
+            usize decoded = hex_decode_strict(src + src_index,
+                                              (chunk_len - src_index) / 2,
+                                              out + out_index);
+            src_index += decoded * 2;
+            out_index += decoded;
+            if (src_index >= chunk_len) break;
+        }
+
+        u8 nibble = HEX_DECODE_TABLE[src[src_index]];
+        if (nibble > 0x0F) {
+            if (self->_strict) {
+                self->_failed = true;
+                self->_consumed += src_index;
 
 #ifdef ENABLE_DEBUG_LOG
-        DEBUG_LOG(HexBuffer,
-                  Hex_from_string,
-                  "buffer->_buffer[%u]: %02X",
-                  index,
-                  buffer->_buffer[index]);
+                DEBUG_LOG(HexDecoder,
+                          feed,
+                          "invalid hex character at index: %lu",
+                          self->_consumed);
 #endif
+                return -1;
+            }
+            src_index++;
+            continue;
+        }
+        src_index++;
 
-        copy_str += 2;
+        if (self->_has_pending) {
+            out[out_index++]   = (u8)((self->_pending_hi << 4) | nibble);
+            self->_has_pending = false;
+        } else {
+            self->_pending_hi  = nibble;
+            self->_has_pending = true;
+        }
     }
 
-    return buffer;
+    self->_consumed += chunk_len;
+
+    return (long)out_index;
+}
+
+/*
+ * Return the count of input characters consumed so far
+ */
+usize HexDecoder_consumed(const HexDecoder *self) {
+    return (self != NULL) ? self->_consumed : 0;
+}
+
+/*
+ * Finish decoding
+ */
+bool HexDecoder_finish(HexDecoder *self) {
+    if (self == NULL) return false;
+
+    bool result = !self->_failed && !self->_has_pending;
+    HexDecoder_init(self, self->_strict);
+
+    return result;
+}
+
+/*
+ * Init the encoder
+ */
+void HexEncoder_init(HexEncoder *self, HexEncodeOptions options) {
+    if (self == NULL) return;
+
+    *self = (HexEncoder){._options = options, ._started = false};
+}
+
+/*
+ * Encode `chunk[0..chunk_len]` into `out`
+ */
+usize HexEncoder_feed(HexEncoder *self,
+                      const u8 *chunk,
+                      usize chunk_len,
+                      char *out) {
+    if (self == NULL || chunk == NULL || chunk_len == 0 || out == NULL) {
+        return 0;
+    }
+
+    usize out_len = 0;
+    if (self->_started && self->_options.separator != '\0') {
+        out[out_len++] = self->_options.separator;
+    }
+    self->_started = true;
+
+    return out_len +
+           Hex_encode(chunk, chunk_len, out + out_len, self->_options);
+}
+
+//
+// Bytewise operations, every function runs the widest path first and each
+// path returns the index it has processed (or stopped at), then the
+// narrower path continues from there:
+//
+// AVX2 (32 bytes, runtime check) -> SSE2 (16 bytes) -> u64 (8 bytes) -> u8
+//
+// (`Hex_popcount` needs `pshufb` for its 16 bytes path, so it's SSSE3 with
+// a runtime check instead of SSE2.)
+//
+
+#define HEX_ONES 0x0101010101010101ULL
+#define HEX_HIGH_BITS 0x8080808080808080ULL
+
+#ifdef SIMD_X86_64
+
+//
+// Popcount of each nibble, for the `pshufb` lookup
+//
+static const u8 HEX_NIBBLE_POPCOUNT_TABLE[32] = {
+    0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+    0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4};
+
+SIMD_TARGET("avx2")
+static usize hex_mismatch_avx2(const u8 *a, const u8 *b, usize len) {
+    usize index = 0;
+    for (; index + 32 <= len; index += 32) {
+        __m256i a_v = _mm256_loadu_si256((const __m256i *)(a + index));
+        __m256i b_v = _mm256_loadu_si256((const __m256i *)(b + index));
+        u32 equal_mask = (u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(a_v, b_v));
+        if (equal_mask != 0xFFFFFFFF) {
+            return index + __builtin_ctz(~equal_mask);
+        }
+    }
+    return index;
+}
+
+SIMD_TARGET("avx2")
+static usize hex_xor_avx2(u8 *dst, const u8 *src, usize len) {
+    usize index = 0;
+    for (; index + 32 <= len; index += 32) {
+        __m256i dst_v = _mm256_loadu_si256((const __m256i *)(dst + index));
+        __m256i src_v = _mm256_loadu_si256((const __m256i *)(src + index));
+        _mm256_storeu_si256((__m256i *)(dst + index),
+                            _mm256_xor_si256(dst_v, src_v));
+    }
+    return index;
+}
+
+//
+// Only the positions where both the first and the last pattern byte match
+// are worth a full compare. Return the match index, or `-1` with
+// `*processed` set to the index to continue from.
+//
+SIMD_TARGET("avx2")
+static long hex_find_avx2(const u8 *ptr,
+                          usize len,
+                          const u8 *pattern,
+                          usize pattern_len,
+                          usize *processed) {
+    const __m256i first_v = _mm256_set1_epi8((char)pattern[0]);
+    const __m256i last_v  = _mm256_set1_epi8((char)pattern[pattern_len - 1]);
+
+    usize index = 0;
+    for (; index + pattern_len - 1 + 32 <= len; index += 32) {
+        __m256i block_first =
+            _mm256_loadu_si256((const __m256i *)(ptr + index));
+        __m256i block_last = _mm256_loadu_si256(
+            (const __m256i *)(ptr + index + pattern_len - 1));
+        u32 candidates = (u32)_mm256_movemask_epi8(
+            _mm256_and_si256(_mm256_cmpeq_epi8(block_first, first_v),
+                             _mm256_cmpeq_epi8(block_last, last_v)));
+        while (candidates != 0) {
+            usize offset = __builtin_ctz(candidates);
+            if (pattern_len <= 2 || memcmp(ptr + index + offset + 1,
+                                           pattern + 1,
+                                           pattern_len - 2) == 0) {
+                return (long)(index + offset);
+            }
+            candidates &= candidates - 1;
+        }
+    }
+
+    *processed = index;
+    return -1;
+}
+
+//
+// `cmpeq` gives `-1` for each matched byte, so subtracting it counts up to
+// 255 matches per byte lane, then `sad` folds the lanes into 4 `u64`.
+//
+SIMD_TARGET("avx2")
+static usize hex_count_byte_avx2(const u8 *ptr,
+                                 usize len,
+                                 u8 value,
+                                 usize *count) {
+    const __m256i value_v = _mm256_set1_epi8((char)value);
+    __m256i total         = _mm256_setzero_si256();
+
+    usize index = 0;
+    while (index + 32 <= len) {
+        __m256i lanes = _mm256_setzero_si256();
+        for (usize round = 0; round < 255 && index + 32 <= len;
+             round++, index += 32) {
+            __m256i block = _mm256_loadu_si256((const __m256i *)(ptr + index));
+            lanes = _mm256_sub_epi8(lanes, _mm256_cmpeq_epi8(block, value_v));
+        }
+        total = _mm256_add_epi64(
+            total,
+            _mm256_sad_epu8(lanes, _mm256_setzero_si256()));
+    }
+
+    *count += (usize)_mm256_extract_epi64(total, 0) +
+              (usize)_mm256_extract_epi64(total, 1) +
+              (usize)_mm256_extract_epi64(total, 2) +
+              (usize)_mm256_extract_epi64(total, 3);
+    return index;
+}
+
+//
+// `pshufb` looks up the popcount of both nibbles of each byte ("Faster
+// Population Counts Using AVX2 Instructions", Muła, Kurz & Lemire), then
+// `sad` folds the bytes into 4 `u64`.
+//
+SIMD_TARGET("avx2")
+static usize hex_popcount_avx2(const u8 *ptr, usize len, usize *count) {
+    const __m256i lookup =
+        _mm256_loadu_si256((const __m256i *)HEX_NIBBLE_POPCOUNT_TABLE);
+    const __m256i low_mask = _mm256_set1_epi8(0x0F);
+    __m256i total          = _mm256_setzero_si256();
+
+    usize index = 0;
+    for (; index + 32 <= len; index += 32) {
+        __m256i block = _mm256_loadu_si256((const __m256i *)(ptr + index));
+        __m256i low   = _mm256_and_si256(block, low_mask);
+        __m256i high  = _mm256_and_si256(_mm256_srli_epi16(block, 4), low_mask);
+        __m256i bits  = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, low),
+                                       _mm256_shuffle_epi8(lookup, high));
+        total         = _mm256_add_epi64(
+            total,
+            _mm256_sad_epu8(bits, _mm256_setzero_si256()));
+    }
+
+    *count += (usize)_mm256_extract_epi64(total, 0) +
+              (usize)_mm256_extract_epi64(total, 1) +
+              (usize)_mm256_extract_epi64(total, 2) +
+              (usize)_mm256_extract_epi64(total, 3);
+    return index;
+}
+
+//
+// The 16 bytes version of `hex_count_byte_avx2`, starts from `index`
+//
+static usize hex_count_byte_sse2(const u8 *ptr,
+                                 usize len,
+                                 usize index,
+                                 u8 value,
+                                 usize *count) {
+    const __m128i value_v = _mm_set1_epi8((char)value);
+    __m128i total         = _mm_setzero_si128();
+
+    while (index + 16 <= len) {
+        __m128i lanes = _mm_setzero_si128();
+        for (usize round = 0; round < 255 && index + 16 <= len;
+             round++, index += 16) {
+            __m128i block = _mm_loadu_si128((const __m128i *)(ptr + index));
+            lanes = _mm_sub_epi8(lanes, _mm_cmpeq_epi8(block, value_v));
+        }
+        total = _mm_add_epi64(total, _mm_sad_epu8(lanes, _mm_setzero_si128()));
+    }
+
+    *count += (usize)_mm_cvtsi128_si64(total) +
+              (usize)_mm_cvtsi128_si64(_mm_unpackhi_epi64(total, total));
+    return index;
+}
+
+//
+// The 16 bytes version of `hex_popcount_avx2` (`pshufb` needs SSSE3),
+// starts from `index`
+//
+SIMD_TARGET("ssse3")
+static usize hex_popcount_ssse3(const u8 *ptr,
+                                usize len,
+                                usize index,
+                                usize *count) {
+    const __m128i lookup =
+        _mm_loadu_si128((const __m128i *)HEX_NIBBLE_POPCOUNT_TABLE);
+    const __m128i low_mask = _mm_set1_epi8(0x0F);
+    __m128i total          = _mm_setzero_si128();
+
+    for (; index + 16 <= len; index += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i *)(ptr + index));
+        __m128i low   = _mm_and_si128(block, low_mask);
+        __m128i high  = _mm_and_si128(_mm_srli_epi16(block, 4), low_mask);
+        __m128i bits  = _mm_add_epi8(_mm_shuffle_epi8(lookup, low),
+                                    _mm_shuffle_epi8(lookup, high));
+        total = _mm_add_epi64(total, _mm_sad_epu8(bits, _mm_setzero_si128()));
+    }
+
+    *count += (usize)_mm_cvtsi128_si64(total) +
+              (usize)_mm_cvtsi128_si64(_mm_unpackhi_epi64(total, total));
+    return index;
+}
+
+#endif
+
+//
+// Return the index of the first mismatch, or `len` if all bytes are equal
+//
+static usize hex_mismatch(const u8 *a, const u8 *b, usize len) {
+    usize index = 0;
+
+#ifdef SIMD_X86_64
+    if (len >= 32 && SIMD_CPU_HAS("avx2")) {
+        index = hex_mismatch_avx2(a, b, len);
+        if (index + 32 <= len) return index;
+    }
+    for (; index + 16 <= len; index += 16) {
+        __m128i a_v = _mm_loadu_si128((const __m128i *)(a + index));
+        __m128i b_v = _mm_loadu_si128((const __m128i *)(b + index));
+        u32 equal_mask = (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(a_v, b_v));
+        if (equal_mask != 0xFFFF) {
+            return index + __builtin_ctz(~equal_mask);
+        }
+    }
+#endif
+
+    for (; index + 8 <= len; index += 8) {
+        u64 a_word, b_word;
+        memcpy(&a_word, a + index, sizeof(a_word));
+        memcpy(&b_word, b + index, sizeof(b_word));
+        if (a_word != b_word) break;
+    }
+    for (; index < len; index++) {
+        if (a[index] != b[index]) break;
+    }
+
+    return index;
+}
+
+/*
+ * Return `true` if both `HexBuffer` have the same bytes
+ */
+bool Hex_equals(const HexBuffer self, const HexBuffer other) {
+    usize len = Hex_length(self);
+    if (len != Hex_length(other)) return false;
+    if (len == 0) return true;
+
+    return hex_mismatch(self->_buffer, other->_buffer, len) == len;
+}
+
+/*
+ * Compare 2 `HexBuffer` in lexicographical order
+ */
+int Hex_compare(const HexBuffer self, const HexBuffer other) {
+    usize self_len  = Hex_length(self);
+    usize other_len = Hex_length(other);
+    usize len       = self_len < other_len ? self_len : other_len;
+
+    usize index =
+        len > 0 ? hex_mismatch(self->_buffer, other->_buffer, len) : 0;
+    if (index < len) {
+        return self->_buffer[index] < other->_buffer[index] ? -1 : 1;
+    }
+
+    return self_len < other_len ? -1 : self_len > other_len ? 1 : 0;
+}
+
+/*
+ * XOR the first `Hex_length(self)` bytes of `key` into `self`
+ */
+bool Hex_xor_into(HexBuffer self, const HexBuffer key) {
+    if (self == NULL || key == NULL || key->_len < self->_len) return false;
+
+    u8 *dst       = self->_buffer;
+    const u8 *src = key->_buffer;
+    usize len     = self->_len;
+    usize index   = 0;
+
+#ifdef SIMD_X86_64
+    if (len >= 32 && SIMD_CPU_HAS("avx2")) {
+        index = hex_xor_avx2(dst, src, len);
+    }
+    for (; index + 16 <= len; index += 16) {
+        __m128i dst_v = _mm_loadu_si128((const __m128i *)(dst + index));
+        __m128i src_v = _mm_loadu_si128((const __m128i *)(src + index));
+        _mm_storeu_si128((__m128i *)(dst + index), _mm_xor_si128(dst_v, src_v));
+    }
+#endif
+
+    for (; index + 8 <= len; index += 8) {
+        u64 dst_word, src_word;
+        memcpy(&dst_word, dst + index, sizeof(dst_word));
+        memcpy(&src_word, src + index, sizeof(src_word));
+        dst_word ^= src_word;
+        memcpy(dst + index, &dst_word, sizeof(dst_word));
+    }
+    for (; index < len; index++) {
+        dst[index] ^= src[index];
+    }
+
+    return true;
+}
+
+/*
+ * Find the first occurrence of `pattern[0..pattern_len]`
+ */
+long Hex_find(const HexBuffer self, const u8 *pattern, usize pattern_len) {
+    if (self == NULL || pattern == NULL || pattern_len == 0 ||
+        pattern_len > self->_len) {
+        return -1;
+    }
+
+    const u8 *ptr = self->_buffer;
+    usize len     = self->_len;
+    usize index   = 0;
+
+#ifdef SIMD_X86_64
+    if (len - pattern_len + 1 >= 32 && SIMD_CPU_HAS("avx2")) {
+        long found = hex_find_avx2(ptr, len, pattern, pattern_len, &index);
+        if (found >= 0) return found;
+    }
+#endif
+
+    //
+    // `memchr` jumps to the next first byte candidate
+    //
+    while (index + pattern_len <= len) {
+        const u8 *candidate =
+            memchr(ptr + index, pattern[0], len - pattern_len + 1 - index);
+        if (candidate == NULL) break;
+
+        index = candidate - ptr;
+        if (memcmp(candidate + 1, pattern + 1, pattern_len - 1) == 0) {
+            return (long)index;
+        }
+        index++;
+    }
+
+    return -1;
+}
+
+/*
+ * Count how many bytes equal to `value`
+ */
+usize Hex_count_byte(const HexBuffer self, u8 value) {
+    if (self == NULL) return 0;
+
+    const u8 *ptr = self->_buffer;
+    usize len     = self->_len;
+    usize index   = 0;
+    usize count   = 0;
+
+#ifdef SIMD_X86_64
+    if (len >= 32 && SIMD_CPU_HAS("avx2")) {
+        index = hex_count_byte_avx2(ptr, len, value, &count);
+    }
+    index = hex_count_byte_sse2(ptr, len, index, value, &count);
+#endif
+
+    //
+    // The high bit of each byte is set if the byte is NOT zero after XOR
+    // (no carry between bytes)
+    //
+    const u64 pattern = value * HEX_ONES;
+    const u64 low_7   = ~HEX_HIGH_BITS;
+    for (; index + 8 <= len; index += 8) {
+        u64 word;
+        memcpy(&word, ptr + index, sizeof(word));
+        word ^= pattern;
+
+        u64 non_zero = (((word & low_7) + low_7) | word) & HEX_HIGH_BITS;
+        count += 8 - __builtin_popcountll(non_zero);
+    }
+    for (; index < len; index++) {
+        count += ptr[index] == value;
+    }
+
+    return count;
+}
+
+/*
+ * Count the 1 bits of all bytes
+ */
+usize Hex_popcount(const HexBuffer self) {
+    if (self == NULL) return 0;
+
+    const u8 *ptr = self->_buffer;
+    usize len     = self->_len;
+    usize index   = 0;
+    usize count   = 0;
+
+#ifdef SIMD_X86_64
+    if (len >= 32 && SIMD_CPU_HAS("avx2")) {
+        index = hex_popcount_avx2(ptr, len, &count);
+    }
+    if (len - index >= 16 && SIMD_CPU_HAS("ssse3")) {
+        index = hex_popcount_ssse3(ptr, len, index, &count);
+    }
+#endif
+
+    for (; index + 8 <= len; index += 8) {
+        u64 word;
+        memcpy(&word, ptr + index, sizeof(word));
+        count += __builtin_popcountll(word);
+    }
+    for (; index < len; index++) {
+        count += __builtin_popcount(ptr[index]);
+    }
+
+    return count;
 }
 
 /*
@@ -149,40 +1098,20 @@ int Hex_to_string(const HexBuffer self,
 
     if (copied_buffer_size > out_buffer_size) return -1;
 
-#ifdef ENABLE_DEBUG_LOG
-    DEBUG_LOG(HexBuffer,
-              Hex_to_string,
-              "self->_len: %lu, copied_buffer_size: %lu, self->_buffer: 0x",
-              self->_len,
-              copied_buffer_size);
-
-    for (usize index = 0; index < self->_len; index++) {
-        printf("%02X", self->_buffer[index]);
-        // printf("%u", self->_buffer[index]);
-    }
-#endif
-
-    char *copy_ptr = out_buffer;
-    for (usize index = 0; index < self->_len; index++) {
-        char hex_value[3] = {0};
+    Hex_encode(self->_buffer,
+               self->_len,
+               out_buffer,
+               (HexEncodeOptions){.lower_case = false, .separator = '\0'});
 
-#ifdef ENABLE_DEBUG_LOG
-        // `02` means left-padding `0` until output len is 2
-        usize copied_size =
-            snprintf(hex_value, 3, "%02X", self->_buffer[index]);
-        DEBUG_LOG(HexBuffer,
-                  Hex_to_string,
-                  "copied_size: %lu, hex_value: %s",
-                  copied_size,
-                  hex_value);
-#else
-        // `02` means left-padding `0` until output len is 2
-        snprintf(hex_value, 3, "%02X", self->_buffer[index]);
-#endif
-        memcpy(copy_ptr, hex_value, 2);
-        copy_ptr += 2;
+    //
+    // Add the null-terminated character when there is space for it,
+    // otherwise keep the old behavior: the last character gets replaced.
+    //
+    if (copied_buffer_size < out_buffer_size) {
+        out_buffer[copied_buffer_size] = '\0';
+    } else {
+        out_buffer[out_buffer_size - 1] = '\0';
     }
-    out_buffer[out_buffer_size - 1] = '\0';
 
     return self->_len * 2;
 }
@@ -2,6 +2,7 @@
 #define __UTILS_HEX_BUFFER_H__
 
 #include "data_types.h"
+#include "heap_string.h"
 
 /*
  * Opaque pointer to `struct _HexBuffer`
@@ -27,6 +28,41 @@ typedef struct {
  */
 HexBuffer Hex_from_string(const char *hex_str);
 
+/*
+ * Same with `Hex_from_string`, but works on `ptr[0..len]` which doesn't need
+ * to be null-terminated. The input is decoded straight into the result
+ * buffer, so it's safe for the multi-MB input as well.
+ */
+HexBuffer Hex_from_bytes(const char *ptr, usize len);
+
+/*
+ * Strict version of `Hex_from_bytes`: every character in `ptr[0..len]` has
+ * to be `0~9` `a~f` `A~F`.
+ *
+ * Return `NULL` if:
+ *
+ * - `ptr` is NULL or `len` is 0
+ * - `len` is odd
+ * - `ptr[0..len]` contains any non hex character
+ */
+HexBuffer Hex_from_bytes_strict(const char *ptr, usize len);
+
+/*
+ * Create `HexBuffer` by copying the raw bytes `ptr[0..len]` (NOT hex
+ * characters).
+ *
+ * Return `NULL` if `ptr` is NULL or `len` is 0
+ */
+HexBuffer Hex_from_raw(const u8 *ptr, usize len);
+
+/*
+ * Create `HexBuffer` with `len` uninitialized bytes, it's for the decoders
+ * that write straight into the buffer (via `Hex_iter`) to avoid a copy.
+ *
+ * Return `NULL` if `len` is 0
+ */
+HexBuffer Hex_with_length(usize len);
+
 /*
  * Return the hex buffer length
  */
@@ -43,6 +79,190 @@ int Hex_to_string(const HexBuffer self,
                   char *out_buffer,
                   usize out_buffer_size);
 
+/*
+ * Hex encode options:
+ *
+ * - `lower_case`: `a~f` instead of `A~F`
+ * - `separator`: character between every 2 bytes, `\0` means no separator
+ *
+ * ```c
+ * // "AABBCC"
+ * (HexEncodeOptions){0}
+ *
+ * // "aa:bb:cc"
+ * (HexEncodeOptions){.lower_case = true, .separator = ':'}
+ * ```
+ */
+typedef struct {
+    bool lower_case;
+    char separator;
+} HexEncodeOptions;
+
+/*
+ * Return the output length (without the null-terminated character) of
+ * encoding `len` bytes with the given options
+ */
+usize Hex_encoded_length(usize len, HexEncodeOptions options);
+
+/*
+ * Encode `ptr[0..len]` into hex characters, `out` should be able to hold
+ * `Hex_encoded_length(len, options)` characters. It does NOT add the
+ * null-terminated character.
+ *
+ * Return the count of characters written into `out`.
+ */
+usize Hex_encode(const u8 *ptr, usize len, char *out, HexEncodeOptions options);
+
+/*
+ * Append the hex string to the given `String`, the `String` grows only once.
+ */
+void Hex_encode_into(const HexBuffer self,
+                     String out,
+                     HexEncodeOptions options);
+
+/*
+ * Streaming hex decoder, decode a huge hex input chunk by chunk in constant
+ * memory. A hex pair can be split between 2 chunks, the pending nibble is
+ * kept in the decoder.
+ *
+ * ```c
+ * HexDecoder decoder;
+ * HexDecoder_init(&decoder, false);
+ *
+ * char chunk[65536];
+ * u8 out[HEX_DECODER_MAX_OUTPUT(sizeof(chunk))];
+ * ssize_t read_size;
+ * while ((read_size = read(in_fd, chunk, sizeof(chunk))) > 0) {
+ *     long out_len = HexDecoder_feed(&decoder, chunk, read_size, out);
+ *     if (out_len < 0) break;
+ *     write(out_fd, out, out_len);
+ * }
+ *
+ * if (!HexDecoder_finish(&decoder)) {
+ *     // Invalid or odd length input
+ * }
+ * ```
+ */
+typedef struct {
+    bool _strict;
+    bool _failed;
+    bool _has_pending;
+    u8 _pending_hi;
+    usize _consumed;
+} HexDecoder;
+
+/*
+ * The max output size of feeding `chunk_len` characters
+ */
+#define HEX_DECODER_MAX_OUTPUT(chunk_len) ((chunk_len) / 2 + 1)
+
+/*
+ * Init the decoder. In strict mode, any non hex character fails the decoder,
+ * otherwise they're ignored (same with `Hex_from_bytes`).
+ */
+void HexDecoder_init(HexDecoder *self, bool strict);
+
+/*
+ * Decode `chunk[0..chunk_len]` into `out`, `out` should be able to hold
+ * `HEX_DECODER_MAX_OUTPUT(chunk_len)` bytes.
+ *
+ * Return the count of bytes written into `out`, return `-1` if it's in strict
+ * mode and the chunk contains any non hex character (the decoder stays in
+ * the failed state).
+ */
+long HexDecoder_feed(HexDecoder *self,
+                     const char *chunk,
+                     usize chunk_len,
+                     u8 *out);
+
+/*
+ * Return the count of input characters consumed so far. In the failed state,
+ * it's the index of the first invalid character.
+ */
+usize HexDecoder_consumed(const HexDecoder *self);
+
+/*
+ * Finish decoding, return `false` if the decoder is in the failed state or
+ * there is a pending nibble (odd length input). The decoder is reset and
+ * ready for the next input.
+ */
+bool HexDecoder_finish(HexDecoder *self);
+
+/*
+ * Streaming hex encoder, the separator (if any) between chunks is handled
+ * as well, so the output is the same with encoding all data in one go.
+ */
+typedef struct {
+    HexEncodeOptions _options;
+    bool _started;
+} HexEncoder;
+
+/*
+ * The max output size of feeding `chunk_len` bytes
+ */
+#define HEX_ENCODER_MAX_OUTPUT(chunk_len) ((chunk_len) * 3)
+
+/*
+ * Init the encoder
+ */
+void HexEncoder_init(HexEncoder *self, HexEncodeOptions options);
+
+/*
+ * Encode `chunk[0..chunk_len]` into `out`, `out` should be able to hold
+ * `HEX_ENCODER_MAX_OUTPUT(chunk_len)` characters. It does NOT add the
+ * null-terminated character.
+ *
+ * Return the count of characters written into `out`.
+ */
+usize HexEncoder_feed(HexEncoder *self,
+                      const u8 *chunk,
+                      usize chunk_len,
+                      char *out);
+
+//
+// Bytewise operations, they run on `AVX2` / `SSE2` / `u64` words instead of
+// walking `Hex_iter` byte by byte. `NULL` is treated as an empty buffer.
+//
+
+/*
+ * Return `true` if both `HexBuffer` have the same length and the same bytes
+ */
+bool Hex_equals(const HexBuffer self, const HexBuffer other);
+
+/*
+ * Compare 2 `HexBuffer` in lexicographical order (same with `memcmp`, the
+ * shorter one comes first if it's the prefix of the other one).
+ *
+ * Return `-1` if `self < other`, `0` if equal, `1` if `self > other`.
+ */
+int Hex_compare(const HexBuffer self, const HexBuffer other);
+
+/*
+ * XOR the first `Hex_length(self)` bytes of `key` (for example, a keystream)
+ * into `self` in place.
+ *
+ * Return `false` (nothing changed) if any of them is NULL or `key` is
+ * shorter than `self`.
+ */
+bool Hex_xor_into(HexBuffer self, const HexBuffer key);
+
+/*
+ * Return the index of the first occurrence of `pattern[0..pattern_len]`
+ * (for example, a magic sequence), return `-1` if not found or the pattern
+ * is empty.
+ */
+long Hex_find(const HexBuffer self, const u8 *pattern, usize pattern_len);
+
+/*
+ * Return the count of bytes that equal to `value`
+ */
+usize Hex_count_byte(const HexBuffer self, u8 value);
+
+/*
+ * Return the count of 1 bits in all bytes
+ */
+usize Hex_popcount(const HexBuffer self);
+
 /*
  * Return the u8 array iterator
  */
@@ -0,0 +1,252 @@
+#include "hexdump.h"
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "hex_buffer.h"
+
+#ifdef ENABLE_DEBUG_LOG
+    #include "log.h"
+#endif
+
+//
+// `bytes_per_line` is capped, so the longest line always fits in the block
+//
+#define HEXDUMP_MAX_BYTES_PER_LINE 256
+#define HEXDUMP_BLOCK_SIZE 65536
+
+//
+// Everything needed to format a line, calculated once per dump
+//
+typedef struct {
+    usize bytes_per_line;
+    usize group_size;
+    usize offset_width;
+    usize hex_width;
+    usize max_line_len;
+    bool upper_case;
+    bool show_offset;
+    bool show_ascii;
+} HexdumpLayout;
+
+//
+// Receive the formatted block
+//
+typedef bool (*HexdumpSink)(void *ctx, const char *ptr, usize len);
+
+//
+// Hex width (without padding) of `count` bytes
+//
+static inline usize hexdump_hex_len(usize count, usize group_size) {
+    if (count == 0) return 0;
+
+    return count * 2 + (count + group_size - 1) / group_size - 1;
+}
+
+//
+//
+//
+static HexdumpLayout hexdump_layout(usize len, HexdumpOptions options) {
+    HexdumpLayout layout = {
+        .bytes_per_line = options.bytes_per_line > 0 ? options.bytes_per_line
+                                                     : 16,
+        .group_size     = options.group_size > 0 ? options.group_size : 2,
+        .offset_width   = 8,
+        .upper_case     = options.upper_case,
+        .show_offset    = !options.hide_offset,
+        .show_ascii     = !options.hide_ascii,
+    };
+
+    if (layout.bytes_per_line > HEXDUMP_MAX_BYTES_PER_LINE) {
+        layout.bytes_per_line = HEXDUMP_MAX_BYTES_PER_LINE;
+    }
+
+    // Wider offset column when the last offset doesn't fit in 8 digits
+    if (len > 0 && options.start_offset + len - 1 > 0xFFFFFFFF) {
+        layout.offset_width = 16;
+    }
+
+    layout.hex_width =
+        hexdump_hex_len(layout.bytes_per_line, layout.group_size);
+    layout.max_line_len =
+        (layout.show_offset ? layout.offset_width + 2 : 0) + layout.hex_width +
+        (layout.show_ascii ? 2 + layout.bytes_per_line : 0) + 1;
+
+    return layout;
+}
+
+//
+// Format one line (include the `\n`) into `out`, return the line length
+//
+static usize hexdump_format_line(const u8 *ptr,
+                                 usize count,
+                                 usize offset,
+                                 char *out,
+                                 const HexdumpLayout *layout) {
+    const char *digits =
+        layout->upper_case ? "0123456789ABCDEF" : "0123456789abcdef";
+    char *out_ptr = out;
+
+    if (layout->show_offset) {
+        for (usize index = 0; index < layout->offset_width; index++) {
+            usize shift = (layout->offset_width - 1 - index) * 4;
+            out_ptr[index] = digits[(offset >> shift) & 0x0F];
+        }
+        out_ptr += layout->offset_width;
+        *out_ptr++ = ':';
+        *out_ptr++ = ' ';
+    }
+
+    //
+    // Encode the whole line in one go, then copy group by group
+    //
+    char hex[HEXDUMP_MAX_BYTES_PER_LINE * 2];
+    Hex_encode(ptr,
+               count,
+               hex,
+               (HexEncodeOptions){.lower_case = !layout->upper_case});
+    for (usize index = 0; index < count; index += layout->group_size) {
+        usize group_bytes = count - index < layout->group_size
+                                ? count - index
+                                : layout->group_size;
+        if (index > 0) *out_ptr++ = ' ';
+        memcpy(out_ptr, hex + index * 2, group_bytes * 2);
+        out_ptr += group_bytes * 2;
+    }
+
+    if (layout->show_ascii) {
+        //
+        // Pad the short (last) line, so the ASCII gutter stays aligned
+        //
+        usize padding =
+            layout->hex_width - hexdump_hex_len(count, layout->group_size) + 2;
+        memset(out_ptr, ' ', padding);
+        out_ptr += padding;
+
+        for (usize index = 0; index < count; index++) {
+            u8 c           = ptr[index];
+            out_ptr[index] = (c >= 0x20 && c < 0x7F) ? (char)c : '.';
+        }
+        out_ptr += count;
+    }
+
+    *out_ptr++ = '\n';
+
+    return out_ptr - out;
+}
+
+//
+// Format all lines into a big block and pass the block to `sink` every time
+// it's (nearly) full
+//
+static bool hexdump_run(const u8 *ptr,
+                        usize len,
+                        HexdumpOptions options,
+                        HexdumpSink sink,
+                        void *ctx) {
+    HexdumpLayout layout = hexdump_layout(len, options);
+
+    char block[HEXDUMP_BLOCK_SIZE];
+    usize block_len = 0;
+
+    for (usize index = 0; index < len; index += layout.bytes_per_line) {
+        if (HEXDUMP_BLOCK_SIZE - block_len < layout.max_line_len) {
+            if (!sink(ctx, block, block_len)) return false;
+            block_len = 0;
+        }
+
+        usize count = len - index < layout.bytes_per_line
+                          ? len - index
+                          : layout.bytes_per_line;
+        block_len += hexdump_format_line(ptr + index,
+                                         count,
+                                         options.start_offset + index,
+                                         block + block_len,
+                                         &layout);
+    }
+
+    return (block_len > 0) ? sink(ctx, block, block_len) : true;
+}
+
+//
+// Write all bytes to the fd, handle the partial write and `EINTR`
+//
+static bool hexdump_fd_sink(void *ctx, const char *ptr, usize len) {
+    int fd = *(int *)ctx;
+
+    while (len > 0) {
+        ssize_t written = write(fd, ptr, len);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+
+#ifdef ENABLE_DEBUG_LOG
+            DEBUG_LOG(Hexdump,
+                      fd_sink,
+                      "write to fd: %d failed: %s",
+                      fd,
+                      strerror(errno));
+#endif
+            return false;
+        }
+        ptr += written;
+        len -= written;
+    }
+
+    return true;
+}
+
+//
+//
+//
+static bool hexdump_string_sink(void *ctx, const char *ptr, usize len) {
+    HS_push_view((String)ctx, (StrView){.ptr = ptr, .len = len});
+    return true;
+}
+
+/*
+ * Return the total characters (include all `\n`) of dumping `len` bytes
+ */
+usize Hexdump_output_length(usize len, HexdumpOptions options) {
+    if (len == 0) return 0;
+
+    HexdumpLayout layout = hexdump_layout(len, options);
+    usize full_lines     = len / layout.bytes_per_line;
+    usize rest_bytes     = len % layout.bytes_per_line;
+    usize total          = full_lines * layout.max_line_len;
+
+    //
+    // The short (last) line has a shorter ASCII gutter, or a shorter hex
+    // column if there is no ASCII gutter (no padding needed).
+    //
+    if (rest_bytes > 0 && layout.show_ascii) {
+        total += layout.max_line_len - layout.bytes_per_line + rest_bytes;
+    } else if (rest_bytes > 0) {
+        total += layout.max_line_len - layout.hex_width +
+                 hexdump_hex_len(rest_bytes, layout.group_size);
+    }
+
+    return total;
+}
+
+/*
+ * Dump `ptr[0..len]` to the given file descriptor
+ */
+bool Hexdump_to_fd(int fd, const void *ptr, usize len, HexdumpOptions options) {
+    if (ptr == NULL || len == 0) return true;
+
+    return hexdump_run(ptr, len, options, hexdump_fd_sink, &fd);
+}
+
+/*
+ * Append the dump of `ptr[0..len]` to the given `String`
+ */
+void Hexdump_into(String out,
+                  const void *ptr,
+                  usize len,
+                  HexdumpOptions options) {
+    if (out == NULL || ptr == NULL || len == 0) return;
+
+    HS_reserve(out, Hexdump_output_length(len, options));
+    hexdump_run(ptr, len, options, hexdump_string_sink, out);
+}
@@ -0,0 +1,54 @@
+#ifndef __UTILS_HEXDUMP_H__
+#define __UTILS_HEXDUMP_H__
+
+#include <stdbool.h>
+
+#include "data_types.h"
+#include "heap_string.h"
+
+/*
+ * `xxd` style hexdump options, `(HexdumpOptions){0}` is the `xxd` default:
+ *
+ * ```
+ * 00000000: 4865 6c6c 6f2c 2077 6f72 6c64 210a 0001  Hello, world!...
+ * ```
+ *
+ * - `bytes_per_line`: `0` means 16
+ * - `group_size`: bytes per hex group, `0` means 2
+ * - `start_offset`: the offset column value of the first byte
+ * - `upper_case`: `A~F` instead of `a~f`
+ * - `hide_offset`: no offset column
+ * - `hide_ascii`: no ASCII gutter (non printable bytes are shown as `.`)
+ */
+typedef struct {
+    usize bytes_per_line;
+    usize group_size;
+    usize start_offset;
+    bool upper_case;
+    bool hide_offset;
+    bool hide_ascii;
+} HexdumpOptions;
+
+/*
+ * Dump `ptr[0..len]` to the given file descriptor. Lines are formatted into
+ * a big block on the stack and written by `write(2)` block by block.
+ *
+ * Return `false` if `write` fails.
+ */
+bool Hexdump_to_fd(int fd, const void *ptr, usize len, HexdumpOptions options);
+
+/*
+ * Append the dump of `ptr[0..len]` to the given `String`, the `String` grows
+ * only once.
+ */
+void Hexdump_into(String out,
+                  const void *ptr,
+                  usize len,
+                  HexdumpOptions options);
+
+/*
+ * Return the total characters (include all `\n`) of dumping `len` bytes
+ */
+usize Hexdump_output_length(usize len, HexdumpOptions options);
+
+#endif
@@ -24,7 +24,7 @@
 #endif
 
 /*
- * Print memory block data in HEX format
+ * Print memory block data in HEX format (`xxd` style, see `hexdump.h`)
  */
 void print_memory_block(char *type_name, usize type_size, void *value);
 
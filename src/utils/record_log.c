@@ -0,0 +1,557 @@
+#include "record_log.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "checksum.h"
+#include "collections/string_table.h"
+
+#ifdef ENABLE_DEBUG_LOG
+    #include "log.h"
+#endif
+
+//
+// The first 8 bytes of every segment
+//
+#define RECORD_LOG_MAGIC "RECLOG01"
+#define RECORD_LOG_MAGIC_SIZE 8
+
+struct _RecordLog {
+    String folder;
+    RecordLogOptions options;
+
+    // The segment that the next record goes to, `NULL` if the log can't be
+    // opened
+    File segment;
+    u64 segment_number;
+
+    // Bytes in the segment, include the buffered ones
+    usize segment_size;
+
+    usize truncated_size;
+    String error;
+};
+
+struct _RecordLogReader {
+    // All segment paths, in the append order
+    StringTable paths;
+    usize next_path;
+
+    // The mapped segment, records are read from `data[offset..size]`
+    File segment;
+    const u8 *data;
+    usize size;
+    usize offset;
+    bool is_last;
+
+    String error;
+};
+
+static inline u32 record_log_read_u32(const u8 *ptr) {
+    return (u32)ptr[0] | (u32)ptr[1] << 8 | (u32)ptr[2] << 16 |
+           (u32)ptr[3] << 24;
+}
+
+static inline void record_log_write_u32(u8 *ptr, u32 value) {
+    ptr[0] = (u8)value;
+    ptr[1] = (u8)(value >> 8);
+    ptr[2] = (u8)(value >> 16);
+    ptr[3] = (u8)(value >> 24);
+}
+
+/*
+ * `CRC32C` of the 4 `len` bytes + the payload
+ */
+static u32 record_log_crc(const u8 *len_bytes, const void *ptr, usize len) {
+    u32 crc = Checksum_crc32c(len_bytes, 4);
+    return len > 0 ? Checksum_crc32c_update(crc, ptr, len) : crc;
+}
+
+/*
+ * Check the record at `data[offset..size]`, set `payload` (if not `NULL`)
+ * to the payload.
+ *
+ * Return the record size (header + payload), `0` if the record is
+ * incomplete or broken.
+ */
+static usize record_log_check(const u8 *data,
+                              usize size,
+                              usize offset,
+                              StrView *payload) {
+    if (size - offset < RECORD_LOG_HEADER_SIZE) return 0;
+
+    const u8 *header = data + offset;
+    u32 len          = record_log_read_u32(header);
+    if (size - offset - RECORD_LOG_HEADER_SIZE < len) return 0;
+
+    const u8 *ptr = header + RECORD_LOG_HEADER_SIZE;
+    if (record_log_crc(header, ptr, len) != record_log_read_u32(header + 4))
+        return 0;
+
+    if (payload != NULL) {
+        *payload = (StrView){.ptr = (const char *)ptr, .len = len};
+    }
+
+    return RECORD_LOG_HEADER_SIZE + len;
+}
+
+/*
+ * `<folder>/<number, 20 digits>.log`
+ */
+static String record_log_segment_path(const char *folder, u64 number) {
+    char name[32];
+    snprintf(name, sizeof(name), "/%020" PRIu64 ".log", number);
+
+    String path = HS_from_str(folder);
+    HS_push_str(path, name);
+
+    return path;
+}
+
+/*
+ * All segment paths in `folder` in the append order (the zero padded
+ * numbers sort as strings), `NULL` if the folder can't be opened
+ */
+static StringTable record_log_list_segments(const char *folder) {
+    return Dir_walk(folder,
+                    (DirWalkOptions){
+                        .pattern   = "????????????????????.log",
+                        .symlinks  = DWS_SKIP,
+                        .max_depth = 1,
+                        .sort      = true,
+                    });
+}
+
+//
+// Writer
+//
+
+static void record_log_set_error(RecordLog self, const char *error) {
+    if (self->error != NULL) HS_free(self->error);
+    self->error = HS_from_str(error);
+}
+
+/*
+ * Open the segment for appending, write the magic if it's a new one
+ */
+static bool record_log_open_segment(RecordLog self, u64 number) {
+    String path  = record_log_segment_path(HS_as_str(self->folder), number);
+    File segment = File_open(HS_as_str(path), FM_APPEND);
+    HS_free(path);
+
+    if (!File_is_open_successfully(segment)) {
+        record_log_set_error(self, File_get_error(segment));
+        File_free(segment);
+        return false;
+    }
+    File_set_write_options(segment, self->options.write_options);
+
+    self->segment        = segment;
+    self->segment_number = number;
+    if (self->segment_size == 0) {
+        if (!File_append_bytes(segment,
+                               RECORD_LOG_MAGIC,
+                               RECORD_LOG_MAGIC_SIZE)) {
+            record_log_set_error(self, File_get_error(segment));
+            return false;
+        }
+        self->segment_size = RECORD_LOG_MAGIC_SIZE;
+    }
+
+#ifdef ENABLE_DEBUG_LOG
+    DEBUG_LOG(RecordLog,
+              open_segment,
+              "folder: %s, segment: %" PRIu64 ", size: %lu",
+              HS_as_str(self->folder),
+              number,
+              self->segment_size);
+#endif
+
+    return true;
+}
+
+/*
+ * Scan the last segment and truncate the torn record at the end (if any),
+ * `segment_size` is the size after truncating
+ */
+static bool record_log_recover(RecordLog self, const char *path) {
+    defer_file(segment) = File_open(path, FM_READ_ONLY);
+    if (!File_map(segment, (FileMapOptions){.sequential = true})) {
+        record_log_set_error(self, File_get_error(segment));
+        return false;
+    }
+
+    const u8 *data = (const u8 *)File_get_data(segment);
+    usize size     = File_get_size(segment);
+
+    //
+    // A torn magic is rewritten by `record_log_open_segment`
+    //
+    usize valid_size = 0;
+    if (size >= RECORD_LOG_MAGIC_SIZE) {
+        if (memcmp(data, RECORD_LOG_MAGIC, RECORD_LOG_MAGIC_SIZE) != 0) {
+            record_log_set_error(self, "Not a record log segment");
+            return false;
+        }
+
+        valid_size = RECORD_LOG_MAGIC_SIZE;
+        for (;;) {
+            usize record_size = record_log_check(data, size, valid_size, NULL);
+            if (record_size == 0) break;
+
+            valid_size += record_size;
+        }
+    }
+
+    self->segment_size   = valid_size;
+    self->truncated_size = size - valid_size;
+    if (valid_size == size) return true;
+
+#ifdef ENABLE_DEBUG_LOG
+    DEBUG_LOG(RecordLog,
+              recover,
+              "path: %s, size: %lu, truncate to: %lu",
+              path,
+              size,
+              valid_size);
+#endif
+
+    int fd = open(path, O_WRONLY);
+    if (fd < 0 || ftruncate(fd, valid_size) != 0 || fsync(fd) != 0) {
+        record_log_set_error(self, strerror(errno));
+        if (fd >= 0) close(fd);
+        return false;
+    }
+    close(fd);
+
+    return true;
+}
+
+/*
+ * `fsync` the folder, so the new segment file survives a crash
+ */
+static void record_log_sync_folder(RecordLog self) {
+    int fd = open(HS_as_str(self->folder), O_RDONLY);
+    if (fd < 0) return;
+
+    fsync(fd);
+    close(fd);
+}
+
+/*
+ * Close the current segment and start the next one
+ */
+static bool record_log_roll(RecordLog self) {
+    if (!File_flush(self->segment)) {
+        record_log_set_error(self, File_get_error(self->segment));
+        return false;
+    }
+    File_free(self->segment);
+    self->segment      = NULL;
+    self->segment_size = 0;
+
+    if (!record_log_open_segment(self, self->segment_number + 1)) return false;
+    if (self->options.write_options.sync != FS_NONE) {
+        record_log_sync_folder(self);
+    }
+
+    return true;
+}
+
+/*
+ * Open (or create) the record log
+ */
+RecordLog RecordLog_open(const char *folder, RecordLogOptions options) {
+    if (options.segment_size == 0) {
+        options.segment_size = RECORD_LOG_DEFAULT_SEGMENT_SIZE;
+    }
+
+    RecordLog self = malloc(sizeof(struct _RecordLog));
+    *self          = (struct _RecordLog){
+                 .folder  = HS_from_str(folder),
+                 .options = options,
+    };
+
+    if (mkdir(folder, 0755) != 0 && errno != EEXIST) {
+        record_log_set_error(self, strerror(errno));
+        return self;
+    }
+
+    defer_string_table(segments) = record_log_list_segments(folder);
+    if (segments == NULL) {
+        record_log_set_error(self, "Can't open the folder");
+        return self;
+    }
+
+    usize segment_count = ST_len(segments);
+    if (segment_count == 0) {
+        record_log_open_segment(self, 0);
+        return self;
+    }
+
+    //
+    // Continue with the last segment
+    //
+    const char *last_path = ST_get(segments, segment_count - 1).ptr;
+    u64 number            = strtoull(strrchr(last_path, '/') + 1, NULL, 10);
+    if (record_log_recover(self, last_path)) {
+        record_log_open_segment(self, number);
+    }
+
+    return self;
+}
+
+/*
+ * Append a record
+ */
+bool RecordLog_append(RecordLog self, const void *ptr, usize len) {
+    if (self == NULL || self->segment == NULL || (ptr == NULL && len > 0))
+        return false;
+    if (len > 0xFFFFFFFF) {
+        record_log_set_error(self, "Record is too big");
+        return false;
+    }
+
+    //
+    // Roll before the segment grows bigger than the limit, a record bigger
+    // than the limit goes to a segment of its own
+    //
+    usize record_size = RECORD_LOG_HEADER_SIZE + len;
+    if (self->segment_size > RECORD_LOG_MAGIC_SIZE &&
+        self->segment_size + record_size > self->options.segment_size &&
+        !record_log_roll(self)) {
+        return false;
+    }
+
+    u8 header[RECORD_LOG_HEADER_SIZE];
+    record_log_write_u32(header, (u32)len);
+    record_log_write_u32(header + 4, record_log_crc(header, ptr, len));
+
+    if (!File_append_bytes(self->segment, header, RECORD_LOG_HEADER_SIZE) ||
+        (len > 0 && !File_append_bytes(self->segment, ptr, len))) {
+        record_log_set_error(self, File_get_error(self->segment));
+        return false;
+    }
+    self->segment_size += record_size;
+
+    return true;
+}
+
+/*
+ * Write the buffered records
+ */
+bool RecordLog_flush(RecordLog self) {
+    if (self == NULL || self->segment == NULL) return false;
+
+    if (!File_flush(self->segment)) {
+        record_log_set_error(self, File_get_error(self->segment));
+        return false;
+    }
+
+    return true;
+}
+
+/*
+ * Return the current segment number
+ */
+u64 RecordLog_get_segment(const RecordLog self) {
+    return self != NULL ? self->segment_number : 0;
+}
+
+/*
+ * Return the truncated size
+ */
+usize RecordLog_get_truncated_size(const RecordLog self) {
+    return self != NULL ? self->truncated_size : 0;
+}
+
+/*
+ * Return the last error
+ */
+const char *RecordLog_get_error(const RecordLog self) {
+    return (self != NULL && self->error != NULL) ? HS_as_str(self->error)
+                                                 : NULL;
+}
+
+/*
+ * Flush and free
+ */
+void RecordLog_free(RecordLog self) {
+    if (self == NULL) return;
+
+#ifdef ENABLE_DEBUG_LOG
+    DEBUG_LOG(RecordLog,
+              free,
+              "self ptr: %p, folder: %s, segment: %" PRIu64 ", size: %lu",
+              self,
+              HS_as_str(self->folder),
+              self->segment_number,
+              self->segment_size);
+#endif
+
+    File_free(self->segment);
+    HS_free(self->folder);
+    if (self->error != NULL) HS_free(self->error);
+    free(self);
+}
+
+/*
+ * Auto free record log
+ */
+void auto_free_record_log(RecordLog *ptr) {
+    RecordLog_free(*ptr);
+}
+
+//
+// Reader
+//
+
+static void record_log_reader_set_error(RecordLogReader self,
+                                        const char *error,
+                                        usize offset) {
+    char message[512];
+    snprintf(message,
+             sizeof(message),
+             "%s at %lu of '%s'",
+             error,
+             offset,
+             File_get_filename(self->segment));
+
+    if (self->error != NULL) HS_free(self->error);
+    self->error = HS_from_str(message);
+}
+
+/*
+ * Map the next segment, return `false` if there is no more or it can't be
+ * mapped
+ */
+static bool record_log_reader_next_segment(RecordLogReader self) {
+    File_free(self->segment);
+    self->segment = NULL;
+    if (self->next_path >= ST_len(self->paths)) return false;
+
+    StrView path  = ST_get(self->paths, self->next_path++);
+    self->is_last = self->next_path == ST_len(self->paths);
+    self->segment = File_open(path.ptr, FM_READ_ONLY);
+    if (!File_map(self->segment, (FileMapOptions){.sequential = true})) {
+        record_log_reader_set_error(self, File_get_error(self->segment), 0);
+        return false;
+    }
+
+    self->data   = (const u8 *)File_get_data(self->segment);
+    self->size   = File_get_size(self->segment);
+    self->offset = RECORD_LOG_MAGIC_SIZE;
+
+#ifdef ENABLE_DEBUG_LOG
+    DEBUG_LOG(RecordLogReader,
+              next_segment,
+              "path: %s, size: %lu, is_last: %d",
+              path.ptr,
+              self->size,
+              self->is_last);
+#endif
+
+    //
+    // Only the last segment can have a torn magic
+    //
+    if (self->size < RECORD_LOG_MAGIC_SIZE) {
+        self->offset = self->size;
+        if (self->is_last) return true;
+
+        record_log_reader_set_error(self, "Broken segment", 0);
+        return false;
+    }
+    if (memcmp(self->data, RECORD_LOG_MAGIC, RECORD_LOG_MAGIC_SIZE) != 0) {
+        record_log_reader_set_error(self, "Not a record log segment", 0);
+        return false;
+    }
+
+    return true;
+}
+
+/*
+ * Open a reader
+ */
+RecordLogReader RecordLogReader_open(const char *folder) {
+    StringTable paths = record_log_list_segments(folder);
+    if (paths == NULL) return NULL;
+
+    RecordLogReader self = malloc(sizeof(struct _RecordLogReader));
+    *self                = (struct _RecordLogReader){.paths = paths};
+
+#ifdef ENABLE_DEBUG_LOG
+    DEBUG_LOG(RecordLogReader,
+              open,
+              "self ptr: %p, folder: %s, segments: %lu",
+              self,
+              folder,
+              ST_len(paths));
+#endif
+
+    return self;
+}
+
+/*
+ * Read the next record
+ */
+bool RecordLogReader_next(RecordLogReader self, StrView *record) {
+    if (self == NULL || record == NULL || self->error != NULL) return false;
+
+    for (;;) {
+        if (self->segment != NULL && self->offset < self->size) {
+            usize record_size =
+                record_log_check(self->data, self->size, self->offset, record);
+            if (record_size > 0) {
+                self->offset += record_size;
+                return true;
+            }
+
+            //
+            // The torn record at the end of the last segment is the end,
+            // it's broken in the middle otherwise
+            //
+            if (!self->is_last) {
+                record_log_reader_set_error(self,
+                                            "Broken record",
+                                            self->offset);
+            }
+            self->offset = self->size;
+            return false;
+        }
+
+        if (!record_log_reader_next_segment(self)) return false;
+    }
+}
+
+/*
+ * Return the error
+ */
+const char *RecordLogReader_get_error(const RecordLogReader self) {
+    return (self != NULL && self->error != NULL) ? HS_as_str(self->error)
+                                                 : NULL;
+}
+
+/*
+ * Free
+ */
+void RecordLogReader_free(RecordLogReader self) {
+    if (self == NULL) return;
+
+    File_free(self->segment);
+    ST_free(self->paths);
+    if (self->error != NULL) HS_free(self->error);
+    free(self);
+}
+
+/*
+ * Auto free record log reader
+ */
+void auto_free_record_log_reader(RecordLogReader *ptr) {
+    RecordLogReader_free(*ptr);
+}
@@ -0,0 +1,184 @@
+#ifndef __UTILS_RECORD_LOG_H__
+#define __UTILS_RECORD_LOG_H__
+
+#include <stdbool.h>
+
+#include "data_types.h"
+#include "file.h"
+#include "heap_string.h"
+
+//
+// Append-only record log: binary records in segment files of a folder.
+//
+// Segment file: `<folder>/<segment number, 20 digits>.log`, e.g.
+// `00000000000000000003.log`, it starts with the 8 bytes magic `RECLOG01`
+// followed by the records:
+//
+// ```
+// +----------------+----------------+---------------------+
+// | len (u32, LE)  | crc (u32, LE)  | payload (len bytes) |
+// +----------------+----------------+---------------------+
+// ```
+//
+// `crc` is the `CRC32C` of the 4 `len` bytes + the payload, so a torn `len`
+// is detected as well. A new segment is started when the current one would
+// grow bigger than `segment_size` (a record bigger than that has a segment
+// of its own).
+//
+// A crash in the middle of an append leaves a torn (incomplete or invalid)
+// record at the end of the last segment, `RecordLog_open` truncates it, and
+// the reader stops before it.
+//
+
+/*
+ * Opaque pointer to `struct _RecordLog`
+ */
+typedef struct _RecordLog *RecordLog;
+
+/*
+ * Opaque pointer to `struct _RecordLogReader`
+ */
+typedef struct _RecordLogReader *RecordLogReader;
+
+/*
+ * The default segment size
+ */
+#define RECORD_LOG_DEFAULT_SEGMENT_SIZE (64 * 1024 * 1024)
+
+/*
+ * Record header size (`len` + `crc`)
+ */
+#define RECORD_LOG_HEADER_SIZE 8
+
+/*
+ * Writer options, `(RecordLogOptions){0}` is the default:
+ *
+ * - `segment_size`: `0` means `RECORD_LOG_DEFAULT_SEGMENT_SIZE`
+ * - `write_options`: buffer size and durability of the segment files (see
+ *   `File_set_write_options`), the default buffers `1MB` and never syncs
+ */
+typedef struct {
+    usize segment_size;
+    FileWriteOptions write_options;
+} RecordLogOptions;
+
+//
+//
+//
+void auto_free_record_log(RecordLog *ptr);
+
+/*
+ * Define smart `RecordLog` var that calls `RecordLog_free()` automatically
+ * when the variable is out of the scope
+ *
+ * ```c
+ * defer_record_log(events) = RecordLog_open("events", (RecordLogOptions){
+ *     .write_options = {.sync = FS_ON_CLOSE},
+ * });
+ * if (RecordLog_get_error(events) != NULL) return;
+ *
+ * RecordLog_append(events, payload, payload_len);
+ * ```
+ */
+#define defer_record_log(x)                                                    \
+    __attribute__((cleanup(auto_free_record_log))) RecordLog x
+
+//
+//
+//
+void auto_free_record_log_reader(RecordLogReader *ptr);
+
+/*
+ * Define smart `RecordLogReader` var that calls `RecordLogReader_free()`
+ * automatically when the variable is out of the scope
+ *
+ * ```c
+ * defer_record_log_reader(reader) = RecordLogReader_open("events");
+ *
+ * StrView record;
+ * while (RecordLogReader_next(reader, &record)) {
+ *     handle_event(record.ptr, record.len);
+ * }
+ *
+ * if (RecordLogReader_get_error(reader) != NULL) {
+ *     printf("\n>>> Broken log: %s", RecordLogReader_get_error(reader));
+ * }
+ * ```
+ */
+#define defer_record_log_reader(x)                                             \
+    __attribute__((cleanup(auto_free_record_log_reader))) RecordLogReader x
+
+/*
+ * Open (or create) the record log in `folder` for appending. The folder is
+ * created if it doesn't exist, the torn record at the end of the last
+ * segment (if any) is truncated.
+ *
+ * Check `RecordLog_get_error` after opening, `RecordLog_append` fails if the
+ * log can't be opened.
+ */
+RecordLog RecordLog_open(const char *folder, RecordLogOptions options);
+
+/*
+ * Append a record `ptr[0..len]` (`len` fits in `u32`). It goes to the write
+ * buffer, use `RecordLog_flush` (or the `write_options.sync` policy) to
+ * make it durable.
+ *
+ * Return `false` and set the error if the write fails.
+ */
+bool RecordLog_append(RecordLog self, const void *ptr, usize len);
+
+/*
+ * Write the buffered records to the current segment
+ */
+bool RecordLog_flush(RecordLog self);
+
+/*
+ * Return the segment number that the next record goes to
+ */
+u64 RecordLog_get_segment(const RecordLog self);
+
+/*
+ * Return the size of the torn record truncated by `RecordLog_open`, `0`
+ * means the log was closed cleanly
+ */
+usize RecordLog_get_truncated_size(const RecordLog self);
+
+/*
+ * Return the last error, `NULL` if no error
+ */
+const char *RecordLog_get_error(const RecordLog self);
+
+/*
+ * Flush and free
+ */
+void RecordLog_free(RecordLog self);
+
+/*
+ * Open a reader on the record log in `folder`, the segments are mapped
+ * (`File_map`) one by one, the records are read in the append order.
+ *
+ * Return `NULL` if the folder can't be opened.
+ */
+RecordLogReader RecordLogReader_open(const char *folder);
+
+/*
+ * Read the next record as a zero-copy view into the mapped segment, it's
+ * valid until the reader moves to the next segment (or freed).
+ *
+ * Return `false` at the end of the log (a torn record at the end of the
+ * last segment is the end as well), or when a record in the middle is
+ * broken (`RecordLogReader_get_error` is not `NULL`).
+ */
+bool RecordLogReader_next(RecordLogReader self, StrView *record);
+
+/*
+ * Return the error, `NULL` if no error
+ */
+const char *RecordLogReader_get_error(const RecordLogReader self);
+
+/*
+ * Free
+ */
+void RecordLogReader_free(RecordLogReader self);
+
+#endif
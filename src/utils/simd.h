@@ -0,0 +1,25 @@
+#ifndef __UTILS_SIMD_H__
+#define __UTILS_SIMD_H__
+
+#include <stdbool.h>
+
+//
+// SIMD helpers shared by the string, hex and file modules.
+//
+// The library is compiled without any `-m` flags, so the wide code paths are
+// compiled per function via `SIMD_TARGET("avx2")` and selected at runtime
+// with `SIMD_CPU_HAS("avx2")`. `SSE2` is part of the `x86_64` baseline, so it
+// can be used directly without any check.
+//
+// On every other architecture `SIMD_X86_64` is undefined and the callers fall
+// back to their portable (scalar or `u64` word-at-a-time) implementation.
+//
+#if defined(__x86_64__)
+    #define SIMD_X86_64
+    #include <immintrin.h>
+
+    #define SIMD_TARGET(FEATURES) __attribute__((target(FEATURES)))
+    #define SIMD_CPU_HAS(FEATURE) (__builtin_cpu_supports(FEATURE) > 0)
+#endif
+
+#endif
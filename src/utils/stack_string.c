@@ -0,0 +1,240 @@
+#include "stack_string.h"
+
+#include <string.h>
+
+#include "ascii.h"
+
+#ifdef ENABLE_DEBUG_LOG
+    #include "log.h"
+#endif
+
+//
+// Return `true` if `extra_len` more characters (plus the null-terminated
+// character) fit, otherwise set the overflow flag.
+//
+static inline bool stack_string_reserve(StackStr self, usize extra_len) {
+    if (self->_len + extra_len + 1 > self->_capacity) {
+        self->_overflow = true;
+
+#ifdef ENABLE_DEBUG_LOG
+        DEBUG_LOG(StackString,
+                  reserve,
+                  "overflow, self ptr: %p, len: %lu, extra_len: %lu, "
+                  "capacity: %lu",
+                  self,
+                  self->_len,
+                  extra_len,
+                  self->_capacity);
+#endif
+        return false;
+    }
+
+    return true;
+}
+
+/*
+ * Push the given `char *` at the end
+ */
+bool SS_push_str(StackStr self, const char *str_to_push) {
+    if (self == NULL || str_to_push == NULL) return false;
+
+    return SS_push_view(
+        self,
+        (StrView){.ptr = str_to_push, .len = strlen(str_to_push)});
+}
+
+/*
+ * Push the given `StrView` at the end
+ */
+bool SS_push_view(StackStr self, StrView view) {
+    if (self == NULL || view.ptr == NULL) return false;
+    if (view.len == 0) return true;
+    if (!stack_string_reserve(self, view.len)) return false;
+
+    memcpy(self->_buffer + self->_len, view.ptr, view.len);
+    self->_len += view.len;
+    self->_buffer[self->_len] = '\0';
+
+    return true;
+}
+
+/*
+ * Push the given `String` at the end
+ */
+bool SS_push_other(StackStr self, const String other) {
+    if (self == NULL || other == NULL) return false;
+
+    StrView view = HS_as_view(other);
+    return (view.ptr == NULL) ? true : SS_push_view(self, view);
+}
+
+/*
+ * Insert `char *` to the beginning
+ */
+bool SS_insert_str_to_begin(StackStr self, const char *str_to_insert) {
+    if (self == NULL || str_to_insert == NULL) return false;
+
+    usize insert_len = strlen(str_to_insert);
+    if (insert_len == 0) return true;
+    if (!stack_string_reserve(self, insert_len)) return false;
+
+    // Move the existing characters (include the `\0`) to the right
+    memmove(self->_buffer + insert_len, self->_buffer, self->_len + 1);
+    memcpy(self->_buffer, str_to_insert, insert_len);
+    self->_len += insert_len;
+
+    return true;
+}
+
+/*
+ * Get back string length
+ */
+usize SS_length(const StackStr self) {
+    return (self != NULL) ? self->_len : 0;
+}
+
+/*
+ * Get back capacity (includes the null-terminated character)
+ */
+usize SS_capacity(const StackStr self) {
+    return (self != NULL) ? self->_capacity : 0;
+}
+
+/*
+ * Check whether any push or insert has been dropped
+ */
+bool SS_is_overflow(const StackStr self) {
+    return (self != NULL) ? self->_overflow : false;
+}
+
+/*
+ * Get back `char *`
+ */
+const char *SS_as_str(const StackStr self) {
+    return (self != NULL) ? self->_buffer : NULL;
+}
+
+/*
+ * Get back a `StrView` that points to the internal buffer
+ */
+StrView SS_as_view(const StackStr self) {
+    return (self != NULL) ? (StrView){.ptr = self->_buffer, .len = self->_len}
+                          : (StrView){.ptr = NULL, .len = 0};
+}
+
+/*
+ * Find the given `char *` index, return `-1` if not found.
+ */
+long SS_index_of(const StackStr self, const char *str_to_find) {
+    if (self == NULL || str_to_find == NULL) return -1;
+
+    return Ascii_index_of_ignore_case(self->_buffer,
+                                      self->_len,
+                                      str_to_find,
+                                      strlen(str_to_find));
+}
+
+/*
+ * Find the given `char *` (case sensitive) index, return `-1` if not found.
+ */
+long SS_index_of_case_sensitive(const StackStr self, const char *str_to_find) {
+    if (self == NULL || str_to_find == NULL || str_to_find[0] == '\0') {
+        return -1;
+    }
+
+    char *found = strstr(self->_buffer, str_to_find);
+    return (found == NULL) ? -1 : found - self->_buffer;
+}
+
+/*
+ * Check whether contain the given `char *` or not
+ */
+bool SS_contains(const StackStr self, const char *str_to_check) {
+    return SS_index_of(self, str_to_check) != -1;
+}
+
+/*
+ * Byte by byte compare, return `< 0`, `0` or `> 0` like `strcmp`
+ */
+int SS_compare(const StackStr self, const StackStr other) {
+    StrView self_view  = SS_as_view(self);
+    StrView other_view = SS_as_view(other);
+    usize min_len =
+        self_view.len < other_view.len ? self_view.len : other_view.len;
+
+    if (min_len > 0) {
+        int result = memcmp(self_view.ptr, other_view.ptr, min_len);
+        if (result != 0) return result;
+    }
+
+    if (self_view.len == other_view.len) return 0;
+    return self_view.len < other_view.len ? -1 : 1;
+}
+
+/*
+ * Case-insensitive (ASCII only) compare, return `true` if equal
+ */
+bool SS_equals_ignore_case(const StackStr self, const StackStr other) {
+    StrView self_view  = SS_as_view(self);
+    StrView other_view = SS_as_view(other);
+
+    if (self_view.len != other_view.len) return false;
+
+    return Ascii_equals_ignore_case(self_view.ptr,
+                                    other_view.ptr,
+                                    self_view.len);
+}
+
+/*
+ * Case-insensitive (ASCII only) version of `SS_compare`
+ */
+int SS_compare_ignore_case(const StackStr self, const StackStr other) {
+    StrView self_view  = SS_as_view(self);
+    StrView other_view = SS_as_view(other);
+
+    return Ascii_compare_ignore_case(self_view.ptr,
+                                     self_view.len,
+                                     other_view.ptr,
+                                     other_view.len);
+}
+
+/*
+ * Reset to empty string, also clear the overflow flag
+ */
+void SS_reset_to_empty(StackStr self) {
+    if (self == NULL) return;
+
+    self->_len      = 0;
+    self->_overflow = false;
+    if (self->_capacity > 0) self->_buffer[0] = '\0';
+}
+
+/*
+ * Promote to a heap allocated `String`
+ */
+String SS_to_string(const StackStr self) {
+    usize len = SS_length(self);
+    if (len == 0) return HS_from_empty();
+
+    //
+    // The capacity is exactly enough, so `HS_push_view` never reallocs
+    //
+    String string = HS_from_empty_with_capacity(len + 1);
+    HS_push_view(string, SS_as_view(self));
+
+    return string;
+}
+
+/*
+ *
+ */
+void auto_free_stack_string(StackStr *ptr) {
+#ifdef ENABLE_DEBUG_LOG
+    DEBUG_LOG(StackString,
+              auto_free_stack_string,
+              "out of scope with stack string ptr: %p, as_str: %s",
+              *ptr,
+              SS_as_str(*ptr));
+#endif
+    SS_reset_to_empty(*ptr);
+}
@@ -0,0 +1,170 @@
+#ifndef __UTILS_STACK_STRING_H__
+#define __UTILS_STACK_STRING_H__
+
+#include <stdbool.h>
+
+#include "data_types.h"
+#include "heap_string.h"
+
+//
+// Fixed-capacity string that lives on the stack (or inside another struct),
+// it never touches the heap.
+//
+// `StackString(N)` is the storage type, it holds at most `N - 1` characters
+// plus the null-terminated character. All `SS_xxx` functions work on the
+// `StackStr` handle, which points to the storage. A push or insert that
+// doesn't fit changes nothing and sets the overflow flag instead, so the
+// content is never truncated in the middle of a UTF-8 sequence.
+//
+#define StackString(N)                                                         \
+    struct {                                                                   \
+        usize _capacity;                                                       \
+        usize _len;                                                            \
+        bool _overflow;                                                        \
+        char _buffer[(N)];                                                     \
+    }
+
+//
+// The common header of all `StackString(N)`, it has the same layout with
+// `StackString(N)` except the buffer size.
+//
+struct _StackStringHeader {
+    usize _capacity;
+    usize _len;
+    bool _overflow;
+    char _buffer[];
+};
+
+//
+// Stack string handle
+//
+typedef struct _StackStringHeader *StackStr;
+
+/*
+ * Initializer for `StackString(N)`
+ *
+ * ```c
+ * StackString(64) key_storage = STACK_STRING_INIT(64);
+ * StackStr key                = SS_from_storage(&key_storage);
+ * ```
+ */
+#define STACK_STRING_INIT(N)                                                   \
+    {._capacity = (N), ._len = 0, ._overflow = false, ._buffer = {0}}
+
+/*
+ * Get back the `StackStr` handle of the given `StackString(N)` storage
+ */
+#define SS_from_storage(storage_ptr) ((StackStr)(storage_ptr))
+
+//
+//
+//
+void auto_free_stack_string(StackStr *ptr);
+
+/*
+ * Define `StackString(N)` storage and the `StackStr` handle `x` that points
+ * to it, the content is reset when the variable is out of the scope.
+ *
+ * ```c
+ * defer_stack_string(log_line, 256);
+ * SS_push_str(log_line, "[ INFO ] ");
+ * SS_push_str(log_line, message);
+ * ```
+ */
+#define defer_stack_string(x, N)                                               \
+    StackString(N) x##_storage = STACK_STRING_INIT(N);                         \
+    __attribute__((cleanup(auto_free_stack_string))) StackStr x =              \
+        SS_from_storage(&x##_storage)
+
+/*
+ * Push the given `char *` at the end, return `false` (and set the overflow
+ * flag) if it doesn't fit.
+ */
+bool SS_push_str(StackStr self, const char *str_to_push);
+
+/*
+ * Push the given `StrView` at the end, return `false` (and set the overflow
+ * flag) if it doesn't fit.
+ */
+bool SS_push_view(StackStr self, StrView view);
+
+/*
+ * Push the given `String` at the end, return `false` (and set the overflow
+ * flag) if it doesn't fit.
+ */
+bool SS_push_other(StackStr self, const String other);
+
+/*
+ * Insert `char *` to the beginning, return `false` (and set the overflow
+ * flag) if it doesn't fit.
+ */
+bool SS_insert_str_to_begin(StackStr self, const char *str_to_insert);
+
+/*
+ * Get back string length
+ */
+usize SS_length(const StackStr self);
+
+/*
+ * Get back capacity (includes the null-terminated character)
+ */
+usize SS_capacity(const StackStr self);
+
+/*
+ * Check whether any push or insert has been dropped because of not enough
+ * capacity
+ */
+bool SS_is_overflow(const StackStr self);
+
+/*
+ * Get back `char *`, it's always null-terminated
+ */
+const char *SS_as_str(const StackStr self);
+
+/*
+ * Get back a `StrView` that points to the internal buffer (zero-copy)
+ */
+StrView SS_as_view(const StackStr self);
+
+/*
+ * Find the given `char *` index, return `-1` if not found.
+ */
+long SS_index_of(const StackStr self, const char *str_to_find);
+
+/*
+ * Find the given `char *` (case sensitive) index, return `-1` if not found.
+ */
+long SS_index_of_case_sensitive(const StackStr self, const char *str_to_find);
+
+/*
+ * Check whether contain the given `char *` or not
+ */
+bool SS_contains(const StackStr self, const char *str_to_check);
+
+/*
+ * Byte by byte compare, return `< 0`, `0` or `> 0` like `strcmp`
+ */
+int SS_compare(const StackStr self, const StackStr other);
+
+/*
+ * Case-insensitive (ASCII only) compare, return `true` if equal
+ */
+bool SS_equals_ignore_case(const StackStr self, const StackStr other);
+
+/*
+ * Case-insensitive (ASCII only) version of `SS_compare`
+ */
+int SS_compare_ignore_case(const StackStr self, const StackStr other);
+
+/*
+ * Reset to empty string, also clear the overflow flag
+ */
+void SS_reset_to_empty(StackStr self);
+
+/*
+ * Promote to a heap allocated `String`, the buffer is allocated only once
+ * with the exact size. The caller owns the returned `String`.
+ */
+String SS_to_string(const StackStr self);
+
+#endif
@@ -0,0 +1,431 @@
+#include "utf8.h"
+
+#include <string.h>
+
+#include "simd.h"
+
+#ifdef ENABLE_DEBUG_LOG
+    #include "log.h"
+#endif
+
+//
+// Return the byte length of the valid UTF-8 sequence starts at `ptr`, return
+// 0 if it's invalid or truncated. Ranges come from the Unicode standard
+// "Table 3-7. Well-Formed UTF-8 Byte Sequences".
+//
+static usize utf8_sequence_length(const u8 *ptr, usize remain) {
+    u8 b0 = ptr[0];
+    if (b0 < 0x80) return 1;
+
+    u8 second_min = 0x80;
+    u8 second_max = 0xBF;
+    usize seq_len = 0;
+
+    if (b0 >= 0xC2 && b0 <= 0xDF) {
+        seq_len = 2;
+    } else if (b0 == 0xE0) {
+        seq_len    = 3;
+        second_min = 0xA0;
+    } else if (b0 == 0xED) {
+        // No surrogates: U+D800 ~ U+DFFF
+        seq_len    = 3;
+        second_max = 0x9F;
+    } else if (b0 >= 0xE1 && b0 <= 0xEF) {
+        seq_len = 3;
+    } else if (b0 == 0xF0) {
+        seq_len    = 4;
+        second_min = 0x90;
+    } else if (b0 >= 0xF1 && b0 <= 0xF3) {
+        seq_len = 4;
+    } else if (b0 == 0xF4) {
+        // Not greater than U+10FFFF
+        seq_len    = 4;
+        second_max = 0x8F;
+    } else {
+        return 0;
+    }
+
+    if (remain < seq_len) return 0;
+    if (ptr[1] < second_min || ptr[1] > second_max) return 0;
+    for (usize index = 2; index < seq_len; index++) {
+        if ((ptr[index] & 0xC0) != 0x80) return 0;
+    }
+
+    return seq_len;
+}
+
+//
+// Portable validation: skip ASCII 8 bytes at a time, then check the
+// multi-byte sequence one by one.
+//
+static bool utf8_is_valid_scalar(const u8 *ptr, usize len) {
+    const u8 *end = ptr + len;
+
+    while (ptr < end) {
+        while (end - ptr >= 8) {
+            u64 word;
+            memcpy(&word, ptr, sizeof(word));
+            if (word & 0x8080808080808080ULL) break;
+            ptr += 8;
+        }
+        if (ptr >= end) break;
+
+        usize seq_len = utf8_sequence_length(ptr, end - ptr);
+        if (seq_len == 0) return false;
+        ptr += seq_len;
+    }
+
+    return true;
+}
+
+//
+// Portable code point count: count all continuation bytes (`10xxxxxx`) 8
+// bytes at a time, as `len - continuation_bytes` is the code point count.
+//
+static usize utf8_char_count_scalar(const u8 *ptr, usize len) {
+    usize continuation_bytes = 0;
+    usize index              = 0;
+
+    for (; index + 8 <= len; index += 8) {
+        u64 word;
+        memcpy(&word, ptr + index, sizeof(word));
+        // Bit 7 set and bit 6 (shifted into bit 7) clear
+        u64 continuation_bits = word & ~(word << 1) & 0x8080808080808080ULL;
+        continuation_bytes += __builtin_popcountll(continuation_bits);
+    }
+    for (; index < len; index++) {
+        if ((ptr[index] & 0xC0) == 0x80) continuation_bytes++;
+    }
+
+    return len - continuation_bytes;
+}
+
+#ifdef SIMD_X86_64
+
+//
+// Lookup tables of the "Validating UTF-8 In Less Than One Instruction Per
+// Byte" (Keiser & Lemire) algorithm. Each bit represents one error kind, the
+// error only happens when all 3 lookup results (high and low nibble of the
+// previous byte, high nibble of the current byte) have the same bit set.
+//
+    #define UTF8_TOO_SHORT (1 << 0)
+    #define UTF8_TOO_LONG (1 << 1)
+    #define UTF8_OVERLONG_3 (1 << 2)
+    #define UTF8_TOO_LARGE (1 << 3)
+    #define UTF8_SURROGATE (1 << 4)
+    #define UTF8_OVERLONG_2 (1 << 5)
+    #define UTF8_TOO_LARGE_1000 (1 << 6)
+    #define UTF8_OVERLONG_4 (1 << 6)
+    #define UTF8_TWO_CONTS (1 << 7)
+    #define UTF8_CARRY (UTF8_TOO_SHORT | UTF8_TOO_LONG | UTF8_TWO_CONTS)
+
+    #define UTF8_TABLE_16_TO_32(...) {__VA_ARGS__, __VA_ARGS__}
+
+static const u8 UTF8_BYTE_1_HIGH_TABLE[32] = UTF8_TABLE_16_TO_32(
+    // 0_______ ________ <ASCII in byte 1>
+    UTF8_TOO_LONG,
+    UTF8_TOO_LONG,
+    UTF8_TOO_LONG,
+    UTF8_TOO_LONG,
+    UTF8_TOO_LONG,
+    UTF8_TOO_LONG,
+    UTF8_TOO_LONG,
+    UTF8_TOO_LONG,
+    // 10______ ________ <continuation in byte 1>
+    UTF8_TWO_CONTS,
+    UTF8_TWO_CONTS,
+    UTF8_TWO_CONTS,
+    UTF8_TWO_CONTS,
+    // 1100____ ________ <two byte lead in byte 1>
+    UTF8_TOO_SHORT | UTF8_OVERLONG_2,
+    // 1101____ ________ <two byte lead in byte 1>
+    UTF8_TOO_SHORT,
+    // 1110____ ________ <three byte lead in byte 1>
+    UTF8_TOO_SHORT | UTF8_OVERLONG_3 | UTF8_SURROGATE,
+    // 1111____ ________ <four+ byte lead in byte 1>
+    UTF8_TOO_SHORT | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4);
+
+static const u8 UTF8_BYTE_1_LOW_TABLE[32] = UTF8_TABLE_16_TO_32(
+    // ____0000 ________
+    UTF8_CARRY | UTF8_OVERLONG_3 | UTF8_OVERLONG_2 | UTF8_OVERLONG_4,
+    // ____0001 ________
+    UTF8_CARRY | UTF8_OVERLONG_2,
+    // ____001_ ________
+    UTF8_CARRY,
+    UTF8_CARRY,
+    // ____0100 ________
+    UTF8_CARRY | UTF8_TOO_LARGE,
+    // ____0101 ________
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    // ____011_ ________
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    // ____1___ ________
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    // ____1101 ________
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_SURROGATE,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000);
+
+static const u8 UTF8_BYTE_2_HIGH_TABLE[32] = UTF8_TABLE_16_TO_32(
+    // ________ 0_______ <ASCII in byte 2>
+    UTF8_TOO_SHORT,
+    UTF8_TOO_SHORT,
+    UTF8_TOO_SHORT,
+    UTF8_TOO_SHORT,
+    UTF8_TOO_SHORT,
+    UTF8_TOO_SHORT,
+    UTF8_TOO_SHORT,
+    UTF8_TOO_SHORT,
+    // ________ 1000____
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 |
+        UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4,
+    // ________ 1001____
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 |
+        UTF8_TOO_LARGE,
+    // ________ 101_____
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE |
+        UTF8_TOO_LARGE,
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE |
+        UTF8_TOO_LARGE,
+    // ________ 11______
+    UTF8_TOO_SHORT,
+    UTF8_TOO_SHORT,
+    UTF8_TOO_SHORT,
+    UTF8_TOO_SHORT);
+
+//
+// If the last 3 bytes of a block match these, the sequence is not finished
+// yet: `... 1111____ 111_____ 11______`
+//
+static const u8 UTF8_INCOMPLETE_MAX_TABLE[32] = {
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 0xEF, 0xDF, 0xBF};
+
+//
+// The last `N` bytes of `PREV_INPUT` followed by the first `32 - N` bytes of
+// `INPUT`
+//
+    #define UTF8_PREV_AVX2(INPUT, PREV_INPUT, N)                               \
+        _mm256_alignr_epi8(                                                    \
+            (INPUT),                                                           \
+            _mm256_permute2x128_si256((PREV_INPUT), (INPUT), 0x21),            \
+            16 - (N))
+
+SIMD_TARGET("avx2")
+static inline __m256i utf8_high_nibble_avx2(__m256i v) {
+    return _mm256_and_si256(_mm256_srli_epi16(v, 4), _mm256_set1_epi8(0x0F));
+}
+
+SIMD_TARGET("avx2")
+static inline __m256i utf8_check_block_avx2(__m256i input,
+                                            __m256i prev_input) {
+    const __m256i byte_1_high_table =
+        _mm256_loadu_si256((const __m256i *)UTF8_BYTE_1_HIGH_TABLE);
+    const __m256i byte_1_low_table =
+        _mm256_loadu_si256((const __m256i *)UTF8_BYTE_1_LOW_TABLE);
+    const __m256i byte_2_high_table =
+        _mm256_loadu_si256((const __m256i *)UTF8_BYTE_2_HIGH_TABLE);
+
+    //
+    // Special cases: 2 bytes pair errors
+    //
+    __m256i prev1       = UTF8_PREV_AVX2(input, prev_input, 1);
+    __m256i byte_1_high = _mm256_shuffle_epi8(byte_1_high_table,
+                                              utf8_high_nibble_avx2(prev1));
+    __m256i byte_1_low  = _mm256_shuffle_epi8(
+        byte_1_low_table,
+        _mm256_and_si256(prev1, _mm256_set1_epi8(0x0F)));
+    __m256i byte_2_high = _mm256_shuffle_epi8(byte_2_high_table,
+                                              utf8_high_nibble_avx2(input));
+    __m256i special_cases =
+        _mm256_and_si256(_mm256_and_si256(byte_1_high, byte_1_low),
+                         byte_2_high);
+
+    //
+    // Multi-byte length: the 3rd/4th byte of a sequence must be a
+    // continuation, only `111_____` and `1111____` survive the saturating
+    // subtraction with the high bit set.
+    //
+    __m256i prev2          = UTF8_PREV_AVX2(input, prev_input, 2);
+    __m256i prev3          = UTF8_PREV_AVX2(input, prev_input, 3);
+    __m256i is_third_byte  = _mm256_subs_epu8(prev2, _mm256_set1_epi8(0x60));
+    __m256i is_fourth_byte = _mm256_subs_epu8(prev3, _mm256_set1_epi8(0x70));
+    __m256i must_be_continuation =
+        _mm256_and_si256(_mm256_or_si256(is_third_byte, is_fourth_byte),
+                         _mm256_set1_epi8((char)0x80));
+
+    return _mm256_xor_si256(must_be_continuation, special_cases);
+}
+
+SIMD_TARGET("avx2")
+static bool utf8_is_valid_avx2(const u8 *ptr, usize len) {
+    const __m256i incomplete_max =
+        _mm256_loadu_si256((const __m256i *)UTF8_INCOMPLETE_MAX_TABLE);
+
+    __m256i error           = _mm256_setzero_si256();
+    __m256i prev_input      = _mm256_setzero_si256();
+    __m256i prev_incomplete = _mm256_setzero_si256();
+
+    usize index = 0;
+    while (index < len) {
+        __m256i input;
+        if (index + 32 <= len) {
+            input = _mm256_loadu_si256((const __m256i *)(ptr + index));
+        } else {
+            //
+            // Zero padded tail, a sequence truncated by the end of input is
+            // followed by `0x00`, which is reported as `TOO_SHORT`.
+            //
+            u8 tail[32] = {0};
+            memcpy(tail, ptr + index, len - index);
+            input = _mm256_loadu_si256((const __m256i *)tail);
+        }
+
+        if (_mm256_movemask_epi8(input) == 0) {
+            // ASCII fast path, only need to check the previous block ending
+            error = _mm256_or_si256(error, prev_incomplete);
+            prev_incomplete = _mm256_setzero_si256();
+        } else {
+            error = _mm256_or_si256(error,
+                                    utf8_check_block_avx2(input, prev_input));
+            prev_incomplete = _mm256_subs_epu8(input, incomplete_max);
+        }
+
+        prev_input = input;
+        index += 32;
+    }
+
+    error = _mm256_or_si256(error, prev_incomplete);
+    return _mm256_testz_si256(error, error) != 0;
+}
+
+SIMD_TARGET("avx2")
+static usize utf8_char_count_avx2(const u8 *ptr, usize len) {
+    // Signed compare: continuation bytes are `0x80 ~ 0xBF` (-128 ~ -65)
+    const __m256i continuation_max = _mm256_set1_epi8(-65);
+
+    usize count = 0;
+    usize index = 0;
+    for (; index + 32 <= len; index += 32) {
+        __m256i input = _mm256_loadu_si256((const __m256i *)(ptr + index));
+        u32 mask      = (u32)_mm256_movemask_epi8(
+            _mm256_cmpgt_epi8(input, continuation_max));
+        count += __builtin_popcount(mask);
+    }
+
+    return count + utf8_char_count_scalar(ptr + index, len - index);
+}
+
+static usize utf8_char_count_sse2(const u8 *ptr, usize len) {
+    const __m128i continuation_max = _mm_set1_epi8(-65);
+
+    usize count = 0;
+    usize index = 0;
+    for (; index + 16 <= len; index += 16) {
+        __m128i input = _mm_loadu_si128((const __m128i *)(ptr + index));
+        u32 mask =
+            (u32)_mm_movemask_epi8(_mm_cmpgt_epi8(input, continuation_max));
+        count += __builtin_popcount(mask);
+    }
+
+    return count + utf8_char_count_scalar(ptr + index, len - index);
+}
+
+#endif
+
+/*
+ * Check whether `ptr[0..len]` is a valid UTF-8 sequence or not
+ */
+bool Utf8_is_valid(const char *ptr, usize len) {
+    if (ptr == NULL || len == 0) return true;
+
+#ifdef SIMD_X86_64
+    if (SIMD_CPU_HAS("avx2")) {
+        return utf8_is_valid_avx2((const u8 *)ptr, len);
+    }
+#endif
+
+    return utf8_is_valid_scalar((const u8 *)ptr, len);
+}
+
+/*
+ * Get back the code point count of `ptr[0..len]`
+ */
+usize Utf8_char_count(const char *ptr, usize len) {
+    if (ptr == NULL || len == 0) return 0;
+
+#ifdef SIMD_X86_64
+    if (SIMD_CPU_HAS("avx2")) {
+        return utf8_char_count_avx2((const u8 *)ptr, len);
+    }
+    return utf8_char_count_sse2((const u8 *)ptr, len);
+#else
+    return utf8_char_count_scalar((const u8 *)ptr, len);
+#endif
+}
+
+/*
+ * Create iterator from the given `StrView`
+ */
+Utf8Iteractor Utf8_iter(StrView view) {
+    if (view.ptr == NULL) {
+        return (Utf8Iteractor){._ptr = NULL, ._end = NULL};
+    }
+
+    return (Utf8Iteractor){
+        ._ptr = (const u8 *)view.ptr,
+        ._end = (const u8 *)view.ptr + view.len,
+    };
+}
+
+/*
+ * Decode the next code point into `out_code_point`
+ */
+bool Utf8_iter_next(Utf8Iteractor *iter, u32 *out_code_point) {
+    if (iter == NULL || iter->_ptr == NULL || iter->_ptr >= iter->_end) {
+        return false;
+    }
+
+    const u8 *ptr = iter->_ptr;
+    usize seq_len = utf8_sequence_length(ptr, iter->_end - ptr);
+    u32 code_point;
+
+    switch (seq_len) {
+        case 1:
+            code_point = ptr[0];
+            break;
+        case 2:
+            code_point = ((u32)(ptr[0] & 0x1F) << 6) | (ptr[1] & 0x3F);
+            break;
+        case 3:
+            code_point = ((u32)(ptr[0] & 0x0F) << 12) |
+                         ((u32)(ptr[1] & 0x3F) << 6) | (ptr[2] & 0x3F);
+            break;
+        case 4:
+            code_point = ((u32)(ptr[0] & 0x07) << 18) |
+                         ((u32)(ptr[1] & 0x3F) << 12) |
+                         ((u32)(ptr[2] & 0x3F) << 6) | (ptr[3] & 0x3F);
+            break;
+        default:
+#ifdef ENABLE_DEBUG_LOG
+            DEBUG_LOG(Utf8,
+                      iter_next,
+                      "invalid byte: 0x%02X, yield U+FFFD",
+                      ptr[0]);
+#endif
+            code_point = UTF8_REPLACEMENT_CHAR;
+            seq_len    = 1;
+            break;
+    }
+
+    iter->_ptr += seq_len;
+    if (out_code_point != NULL) *out_code_point = code_point;
+
+    return true;
+}
@@ -0,0 +1,61 @@
+#ifndef __UTILS_UTF8_H__
+#define __UTILS_UTF8_H__
+
+#include <stdbool.h>
+
+#include "data_types.h"
+#include "heap_string.h"
+
+//
+// Replacement character, `Utf8_iter_next` returns it for every invalid byte
+//
+#define UTF8_REPLACEMENT_CHAR 0xFFFD
+
+/*
+ * UTF-8 code point iterator over a `StrView`
+ *
+ * ```c
+ * Utf8Iteractor iter = Utf8_iter(HS_as_view(my_str));
+ * u32 code_point     = 0;
+ * while (Utf8_iter_next(&iter, &code_point)) {
+ *     printf("\n>>> U+%04X", code_point);
+ * }
+ * ```
+ */
+typedef struct {
+    const u8 *_ptr;
+    const u8 *_end;
+} Utf8Iteractor;
+
+/*
+ * Check whether `ptr[0..len]` is a valid UTF-8 sequence or not, the input
+ * doesn't need to be null-terminated.
+ *
+ * It validates 32 bytes per iteration with the `AVX2` lookup table method
+ * when the CPU supports it, pure ASCII blocks are skipped with a single
+ * `movemask`.
+ */
+bool Utf8_is_valid(const char *ptr, usize len);
+
+/*
+ * Get back the code point count of `ptr[0..len]`, it counts all
+ * non-continuation bytes (`10xxxxxx`). Only meaningful when the input is a
+ * valid UTF-8 sequence.
+ */
+usize Utf8_char_count(const char *ptr, usize len);
+
+/*
+ * Create iterator from the given `StrView`
+ */
+Utf8Iteractor Utf8_iter(StrView view);
+
+/*
+ * Decode the next code point into `out_code_point` and return `true`, return
+ * `false` when reaching the end.
+ *
+ * An invalid or truncated sequence yields `UTF8_REPLACEMENT_CHAR` and skips
+ * one byte only, so the iterator always moves forward.
+ */
+bool Utf8_iter_next(Utf8Iteractor *iter, u32 *out_code_point);
+
+#endif